@@ -2,27 +2,43 @@
 #include <chrono>
 #include <iostream>
 
+/**
+ * @brief Measures the elapsed time since creation or the last restart.
+*/
 class Timer {
 public:
 	Timer() {
-		startTimePoint = std::chrono::high_resolution_clock::now();
+		restart();
 	}
 
 	~Timer() {
 	}
 
-	void stop() {
-		auto endTimePoint = std::chrono::high_resolution_clock::now();
-
-		auto start = std::chrono::time_point_cast<std::chrono::microseconds>(startTimePoint).time_since_epoch().count();
-		auto end = std::chrono::time_point_cast<std::chrono::microseconds>(endTimePoint).time_since_epoch().count();
+	/**
+	 * @brief Restarts the timer.
+	*/
+	void restart() {
+		startTimePoint = std::chrono::steady_clock::now();
+	}
 
-		auto duration = end - start;
+	/**
+	 * @brief Gets the elapsed time.
+	 * @return Elapsed time in microseconds.
+	*/
+	double getElapsedMicroseconds() {
+		auto endTimePoint = std::chrono::steady_clock::now();
+		return std::chrono::duration<double, std::micro>(endTimePoint - startTimePoint).count();
+	}
 
+	/**
+	 * @brief Prints the elapsed time.
+	*/
+	void stop() {
+		double duration = getElapsedMicroseconds();
 		double ms = duration * 0.001;
 
 		std::cout << duration << "us (" << ms << "ms)\n";
 	}
 private:
-	std::chrono::time_point<std::chrono::high_resolution_clock> startTimePoint;
-};
\ No newline at end of file
+	std::chrono::time_point<std::chrono::steady_clock> startTimePoint;
+};
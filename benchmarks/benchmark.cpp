@@ -0,0 +1,247 @@
+#include "benchmark.h"
+#include "Timer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <include/nlohmann/json.hpp>
+#include <util/memorytracker.h>
+using json = nlohmann::json;
+
+/**
+* @brief Gets the value at the given percentile of sorted samples (nearest rank).
+* @param samples - Sorted samples.
+* @param percentile - Percentile between 0 and 100.
+* @return Value at the percentile.
+*/
+static double getPercentile(const std::vector<double>& samples, double percentile) {
+	if (samples.empty()) {
+		return 0.0;
+	}
+	size_t rank = (size_t)std::ceil(percentile / 100.0 * samples.size());
+	if (rank > 0) {
+		rank--;
+	}
+	return samples[std::min(rank, samples.size() - 1)];
+}
+
+/**
+* @brief Destructor of the runner. Deletes the registered benchmarks.
+*/
+BenchmarkRunner::~BenchmarkRunner() {
+	for (size_t i = 0; i < benchmarks.size(); i++) {
+		delete benchmarks[i];
+	}
+}
+
+/**
+* @brief Registers a benchmark. The runner takes ownership of the benchmark.
+* @param benchmark - Benchmark to register.
+*/
+void BenchmarkRunner::addBenchmark(Benchmark* benchmark) {
+	benchmarks.push_back(benchmark);
+}
+
+/**
+* @brief Runs every benchmark matching the filter, writes the requested outputs and compares the results against the baseline.
+* @param options - Settings of the run.
+* @return Whether every benchmark could be prepared and the run succeeded without regressions and, in strict frame mode, without allocating frames.
+*/
+bool BenchmarkRunner::run(const BenchmarkOptions& options) {
+	results.clear();
+	bool success = true;
+
+	std::printf("%-32s %8s %12s %12s %12s %12s %12s %12s\n", "benchmark", "reps", "min(us)", "mean(us)", "p50(us)", "p90(us)", "p99(us)", "mem(KiB)");
+	for (size_t i = 0; i < benchmarks.size(); i++) {
+		if (!options.filter.empty() && benchmarks[i]->getName().find(options.filter) == std::string::npos) {
+			continue;
+		}
+
+		BenchmarkResult result = measure(benchmarks[i], options);
+		if (!result.prepared) {
+			// timing an unprepared benchmark would report meaningless numbers
+			std::cerr << result.name << ": could not be prepared\n";
+			success = false;
+			continue;
+		}
+
+		std::printf("%-32s %8zu %12.2f %12.2f %12.2f %12.2f %12.2f %12zu\n", result.name.c_str(), result.repetitions, result.min, result.mean, result.p50, result.p90, result.p99, result.memoryBytes / 1024);
+		results.push_back(result);
+
+		if (result.frameViolations > 0) {
+			std::cerr << result.name << ": " << result.frameViolations << " steady-state frames allocated\n";
+			success = false;
+		}
+	}
+
+	if (!options.csvPath.empty() && !writeCSV(options.csvPath)) {
+		std::cerr << "Could not write csv file " << options.csvPath << "\n";
+		success = false;
+	}
+	if (!options.jsonPath.empty() && !writeJSON(options.jsonPath)) {
+		std::cerr << "Could not write json file " << options.jsonPath << "\n";
+		success = false;
+	}
+	if (!options.baselinePath.empty() && !compareBaseline(options.baselinePath, options.tolerance)) {
+		success = false;
+	}
+	return success;
+}
+
+/**
+* @brief Executes a single benchmark.
+* @param benchmark - Benchmark to execute.
+* @param options - Settings of the run.
+* @return Timing statistics of the benchmark.
+*/
+BenchmarkResult BenchmarkRunner::measure(Benchmark* benchmark, const BenchmarkOptions& options) {
+	Timer timer;
+	std::vector<double> samples;
+	samples.reserve(options.repetitions);
+
+	// only benchmarks running engine frames end memory tracker frames, so the others can not violate the strict mode
+	if (options.strictFrames) {
+		MemoryTracker::setStrictFrameMode(true, options.strictWarmupFrames);
+	}
+
+	BenchmarkResult result;
+	result.name = benchmark->getName();
+	if (!benchmark->prepare()) {
+		benchmark->release();
+		if (options.strictFrames) {
+			MemoryTracker::setStrictFrameMode(false, 0);
+		}
+		result.prepared = false;
+		return result;
+	}
+
+	for (size_t i = 0; i < options.warmup + options.repetitions; i++) {
+		benchmark->setUp();
+		timer.restart();
+		benchmark->run();
+		double elapsed = timer.getElapsedMicroseconds();
+		benchmark->tearDown();
+
+		if (i >= options.warmup) {
+			samples.push_back(elapsed);
+		}
+	}
+
+	result.repetitions = samples.size();
+	result.memoryBytes = benchmark->getMemoryBytes();
+	benchmark->release();
+
+	if (options.strictFrames) {
+		result.frameViolations = MemoryTracker::getFrameViolationCount();
+		MemoryTracker::setStrictFrameMode(false, 0);
+	}
+
+	if (samples.empty()) {
+		return result;
+	}
+
+	std::sort(samples.begin(), samples.end());
+	double sum = 0.0;
+	for (size_t i = 0; i < samples.size(); i++) {
+		sum += samples[i];
+	}
+
+	result.min = samples.front();
+	result.max = samples.back();
+	result.mean = sum / samples.size();
+	result.p50 = getPercentile(samples, 50.0);
+	result.p90 = getPercentile(samples, 90.0);
+	result.p99 = getPercentile(samples, 99.0);
+	return result;
+}
+
+/**
+* @brief Writes the results as csv file.
+* @param path - Output path.
+* @return Whether the file was written.
+*/
+bool BenchmarkRunner::writeCSV(const std::string& path) {
+	std::ofstream file(path);
+	if (!file.is_open()) {
+		return false;
+	}
+
+	file << "name,repetitions,min_us,mean_us,p50_us,p90_us,p99_us,max_us,memory_bytes\n";
+	for (const BenchmarkResult& result : results) {
+		file << result.name << "," << result.repetitions << "," << result.min << "," << result.mean << ","
+			<< result.p50 << "," << result.p90 << "," << result.p99 << "," << result.max << "," << result.memoryBytes << "\n";
+	}
+	return true;
+}
+
+/**
+* @brief Writes the results as json file.
+* @param path - Output path.
+* @return Whether the file was written.
+*/
+bool BenchmarkRunner::writeJSON(const std::string& path) {
+	std::ofstream file(path);
+	if (!file.is_open()) {
+		return false;
+	}
+
+	json output;
+	output["benchmarks"] = json::array();
+	for (const BenchmarkResult& result : results) {
+		output["benchmarks"].push_back({
+			{ "name", result.name },
+			{ "repetitions", result.repetitions },
+			{ "min_us", result.min },
+			{ "mean_us", result.mean },
+			{ "p50_us", result.p50 },
+			{ "p90_us", result.p90 },
+			{ "p99_us", result.p99 },
+			{ "max_us", result.max },
+			{ "memory_bytes", result.memoryBytes }
+		});
+	}
+	file << output.dump(4);
+	return true;
+}
+
+/**
+* @brief Compares the medians of the results against a baseline json file.
+* @param path - Path of the baseline file.
+* @param tolerance - Allowed relative slowdown.
+* @return Whether no benchmark regressed.
+*/
+bool BenchmarkRunner::compareBaseline(const std::string& path, double tolerance) {
+	std::ifstream file(path);
+	if (!file.is_open()) {
+		std::cerr << "Could not open baseline file " << path << "\n";
+		return false;
+	}
+
+	json baseline = json::parse(file, nullptr, false);
+	if (baseline.is_discarded() || !baseline.contains("benchmarks")) {
+		std::cerr << "Invalid baseline file " << path << "\n";
+		return false;
+	}
+
+	bool success = true;
+	std::printf("\n%-32s %12s %12s %9s\n", "baseline", "base p50", "p50", "change");
+	for (const BenchmarkResult& result : results) {
+		for (auto& entry : baseline["benchmarks"]) {
+			if (entry["name"].get<std::string>() != result.name) {
+				continue;
+			}
+
+			double basePercentile = entry["p50_us"].get<double>();
+			double change = (basePercentile > 0.0) ? (result.p50 - basePercentile) / basePercentile : 0.0;
+			bool regressed = change > tolerance;
+
+			std::printf("%-32s %12.2f %12.2f %8.1f%%%s\n", result.name.c_str(), basePercentile, result.p50, change * 100.0, regressed ? "  REGRESSION" : "");
+			if (regressed) {
+				success = false;
+			}
+			break;
+		}
+	}
+	return success;
+}
@@ -0,0 +1,198 @@
+#pragma once
+#include <string>
+#include <vector>
+
+/**
+ * @brief Base class of every benchmark. Only run() is timed, setUp() and tearDown() are executed around each repetition.
+ * prepare() and release() are executed once before the first and after the last repetition.
+*/
+class Benchmark {
+public:
+	/**
+	 * @brief Creates benchmark.
+	 * @param name - Unique name of the benchmark.
+	*/
+	Benchmark(const char* name) : name{ name } {}
+
+	virtual ~Benchmark() {}
+
+	/**
+	 * @brief Prepares the benchmark before the first repetition. Used for data that is too large to keep for the whole run.
+	 * @return Whether the benchmark is ready to run. The benchmark is skipped and the run fails otherwise.
+	*/
+	virtual bool prepare() { return true; }
+
+	/**
+	 * @brief Prepares the next repetition.
+	*/
+	virtual void setUp() {}
+
+	/**
+	 * @brief Executes the measured workload.
+	*/
+	virtual void run() = 0;
+
+	/**
+	 * @brief Cleans up after a repetition.
+	*/
+	virtual void tearDown() {}
+
+	/**
+	 * @brief Releases the data of prepare() after the last repetition.
+	*/
+	virtual void release() {}
+
+	/**
+	 * @brief Gets the memory used by the benchmark workload. Queried after the last repetition.
+	 * @return Used memory in bytes. 0 if the benchmark does not report memory.
+	*/
+	virtual size_t getMemoryBytes() { return 0; }
+
+	/**
+	 * @brief Gets the name of the benchmark.
+	 * @return Name of the benchmark.
+	*/
+	const std::string& getName() { return name; }
+private:
+	/**
+	 * @brief Unique name of the benchmark.
+	*/
+	std::string name;
+};
+
+/**
+ * @brief Timing statistics of a benchmark. All times are in microseconds per repetition.
+*/
+struct BenchmarkResult {
+	std::string name;
+	size_t repetitions = 0;
+	double min = 0.0;
+	double mean = 0.0;
+	double p50 = 0.0;
+	double p90 = 0.0;
+	double p99 = 0.0;
+	double max = 0.0;
+	size_t memoryBytes = 0;
+	size_t frameViolations = 0;
+	bool prepared = true;
+};
+
+/**
+ * @brief Settings of a benchmark run.
+*/
+struct BenchmarkOptions {
+	/**
+	 * @brief Untimed repetitions before measuring.
+	*/
+	size_t warmup = 5;
+
+	/**
+	 * @brief Timed repetitions.
+	*/
+	size_t repetitions = 50;
+
+	/**
+	 * @brief Only benchmarks containing the filter in their name are executed. Empty runs every benchmark.
+	*/
+	std::string filter = "";
+
+	/**
+	 * @brief Output path of the csv results. Empty disables csv output.
+	*/
+	std::string csvPath = "";
+
+	/**
+	 * @brief Output path of the json results. Empty disables json output.
+	*/
+	std::string jsonPath = "";
+
+	/**
+	 * @brief Path of a json result file to compare against. Empty disables the comparison.
+	*/
+	std::string baselinePath = "";
+
+	/**
+	 * @brief Allowed relative slowdown of the median compared to the baseline.
+	*/
+	double tolerance = 0.10;
+
+	/**
+	 * @brief Whether engine frames have to be free of allocations once the warmup frames of a benchmark passed.
+	*/
+	bool strictFrames = false;
+
+	/**
+	 * @brief Engine frames of each benchmark that may allocate before the strict frame check starts.
+	*/
+	size_t strictWarmupFrames = 0;
+};
+
+/**
+ * @brief Executes the registered benchmarks and reports the results.
+*/
+class BenchmarkRunner {
+public:
+	/**
+	 * @brief Destructor of the runner. Deletes the registered benchmarks.
+	*/
+	~BenchmarkRunner();
+
+	/**
+	 * @brief Registers a benchmark. The runner takes ownership of the benchmark.
+	 * @param benchmark - Benchmark to register.
+	*/
+	void addBenchmark(Benchmark* benchmark);
+
+	/**
+	 * @brief Runs every benchmark matching the filter, writes the requested outputs and compares the results against the baseline.
+	 * @param options - Settings of the run.
+	 * @return Whether every benchmark could be prepared and the run succeeded without regressions and, in strict frame mode, without allocating frames.
+	*/
+	bool run(const BenchmarkOptions& options);
+
+	/**
+	 * @brief Gets the results of the last run.
+	 * @return Results of the last run.
+	*/
+	const std::vector<BenchmarkResult>& getResults() { return results; }
+private:
+	/**
+	 * @brief Registered benchmarks.
+	*/
+	std::vector<Benchmark*> benchmarks;
+
+	/**
+	 * @brief Results of the last run.
+	*/
+	std::vector<BenchmarkResult> results;
+
+	/**
+	 * @brief Executes a single benchmark.
+	 * @param benchmark - Benchmark to execute.
+	 * @param options - Settings of the run.
+	 * @return Timing statistics of the benchmark.
+	*/
+	BenchmarkResult measure(Benchmark* benchmark, const BenchmarkOptions& options);
+
+	/**
+	 * @brief Writes the results as csv file.
+	 * @param path - Output path.
+	 * @return Whether the file was written.
+	*/
+	bool writeCSV(const std::string& path);
+
+	/**
+	 * @brief Writes the results as json file.
+	 * @param path - Output path.
+	 * @return Whether the file was written.
+	*/
+	bool writeJSON(const std::string& path);
+
+	/**
+	 * @brief Compares the medians of the results against a baseline json file.
+	 * @param path - Path of the baseline file.
+	 * @param tolerance - Allowed relative slowdown.
+	 * @return Whether no benchmark regressed.
+	*/
+	bool compareBaseline(const std::string& path, double tolerance);
+};
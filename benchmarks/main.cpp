@@ -1,136 +1,81 @@
-#include "Timer.h"
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
-#include <gameengine.h>
-#include <Windows.h>
-#include <stdio.h>
-#include <psapi.h>
+#include "SDL.h"
+#include "benchmark.h"
+#include "microbenchmarks.h"
+#include "stressbenchmarks.h"
+
+/**
+* @brief Prints the command line usage.
+*/
+static void printUsage() {
+	std::cout << "Usage: benchmarks [options]\n"
+		<< "  --filter <text>      Only run benchmarks containing text in their name.\n"
+		<< "  --warmup <n>         Untimed repetitions per benchmark (default 5).\n"
+		<< "  --reps <n>           Timed repetitions per benchmark (default 50).\n"
+		<< "  --csv <path>         Write results as csv.\n"
+		<< "  --json <path>        Write results as json. The file can be used as baseline.\n"
+		<< "  --baseline <path>    Compare against a json baseline and fail on regressions.\n"
+		<< "  --tolerance <ratio>  Allowed slowdown of the median against the baseline (default 0.10).\n"
+		<< "  --stress <n>         Also run headless frames of generated scenes with 100 up to n enemies (at most 100000).\n"
+		<< "  --strict-frames <n>  Fail if an engine frame allocates after the first n frames of a benchmark.\n";
+}
 
+int main(int argc, char* argv[]) {
+	BenchmarkOptions options;
+	size_t stressEnemies = 0;
 
-class Benchmarks {
-public:
-	static void testObjectPools(size_t iterations) {
-		Entity arr[100];
-		GameEngine* gameEngine = new GameEngine();
-		Timer* a = new Timer();
-
-		gameEngine->init(60, "Benchmark", 1280, 720, 1280, 720, "../demo/assets/DemoGame/icon.png", false);
-
-		for (size_t n = 0; n < iterations; n++)
-		{
-			// create
-			for (size_t i = 0; i < 100; i++)
-			{
-				arr[i] = gameEngine->createProjectile("../demo/assets/DemoGame/sprites/proj.png", { 6,6 }, 2.0f, { 0, 0 }, { 1,1 }, 5.0f, true);
-			}
-
-			// destroy
-			for (size_t i = 0; i < 100; i++) {
-				gameEngine->destroyProjectile(arr[i]);
-			}
+	for (int i = 1; i < argc; i++) {
+		bool hasValue = i + 1 < argc;
+		if (std::strcmp(argv[i], "--filter") == 0 && hasValue) {
+			options.filter = argv[++i];
 		}
-		a->stop();
-	}
-
-	static void testManualCreation(size_t iterations) {
-		Entity arr[100];
-		GameEngine* gameEngine = new GameEngine();
-		gameEngine->debugDisableObjectPools();
-		Timer* a = new Timer();
-
-		gameEngine->init(60, "Benchmark", 1280, 720, 1280, 720, "../demo/assets/DemoGame/icon.png", false);
-
-		for (size_t n = 0; n < iterations; n++)
-		{
-			// create
-			for (size_t i = 0; i < 100; i++)
-			{
-				arr[i] = gameEngine->addEntity("projectile", false, { 0, 0 });
-				gameEngine->addSpriteComponent(arr[i], "../demo/assets/DemoGame/sprites/proj.png", { 6,6 }, 2.0f);
-				Collider* projCollider = gameEngine->addColliderComponent(arr[i], { 0,0 }, { 12,12 }, true);
-				gameEngine->addProjectileMovementComponent(arr[i], { 0,0 }, { 1, 1 }, 5.0f, true);
-			}
-
-			// destroy
-			for (size_t i = 0; i < 100; i++) {
-				gameEngine->destroyEntity(arr[i]);
-			}
+		else if (std::strcmp(argv[i], "--warmup") == 0 && hasValue) {
+			options.warmup = std::strtoul(argv[++i], nullptr, 10);
 		}
-		a->stop();
-	}
-
-	static void checkMaxComponentCount(size_t count) {
-		GameEngine* gameEngine = new GameEngine();
-		gameEngine->debugDisableObjectPools();
-		gameEngine->init(60, "Benchmark", 1280, 720, 1280, 720, "../demo/assets/DemoGame/icon.png", false);
-
-		for (size_t i = 0; i < count; i++)
-		{
-			// check component manager with positions
-			gameEngine->addEntity("benchmark", false, { 0,0 });
-
-
+		else if (std::strcmp(argv[i], "--reps") == 0 && hasValue) {
+			options.repetitions = std::strtoul(argv[++i], nullptr, 10);
 		}
-	}
-
-	static void checkComponentMemory() {
-		int div = 1048576;
-
-		PROCESS_MEMORY_COUNTERS pmc;
-		uint64_t usedRAMPostInit(0);
-		uint64_t singleCreationRAM(0);
-		uint64_t currentUsedRAM(0);
-
-
-		GameEngine* gameEngine = new GameEngine();
-		gameEngine->debugDisableObjectPools();
-		gameEngine->init(60, "Benchmark", 1280, 720, 1280, 720, "../demo/assets/DemoGame/icon.png", false);
-
-		BOOL result = GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc));
-		usedRAMPostInit = pmc.WorkingSetSize;
-
-		std::cout << "After init: " <<usedRAMPostInit <<  "Byte ("<< usedRAMPostInit / div <<"MB)" << "\n";
-
-
-		for (size_t i = 0; i < 1; i++)
-		{
-			// check component manager with positions
-			gameEngine->addEntity("benchmark", false, { 0,0 });
-
-
+		else if (std::strcmp(argv[i], "--csv") == 0 && hasValue) {
+			options.csvPath = argv[++i];
 		}
-
-		result = GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc));
-		singleCreationRAM = pmc.WorkingSetSize - usedRAMPostInit;
-		std::cout << "One Entity + component: " << singleCreationRAM << "Byte ("<< singleCreationRAM/div <<"MB)" << "\n";
-
-		for (size_t i = 0; i < 999; i++)
-		{
-			// check component manager with positions
-			gameEngine->addEntity("benchmark", false, { 0,0 });
+		else if (std::strcmp(argv[i], "--json") == 0 && hasValue) {
+			options.jsonPath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--baseline") == 0 && hasValue) {
+			options.baselinePath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--tolerance") == 0 && hasValue) {
+			options.tolerance = std::strtod(argv[++i], nullptr);
+		}
+		else if (std::strcmp(argv[i], "--stress") == 0 && hasValue) {
+			stressEnemies = std::strtoul(argv[++i], nullptr, 10);
+		}
+		else if (std::strcmp(argv[i], "--strict-frames") == 0 && hasValue) {
+			options.strictFrames = true;
+			options.strictWarmupFrames = std::strtoul(argv[++i], nullptr, 10);
+		}
+		else {
+			printUsage();
+			return (std::strcmp(argv[i], "--help") == 0) ? 0 : 1;
 		}
-
-		result = GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc));
-		currentUsedRAM = pmc.WorkingSetSize - usedRAMPostInit;
-		std::cout << "100 Entity + component: " << currentUsedRAM << "Byte (" << currentUsedRAM / div << "MB)" << "\n";
-		std::cout << currentUsedRAM / singleCreationRAM << "\n";
 	}
 
-};
-
-int main(int argc, char* argv[]) {
-	int n = 7500;
+	// the benchmarks only use software rendering, no window or audio device is needed. The stress scenes run the engine in headless mode.
+	if (SDL_Init(SDL_INIT_TIMER) != 0) {
+		std::cerr << "Could not initialize SDL: " << SDL_GetError() << "\n";
+		return 1;
+	}
 
-	/*
-	std::cout << "n = " << n << "\n";
-	std::cout << "+++++++++++++++++++++++++ Object Pools++++++++++++++++++++++++++++\n";
-	Benchmarks::testObjectPools(n);
-	std::cout << "++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n";
-	std::cout << "+++++++++++++++++++++++++ Manual +++++++++++++++++++++++++++++++++\n";
-	Benchmarks::testManualCreation(n);
-	std::cout << "++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n";
+	bool success;
+	{
+		BenchmarkRunner runner;
+		registerMicrobenchmarks(&runner);
+		registerStressBenchmarks(&runner, stressEnemies);
+		success = runner.run(options);
+	}
 
-	Benchmarks::checkMaxComponentCount(1024);
-	 */
-	Benchmarks::checkComponentMemory();
-	return 0;
-}
\ No newline at end of file
+	SDL_Quit();
+	return success ? 0 : 1;
+}
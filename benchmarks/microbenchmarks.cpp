@@ -0,0 +1,976 @@
+#include "microbenchmarks.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <componentmanager.h>
+#include <entitymanager.h>
+#include <inputmanager.h>
+#include <stressscene.h>
+#include <uimanager.h>
+#include <systems/physicsystem.h>
+#include <systems/rendersystem.h>
+#include <util/fileloader.h>
+#include <util/navigation/flowfield.h>
+#include <util/navigation/crowdavoidance.h>
+#include <util/navigation/hierarchicalgrid.h>
+#include <util/navigation/incrementalplanner.h>
+
+/**
+ * @brief Maximum number of components of a component manager.
+*/
+static const size_t COMPONENT_COUNT = 1024;
+
+/**
+ * @brief Seed of every random generator, so each run works on the same data.
+*/
+static const unsigned int SEED = 1337;
+
+/**
+ * @brief Scratch files generated for the tilemap benchmarks.
+*/
+static const char* PARSE_TILEMAP_PATH = "benchmark_parse_tilemap.json";
+static const char* RENDER_TILEMAP_PATH = "benchmark_render_tilemap.json";
+static const char* RENDER_TILESET_PATH = "benchmark_render_tileset.bmp";
+
+/**
+ * @brief Prevents the compiler from optimizing away measured reads.
+*/
+static volatile float sink = 0.0f;
+
+/**
+* @brief Creates an entity with a given uid.
+* @param uid - Uid of the entity.
+* @return Created entity.
+*/
+static Entity makeEntity(unsigned int uid) {
+	Entity e;
+	e.uid = uid;
+	return e;
+}
+
+#pragma region ComponentManager
+/**
+ * @brief Adds a position component to every entity of an empty component manager.
+*/
+class ComponentAddBenchmark : public Benchmark {
+public:
+	ComponentAddBenchmark() : Benchmark("component_add") {}
+
+	void setUp() {
+		manager = new ComponentManager<Position>();
+	}
+
+	void run() {
+		for (unsigned int i = 0; i < COMPONENT_COUNT; i++) {
+			Entity e = makeEntity(i + 1);
+			manager->addComponent(e)->setEntity(e);
+		}
+	}
+
+	void tearDown() {
+		delete manager;
+	}
+private:
+	ComponentManager<Position>* manager = nullptr;
+};
+
+/**
+ * @brief Looks up the position component of every entity of a full component manager.
+*/
+class ComponentGetBenchmark : public Benchmark {
+public:
+	ComponentGetBenchmark() : Benchmark("component_get") {
+		for (unsigned int i = 0; i < COMPONENT_COUNT; i++) {
+			Entity e = makeEntity(i + 1);
+			manager.addComponent(e)->setPosition((float)i, (float)i);
+		}
+	}
+
+	void run() {
+		float sum = 0.0f;
+		for (unsigned int i = 0; i < COMPONENT_COUNT; i++) {
+			sum += manager.getComponent(makeEntity(i + 1))->x();
+		}
+		sink = sum;
+	}
+private:
+	ComponentManager<Position> manager;
+};
+
+/**
+ * @brief Removes every component of a full component manager in random order.
+*/
+class ComponentRemoveBenchmark : public Benchmark {
+public:
+	ComponentRemoveBenchmark() : Benchmark("component_remove") {
+		for (unsigned int i = 0; i < COMPONENT_COUNT; i++) {
+			order.push_back(i + 1);
+		}
+		std::shuffle(order.begin(), order.end(), std::mt19937(SEED));
+	}
+
+	void setUp() {
+		manager = new ComponentManager<Position>();
+		for (unsigned int i = 0; i < COMPONENT_COUNT; i++) {
+			Entity e = makeEntity(i + 1);
+			manager->addComponent(e)->setEntity(e);
+		}
+	}
+
+	void run() {
+		for (size_t i = 0; i < order.size(); i++) {
+			manager->removeComponent(makeEntity(order[i]));
+		}
+	}
+
+	void tearDown() {
+		delete manager;
+	}
+private:
+	ComponentManager<Position>* manager = nullptr;
+	std::vector<unsigned int> order;
+};
+
+/**
+ * @brief Creates and destroys entities with a position component, like spawning and despawning during gameplay.
+*/
+class EntityChurnBenchmark : public Benchmark {
+public:
+	EntityChurnBenchmark() : Benchmark("entity_churn") {}
+
+	void run() {
+		for (size_t round = 0; round < CHURN_ROUNDS; round++) {
+			for (size_t i = 0; i < CHURN_BATCH; i++) {
+				entities[i] = entityManager.createEntity("churn", false);
+				positionManager.addComponent(entities[i])->setEntity(entities[i]);
+			}
+			for (size_t i = 0; i < CHURN_BATCH; i++) {
+				positionManager.removeComponent(entities[i]);
+				entityManager.destroyEntity(entities[i]);
+			}
+		}
+	}
+private:
+	static const size_t CHURN_ROUNDS = 4;
+	static const size_t CHURN_BATCH = 256;
+	EntityManager entityManager;
+	ComponentManager<Position> positionManager;
+	Entity entities[CHURN_BATCH];
+};
+#pragma endregion ComponentManager
+
+#pragma region Systems
+/**
+ * @brief Engine systems with a software renderer and no window. Shared by the system benchmarks.
+*/
+class SystemFixture {
+public:
+	SystemFixture() {
+		surface = SDL_CreateRGBSurfaceWithFormat(0, WINDOW_WIDTH, WINDOW_HEIGHT, 32, SDL_PIXELFORMAT_RGBA8888);
+		renderer = SDL_CreateSoftwareRenderer(surface);
+
+		inputManager = new InputManager();
+		uiManager = new UIManager(renderer, inputManager);
+		playerMovement = new Movement();
+
+		renderSystem = new RenderSystem(16, &spriteManager, &positionManager, renderer, &animatorManager, uiManager, &colliderManager, &enemyMovementManager);
+		renderSystem->initCamera(WINDOW_WIDTH, WINDOW_HEIGHT, WINDOW_WIDTH, WINDOW_HEIGHT);
+
+		physicSystem = new PhysicSystem(inputManager, playerMovement, &positionManager, &spriteManager, &animatorManager, &colliderManager, &projectileMovementManager, &enemyMovementManager);
+
+		spriteTexture.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STATIC, 16, 16);
+		spriteTexture.textureWidth = 16;
+		spriteTexture.textureHeight = 16;
+	}
+
+	~SystemFixture() {
+		delete physicSystem;
+		delete renderSystem;
+		delete playerMovement;
+		delete uiManager;
+		delete inputManager;
+		SDL_DestroyTexture(spriteTexture.texture);
+		SDL_DestroyRenderer(renderer);
+		SDL_FreeSurface(surface);
+	}
+
+	/**
+	 * @brief Adds an entity with a position component.
+	 * @param x - X position.
+	 * @param y - Y position.
+	 * @return Created entity.
+	*/
+	Entity addEntity(int x, int y) {
+		Entity e = makeEntity(nextUid++);
+		Position* position = positionManager.addComponent(e);
+		position->setEntity(e);
+		position->setPosition((float)x, (float)y);
+		return e;
+	}
+
+	/**
+	 * @brief Adds a sprite component using the shared sprite texture.
+	 * @param e - Entity to add the sprite to.
+	*/
+	void addSprite(Entity e) {
+		Sprite* sprite = spriteManager.addComponent(e);
+		sprite->setEntity(e);
+		sprite->init("", 16, 16, 1.0f);
+		sprite->setTexture(spriteTexture);
+		sprite->setActive(true);
+	}
+
+	/**
+	 * @brief Adds a collider component.
+	 * @param e - Entity to add the collider to.
+	 * @param size - Size of the collider.
+	 * @param isTrigger - Whether the collider is a trigger.
+	*/
+	void addCollider(Entity e, int size, bool isTrigger) {
+		Position* position = positionManager.getComponent(e);
+		Collider* collider = colliderManager.addComponent(e);
+		collider->setEntity(e);
+		collider->init(position->x(), position->y(), 0, 0, size, size, isTrigger);
+		collider->setActive(true);
+	}
+
+	/**
+	 * @brief Adds the player with position, sprite, animator, collider and movement.
+	 * @param x - X position.
+	 * @param y - Y position.
+	*/
+	void addPlayer(int x, int y) {
+		Entity e = addEntity(x, y);
+		addSprite(e);
+		Animator* animator = animatorManager.addComponent(e);
+		animator->setEntity(e);
+		animator->addAnimation(STATES::IDLE_SIDE, 1, 100, spriteTexture);
+		addCollider(e, 16, false);
+		playerMovement->setEntity(e);
+	}
+
+	static const int WINDOW_WIDTH = 1280;
+	static const int WINDOW_HEIGHT = 720;
+
+	SDL_Surface* surface = nullptr;
+	SDL_Renderer* renderer = nullptr;
+	InputManager* inputManager = nullptr;
+	UIManager* uiManager = nullptr;
+	Movement* playerMovement = nullptr;
+	RenderSystem* renderSystem = nullptr;
+	PhysicSystem* physicSystem = nullptr;
+	Texture spriteTexture;
+
+	ComponentManager<Position> positionManager;
+	ComponentManager<Sprite> spriteManager;
+	ComponentManager<Animator> animatorManager;
+	ComponentManager<Collider> colliderManager;
+	ComponentManager<ProjectileMovement> projectileMovementManager;
+	ComponentManager<EnemyMovement> enemyMovementManager;
+private:
+	unsigned int nextUid = 1;
+};
+
+/**
+ * @brief Depth sorts every sprite position before rendering.
+*/
+class SpriteSortBenchmark : public Benchmark {
+public:
+	SpriteSortBenchmark() : Benchmark("sprite_sort") {
+		std::mt19937 random(SEED);
+		std::uniform_int_distribution<int> x(0, SystemFixture::WINDOW_WIDTH);
+		std::uniform_int_distribution<int> y(0, SystemFixture::WINDOW_HEIGHT);
+
+		for (size_t i = 0; i < COMPONENT_COUNT; i++) {
+			fixture.addSprite(fixture.addEntity(x(random), y(random)));
+		}
+	}
+
+	void run() {
+		fixture.renderSystem->sortSprites();
+	}
+private:
+	SystemFixture fixture;
+};
+
+/**
+ * @brief Physic system step with the player and projectiles tested against static colliders.
+*/
+class CollisionBenchmark : public Benchmark {
+public:
+	CollisionBenchmark() : Benchmark("physics_collision") {
+		std::mt19937 random(SEED);
+		std::uniform_int_distribution<int> x(0, SystemFixture::WINDOW_WIDTH);
+		std::uniform_int_distribution<int> y(0, SystemFixture::WINDOW_HEIGHT);
+
+		fixture.addPlayer(SystemFixture::WINDOW_WIDTH / 2, SystemFixture::WINDOW_HEIGHT / 2);
+		for (size_t i = 0; i < STATIC_COLLIDERS; i++) {
+			fixture.addCollider(fixture.addEntity(x(random), y(random)), 32, false);
+		}
+		for (size_t i = 0; i < PROJECTILES; i++) {
+			Entity e = fixture.addEntity(x(random), y(random));
+			fixture.addCollider(e, 12, true);
+			ProjectileMovement* projectile = fixture.projectileMovementManager.addComponent(e);
+			projectile->setEntity(e);
+			projectile->setActive(true);
+			// stationary projectiles keep the workload identical between repetitions
+			projectile->init(0.0, 0.0f);
+		}
+	}
+
+	void run() {
+		fixture.physicSystem->update();
+	}
+private:
+	static const size_t STATIC_COLLIDERS = 511;
+	static const size_t PROJECTILES = 256;
+	SystemFixture fixture;
+};
+
+/**
+ * @brief Path queries between random positions on an open grid.
+*/
+class AStarBenchmark : public Benchmark {
+public:
+	AStarBenchmark() : Benchmark("astar_64x64") {
+		fixture.physicSystem->initGrid(GRID_SIZE, GRID_SIZE, { TILE_SIZE, TILE_SIZE }, GRID_SIZE);
+		// the same queries are repeated, the search itself is measured
+		fixture.physicSystem->setPathCacheCapacity(0);
+
+		std::mt19937 random(SEED);
+		std::uniform_int_distribution<int> position(0, GRID_SIZE * TILE_SIZE - 1);
+		for (size_t i = 0; i < QUERIES; i++) {
+			starts[i] = { position(random), position(random) };
+			destinations[i] = { position(random), position(random) };
+		}
+	}
+
+	void run() {
+		size_t length = 0;
+		for (size_t i = 0; i < QUERIES; i++) {
+			fixture.physicSystem->findPath(makeEntity(0), starts[i], destinations[i], path);
+			length += path.size();
+		}
+		sink = (float)length;
+	}
+private:
+	static const int GRID_SIZE = 64;
+	static const int TILE_SIZE = 16;
+	static const size_t QUERIES = 16;
+	SystemFixture fixture;
+	SDL_Point starts[QUERIES];
+	SDL_Point destinations[QUERIES];
+	std::vector<NodeIndex> path;
+};
+
+/**
+ * @brief Short path queries on a large grid. The cost should depend on the explored nodes, not on the size of the grid.
+*/
+class AStarLocalBenchmark : public Benchmark {
+public:
+	AStarLocalBenchmark() : Benchmark("astar_local_256x256") {
+		fixture.physicSystem->initGrid(GRID_SIZE, GRID_SIZE, { TILE_SIZE, TILE_SIZE }, GRID_SIZE);
+		// the same queries are repeated, the search itself is measured
+		fixture.physicSystem->setPathCacheCapacity(0);
+
+		std::mt19937 random(SEED);
+		std::uniform_int_distribution<int> position(RANGE * TILE_SIZE, (GRID_SIZE - RANGE) * TILE_SIZE - 1);
+		std::uniform_int_distribution<int> offset(-RANGE * TILE_SIZE, RANGE * TILE_SIZE);
+		for (size_t i = 0; i < QUERIES; i++) {
+			starts[i] = { position(random), position(random) };
+			destinations[i] = { starts[i].x + offset(random), starts[i].y + offset(random) };
+		}
+	}
+
+	void run() {
+		size_t length = 0;
+		for (size_t i = 0; i < QUERIES; i++) {
+			fixture.physicSystem->findPath(makeEntity(0), starts[i], destinations[i], path);
+			length += path.size();
+		}
+		sink = (float)length;
+	}
+private:
+	static const int GRID_SIZE = 256;
+	static const int TILE_SIZE = 16;
+	static const int RANGE = 8;
+	static const size_t QUERIES = 64;
+	SystemFixture fixture;
+	SDL_Point starts[QUERIES];
+	SDL_Point destinations[QUERIES];
+	std::vector<NodeIndex> path;
+};
+
+/**
+ * @brief Path queries between random positions on a grid with many static colliders. The colliders occupy the grid once instead of being marked before every query.
+*/
+class AStarCollidersBenchmark : public Benchmark {
+public:
+	AStarCollidersBenchmark() : Benchmark("astar_colliders_64x64") {
+		fixture.physicSystem->initGrid(GRID_SIZE, GRID_SIZE, { TILE_SIZE, TILE_SIZE }, GRID_SIZE);
+		// the same queries are repeated, the search itself is measured
+		fixture.physicSystem->setPathCacheCapacity(0);
+
+		std::mt19937 random(SEED);
+		std::uniform_int_distribution<int> tile(0, GRID_SIZE - 1);
+		for (size_t i = 0; i < COLLIDERS; i++) {
+			Entity e = fixture.addEntity(tile(random) * TILE_SIZE + TILE_SIZE / 2, tile(random) * TILE_SIZE + TILE_SIZE / 2);
+			fixture.addCollider(e, TILE_SIZE, false);
+		}
+		fixture.physicSystem->updateOccupancy();
+
+		std::uniform_int_distribution<int> position(0, GRID_SIZE * TILE_SIZE - 1);
+		for (size_t i = 0; i < QUERIES; i++) {
+			starts[i] = { position(random), position(random) };
+			destinations[i] = { position(random), position(random) };
+		}
+	}
+
+	void run() {
+		size_t length = 0;
+		for (size_t i = 0; i < QUERIES; i++) {
+			fixture.physicSystem->findPath(makeEntity(0), starts[i], destinations[i], path);
+			length += path.size();
+		}
+		sink = (float)length;
+	}
+private:
+	static const int GRID_SIZE = 64;
+	static const int TILE_SIZE = 16;
+	static const size_t COLLIDERS = 1024;
+	static const size_t QUERIES = 16;
+	SystemFixture fixture;
+	SDL_Point starts[QUERIES];
+	SDL_Point destinations[QUERIES];
+	std::vector<NodeIndex> path;
+};
+
+/**
+ * @brief Agents walking to the same target and searching their path again every few nodes, with or without the path cache.
+*/
+class PathReplanBenchmark : public Benchmark {
+public:
+	/**
+	 * @brief Creates the benchmark.
+	 * @param cached - Whether the path cache is used.
+	*/
+	PathReplanBenchmark(bool cached) : Benchmark(cached ? "path_replan_cache_64x64" : "path_replan_nocache_64x64") {
+		fixture.physicSystem->initGrid(GRID_SIZE, GRID_SIZE, { TILE_SIZE, TILE_SIZE }, GRID_SIZE);
+		fixture.physicSystem->setPathCacheCapacity(cached ? PathCache::DEFAULT_CAPACITY : 0);
+
+		std::mt19937 random(SEED);
+		std::uniform_int_distribution<int> tile(0, GRID_SIZE - 1);
+		for (size_t i = 0; i < COLLIDERS; i++) {
+			Entity e = fixture.addEntity(tile(random) * TILE_SIZE + TILE_SIZE / 2, tile(random) * TILE_SIZE + TILE_SIZE / 2);
+			fixture.addCollider(e, TILE_SIZE, false);
+		}
+		fixture.physicSystem->updateOccupancy();
+
+		std::uniform_int_distribution<int> position(0, GRID_SIZE * TILE_SIZE - 1);
+		target = { GRID_SIZE * TILE_SIZE / 2, GRID_SIZE * TILE_SIZE / 2 };
+		for (size_t i = 0; i < AGENTS; i++) {
+			agents[i] = { position(random), position(random) };
+		}
+	}
+
+	void run() {
+		fixture.physicSystem->getPathCache()->clear();
+
+		size_t length = 0;
+		for (size_t i = 0; i < AGENTS; i++) {
+			SDL_Point start = agents[i];
+			while (fixture.physicSystem->findPath(makeEntity(0), start, target, path) && path.size() > REPLAN_NODES) {
+				length += path.size();
+
+				// walk a few nodes along the path before searching again
+				NodeIndex next = path[path.size() - 1 - REPLAN_NODES];
+				start = { (next % GRID_SIZE) * TILE_SIZE + TILE_SIZE / 2, (next / GRID_SIZE) * TILE_SIZE + TILE_SIZE / 2 };
+			}
+		}
+		sink = (float)length;
+	}
+private:
+	static const int GRID_SIZE = 64;
+	static const int TILE_SIZE = 16;
+	static const size_t COLLIDERS = 512;
+	static const size_t AGENTS = 32;
+	static const size_t REPLAN_NODES = 4;
+	SystemFixture fixture;
+	SDL_Point target;
+	SDL_Point agents[AGENTS];
+	std::vector<NodeIndex> path;
+};
+
+/**
+ * @brief Path queries from random positions to a target on an island walled off by static colliders. No query can succeed.
+*/
+class UnreachableBenchmark : public Benchmark {
+public:
+	UnreachableBenchmark() : Benchmark("path_unreachable_64x64") {
+		fixture.physicSystem->initGrid(GRID_SIZE, GRID_SIZE, { TILE_SIZE, TILE_SIZE }, GRID_SIZE);
+
+		// wall around the center of the map
+		for (int i = WALL_MIN; i <= WALL_MAX; i++) {
+			addWall(i, WALL_MIN);
+			addWall(i, WALL_MAX);
+			if (i != WALL_MIN && i != WALL_MAX) {
+				addWall(WALL_MIN, i);
+				addWall(WALL_MAX, i);
+			}
+		}
+		fixture.physicSystem->updateOccupancy();
+
+		std::mt19937 random(SEED);
+		std::uniform_int_distribution<int> edge(0, WALL_MIN - 1);
+		target = { GRID_SIZE * TILE_SIZE / 2, GRID_SIZE * TILE_SIZE / 2 };
+		for (size_t i = 0; i < QUERIES; i++) {
+			starts[i] = { edge(random) * TILE_SIZE + TILE_SIZE / 2, edge(random) * TILE_SIZE + TILE_SIZE / 2 };
+		}
+	}
+
+	void run() {
+		size_t found = 0;
+		for (size_t i = 0; i < QUERIES; i++) {
+			found += fixture.physicSystem->findPath(makeEntity(0), starts[i], target, path);
+		}
+		sink = (float)found;
+	}
+private:
+	static const int GRID_SIZE = 64;
+	static const int TILE_SIZE = 16;
+	static const int WALL_MIN = 24;
+	static const int WALL_MAX = 39;
+	static const size_t QUERIES = 16;
+	SystemFixture fixture;
+	SDL_Point target;
+	SDL_Point starts[QUERIES];
+	std::vector<NodeIndex> path;
+
+	/**
+	 * @brief Adds a static collider covering a tile.
+	 * @param x - X-position of the tile.
+	 * @param y - Y-position of the tile.
+	*/
+	void addWall(int x, int y) {
+		Entity e = fixture.addEntity(x * TILE_SIZE + TILE_SIZE / 2, y * TILE_SIZE + TILE_SIZE / 2);
+		fixture.addCollider(e, TILE_SIZE, false);
+	}
+};
+
+/**
+ * @brief Many agents routing to the same target on a grid with blocked tiles, either with one a* search per agent or with one shared flow field.
+*/
+class HordeBenchmark : public Benchmark {
+public:
+	/**
+	 * @brief Creates the benchmark.
+	 * @param flowField - Whether the agents follow a shared flow field instead of searching their own path.
+	*/
+	HordeBenchmark(bool flowField) : Benchmark(flowField ? "horde_flowfield_128x128" : "horde_astar_128x128"), flowField{ flowField } {
+		grid.init(GRID_SIZE, GRID_SIZE);
+
+		std::mt19937 random(SEED);
+		std::uniform_int_distribution<int> position(0, GRID_SIZE - 1);
+		target = grid.getIndex(GRID_SIZE / 2, GRID_SIZE / 2);
+		for (size_t i = 0; i < BLOCKED_TILES; i++) {
+			NodeIndex node = grid.getIndex(position(random), position(random));
+			if (node != target) {
+				grid.setCost(node, 0);
+			}
+		}
+		for (size_t i = 0; i < AGENTS; i++) {
+			agents[i] = grid.getIndex(position(random), position(random));
+		}
+	}
+
+	void run() {
+		size_t length = 0;
+		if (flowField) {
+			field.build(grid, target);
+		}
+		for (size_t i = 0; i < AGENTS; i++) {
+			if (flowField) {
+				field.tracePath(grid, agents[i], path);
+			}
+			else {
+				grid.findPath(agents[i], target, path);
+			}
+			length += path.size();
+		}
+		sink = (float)length;
+	}
+private:
+	static const int GRID_SIZE = 128;
+	static const size_t BLOCKED_TILES = GRID_SIZE * GRID_SIZE / 10;
+	static const size_t AGENTS = 256;
+	bool flowField;
+	NavGrid grid;
+	FlowField field;
+	NodeIndex target;
+	NodeIndex agents[AGENTS];
+	std::vector<NodeIndex> path;
+};
+
+/**
+ * @brief Path queries between random free tiles of an open map with scattered blocked tiles or of a maze, for each search algorithm of the navigation grid.
+*/
+class PathfindingBenchmark : public Benchmark {
+public:
+	/**
+	 * @brief Creates the benchmark.
+	 * @param name - Name of the benchmark.
+	 * @param algorithm - Search algorithm.
+	 * @param maze - Whether the map is a maze instead of an open map.
+	*/
+	PathfindingBenchmark(const char* name, PATHFINDING_ALGORITHMS algorithm, bool maze) : Benchmark(name), algorithm{ algorithm } {
+		grid.init(GRID_SIZE, GRID_SIZE);
+		std::mt19937 random(SEED);
+		if (maze) {
+			this->generateMaze(random);
+		}
+		else {
+			std::uniform_int_distribution<int> position(0, GRID_SIZE - 1);
+			for (size_t i = 0; i < GRID_SIZE * GRID_SIZE / 20; i++) {
+				grid.setCost(grid.getIndex(position(random), position(random)), 0);
+			}
+		}
+		grid.buildJumpTable();
+
+		std::uniform_int_distribution<int> node(0, GRID_SIZE * GRID_SIZE - 1);
+		for (size_t i = 0; i < QUERIES; i++) {
+			do { starts[i] = node(random); } while (grid.getCost(starts[i]) == 0);
+			do { destinations[i] = node(random); } while (grid.getCost(destinations[i]) == 0);
+		}
+	}
+
+	void run() {
+		size_t length = 0;
+		for (size_t i = 0; i < QUERIES; i++) {
+			switch (algorithm) {
+			case PATHFINDING_JPS:
+				grid.findPathJps(starts[i], destinations[i], path);
+				break;
+			case PATHFINDING_JPS_PLUS:
+				grid.findPathJpsPlus(starts[i], destinations[i], path);
+				break;
+			default:
+				grid.findPath(starts[i], destinations[i], path);
+				break;
+			}
+			length += path.size();
+		}
+		sink = (float)length;
+	}
+private:
+	static const int GRID_SIZE = 128;
+	static const size_t QUERIES = 16;
+	PATHFINDING_ALGORITHMS algorithm;
+	NavGrid grid;
+	NodeIndex starts[QUERIES];
+	NodeIndex destinations[QUERIES];
+	std::vector<NodeIndex> path;
+
+	/**
+	 * @brief Carves a maze with corridors of one tile into the blocked grid (randomized depth first search).
+	 * @param random - Random generator.
+	*/
+	void generateMaze(std::mt19937& random) {
+		for (size_t i = 0; i < grid.getNodeCount(); i++) {
+			grid.setCost((NodeIndex)i, 0);
+		}
+
+		static const int CELL_X[4] = { 2, -2, 0, 0 };
+		static const int CELL_Y[4] = { 0, 0, 2, -2 };
+		std::vector<SDL_Point> stack;
+		stack.push_back({ 1, 1 });
+		grid.setCost(grid.getIndex(1, 1), 1);
+
+		while (!stack.empty()) {
+			SDL_Point cell = stack.back();
+			int order[4] = { 0, 1, 2, 3 };
+			std::shuffle(order, order + 4, random);
+
+			bool carved = false;
+			for (int i = 0; i < 4 && !carved; i++) {
+				int x = cell.x + CELL_X[order[i]];
+				int y = cell.y + CELL_Y[order[i]];
+				if (x < 1 || y < 1 || x >= GRID_SIZE - 1 || y >= GRID_SIZE - 1 || grid.getCost(grid.getIndex(x, y)) != 0) continue;
+
+				grid.setCost(grid.getIndex((cell.x + x) / 2, (cell.y + y) / 2), 1);
+				grid.setCost(grid.getIndex(x, y), 1);
+				stack.push_back({ x, y });
+				carved = true;
+			}
+			if (!carved) {
+				stack.pop_back();
+			}
+		}
+	}
+};
+
+/**
+ * @brief Cross-map path queries on a large open map, either with a* or as one hierarchical search that refines only the first part of the path.
+*/
+class ChaseBenchmark : public Benchmark {
+public:
+	/**
+	 * @brief Creates the benchmark.
+	 * @param hierarchical - Whether the hierarchical search is used instead of a*.
+	*/
+	ChaseBenchmark(bool hierarchical) : Benchmark(hierarchical ? "chase_hpa_256x256" : "chase_astar_256x256"), hierarchical{ hierarchical } {
+		grid.init(GRID_SIZE, GRID_SIZE);
+		std::mt19937 random(SEED);
+		std::uniform_int_distribution<int> position(0, GRID_SIZE - 1);
+		for (size_t i = 0; i < GRID_SIZE * GRID_SIZE / 10; i++) {
+			grid.setCost(grid.getIndex(position(random), position(random)), 0);
+		}
+		clusters.init(GRID_SIZE, GRID_SIZE);
+		clusters.update(grid);
+
+		// starts on the left edge, destinations on the right edge of the map
+		std::uniform_int_distribution<int> edge(0, GRID_SIZE / 8 - 1);
+		for (size_t i = 0; i < QUERIES; i++) {
+			do { starts[i] = grid.getIndex(edge(random), position(random)); } while (grid.getCost(starts[i]) == 0);
+			do { destinations[i] = grid.getIndex(GRID_SIZE - 1 - edge(random), position(random)); } while (grid.getCost(destinations[i]) == 0);
+		}
+	}
+
+	void run() {
+		size_t length = 0;
+		bool complete = false;
+		for (size_t i = 0; i < QUERIES; i++) {
+			if (hierarchical) {
+				clusters.findPath(grid, starts[i], destinations[i], path, complete);
+			}
+			else {
+				grid.findPath(starts[i], destinations[i], path);
+			}
+			length += path.size();
+		}
+		sink = (float)length;
+	}
+private:
+	static const int GRID_SIZE = 256;
+	static const size_t QUERIES = 16;
+	bool hierarchical;
+	NavGrid grid;
+	HierarchicalGrid clusters;
+	NodeIndex starts[QUERIES];
+	NodeIndex destinations[QUERIES];
+	std::vector<NodeIndex> path;
+};
+
+/**
+ * @brief Agents walking one node per search towards a target that moves one node per search, either searching again with a* or repairing the search of the agent with the incremental search.
+*/
+class MovingTargetBenchmark : public Benchmark {
+public:
+	/**
+	 * @brief Creates the benchmark.
+	 * @param incremental - Whether the incremental search is used instead of a*.
+	*/
+	MovingTargetBenchmark(bool incremental) : Benchmark(incremental ? "moving_target_dstar_128x128" : "moving_target_astar_128x128"), incremental{ incremental } {
+		grid.init(GRID_SIZE, GRID_SIZE);
+		std::mt19937 random(SEED);
+		std::uniform_int_distribution<int> position(0, GRID_SIZE - 1);
+		for (size_t i = 0; i < GRID_SIZE * GRID_SIZE / 6; i++) {
+			grid.setCost(grid.getIndex(position(random), position(random)), 0);
+		}
+
+		// agents start on the left quarter, targets on the right quarter of the map
+		std::uniform_int_distribution<int> edge(0, GRID_SIZE / 4 - 1);
+		for (size_t i = 0; i < AGENTS; i++) {
+			do { starts[i] = grid.getIndex(edge(random), position(random)); } while (grid.getCost(starts[i]) == 0);
+			do { targets[i] = grid.getIndex(GRID_SIZE - 1 - edge(random), position(random)); } while (grid.getCost(targets[i]) == 0);
+		}
+	}
+
+	void run() {
+		std::mt19937 random(SEED);
+		std::uniform_int_distribution<int> direction(0, 7);
+		size_t length = 0;
+		for (size_t i = 0; i < AGENTS; i++) {
+			planner.reset();
+			NodeIndex start = starts[i];
+			NodeIndex target = targets[i];
+			for (size_t step = 0; step < STEPS; step++) {
+				bool found = incremental ? planner.findPath(grid, start, target, path) : grid.findPath(start, target, path);
+				if (!found || path.size() < 2) break;
+				length += path.size();
+
+				start = path[path.size() - 2];
+				NodeIndex next = grid.getNeighbour(target, direction(random));
+				if (next != INVALID_NODE && grid.getCost(next) != 0) {
+					target = next;
+				}
+			}
+		}
+		sink = (float)length;
+	}
+private:
+	static const int GRID_SIZE = 128;
+	static const size_t AGENTS = 8;
+	static const size_t STEPS = 64;
+	bool incremental;
+	NavGrid grid;
+	IncrementalPlanner planner;
+	NodeIndex starts[AGENTS];
+	NodeIndex targets[AGENTS];
+	std::vector<NodeIndex> path;
+};
+
+/**
+ * @brief Local avoidance of a dense crowd of agents all heading to the center of the map.
+*/
+class CrowdAvoidanceBenchmark : public Benchmark {
+public:
+	CrowdAvoidanceBenchmark() : Benchmark("crowd_avoidance_1024") {
+		crowd.init(WORLD_SIZE, WORLD_SIZE, NEIGHBOUR_DISTANCE);
+
+		std::mt19937 random(SEED);
+		std::uniform_real_distribution<float> position(0.0f, (float)WORLD_SIZE);
+		for (size_t i = 0; i < AGENTS; i++) {
+			positions[i] = { position(random), position(random) };
+		}
+	}
+
+	void run() {
+		// 16 pixel colliders moving 1.5 pixels per frame
+		const float radius = 11.0f;
+		const float speed = 1.5f;
+		crowd.clear();
+		float center = WORLD_SIZE / 2.0f;
+		for (size_t i = 0; i < AGENTS; i++) {
+			size_t agent = crowd.addAgent(positions[i], radius, { 0.0f, 0.0f });
+			float dx = center - positions[i].x;
+			float dy = center - positions[i].y;
+			float length = std::sqrt(dx * dx + dy * dy) + 0.001f;
+			crowd.setPreferredVelocity(agent, { dx / length * speed, dy / length * speed });
+		}
+		crowd.solve();
+		sink = crowd.getVelocity(0).x;
+	}
+private:
+	static const int WORLD_SIZE = 1024;
+	static const int NEIGHBOUR_DISTANCE = 48;
+	static const size_t AGENTS = 1024;
+	CrowdAvoidance crowd;
+	CrowdAvoidance::Vec2 positions[AGENTS];
+};
+
+/**
+ * @brief Builds the clusters of the hierarchical search for a large open map, as done at scene load.
+*/
+class HierarchicalBuildBenchmark : public Benchmark {
+public:
+	HierarchicalBuildBenchmark() : Benchmark("hpa_build_256x256") {
+		grid.init(GRID_SIZE, GRID_SIZE);
+		std::mt19937 random(SEED);
+		std::uniform_int_distribution<int> position(0, GRID_SIZE - 1);
+		for (size_t i = 0; i < GRID_SIZE * GRID_SIZE / 10; i++) {
+			grid.setCost(grid.getIndex(position(random), position(random)), 0);
+		}
+		clusters.init(GRID_SIZE, GRID_SIZE);
+	}
+
+	void run() {
+		clusters.invalidate();
+		clusters.update(grid);
+		sink = (float)clusters.getAbstractNodeCount();
+	}
+private:
+	static const int GRID_SIZE = 256;
+	NavGrid grid;
+	HierarchicalGrid clusters;
+};
+
+/**
+ * @brief Parses a tiled json tilemap.
+*/
+class TilemapParseBenchmark : public Benchmark {
+public:
+	TilemapParseBenchmark() : Benchmark("tilemap_parse_128x128") {
+		StressScene::writeTilemapFile(PARSE_TILEMAP_PATH, 128, 128, 16, 64, {});
+	}
+
+	~TilemapParseBenchmark() {
+		std::remove(PARSE_TILEMAP_PATH);
+	}
+
+	void run() {
+		tilemap = FileLoader::loadTilemap(PARSE_TILEMAP_PATH, 1);
+	}
+
+	void tearDown() {
+		delete tilemap;
+	}
+private:
+	Tilemap* tilemap = nullptr;
+};
+
+/**
+ * @brief Full render system update of a tilemap and sprites into the software renderer.
+*/
+class RenderSubmissionBenchmark : public Benchmark {
+public:
+	RenderSubmissionBenchmark() : Benchmark("render_submission") {
+		StressScene::writeTilemapFile(RENDER_TILEMAP_PATH, 80, 45, 16, 64, {});
+		StressScene::writeTilesetFile(RENDER_TILESET_PATH, 8, 16);
+		fixture.renderSystem->setMap(RENDER_TILESET_PATH, RENDER_TILEMAP_PATH, 1);
+
+		std::mt19937 random(SEED);
+		std::uniform_int_distribution<int> x(0, SystemFixture::WINDOW_WIDTH);
+		std::uniform_int_distribution<int> y(0, SystemFixture::WINDOW_HEIGHT);
+		for (size_t i = 0; i < COMPONENT_COUNT; i++) {
+			fixture.addSprite(fixture.addEntity(x(random), y(random)));
+		}
+	}
+
+	~RenderSubmissionBenchmark() {
+		std::remove(RENDER_TILEMAP_PATH);
+		std::remove(RENDER_TILESET_PATH);
+	}
+
+	void run() {
+		fixture.renderSystem->update();
+	}
+private:
+	SystemFixture fixture;
+};
+#pragma endregion Systems
+
+/**
+* @brief Registers the engine microbenchmarks: component manager add/get/remove, entity churn, sprite sort, collision detection, a* on small and large grids, tilemap parsing and render submission.
+* @param runner - Runner to register the benchmarks to.
+*/
+void registerMicrobenchmarks(BenchmarkRunner* runner) {
+	runner->addBenchmark(new ComponentAddBenchmark());
+	runner->addBenchmark(new ComponentGetBenchmark());
+	runner->addBenchmark(new ComponentRemoveBenchmark());
+	runner->addBenchmark(new EntityChurnBenchmark());
+	runner->addBenchmark(new SpriteSortBenchmark());
+	runner->addBenchmark(new CollisionBenchmark());
+	runner->addBenchmark(new AStarBenchmark());
+	runner->addBenchmark(new AStarLocalBenchmark());
+	runner->addBenchmark(new AStarCollidersBenchmark());
+	runner->addBenchmark(new PathReplanBenchmark(false));
+	runner->addBenchmark(new PathReplanBenchmark(true));
+	runner->addBenchmark(new UnreachableBenchmark());
+	runner->addBenchmark(new HordeBenchmark(false));
+	runner->addBenchmark(new HordeBenchmark(true));
+	runner->addBenchmark(new PathfindingBenchmark("path_astar_open_128x128", PATHFINDING_ASTAR, false));
+	runner->addBenchmark(new PathfindingBenchmark("path_jps_open_128x128", PATHFINDING_JPS, false));
+	runner->addBenchmark(new PathfindingBenchmark("path_jpsplus_open_128x128", PATHFINDING_JPS_PLUS, false));
+	runner->addBenchmark(new PathfindingBenchmark("path_astar_maze_128x128", PATHFINDING_ASTAR, true));
+	runner->addBenchmark(new PathfindingBenchmark("path_jps_maze_128x128", PATHFINDING_JPS, true));
+	runner->addBenchmark(new PathfindingBenchmark("path_jpsplus_maze_128x128", PATHFINDING_JPS_PLUS, true));
+	runner->addBenchmark(new ChaseBenchmark(false));
+	runner->addBenchmark(new ChaseBenchmark(true));
+	runner->addBenchmark(new MovingTargetBenchmark(false));
+	runner->addBenchmark(new MovingTargetBenchmark(true));
+	runner->addBenchmark(new CrowdAvoidanceBenchmark());
+	runner->addBenchmark(new HierarchicalBuildBenchmark());
+	runner->addBenchmark(new TilemapParseBenchmark());
+	runner->addBenchmark(new RenderSubmissionBenchmark());
+}
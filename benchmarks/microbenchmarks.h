@@ -0,0 +1,9 @@
+#pragma once
+#include "benchmark.h"
+
+/**
+ * @brief Registers the engine microbenchmarks: component manager add/get/remove, entity churn, sprite sort, collision detection, a* on small and large grids, a* against a shared flow field for many agents, a* against jump point search on open and maze maps, a* against the hierarchical search for cross-map queries on large maps, tilemap parsing and render submission.
+ * The benchmarks generate their own scene data and render into a software renderer, so they need neither a display nor the demo assets.
+ * @param runner - Runner to register the benchmarks to.
+*/
+void registerMicrobenchmarks(BenchmarkRunner* runner);
@@ -0,0 +1,96 @@
+#include "stressbenchmarks.h"
+#include <string>
+#include <gameengine.h>
+#include <stressscene.h>
+
+/**
+ * @brief Seed of the generated scenes, so each run works on the same scene.
+*/
+static const unsigned int SEED = 1337;
+
+/**
+ * @brief Size of the headless render surface and camera.
+*/
+static const int VIEW_WIDTH = 1280;
+static const int VIEW_HEIGHT = 720;
+
+/**
+* @brief Gets the live bytes of every memory tracker tag.
+* @return Tracked live bytes.
+*/
+static size_t getTrackedBytes() {
+	size_t bytes = 0;
+	for (int tag = 0; tag < TAG_COUNT; tag++) {
+		bytes += MemoryTracker::getStats((MEMORY_TAGS)tag).liveBytes;
+	}
+	return bytes;
+}
+
+/**
+ * @brief One headless game engine frame of a generated stress scene. The engine and the scene only exist while the benchmark runs.
+*/
+class StressFrameBenchmark : public Benchmark {
+public:
+	/**
+	 * @brief Creates the benchmark.
+	 * @param enemyCount - Number of enemies of the scene.
+	 * @param levelOfDetail - Whether enemies far from the camera are updated less often.
+	*/
+	StressFrameBenchmark(size_t enemyCount, bool levelOfDetail = true)
+		: Benchmark(("stress_frame_" + std::to_string(enemyCount) + (levelOfDetail ? "" : "_no_lod")).c_str()), enemyCount{ enemyCount }, levelOfDetail{ levelOfDetail } {}
+
+	bool prepare() {
+		// memory of other benchmarks is excluded from the result
+		baselineBytes = getTrackedBytes();
+		scene = new StressScene(StressSceneSettings::scaled(enemyCount, SEED), "benchmark_stress_scene");
+
+		engine = new GameEngine();
+		engine->setComponentCapacity(scene->getComponentCapacity());
+		engine->initHeadless(60, VIEW_WIDTH, VIEW_HEIGHT, VIEW_WIDTH, VIEW_HEIGHT, false);
+		if (!scene->generate(engine)) {
+			return false;
+		}
+
+		AILevelOfDetail settings;
+		settings.enabled = levelOfDetail;
+		engine->setAILevelOfDetail(settings);
+		return true;
+	}
+
+	void run() {
+		engine->runFrames(1);
+	}
+
+	void release() {
+		delete engine;
+		delete scene;
+		engine = nullptr;
+		scene = nullptr;
+	}
+
+	size_t getMemoryBytes() {
+		size_t bytes = getTrackedBytes();
+		return (bytes > baselineBytes) ? bytes - baselineBytes : 0;
+	}
+private:
+	size_t enemyCount;
+	bool levelOfDetail;
+	size_t baselineBytes = 0;
+	GameEngine* engine = nullptr;
+	StressScene* scene = nullptr;
+};
+
+/**
+* @brief Registers the stress scene benchmarks. Each benchmark runs full headless game engine frames of a generated scene with 100, 1000, 10000 or 100000 enemies and reports the tracked memory of the engine.
+* The scene with 10000 enemies also runs with every enemy updated every frame, to compare the level of detail of the enemy movement.
+* @param runner - Runner to register the benchmarks to.
+* @param maxEnemies - Largest enemy count to register.
+*/
+void registerStressBenchmarks(BenchmarkRunner* runner, size_t maxEnemies) {
+	for (size_t enemyCount = 100; enemyCount <= 100000 && enemyCount <= maxEnemies; enemyCount *= 10) {
+		runner->addBenchmark(new StressFrameBenchmark(enemyCount));
+		if (enemyCount == 10000) {
+			runner->addBenchmark(new StressFrameBenchmark(enemyCount, false));
+		}
+	}
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include "benchmark.h"
+
+/**
+ * @brief Registers the stress scene benchmarks. Each benchmark runs full headless game engine frames of a generated scene with 100, 1000, 10000 or 100000 enemies and reports the tracked memory of the engine.
+ * Together the results form the scaling curves of frame time and memory.
+ * @param runner - Runner to register the benchmarks to.
+ * @param maxEnemies - Largest enemy count to register.
+*/
+void registerStressBenchmarks(BenchmarkRunner* runner, size_t maxEnemies);
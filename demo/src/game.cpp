@@ -337,6 +337,7 @@ void Game::addEnemyWolf(SDL_Point pos, int health) {
 
 	EnemyMovement* mov = gameEngine->addEnemyMovementComponent(wolf, 2.5, player);
 	mov->setMaxDistance(20);
+	mov->setFlowField(true);
 
 	Health* healthComponent = gameEngine->addHealthComponent(wolf, health);
 	healthComponent->onZeroHealth(&onWolfDeathWrapper);
@@ -392,6 +393,7 @@ void Game::addEnemyZombie(SDL_Point pos, int health) {
 
 	EnemyMovement* mov = gameEngine->addEnemyMovementComponent(zombie, 1.5, player);
 	mov->setMaxDistance(20);
+	mov->setFlowField(true);
 
 	gameEngine->addAudioComponent(zombie);
 	gameEngine->addAudioClip(zombie, "assets/DemoGame/audio/zombie_hit.mp3");
@@ -1,8 +1,10 @@
 #pragma once
 #include "entity.h"
 #include <map>
-#include <array>
+#include <vector>
+#include <utility>
 #include <iostream>
+#include "util/memorytracker.h"
 /**
  * @brief Template class for ComponentManagers. Each ComponentManager manages a specific component type.
  * @tparam Component - The component type to manage.
@@ -11,15 +13,39 @@ template <typename Component>
 class ComponentManager{
 public:
 	/**
-	 * @brief Adds the component type to the entity and returns added component.
+	 * @brief Creates component manager and accounts the component storage to the memory tracker.
+	 * @param capacity - Maximum number of components.
+	*/
+	ComponentManager(size_t capacity = 1024) : componentData(capacity), maxIndex{ capacity } {
+		MemoryTracker::trackAllocation(TAG_COMPONENTS, sizeof(Component) * maxIndex);
+	}
+
+	/**
+	 * @brief Destructor of the component manager.
+	*/
+	~ComponentManager() {
+		MemoryTracker::trackDeallocation(TAG_COMPONENTS, sizeof(Component) * maxIndex);
+	}
+
+	/**
+	 * @brief Adds the component type to the entity and returns added component. The component is awake.
 	 * @param e - Entity to add the component to.
 	 * @return Added component of entity. Returns nullptr on failure.
 	*/
 	Component* addComponent(Entity e) {
 		if (currentIndex < maxIndex) {
-			entityIndexMap[e] = currentIndex;
+			size_t index = currentIndex;
+
+			// the first sleeping component moves behind the others
+			if (awakeCount < currentIndex) {
+				this->moveComponent(awakeCount, currentIndex);
+				index = awakeCount;
+				componentData[index] = Component();
+			}
+			entityIndexMap[e] = index;
 			currentIndex++;
-			return &componentData[currentIndex - 1];
+			awakeCount++;
+			return &componentData[index];
 		}
 		return nullptr;
 	}
@@ -46,29 +72,60 @@ public:
 		size_t deleteIdx = entityIndexMap[e];
 		entityIndexMap.erase(e);
 
-		if (deleteIdx != currentIndex - 1) {
-			Entity endEntity;
-
-			for (auto& i : entityIndexMap) {
-				if (i.second == currentIndex - 1) {
-					endEntity = i.first;
-					break;
-				}
+		if (deleteIdx < awakeCount) {
+			// the last awake component fills the gap and the last sleeping component fills its slot
+			size_t lastAwake = awakeCount - 1;
+			if (deleteIdx != lastAwake) {
+				this->moveComponent(lastAwake, deleteIdx);
 			}
-
-			componentData[deleteIdx] = componentData[currentIndex - 1];
-			entityIndexMap[endEntity] = deleteIdx;
+			if (lastAwake != currentIndex - 1) {
+				this->moveComponent(currentIndex - 1, lastAwake);
+			}
+			awakeCount--;
+		}
+		else if (deleteIdx != currentIndex - 1) {
+			this->moveComponent(currentIndex - 1, deleteIdx);
 		}
 		currentIndex--;
 	}
 
+	/**
+	 * @brief Wakes the component of the entity or puts it to sleep. Awake components are stored before the sleeping ones, so systems only iterate the first getAwakeCount() components.
+	 * The order of the components changes, pointers to components are invalidated.
+	 * @param e - Entity of the component.
+	 * @param awake - Whether the component is awake.
+	*/
+	void setAwake(Entity e, bool awake) {
+		auto itr = entityIndexMap.find(e);
+		if (itr == entityIndexMap.end()) return;
+
+		size_t index = itr->second;
+		if (awake && index >= awakeCount) {
+			this->swapComponents(index, awakeCount);
+			awakeCount++;
+		}
+		else if (!awake && index < awakeCount) {
+			awakeCount--;
+			this->swapComponents(index, awakeCount);
+		}
+	}
+
+	/**
+	 * @brief Checks if the component of the entity is awake.
+	 * @param e - Entity of the component.
+	 * @return Whether the component is awake. False if the entity has no component.
+	*/
+	bool isAwake(Entity e) {
+		auto itr = entityIndexMap.find(e);
+		return itr != entityIndexMap.end() && itr->second < awakeCount;
+	}
+
 	/**
 	 * @brief Debug function to list every entitiy -> index mapping.
 	 * Should not be used in final project.
 	*/
 	void DebugListEntityIndexMap() {
-		std::map<Entity, size_t>::iterator itr;
-		for (itr = entityIndexMap.begin(); itr != entityIndexMap.end(); itr++) {
+		for (auto itr = entityIndexMap.begin(); itr != entityIndexMap.end(); itr++) {
 			Entity temp = itr->first;
 			std::cout <<temp.uid << " -> " << itr->second << std::endl;
 		}
@@ -93,6 +150,22 @@ public:
 		return currentIndex;
 	}
 
+	/**
+	* @brief Returns the number of awake components. The awake components have the indices from 0 to the awake count.
+	* @return Current awake component count.
+	*/
+	size_t getAwakeCount() {
+		return awakeCount;
+	}
+
+	/**
+	* @brief Returns maximum number of components.
+	* @return Maximum number of components.
+	*/
+	size_t getCapacity() {
+		return maxIndex;
+	}
+
 	/**
 	 * @brief Checks if entity has component.
 	 * @param e - Entity to check
@@ -105,18 +178,45 @@ private:
 	/**
 	 * @brief Mapping of entity to the index of the entity component in componentData.
 	*/
-	std::map<Entity, size_t> entityIndexMap;
+	std::map<Entity, size_t, std::less<Entity>, TrackingAllocator<std::pair<const Entity, size_t>, TAG_COMPONENTS>> entityIndexMap;
 	/**
-	* @brief Array of components.
+	* @brief Components. Allocated once with the capacity of the component manager.
 	*/
-	std::array<Component, 1024> componentData;
+	std::vector<Component> componentData;
 	/**
 	* @brief Next free index of componentData array.
 	*/
 	size_t currentIndex = 0;
 
+	/**
+	* @brief Number of awake components at the start of componentData.
+	*/
+	size_t awakeCount = 0;
+
 	/**
 	 * @brief Maximum number of components
 	*/
-	size_t maxIndex = 1024;
+	size_t maxIndex;
+
+	/**
+	 * @brief Moves a component to another index. The component previously stored at the index is overwritten.
+	 * @param from - Index of the component.
+	 * @param to - New index of the component.
+	*/
+	void moveComponent(size_t from, size_t to) {
+		componentData[to] = componentData[from];
+		entityIndexMap[componentData[to].getEntity()] = to;
+	}
+
+	/**
+	 * @brief Swaps two components.
+	 * @param a - Index of the first component.
+	 * @param b - Index of the second component.
+	*/
+	void swapComponents(size_t a, size_t b) {
+		if (a == b) return;
+		std::swap(componentData[a], componentData[b]);
+		entityIndexMap[componentData[a].getEntity()] = a;
+		entityIndexMap[componentData[b].getEntity()] = b;
+	}
 };
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include "basecomponent.h"
 #include "SDL.h"
 #include "SDL_mixer.h"
+#include "../util/memorytracker.h"
+#include "../util/log.h"
 /**
  * @brief Struct to represent playable soundeffect
 */
@@ -21,7 +23,10 @@ public:
 	AudioClip(const char* filePath) {
 		audioChunk = Mix_LoadWAV(filePath);
 		if (audioChunk == NULL) {
-			SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "SDL Mixer Error", "Could not load sound file!", NULL);
+			Log::error("SDL Mixer Error", "Could not load sound file!");
+		}
+		else {
+			MemoryTracker::trackAllocation(TAG_AUDIO, audioChunk->alen);
 		}
 		playCount = 0;
 	}
@@ -31,6 +36,7 @@ public:
 	*/
 	~AudioClip() {
 		if (audioChunk != NULL) {
+			MemoryTracker::trackDeallocation(TAG_AUDIO, audioChunk->alen);
 			Mix_FreeChunk(audioChunk);
 		}
 	}
@@ -4,6 +4,10 @@
  * @brief Abstract base struct for components.
 */
 struct BaseComponent {
+	/**
+	 * @brief Virtual destructor, so components can be deleted through the base struct.
+	*/
+	virtual ~BaseComponent() {}
 
 	/**
 	 * @brief Prints the component.
@@ -2,6 +2,7 @@
 #include "basecomponent.h"
 #include <iostream>
 #include "SDL.h"
+#include "../util/navigation/navgrid.h"
 /**
  * @brief Collider component. A collider is needed for collision between entities in the gameworld.
 */
@@ -39,6 +40,9 @@ public:
 
 		colliderRect.x = (x-(w/2))+offsetX;
 		colliderRect.y = (y-(h/2))+offsetY;
+
+		// the storage may still hold the occupancy of a removed collider
+		this->setOccupiedNodes({ 0,0,0,0 }, OCCUPANCY_STATIC, 0);
 	}
 
 	/**
@@ -195,6 +199,42 @@ public:
 		return lastCollision;
 	}
 
+	/**
+	 * @brief Sets the nodes of the navigation grid the collider occupies.
+	 * @param nodes - Occupied nodes as rectangle in node coordinates.
+	 * @param layer - Occupancy layer of the nodes.
+	 * @param generation - Occupancy generation of the grid. 0 if the collider occupies no nodes.
+	*/
+	void setOccupiedNodes(SDL_Rect nodes, OCCUPANCY_LAYERS layer, uint32_t generation) {
+		occupiedNodes = nodes;
+		occupancyLayer = layer;
+		occupancyGeneration = generation;
+	}
+
+	/**
+	 * @brief Gets the nodes of the navigation grid the collider occupies.
+	 * @return Occupied nodes as rectangle in node coordinates.
+	*/
+	const SDL_Rect& getOccupiedNodes() {
+		return occupiedNodes;
+	}
+
+	/**
+	 * @brief Gets the occupancy layer of the occupied nodes.
+	 * @return Occupancy layer.
+	*/
+	OCCUPANCY_LAYERS getOccupancyLayer() {
+		return occupancyLayer;
+	}
+
+	/**
+	 * @brief Gets the occupancy generation of the grid the nodes are occupied on.
+	 * @return Occupancy generation. 0 if the collider occupies no nodes.
+	*/
+	uint32_t getOccupancyGeneration() {
+		return occupancyGeneration;
+	}
+
 	/**
 	 * @brief Sets the last collision entity.
 	 * @param e - Entity of last collider this collider collided with.
@@ -260,4 +300,19 @@ private:
 	 * @brief Entity of the last collider this collider collided with.
 	*/
 	Entity lastCollision = { 0 };
+
+	/**
+	 * @brief Nodes of the navigation grid occupied by the collider.
+	*/
+	SDL_Rect occupiedNodes = { 0,0,0,0 };
+
+	/**
+	 * @brief Occupancy layer of the occupied nodes.
+	*/
+	OCCUPANCY_LAYERS occupancyLayer = OCCUPANCY_STATIC;
+
+	/**
+	 * @brief Occupancy generation of the grid the nodes are occupied on. 0 if the collider occupies no nodes.
+	*/
+	uint32_t occupancyGeneration = 0;
 };
\ No newline at end of file
@@ -2,88 +2,11 @@
 #include "basecomponent.h"
 #include <iostream>
 #include <vector>
-#include <queue>
-/**
- * @brief Priority Queue struct for the astar pathfinding.
- * @tparam T - Nodes.
- * @tparam priority - Fcosts of the nodes.
-*/
-template<typename T, typename priority>
-struct PriorityQueue {
-	/**
-	 * @brief Pair of the node and the fcost of the node.
-	*/
-	typedef std::pair<priority, T> Element;
-	std::priority_queue<Element, std::vector<Element>, std::greater<Element>> elements;
-
-	/**
-	 * @brief Checks if the priority queue is empty.
-	 * @return Whether the priority queue is empty.
-	*/
-	inline bool empty(){
-		return elements.empty();
-	}	
-
-	/**
-	 * @brief Adds a node to the priority queue.
-	 * @param item - Node to add to the priority queue.
-	 * @param prio - Fcost of the node.
-	*/
-	inline void put(T item, priority prio) {
-		elements.emplace(prio, item);
-	}
-
-	/**
-	 * @brief Gets the node out of the queue with the smallest fcost.
-	 * @return Node with the smallest Ffcost.
-	*/
-	T get() {
-		T best_item = elements.top().second;
-		elements.pop();
-		return best_item;
-	}
-};
-
-/**
- * @brief Struct representing the logical position on the tilemap grid.
-*/
-struct Node {
-	/**
-	 * @brief X-position on the grid.
-	*/
-	int x = 0;
-	/**
-	 * @brief Y-position on the grid.
-	*/
-	int y = 0;
-	/**
-	 * @brief Parentnode. A parent is the node used to reach this node when searching for a path. Needed to backtrack the found path.
-	*/
-	Node* parent = nullptr;
-	/**
-	 * @brief Whether the node was visited during pathfinding.
-	*/
-	bool visited = false;
-	/**
-	 * @brief Whether the node is an obstacle.
-	*/
-	bool obstacle = false;
-	/**
-	 * @brief Neighbournodes.
-	*/
-	std::vector<Node*> neighbours;
-
-	/**
-	* @brief Current gCost of the node. Total cost from start to this node.
-	*/
-	float gcost = 0.0f;
-
-	/**
-	* @brief Current fCost of the node. Total cost from start to this node (gcost) plus an estimate of the remaining distance to the destination.
-	*/
-	float fcost = 0.0f;
-};
-
+#include "../util/navigation/navgrid.h"
+#include "../util/navigation/pathservice.h"
+#include "../util/navigation/routepool.h"
+#include "../util/navigation/squad.h"
+#include "../util/timerwheel.h"
 /**
  * @brief Component to hold the attributes used for enemy movement.
 */
@@ -102,16 +25,28 @@ public:
 	 * @brief Resets the component.
 	*/
 	void resetComponent() {
-		this->resetCurrentTimer();
+		this->pathfindingTimer = INVALID_TIMER;
 		this->resetTarget();
-		this->setDestination(nullptr);
+		this->setDestination(INVALID_NODE);
 		this->onReachingDestination(nullptr);
 		this->onReachingDestinationCalled = false;
 		this->timerBase = 3000;
 		this->calcRoute = true;
 		this->maxDistance = 10;
+		this->lineOfSight = true;
+		this->flowField = false;
 		this->nextNodeIndex = 0;
-		this->route = {};
+		// the route of a reused slot belongs to the component that was moved out of it
+		this->route = INVALID_ROUTE;
+		this->routeLength = 0;
+		this->routeComplete = true;
+		this->routePending = false;
+		this->destinationUnreachable = false;
+		this->velocityX = 0.0f;
+		this->velocityY = 0.0f;
+		this->lastUpdateFrame = 0;
+		this->squad = Squad::NO_SQUAD;
+		this->squadSlot = 0;
 	}
 
 	/**
@@ -127,64 +62,146 @@ public:
 
 	/**
 	 * @brief Gets the current movement destination of the enemy.
-	 * @return Pointer to the current destination node.
+	 * @return Index of the current destination node. INVALID_NODE if the enemy has no destination.
 	*/
-	Node* getDestination() { return destination; }
+	NodeIndex getDestination() { return destination; }
 
 	/**
 	 * @brief Sets the current movement destination node.
-	 * @param newDest - New movement destination node.
+	 * @param newDest - Index of the new movement destination node.
+	 * @param keepRoute - Whether the enemy keeps following its current route until the route to the new destination arrives.
 	*/
-	void setDestination(Node* newDest) {
+	void setDestination(NodeIndex newDest, bool keepRoute = false) {
 		destination = newDest;
-		this->route = {};
+		destinationUnreachable = false;
+		if (!keepRoute) {
+			this->routeLength = 0;
+			this->routeComplete = true;
+		}
 		onReachingDestinationCalled = false;
 	}
 
 	/**
-	 * @brief Sets the route to the destination node calculated with a*.
+	 * @brief Sets the route to the destination node calculated with a*. The nodes are stored in the span of the previous route in the route pool to avoid reallocations.
+	 * @tparam Container - Container type of the route.
+	 * @param routes - Route pool of the physic system.
 	 * @param route - Route to the destination node.
-	*/
-	void setRoute(std::vector<Node*> route) {
-		this->route = route;
-		this->nextNodeIndex = route.size()-2;
+	 * @param complete - Whether the route ends at the destination node. At the end of an incomplete route the component is flagged to search the next part instead of reaching the destination.
+	*/
+	template<typename Container>
+	void setRoute(RoutePool& routes, const Container& route, bool complete = true) {
+		this->route = routes.assign(this->route, route);
+		this->routeLength = (int)route.size();
+		this->nextNodeIndex = this->routeLength - 2;
+		this->routeComplete = complete;
 	}
 
 	/**
-	 * @brief Gets the current route to the destination node.
-	 * @return Vector containing the nodes on the route to the current destination node.
+	 * @brief Checks if the current route ends at the destination node.
+	 * @return Whether the route ends at the destination node.
 	*/
-	std::vector<Node*> getRoute() {
-		return route;
+	bool isRouteComplete() { return routeComplete; }
+
+	/**
+	 * @brief Sets whether a new route was requested from the path service and not delivered yet.
+	 * @param pending - Whether a route is pending.
+	 * @param priority - Priority of the pending request.
+	*/
+	void setRoutePending(bool pending, PATH_PRIORITIES priority = PATH_PRIORITY_NORMAL) {
+		this->routePending = pending;
+		this->routePriority = priority;
 	}
 
 	/**
-	 * @brief Increases the pathfinding timer. Used to avoid calculating the path every frame.
-	 * @param increase - Timer increase (milliseconds between movement simulation).
+	 * @brief Checks if a new route was requested and not delivered yet.
+	 * @return Whether a route is pending.
 	*/
-	void increaseTimer(int increase) {
-		currentTimer += increase;
-		if (currentTimer >= timerBase) {
-			flag(true);
-		}
+	bool isRoutePending() { return routePending; }
+
+	/**
+	 * @brief Sets whether the destination node is not connected to the node of the enemy. Set by the physic system when a route is requested.
+	 * @param unreachable - Whether the destination is unreachable.
+	*/
+	void setDestinationUnreachable(bool unreachable) { this->destinationUnreachable = unreachable; }
+
+	/**
+	 * @brief Checks if the last route request was rejected, because the destination node is not connected to the node of the enemy. The route is empty until the destination becomes reachable.
+	 * @return Whether the destination is unreachable.
+	*/
+	bool isDestinationUnreachable() { return destinationUnreachable; }
+
+	/**
+	 * @brief Sets the velocity the enemy moved with in the last frame. Set by the physic system.
+	 * @param x - X-velocity in pixels per frame.
+	 * @param y - Y-velocity in pixels per frame.
+	*/
+	void setVelocity(float x, float y) {
+		this->velocityX = x;
+		this->velocityY = y;
 	}
 
 	/**
-	 * @brief Resets the current timer.
+	 * @brief Gets the x-velocity the enemy moved with in the last frame. Used by the local avoidance to predict the enemy.
+	 * @return X-velocity in pixels per frame.
+	*/
+	float getVelocityX() { return velocityX; }
+
+	/**
+	 * @brief Gets the y-velocity the enemy moved with in the last frame. Used by the local avoidance to predict the enemy.
+	 * @return Y-velocity in pixels per frame.
 	*/
-	void resetCurrentTimer() {
-		this->currentTimer = 0;
+	float getVelocityY() { return velocityY; }
+
+	/**
+	 * @brief Sets the frame of the last update of the enemy. Set by the physic system, enemies far from the camera are not updated every frame.
+	 * @param frame - Frame of the enemy movement simulation.
+	*/
+	void setLastUpdate(uint32_t frame) {
+		this->lastUpdateFrame = frame;
 	}
 
+	/**
+	 * @brief Gets the frame of the last update of the enemy.
+	 * @return Frame of the enemy movement simulation.
+	*/
+	uint32_t getLastUpdateFrame() { return lastUpdateFrame; }
+
+	/**
+	 * @brief Gets the priority of the pending route request.
+	 * @return Priority of the pending request.
+	*/
+	PATH_PRIORITIES getRoutePriority() { return routePriority; }
+
+	/**
+	 * @brief Gets the handle of the route in the route pool of the physic system. Has to be released in the pool when the component is removed.
+	 * @return Handle of the route. INVALID_ROUTE if the enemy never had a route.
+	*/
+	RouteHandle getRouteHandle() { return route; }
+
+	/**
+	 * @brief Gets the number of nodes of the current route to the destination node. The nodes are stored from the destination node back to the start node.
+	 * @return Number of nodes of the route.
+	*/
+	int getRouteLength() { return routeLength; }
+
+	/**
+	 * @brief Gets the handle of the scheduled pathfinding timer. The timer flags the component for pathfinding when it fires.
+	 * @return Handle of the timer. INVALID_TIMER if no timer is scheduled.
+	*/
+	TimerHandle getPathfindingTimerHandle() { return pathfindingTimer; }
+
+	/**
+	 * @brief Sets the handle of the scheduled pathfinding timer. Set by the physic system when the path is requested.
+	 * @param handle - Handle of the timer.
+	*/
+	void setPathfindingTimerHandle(TimerHandle handle) { this->pathfindingTimer = handle; }
+
 	/**
 	 * @brief Flags the enemy movement component for pathfinding.
 	 * @param flag - Whether the physic system should calculate a new path for the enemy movement component.
 	*/
 	void flag(bool flag) {
 		calcRoute = flag;
-		if (!calcRoute) {
-			currentTimer = 0;
-		}
 	}
 
 	/**
@@ -195,46 +212,68 @@ public:
 
 	/**
 	 * @brief Gets the next node on the route.
-	 * @return Pointer to the next node on the route.
+	 * @param routes - Route pool of the physic system.
+	 * @return Index of the next node on the route.
 	*/
-	Node* getNextNode() {
-		return route[nextNodeIndex];
+	NodeIndex getNextNode(const RoutePool& routes) {
+		return routes.getNode(route, nextNodeIndex);
 	}
 
 	bool hasNextNode() {
-		return nextNodeIndex >= 0 && route.size() > 0;
+		return nextNodeIndex >= 0 && routeLength > 0;
 	}
 
 	/**
-	 * @brief Checks if the enemy arrived at the next node on the route based on the current position.
-	 * @param x - Current x position of the enemy.
-	 * @param y - Current y position of the enemy.
+	 * @brief Checks if the enemy arrived at the next node on the route based on the current node.
+	 * @param routes - Route pool of the physic system.
+	 * @param current - Index of the node the enemy currently occupies.
 	 * @return Whether the enemy arrived at the next node on the route.
 	*/
-	bool arrivedAtNextNode(int x, int y) {
-		if (nextNodeIndex >= 0 && route.size() > 0) {
-			return (x == route[nextNodeIndex]->x && y == route[nextNodeIndex]->y) ? true : false;
+	bool arrivedAtNextNode(const RoutePool& routes, NodeIndex current) {
+		if (nextNodeIndex >= 0 && routeLength > 0) {
+			return current == routes.getNode(route, nextNodeIndex);
 		}
 		return true;
 	}
 
+	/**
+	 * @brief Checks if the enemy has no node of its route left to move to.
+	 * @param routes - Route pool of the physic system.
+	 * @param current - Index of the node the enemy currently occupies.
+	 * @return Whether the enemy reached the end of its route or has no route.
+	*/
+	bool reachedEndOfRoute(const RoutePool& routes, NodeIndex current) {
+		return routeLength == 0 || nextNodeIndex < 0 || (nextNodeIndex == 0 && current == routes.getNode(route, 0));
+	}
+
 	/**
 	 * @brief Selects the next node of the route. If there is no next node (= current node is destination), remove the current destination.
+	 * At the end of an incomplete route the component is flagged for pathfinding instead, while a route is pending the enemy waits for it.
+	 * @param routes - Route pool of the physic system.
+	 * @return Index of the node the enemy currently occupies on the route. INVALID_NODE if the destination or the end of the route was reached.
 	*/
-	void setNextNode() {
+	NodeIndex setNextNode(const RoutePool& routes) {
 		if (nextNodeIndex > 0) {
-			// set current node as obstacle
-			route[nextNodeIndex]->obstacle = true;
+			NodeIndex current = routes.getNode(route, nextNodeIndex);
 			nextNodeIndex -= 1;
+			return current;
+		}
+		else if (routePending) {
+			// wait for the requested route
+		}
+		else if (!routeComplete && routeLength > 0) {
+			// only the first part of the path was refined
+			this->flag(true);
 		}
 		else {
-			destination = nullptr;
+			destination = INVALID_NODE;
 			// check if component has onReachingDestinationFunction
 			if (nextNodeIndex == 0 && onReachingDestinationFunction != nullptr && !onReachingDestinationCalled) {
 				onReachingDestinationCalled = true;
 				onReachingDestinationFunction(this);
 			}
 		}
+		return INVALID_NODE;
 	}
 
 	/**
@@ -245,6 +284,12 @@ public:
 		this->timerBase = timerMS;
 	}
 
+	/**
+	 * @brief Gets the pathfinding timer.
+	 * @return Milliseconds between the pathfindings.
+	*/
+	int getPathfindingTimer() { return timerBase; }
+
 	/**
 	 * @brief Sets current target entity.
 	 * @param e - New target entity.
@@ -292,6 +337,73 @@ public:
 		return this->maxDistance;
 	}
 
+	/**
+	 * @brief Sets whether the enemy only notices its target within the max distance if no wall blocks the line of sight.
+	 * @param required - Whether the line of sight is required.
+	*/
+	void setLineOfSight(bool required) {
+		this->lineOfSight = required;
+	}
+
+	/**
+	 * @brief Checks if the enemy only notices its target if no wall blocks the line of sight.
+	 * @return Whether the line of sight is required.
+	*/
+	bool requiresLineOfSight() {
+		return this->lineOfSight;
+	}
+
+	/**
+	 * @brief Sets whether the route is taken from the flow field shared by every enemy with the same destination instead of an own a* search.
+	 * Useful for many enemies chasing the same target.
+	 * @param enabled - Whether the flow field is used.
+	*/
+	void setFlowField(bool enabled) {
+		this->flowField = enabled;
+	}
+
+	/**
+	 * @brief Checks if the route is taken from the shared flow field.
+	 * @return Whether the flow field is used.
+	*/
+	bool usesFlowField() {
+		return this->flowField;
+	}
+
+	/**
+	 * @brief Sets the squad of the enemy. Set by the physic system when a squad is created or disbanded.
+	 * @param squad - Index of the squad. Squad::NO_SQUAD if the enemy belongs to no squad.
+	 * @param slot - Formation slot of a follower. -1 for the leader of the squad.
+	*/
+	void setSquad(int squad, int slot) {
+		this->squad = squad;
+		this->squadSlot = slot;
+	}
+
+	/**
+	 * @brief Gets the squad of the enemy.
+	 * @return Index of the squad. Squad::NO_SQUAD if the enemy belongs to no squad.
+	*/
+	int getSquad() {
+		return this->squad;
+	}
+
+	/**
+	 * @brief Gets the formation slot of the enemy in its squad.
+	 * @return Formation slot of a follower. -1 for the leader of the squad.
+	*/
+	int getSquadSlot() {
+		return this->squadSlot;
+	}
+
+	/**
+	 * @brief Checks if the enemy follows the leader of a squad instead of searching own paths.
+	 * @return Whether the enemy is a squad follower.
+	*/
+	bool isSquadFollower() {
+		return this->squad != Squad::NO_SQUAD && this->squadSlot >= 0;
+	}
+
 	/**
 	 * @brief Sets the onReachingDestination handler.
 	 * @param handler - New onReachingDestination handler.
@@ -305,9 +417,9 @@ private:
 	*/
 	int timerBase = 3000;
 	/**
-	 * @brief Current timer.
+	 * @brief Handle of the scheduled pathfinding timer.
 	*/
-	int currentTimer = 0;
+	TimerHandle pathfindingTimer = INVALID_TIMER;
 	/**
 	 * @brief Whether the component is flagged for pathfinding.
 	*/
@@ -329,17 +441,67 @@ private:
 	int maxDistance = 10;
 
 	/**
-	 * @brief Pointer to the current movement destination node.
+	 * @brief Whether the target has to be in sight to be noticed.
 	*/
-	Node* destination = nullptr;
+	bool lineOfSight = true;
+
+	/**
+	 * @brief Whether the route is taken from the shared flow field.
+	*/
+	bool flowField = false;
+
+	/**
+	 * @brief Index of the current movement destination node.
+	*/
+	NodeIndex destination = INVALID_NODE;
 	/**
 	 * @brief Index to the next node of the route.
 	*/
 	int nextNodeIndex = 0;
 	/**
-	 * @brief Current route to the destination node.
+	 * @brief Handle of the current route to the destination node in the route pool.
+	*/
+	RouteHandle route = INVALID_ROUTE;
+	/**
+	 * @brief Number of nodes of the current route.
+	*/
+	int routeLength = 0;
+	/**
+	 * @brief Whether the route ends at the destination node.
+	*/
+	bool routeComplete = true;
+	/**
+	 * @brief Whether a new route was requested from the path service and not delivered yet.
+	*/
+	bool routePending = false;
+	/**
+	 * @brief Priority of the pending route request.
+	*/
+	PATH_PRIORITIES routePriority = PATH_PRIORITY_NORMAL;
+	/**
+	 * @brief Whether the destination node is not connected to the node of the enemy.
+	*/
+	bool destinationUnreachable = false;
+	/**
+	 * @brief X-velocity of the last frame in pixels per frame.
+	*/
+	float velocityX = 0.0f;
+	/**
+	 * @brief Y-velocity of the last frame in pixels per frame.
+	*/
+	float velocityY = 0.0f;
+	/**
+	 * @brief Frame of the last update.
+	*/
+	uint32_t lastUpdateFrame = 0;
+	/**
+	 * @brief Index of the squad of the enemy.
+	*/
+	int squad = Squad::NO_SQUAD;
+	/**
+	 * @brief Formation slot in the squad. -1 for the leader.
 	*/
-	std::vector<Node*> route;
+	int squadSlot = 0;
 
 	/**
 	 * @brief Handler function when the entity reaches the destination.
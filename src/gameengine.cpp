@@ -1,4 +1,6 @@
 #include "gameengine.h"
+#include <algorithm>
+#include <cstdlib>
 #pragma region Lifecycle
 /**
 * @brief Initializes the game engine.
@@ -16,11 +18,11 @@ void GameEngine::init(int fps, std::string windowTitle, int width, int height, i
 		this->frameDelay = 1000 / fps;
 	}
 	if (SDL_Init(SDL_INIT_EVERYTHING) < 0) {
-		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Initialization error", "Could not initialize game engine.", NULL);
+		Log::error("Initialization error", "Could not initialize game engine.");
 		return;
 	}
 	if (TTF_Init() != 0) {
-		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Initialization error", "Could not initialize SDL_TTF.", NULL);
+		Log::error("Initialization error", "Could not initialize SDL_TTF.");
 		return;
 	}
 	this->window = new Window(windowTitle, width, height);
@@ -36,12 +38,79 @@ void GameEngine::init(int fps, std::string windowTitle, int width, int height, i
 	}
 }
 
+/**
+* @brief Initializes the game engine without display and audio device. Uses the dummy video and audio drivers of SDL and renders into a software surface. Errors are written to the log instead of being shown in a message box.
+* @param fps - Target frames per seconds of the simulation.
+* @param width - Width of the render surface.
+* @param height - Height of the render surface.
+* @param cameraWidth - Width of camera.
+* @param cameraHeight - Height of camera.
+* @param debug- Display position, collider and paths for debugging.
+*/
+void GameEngine::initHeadless(int fps, int width, int height, int cameraWidth, int cameraHeight, bool debug) {
+	Log::setHeadless(true);
+	if (fps > 0) {
+		this->frameDelay = 1000 / fps;
+	}
+
+	// keep drivers that were explicitly set in the environment
+	SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+	SDL_setenv("SDL_AUDIODRIVER", "dummy", 0);
+
+	if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO | SDL_INIT_TIMER | SDL_INIT_EVENTS) < 0) {
+		Log::error("Initialization error", SDL_GetError());
+		return;
+	}
+	if (TTF_Init() != 0) {
+		Log::error("Initialization error", "Could not initialize SDL_TTF.");
+		return;
+	}
+	this->window = new Window("Headless", width, height);
+	if (window->initHeadless()) {
+		this->initManagers();
+		this->initComponentManagers();
+		this->initUniqueComponents();
+		this->initObjectPools();
+		this->initSystems(cameraWidth, cameraHeight, debug);
+	}
+}
+
+/**
+* @brief Destructor of game engine. Deletes the systems, managers and the window. Used libraries stay initialized until quit() is called.
+*/
+GameEngine::~GameEngine() {
+	delete audioSystem;
+	delete physicSystem;
+	delete renderSystem;
+
+	delete projectilePool;
+
+	delete spriteManager;
+	delete posManager;
+	delete animatorManager;
+	delete audioManager;
+	delete colliderManager;
+	delete healthManager;
+	delete projectileMovementManager;
+	delete enemyMovementManager;
+
+	delete cameraFollow;
+	delete playerMovement;
+
+	delete uiManager;
+	delete inputManager;
+	delete entityManager;
+	delete frameArena;
+
+	delete window;
+}
+
 /**
 * @brief Runs the game engine. Starts the game loop.
 */
 void GameEngine::run() {
 	if (window == nullptr) {
-		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Runtime error", "Please initialize engine before executing run.", NULL);
+		Log::error("Runtime error", "Please initialize engine before executing run.");
 		return;
 	}
 
@@ -49,17 +118,11 @@ void GameEngine::run() {
 	{
 		Uint32 startTimestamp = SDL_GetTicks();
 
-		inputManager->update();
-		if (inputManager->interrupted) break;
+		if (!runFrame()) break;
 
-		uiManager->update();
+		// headless simulations run as fast as possible
+		if (window->isHeadless()) continue;
 
-		physicSystem->update();
-
-		audioSystem->update();
-		renderSystem->update();
-
-		collectObjects();
 		Uint32 endTimestamp = SDL_GetTicks();
 		Uint32 delay = (Uint32)(frameDelay - (endTimestamp - startTimestamp));
 		if (delay < frameDelay) {
@@ -68,6 +131,62 @@ void GameEngine::run() {
 	}
 }
 
+/**
+* @brief Runs a fixed number of game loop iterations without frame limiting. Used for headless simulations and benchmarks.
+* @param frameCount - Number of frames to run.
+* @return Number of frames that were run. Less than frameCount if the game loop was interrupted.
+*/
+size_t GameEngine::runFrames(size_t frameCount) {
+	if (window == nullptr) {
+		Log::error("Runtime error", "Please initialize engine before executing run.");
+		return 0;
+	}
+
+	size_t frames = 0;
+	while (frames < frameCount && runFrame()) {
+		frames++;
+	}
+	return frames;
+}
+
+/**
+* @brief Executes one iteration of the game loop.
+* @return Whether the game loop should continue.
+*/
+bool GameEngine::runFrame() {
+	MemoryTracker::beginFrame();
+
+	inputManager->update();
+	if (inputManager->interrupted) return false;
+
+	// the tilemap chunks are render targets, so they are rendered again after the renderer lost them
+	if (inputManager->renderTargetsReset) {
+		renderSystem->invalidateTilemapChunks();
+	}
+
+	uiManager->update();
+
+	// expired lifetimes destroy entities, so the timers fire before the systems iterate the components
+	this->updateTimers();
+
+	// sleep state changes reorder the components, so they are applied before the systems iterate them
+	this->updateSleeping();
+
+	// enemies far from the camera of the last frame are updated less often
+	physicSystem->setCamera(renderSystem->getCamera());
+	physicSystem->update();
+
+	audioSystem->update();
+	renderSystem->update();
+
+	collectObjects();
+
+	// release transient data of this frame
+	frameArena->reset();
+	MemoryTracker::endFrame();
+	return true;
+}
+
 /**
 * @brief Quits the game engine and used libraries.
 */
@@ -107,7 +226,7 @@ Entity GameEngine::addEntity(const char* tag, bool isPreserved, SDL_Point positi
 		pos->setPosition(position.x*renderSystem->getCameraZoomFactorX(), position.y*renderSystem->getCameraZoomFactorY());
 	}
 	else {
-		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Entity Initialization error", "Could not add position component to entity.", NULL);
+		Log::error("Entity Initialization error", "Could not add position component to entity.");
 	}
 	return entity;
 }
@@ -120,10 +239,12 @@ Entity GameEngine::addEntity(const char* tag, bool isPreserved, SDL_Point positi
 void GameEngine::setPosition(Entity e, SDL_Point pos) {
 	Position* component = this->posManager->getComponent(e);
 	if (component != nullptr) {
+		// the sleep grid stores the position the entity fell asleep at
+		this->wakeEntity(e);
 		component->setPosition(pos.x * renderSystem->getCameraZoomFactorX(), pos.y * renderSystem->getCameraZoomFactorY());
 	}
 	else {
-		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Entity Initialization error", "Could not add position component to entity.", NULL);
+		Log::error("Entity Initialization error", "Could not add position component to entity.");
 	}
 }
 
@@ -176,11 +297,14 @@ Entity GameEngine::addPlayer(const char* tag, bool isPreserved, SDL_Point positi
 * @param target - Target position.
 * @param projectileSpeed - Projectile speed.
 * @param isCursorTarget - Whether the cursor position is the target position.
+* @param lifetimeMS - Milliseconds until the projectile is destroyed. 0 keeps the projectile until it is destroyed.
 * @return Projectile entity.
 */
-Entity GameEngine::createProjectile(const char* spritePath, SDL_Point size, float scale, SDL_Point start, SDL_Point target, float projectileSpeed, bool isCursorTarget) {
+Entity GameEngine::createProjectile(const char* spritePath, SDL_Point size, float scale, SDL_Point start, SDL_Point target, float projectileSpeed, bool isCursorTarget, Uint32 lifetimeMS) {
 	Entity result = this->projectilePool->getNext();
 	if (result.uid != 0) {
+		// unused projectiles of the pool are sleeping
+		this->wakeEntity(result);
 		Position* position = this->posManager->getComponent(result);
 		position->setPosition(start.x, start.y);
 
@@ -214,6 +338,10 @@ Entity GameEngine::createProjectile(const char* spritePath, SDL_Point size, floa
 			projectileMovement->init(angle, projectileSpeed);
 			projectileMovement->setActive(true);
 		}
+
+		if (lifetimeMS > 0) {
+			this->setEntityLifetime(result, lifetimeMS);
+		}
 	}
 	return result;
 }
@@ -224,6 +352,9 @@ Entity GameEngine::createProjectile(const char* spritePath, SDL_Point size, floa
 */
 void GameEngine::destroyProjectile(Entity e) {
 	if (this->projectilePool->collect(e)) {
+		// the pooled entity is reused by the next projectile
+		this->cancelEntityLifetime(e);
+
 		Sprite* sprite = this->spriteManager->getComponent(e);
 		sprite->setActive(false);
 
@@ -271,7 +402,7 @@ void GameEngine::setTilemap(const char* tilesetFilePath, const char* tilemapData
 		int tileHeight = tilemap->getTileHeight();
 		int tileWidth = tilemap->getTileWidth();
 		Tileset* tileset = this->renderSystem->getTileset();
-		unsigned int tilesetWidth = tileset->getTexture().textureWidth;
+		TileLayer spriteLayer = tilemap->getLayer(tilemap->getLayerCount() - 1);
 
 		for (size_t i = 0; i < objLayer.size(); i++) {
 			// checks if current x-position is greater or equals to max tilecount in row
@@ -280,26 +411,15 @@ void GameEngine::setTilemap(const char* tilesetFilePath, const char* tilemapData
 
 			int idxOffsetX = objLayer[i].x / tileWidth;
 
-			int dataIndex = (objLayer[i].y / tileHeight)*tilemap->getTilesPerRow() + idxOffsetX;
-			int tilemapData = tilemap->getLayer(tilemap->getLayerCount() - 1)[dataIndex];
+			size_t dataIndex = (size_t)(objLayer[i].y / tileHeight)*tilemap->getTilesPerRow() + idxOffsetX;
+			unsigned int tilemapData = (dataIndex < spriteLayer.size()) ? spriteLayer[dataIndex] : 0;
 
-			int srcX = 0;
-			int srcY = 0;
-			// check if first row tileWidth * maxWidth
-			if ((tilemapData * tileWidth) <= (tilesetWidth)) {
-				srcX = (tilemapData == 0) ? tilemapData * tileWidth : (tilemapData - 1) * tileWidth;
-			}
-			else {
-				// calculate row
-				unsigned int yoffset = (tilemapData * tileWidth) / (tilesetWidth);
-				unsigned int xoffset = ((tilemapData * tileWidth) % (tilesetWidth)) / tileWidth;
-
-				srcX = (xoffset == 0) ? xoffset * tileWidth : (xoffset - 1) * tileWidth;
-				srcY = yoffset * tileHeight;
-			}
+			// objects on empty tiles use the first tile of the tileset
+			const SDL_Rect* src = tileset->getTileRect(tilemapData);
+			SDL_Point srcPosition = (src != nullptr) ? SDL_Point{ src->x, src->y } : SDL_Point{ 0, 0 };
 
 			Entity e = this->addEntity("", false, { newX, newY });
-			Sprite* sprite = this->addSpriteComponent(e, "", {srcX, srcY}, { objLayer[i].w, objLayer[i].h }, 1.0f);
+			Sprite* sprite = this->addSpriteComponent(e, "", srcPosition, { objLayer[i].w, objLayer[i].h }, 1.0f);
 			sprite->setTexture(tileset->getTexture());
 		}
 	}
@@ -345,7 +465,7 @@ void GameEngine::playAudioFile(const char* path) {
 		this->audioSystem->playSound(clip);
 	}
 	else {
-		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Audio error", "Could not play audio clip.", NULL);
+		Log::error("Audio error", "Could not play audio clip.");
 	}
 }
 
@@ -355,16 +475,78 @@ void GameEngine::playAudioFile(const char* path) {
 * @param pos - Destination position.
 */
 void GameEngine::setEnemyDestination(Entity e, Position* pos) {
-	Node* dest = this->physicSystem->getCurrentNode(pos);
-	if (dest != nullptr) {
+	NodeIndex dest = this->physicSystem->getCurrentNode(pos);
+	if (dest != INVALID_NODE) {
 		EnemyMovement* component = enemyMovementManager->getComponent(e);
 		if (component != nullptr) {
 			component->setDestination(dest);
 			component->flag(true);
+			this->wakeEntity(e);
 		}
 	}
 }
 
+/**
+* @brief Checks if two entities see each other on the tilemap. Blocked tiles and static colliders block the sight. Used for the target selection of the game.
+* @param a - First entity.
+* @param b - Second entity.
+* @return Whether the entities see each other. false if an entity has no position or is outside of the tilemap.
+*/
+bool GameEngine::hasLineOfSight(Entity a, Entity b) {
+	Position* first = this->posManager->getComponent(a);
+	Position* second = this->posManager->getComponent(b);
+	if (first == nullptr || second == nullptr) return false;
+	return this->physicSystem->hasLineOfSight(first, second);
+}
+
+/**
+* @brief Creates a squad of enemies. Only the leader searches paths, the followers keep their formation slot around the leader and follow its trail around corners.
+* @param leader - Entity leading the squad.
+* @param followers - Entities following the leader.
+* @param formation - Formation of the followers.
+* @param spacing - Distance between the formation slots in pixels.
+* @return Index of the squad. Squad::NO_SQUAD if the leader has no enemy movement component.
+*/
+int GameEngine::createSquad(Entity leader, const std::vector<Entity>& followers, SQUAD_FORMATIONS formation, float spacing) {
+	// sleeping members would leave the formation behind
+	this->wakeEntity(leader);
+	for (size_t i = 0; i < followers.size(); i++) {
+		this->wakeEntity(followers[i]);
+	}
+	return this->physicSystem->createSquad(leader, followers, formation, spacing);
+}
+
+/**
+* @brief Disbands a squad. The followers search their own paths again.
+* @param squad - Index of the squad.
+*/
+void GameEngine::disbandSquad(int squad) {
+	this->physicSystem->disbandSquad(squad);
+}
+
+/**
+* @brief Sets the destination of a squad. Only the leader searches a path to the destination.
+* @param squad - Index of the squad.
+* @param pos - Destination position.
+*/
+void GameEngine::setSquadDestination(int squad, Position* pos) {
+	unsigned int leader = this->physicSystem->getSquadLeader(squad);
+	if (leader != 0) {
+		this->setEnemyDestination(Entity{ leader, "", false }, pos);
+	}
+}
+
+/**
+* @brief Changes a tile of a tile layer of the current tilemap. Colliders and objects of the tilemap are not changed.
+* @param layer - Index of the layer.
+* @param column - Column of the tile.
+* @param row - Row of the tile.
+* @param tile - New tile. 0 for an empty tile.
+*/
+void GameEngine::setTile(size_t layer, unsigned int column, unsigned int row, unsigned int tile) {
+	this->renderSystem->setTile(layer, column, row, tile);
+}
+
 /**
 * @brief Adds a sprite component to the entity.
 * @param e - Entity to add component to
@@ -381,7 +563,7 @@ Sprite* GameEngine::addSpriteComponent(Entity e, const char* filePath, SDL_Point
 		spriteComponent->setActive(true);
 	}
 	else {
-		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Component Initialization error", "Could not add sprite component.", NULL);
+		Log::error("Component Initialization error", "Could not add sprite component.");
 	}
 	return spriteComponent;
 }
@@ -403,7 +585,7 @@ Sprite* GameEngine::addSpriteComponent(Entity e, const char* filePath, SDL_Point
 		spriteComponent->setActive(true);
 	}
 	else {
-		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Component Initialization error", "Could not add sprite component.", NULL);
+		Log::error("Component Initialization error", "Could not add sprite component.");
 	}
 	return spriteComponent;
 }
@@ -425,7 +607,7 @@ Collider* GameEngine::addColliderComponent(Entity e, SDL_Point offset, SDL_Point
 		colliderComponent->setActive(true);
 	}
 	else {
-		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Component Initialization error", "Could not add collider component.", NULL);
+		Log::error("Component Initialization error", "Could not add collider component.");
 	}
 	return colliderComponent;
 }
@@ -442,7 +624,7 @@ Audio* GameEngine::addAudioComponent(Entity e) {
 		audioComponent->resetComponent();
 	}
 	else {
-		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Component Initialization error", "Could not add audio component.", NULL);
+		Log::error("Component Initialization error", "Could not add audio component.");
 	}
 	return audioComponent;
 }
@@ -460,7 +642,7 @@ size_t GameEngine::addAudioClip(Entity e, const char* filePath) {
 		size_t audioIndex = audioComponent->addAudioClip(filePath);
 		return audioIndex;
 	}
-	SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "AudioClip Initialization error", "Could not add audio clip to component.", NULL);
+	Log::error("AudioClip Initialization error", "Could not add audio clip to component.");
 	return SIZE_MAX;
 }
 
@@ -476,7 +658,7 @@ Animator* GameEngine::addAnimatorComponent(Entity e) {
 		animator->resetComponent();
 	}
 	else {
-		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Component Initialization error", "Could not add animator component.", NULL);
+		Log::error("Component Initialization error", "Could not add animator component.");
 	}
 	return animator;
 }
@@ -519,7 +701,7 @@ Health* GameEngine::addHealthComponent(Entity e, int maximumHealth) {
 		health->init(maximumHealth);
 	}
 	else {
-		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Component Initialization error", "Could not add health component.", NULL);
+		Log::error("Component Initialization error", "Could not add health component.");
 	}
 	return health;
 }
@@ -543,7 +725,7 @@ ProjectileMovement* GameEngine::addProjectileMovementComponent(Entity e, SDL_Poi
 		component->init(angle, projectileSpeed);
 	}
 	else {
-		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Component Initialization error", "Could not add projectile movement component.", NULL);
+		Log::error("Component Initialization error", "Could not add projectile movement component.");
 	}
 	return component;
 }
@@ -562,7 +744,7 @@ EnemyMovement* GameEngine::addEnemyMovementComponent(Entity e, float movementSpe
 		component->resetComponent();
 	}
 	else {
-		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Component Initialization error", "Could not add enemy movement component.", NULL);
+		Log::error("Component Initialization error", "Could not add enemy movement component.");
 	}
 	return component;
 }
@@ -580,7 +762,7 @@ EnemyMovement* GameEngine::addEnemyMovementComponent(Entity e, float movementSpe
 		component->setPathfindingTimer(pathfindingTimerMS);
 	}
 	else {
-		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Component Initialization error", "Could not add enemy movement component.", NULL);
+		Log::error("Component Initialization error", "Could not add enemy movement component.");
 	}
 	return component;
 }
@@ -599,7 +781,7 @@ EnemyMovement* GameEngine::addEnemyMovementComponent(Entity e, float movementSpe
 		component->setTarget(target);
 	}
 	else {
-		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Component Initialization error", "Could not add enemy movement component.", NULL);
+		Log::error("Component Initialization error", "Could not add enemy movement component.");
 	}
 	return component;
 }
@@ -619,7 +801,7 @@ EnemyMovement* GameEngine::addEnemyMovementComponent(Entity e, float movementSpe
 		component->setTarget(target);
 	}
 	else {
-		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Component Initialization error", "Could not add enemy movement component.", NULL);
+		Log::error("Component Initialization error", "Could not add enemy movement component.");
 	}
 	return component;
 }
@@ -713,6 +895,7 @@ EnemyMovement* GameEngine::getEnemyMovementComponent(Entity e){
 void GameEngine::initManagers() {
 	this->entityManager = new EntityManager();
 	this->inputManager = new InputManager();
+	this->frameArena = new FrameArena(FRAME_ARENA_SIZE);
 	this->uiManager = new UIManager(window->getRenderer(), inputManager);
 }
 
@@ -720,14 +903,14 @@ void GameEngine::initManagers() {
 * @brief Initializes the component manager of the game engine.
 */
 void GameEngine::initComponentManagers() {
-	this->spriteManager = new ComponentManager<Sprite>();
-	this->posManager = new ComponentManager<Position>();
-	this->animatorManager = new ComponentManager<Animator>();
-	this->audioManager = new ComponentManager<Audio>();
-	this->colliderManager = new ComponentManager<Collider>();
-	this->healthManager = new ComponentManager<Health>();
-	this->projectileMovementManager = new ComponentManager<ProjectileMovement>();
-	this->enemyMovementManager = new ComponentManager<EnemyMovement>();
+	this->spriteManager = new ComponentManager<Sprite>(componentCapacity);
+	this->posManager = new ComponentManager<Position>(componentCapacity);
+	this->animatorManager = new ComponentManager<Animator>(componentCapacity);
+	this->audioManager = new ComponentManager<Audio>(componentCapacity);
+	this->colliderManager = new ComponentManager<Collider>(componentCapacity);
+	this->healthManager = new ComponentManager<Health>(componentCapacity);
+	this->projectileMovementManager = new ComponentManager<ProjectileMovement>(componentCapacity);
+	this->enemyMovementManager = new ComponentManager<EnemyMovement>(componentCapacity);
 }
 
 /**
@@ -744,6 +927,7 @@ void GameEngine::initUniqueComponents() {
 void GameEngine::initObjectPools() {
 	if (this->debugDisableObjectPoolInit) return;
 	// init projectile pool
+	delete this->projectilePool;
 	this->projectilePool = new ObjectPool(this->entityManager, this->posManager);
 	this->projectilePool->init("projectile");
 }
@@ -762,6 +946,14 @@ void GameEngine::initSystems(int cameraWidth, int cameraHeight, bool debug) {
 	this->physicSystem = new PhysicSystem(inputManager, playerMovement, posManager, spriteManager, animatorManager, colliderManager, projectileMovementManager, enemyMovementManager);
 	this->physicSystem->setCameraZoom(this->renderSystem->getCameraZoomFactorX(), this->renderSystem->getCameraZoomFactorY());
 	this->physicSystem->initGrid(renderSystem->getTilemapNumberOfRows(), renderSystem->getTilemapNumberOfCols(), {renderSystem->getTileWidth(), renderSystem->getTileHeight()}, renderSystem->getTilesPerRow());
+	this->physicSystem->setPathfindingAlgorithm(this->pathfindingAlgorithm);
+	this->physicSystem->setPathfindingBudget(this->pathfindingBudgetMS);
+	this->physicSystem->setPathCacheCapacity(this->pathCacheCapacity);
+	this->physicSystem->setCrowdAvoidance(this->crowdAvoidance);
+	this->physicSystem->setAILevelOfDetail(this->aiLevelOfDetail);
+	this->physicSystem->setTimerWheel(&this->timers);
+	this->renderSystem->setRoutePool(this->physicSystem->getRoutePool());
+	this->timers.reset(SDL_GetTicks());
 
 	this->audioSystem = new AudioSystem(audioManager);
 	this->audioSystem->init();
@@ -777,6 +969,15 @@ void GameEngine::loadScene(Scene* scene, bool loopBGM) {
 	this->setTilemap(scene->getTilesetFilePath(), scene->getTilemapDataFilePath(), scene->getLayerCount());
 	this->setBGM(scene->getBGMFilePath(), loopBGM);
 	this->physicSystem->initGrid(renderSystem->getTilemapNumberOfRows(), renderSystem->getTilemapNumberOfCols(), { renderSystem->getTileWidth(), renderSystem->getTileHeight() }, renderSystem->getTilesPerRow());
+	this->setAILevelOfDetail(scene->getAILevelOfDetail());
+
+	// preserved entities wake up in the new scene
+	this->sleepGrid.collectAll(wakeRequests);
+	for (size_t i = 0; i < wakeRequests.size(); i++) {
+		this->setEntityAwake(Entity{ wakeRequests[i], "", false }, true);
+	}
+	wakeRequests.clear();
+	this->sleepGrid.init((int)(renderSystem->getTotalTilemapWidth() * renderSystem->getCameraZoomFactorX()), (int)(renderSystem->getTotalTilemapHeight() * renderSystem->getCameraZoomFactorY()));
 	scene->init();
 	
 }
@@ -797,14 +998,260 @@ void GameEngine::changeScene(Scene* scene, bool clearEveryEntity, bool loopBGM)
 }
 #pragma endregion Scene
 
+#pragma region Sleeping
+/**
+* @brief Wakes a sleeping entity. The entity is simulated and rendered again from the next frame on.
+* @param e - Entity to wake.
+*/
+void GameEngine::wakeEntity(Entity e) {
+	Position* position = this->posManager->getComponent(e);
+	if (position == nullptr) return;
+
+	if (!this->posManager->isAwake(e)) {
+		this->sleepGrid.remove(e.uid, { position->x(), position->y() });
+	}
+	wakeRequests.push_back(e.uid);
+}
+
+/**
+* @brief Puts an entity to sleep at the start of the next frame. Sleeping entities are skipped by the physics, animations and rendering until they are woken.
+* Entities close to the camera or to a moving collider are woken again, so the player and visible entities never sleep.
+* @param e - Entity to put to sleep.
+*/
+void GameEngine::sleepEntity(Entity e) {
+	sleepRequests.push_back(e.uid);
+}
+
+/**
+* @brief Checks if an entity is sleeping.
+* @param e - Entity to check.
+* @return Whether the entity is sleeping.
+*/
+bool GameEngine::isEntityAsleep(Entity e) {
+	return this->posManager->hasComponent(e) && !this->posManager->isAwake(e);
+}
+
+/**
+* @brief Puts the requested and idle entities far from the camera to sleep and wakes the requested entities and the entities close to the camera or a moving collider.
+* Called at the start of a frame, because changing the sleep state reorders the components.
+*/
+void GameEngine::updateSleeping() {
+	// requested entities were already removed from the sleep grid
+	for (size_t i = 0; i < wakeRequests.size(); i++) {
+		this->setEntityAwake(Entity{ wakeRequests[i], "", false }, true);
+	}
+	wakeRequests.clear();
+
+	SDL_Rect wakeArea = this->getWakeArea();
+	if (!simulationSleeping || wakeArea.w == 0) {
+		sleepRequests.clear();
+		this->sleepGrid.collectAll(wakeRequests);
+	}
+	else {
+		for (size_t i = 0; i < sleepRequests.size(); i++) {
+			Entity e = { sleepRequests[i], "", false };
+			if (this->posManager->isAwake(e) && e.uid != this->playerMovement->getEntity().uid && e.uid != this->cameraFollow->getEntity().uid) {
+				this->putToSleep(e);
+			}
+		}
+		sleepRequests.clear();
+
+		// idle entities are only searched every few frames, the awake entities are iterated backwards because sleeping ones move behind them
+		if (++framesSinceSleepCheck >= SLEEP_CHECK_INTERVAL) {
+			framesSinceSleepCheck = 0;
+			for (size_t i = this->posManager->getAwakeCount(); i > 0; i--) {
+				Position* position = this->posManager->getComponentWithIndex(i - 1);
+				SDL_Point point = { position->x(), position->y() };
+				Entity e = position->getEntity();
+				if (!SDL_PointInRect(&point, &wakeArea) && this->isEntityIdle(e)) {
+					this->putToSleep(e);
+				}
+			}
+		}
+
+		// sleeping entities close to the camera or a moving collider wake up
+		this->sleepGrid.collect(wakeArea, wakeRequests);
+		Collider* playerCollider = this->colliderManager->getComponent(this->playerMovement->getEntity());
+		if (playerCollider != nullptr && playerCollider->isActive()) {
+			this->sleepGrid.collect(*playerCollider->getColliderRect(), wakeRequests);
+		}
+		size_t projectileCount = this->projectileMovementManager->getAwakeCount();
+		for (size_t i = 0; i < projectileCount && this->sleepGrid.getCount() > 0; i++) {
+			ProjectileMovement* projectile = this->projectileMovementManager->getComponentWithIndex(i);
+			Collider* collider = this->colliderManager->getComponent(projectile->getEntity());
+			if (projectile->isActive() && collider != nullptr && collider->isActive()) {
+				this->sleepGrid.collect(*collider->getColliderRect(), wakeRequests);
+			}
+		}
+	}
+
+	for (size_t i = 0; i < wakeRequests.size(); i++) {
+		this->setEntityAwake(Entity{ wakeRequests[i], "", false }, true);
+	}
+	wakeRequests.clear();
+}
+
+/**
+* @brief Wakes the components of an entity or puts them to sleep.
+* @param e - Entity to change.
+* @param awake - Whether the components are awake.
+*/
+void GameEngine::setEntityAwake(Entity e, bool awake) {
+	this->posManager->setAwake(e, awake);
+	this->spriteManager->setAwake(e, awake);
+	this->animatorManager->setAwake(e, awake);
+	this->colliderManager->setAwake(e, awake);
+	this->projectileMovementManager->setAwake(e, awake);
+	this->enemyMovementManager->setAwake(e, awake);
+}
+
+/**
+* @brief Puts an awake entity to sleep and adds it to the sleep grid.
+* @param e - Entity to put to sleep.
+*/
+void GameEngine::putToSleep(Entity e) {
+	Position* position = this->posManager->getComponent(e);
+
+	// the collider may reach into the neighbouring cells of the position
+	int reach = 0;
+	Collider* collider = this->colliderManager->getComponent(e);
+	if (collider != nullptr) {
+		SDL_Rect* rect = collider->getColliderRect();
+		reach = std::max(std::max(std::abs(rect->x - position->x()), std::abs(rect->x + rect->w - position->x())),
+			std::max(std::abs(rect->y - position->y()), std::abs(rect->y + rect->h - position->y())));
+	}
+
+	// entities outside of the sleep grid would never be woken by their surroundings
+	if (this->sleepGrid.add(e.uid, { position->x(), position->y() }, reach)) {
+		this->setEntityAwake(e, false);
+	}
+}
+
+/**
+* @brief Checks if an entity has nothing to simulate. The player, the camera target, enemies with a destination and active projectiles are never idle.
+* @param e - Entity to check.
+* @return Whether the entity is idle.
+*/
+bool GameEngine::isEntityIdle(Entity e) {
+	if (e.uid == this->playerMovement->getEntity().uid || e.uid == this->cameraFollow->getEntity().uid) return false;
+
+	EnemyMovement* enemyMovement = this->enemyMovementManager->getComponent(e);
+	if (enemyMovement != nullptr && enemyMovement->isActive() && (enemyMovement->getDestination() != INVALID_NODE || enemyMovement->getSquad() != Squad::NO_SQUAD)) return false;
+
+	ProjectileMovement* projectileMovement = this->projectileMovementManager->getComponent(e);
+	return projectileMovement == nullptr || !projectileMovement->isActive();
+}
+
+/**
+* @brief Gets the area around the camera view in which entities are kept awake.
+* @return Area in world coordinates. Empty if the camera is not initialized.
+*/
+SDL_Rect GameEngine::getWakeArea() {
+	SDL_Rect camera = this->renderSystem->getCamera();
+	if (camera.w <= 0 || camera.h <= 0) return { 0,0,0,0 };
+	return { camera.x - sleepDistance, camera.y - sleepDistance, camera.w + 2 * sleepDistance, camera.h + 2 * sleepDistance };
+}
+#pragma endregion Sleeping
+
+#pragma region Timers
+/**
+* @brief Calls a function once after a delay. The function is called at the start of a frame.
+* @param delayMS - Delay in milliseconds.
+* @param callback - Function to call.
+* @return Handle of the timer, used to cancel it.
+*/
+TimerHandle GameEngine::addTimer(Uint32 delayMS, TimerWheel::timerFunction callback) {
+	if (callback == nullptr) {
+		Log::error("Timer error", "Could not add timer without a callback.");
+		return INVALID_TIMER;
+	}
+	return this->timers.schedule(delayMS, TIMER_EVENT_CALLBACK, 0, callback);
+}
+
+/**
+* @brief Cancels a timer before it fires.
+* @param handle - Handle of the timer.
+* @return Whether the timer was scheduled.
+*/
+bool GameEngine::cancelTimer(TimerHandle handle) {
+	return this->timers.cancel(handle);
+}
+
+/**
+* @brief Destroys an entity after a lifetime. Projectiles of the object pool are returned to the pool. Setting a new lifetime replaces the previous one.
+* @param e - Entity to destroy.
+* @param lifetimeMS - Milliseconds until the entity is destroyed.
+*/
+void GameEngine::setEntityLifetime(Entity e, Uint32 lifetimeMS) {
+	TimerHandle& handle = this->entityLifetimes[e.uid];
+	this->timers.cancel(handle);
+	handle = this->timers.schedule(lifetimeMS, TIMER_EVENT_LIFETIME, e.uid);
+}
+
+/**
+* @brief Cancels the lifetime of an entity. The entity is kept until it is destroyed.
+* @param e - Entity to keep.
+*/
+void GameEngine::cancelEntityLifetime(Entity e) {
+	std::unordered_map<unsigned int, TimerHandle>::iterator lifetime = this->entityLifetimes.find(e.uid);
+	if (lifetime == this->entityLifetimes.end()) return;
+
+	this->timers.cancel(lifetime->second);
+	this->entityLifetimes.erase(lifetime);
+}
+
+/**
+* @brief Advances the timers and handles the fired timers. Called at the start of a frame, because expired lifetimes destroy entities.
+*/
+void GameEngine::updateTimers() {
+	this->timers.advance(SDL_GetTicks());
+
+	// handlers may schedule new timers, they fire at the next advance
+	const std::vector<TimerWheel::Event>& events = this->timers.getFiredEvents();
+	for (size_t i = 0; i < events.size(); i++) {
+		TimerWheel::Event event = events[i];
+		Entity e = { event.uid, "", false };
+
+		switch (event.type) {
+			case TIMER_EVENT_CALLBACK:
+				event.callback();
+				break;
+			case TIMER_EVENT_PATHFINDING: {
+				EnemyMovement* movement = this->enemyMovementManager->getComponent(e);
+				if (movement != nullptr && movement->getPathfindingTimerHandle() == event.handle) {
+					movement->setPathfindingTimerHandle(INVALID_TIMER);
+					movement->flag(true);
+				}
+				break;
+			}
+			case TIMER_EVENT_LIFETIME: {
+				std::unordered_map<unsigned int, TimerHandle>::iterator lifetime = this->entityLifetimes.find(event.uid);
+				if (lifetime == this->entityLifetimes.end() || lifetime->second != event.handle) break;
+				this->entityLifetimes.erase(lifetime);
+
+				if (this->projectilePool != nullptr && this->projectilePool->contains(e)) {
+					this->destroyProjectile(e);
+				}
+				else {
+					this->destroyEntity(e);
+				}
+				break;
+			}
+			default:
+				break;
+		}
+	}
+	this->timers.clearFiredEvents();
+}
+#pragma endregion Timers
+
 #pragma region Garbage Collection
 /**
 * @brief Collects and frees the entities and component that should not be preserved when switching scenes.
 * @param collectEverything - Whether every Entity should be collected.
 */
 void GameEngine::collectSceneGarbage(bool collectEverything) {
-	std::vector<Entity> tempVector = {};
-	size_t vectorIndex = 0;
+	FrameVector<Entity> tempVector{ FrameAllocator<Entity>(this->frameArena) };
 
 	for (std::unordered_set<Entity>::iterator i = this->entityManager->getEntityBegin(); i != this->entityManager->getEntityEnd(); i++)
 	{
@@ -812,13 +1259,12 @@ void GameEngine::collectSceneGarbage(bool collectEverything) {
 		if (collectEverything || !e.preserve) {
 			this->removeEntityComponents(e);
 
-			tempVector.insert(tempVector.begin() + vectorIndex, e);
-			vectorIndex++;
+			tempVector.push_back(e);
 		}
 	}
 
 	// clean not preserved entities.
-	for (std::vector<Entity>::iterator i = tempVector.begin(); i != tempVector.end(); i++) {
+	for (FrameVector<Entity>::iterator i = tempVector.begin(); i != tempVector.end(); i++) {
 		this->entityManager->destroyEntity(*i);
 	}
 
@@ -845,6 +1291,10 @@ void GameEngine::resetLastCollisions() {
 void GameEngine::removeEntityComponents(Entity e) {
 	//  Clean components of entity.
 	if (this->posManager->hasComponent(e)) {
+		if (!this->posManager->isAwake(e)) {
+			Position* position = this->posManager->getComponent(e);
+			this->sleepGrid.remove(e.uid, { position->x(), position->y() });
+		}
 		this->posManager->removeComponent(e);
 	}
 
@@ -853,6 +1303,10 @@ void GameEngine::removeEntityComponents(Entity e) {
 	}
 
 	if (this->colliderManager->hasComponent(e)) {
+		// the removed slot is reused, so the occupied nodes are released first
+		if (this->physicSystem != nullptr) {
+			this->physicSystem->releaseCollider(this->colliderManager->getComponent(e));
+		}
 		this->colliderManager->removeComponent(e);
 	}
 
@@ -873,9 +1327,16 @@ void GameEngine::removeEntityComponents(Entity e) {
 	}
 
 	if (this->enemyMovementManager->hasComponent(e)) {
+		this->timers.cancel(this->enemyMovementManager->getComponent(e)->getPathfindingTimerHandle());
+		// the removed slot is reused, so the route is released first
+		if (this->physicSystem != nullptr) {
+			this->physicSystem->releaseRoute(this->enemyMovementManager->getComponent(e));
+		}
 		this->enemyMovementManager->removeComponent(e);
 	}
 
+	this->cancelEntityLifetime(e);
+
 	if (this->cameraFollow != nullptr && this->cameraFollow->getEntity().uid == e.uid) {
 		this->cameraFollow->setEntity({ 0, "", false });
 	}
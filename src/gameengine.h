@@ -10,7 +10,13 @@
 #include "util/window.h"
 #include "util/scene.h"
 #include "util/objectpool.h"
+#include "util/framearena.h"
+#include "util/memorytracker.h"
+#include "util/sleepgrid.h"
+#include "util/timerwheel.h"
+#include <unordered_map>
 #include <cmath>
+#include "util/log.h"
 /**
  * @brief Game Engine class. Used to initialize systems and managers aswell as start the gameloop.
 */
@@ -24,10 +30,9 @@ public:
 	}
 
 	/**
-	* @brief Default destructor of game engine.
+	* @brief Destructor of game engine. Deletes the systems, managers and the window. Used libraries stay initialized until quit() is called.
 	*/
-	~GameEngine() {
-	}
+	~GameEngine();
 
 	/**
 	 * @brief Initializes the game engine.
@@ -42,11 +47,37 @@ public:
 	*/
 	void init(int fps, std::string windowTitle, int windowWidth, int windowHeight, int cameraWidth, int cameraHeight, const char* iconFilePath, bool debug);
 
+	/**
+	 * @brief Initializes the game engine without display and audio device. Uses the dummy video and audio drivers of SDL and renders into a software surface. Errors are written to the log instead of being shown in a message box.
+	 * @param fps - Target frames per seconds of the simulation.
+	 * @param width - Width of the render surface.
+	 * @param height - Height of the render surface.
+	 * @param cameraWidth - Width of camera.
+	 * @param cameraHeight - Height of camera.
+	 * @param debug- Display position, collider and paths for debugging.
+	*/
+	void initHeadless(int fps, int width, int height, int cameraWidth, int cameraHeight, bool debug);
+
 	/**
 	 * @brief Runs the game engine. Starts the game loop.
 	*/
 	void run();
 
+	/**
+	 * @brief Runs a fixed number of game loop iterations without frame limiting. Used for headless simulations and benchmarks.
+	 * @param frameCount - Number of frames to run.
+	 * @return Number of frames that were run. Less than frameCount if the game loop was interrupted.
+	*/
+	size_t runFrames(size_t frameCount);
+
+	/**
+	 * @brief Checks if the game engine runs without display.
+	 * @return Whether the game engine runs headless.
+	*/
+	bool isHeadless() {
+		return window != nullptr && window->isHeadless();
+	}
+
 	/**
 	 * @brief Quits the game engine and used libraries.
 	*/
@@ -97,9 +128,10 @@ public:
 	 * @param target - Target position.
 	 * @param projectileSpeed - Projectile speed.
 	 * @param isCursorTarget - Whether the cursor position is the target position.
+	 * @param lifetimeMS - Milliseconds until the projectile is destroyed. 0 keeps the projectile until it is destroyed.
 	 * @return Projectile entity.
 	*/
-	Entity createProjectile(const char* spritePath, SDL_Point size, float scale, SDL_Point start, SDL_Point target, float projectileSpeed, bool isCursorTarget);
+	Entity createProjectile(const char* spritePath, SDL_Point size, float scale, SDL_Point start, SDL_Point target, float projectileSpeed, bool isCursorTarget, Uint32 lifetimeMS = 0);
 
 	/**
 	 * @brief Destroys projectile of projectile object pool.
@@ -134,6 +166,46 @@ public:
 	*/
 	void setEnemyDestination(Entity e, Position* pos);
 
+	/**
+	 * @brief Checks if two entities see each other on the tilemap. Blocked tiles and static colliders block the sight. Used for the target selection of the game.
+	 * @param a - First entity.
+	 * @param b - Second entity.
+	 * @return Whether the entities see each other. false if an entity has no position or is outside of the tilemap.
+	*/
+	bool hasLineOfSight(Entity a, Entity b);
+
+	/**
+	 * @brief Creates a squad of enemies. Only the leader searches paths, the followers keep their formation slot around the leader and follow its trail around corners.
+	 * @param leader - Entity leading the squad.
+	 * @param followers - Entities following the leader.
+	 * @param formation - Formation of the followers.
+	 * @param spacing - Distance between the formation slots in pixels.
+	 * @return Index of the squad. Squad::NO_SQUAD if the leader has no enemy movement component.
+	*/
+	int createSquad(Entity leader, const std::vector<Entity>& followers, SQUAD_FORMATIONS formation, float spacing);
+
+	/**
+	 * @brief Disbands a squad. The followers search their own paths again.
+	 * @param squad - Index of the squad.
+	*/
+	void disbandSquad(int squad);
+
+	/**
+	 * @brief Sets the destination of a squad. Only the leader searches a path to the destination.
+	 * @param squad - Index of the squad.
+	 * @param pos - Destination position.
+	*/
+	void setSquadDestination(int squad, Position* pos);
+
+	/**
+	 * @brief Changes a tile of a tile layer of the current tilemap. Colliders and objects of the tilemap are not changed.
+	 * @param layer - Index of the layer.
+	 * @param column - Column of the tile.
+	 * @param row - Row of the tile.
+	 * @param tile - New tile. 0 for an empty tile.
+	*/
+	void setTile(size_t layer, unsigned int column, unsigned int row, unsigned int tile);
+
 	/**
 	 * @brief Changes current scene.
 	 * @param scene - Scene to change to.
@@ -283,6 +355,62 @@ public:
 	*/
 	void setPosition(Entity e, SDL_Point pos);
 
+	/**
+	 * @brief Wakes a sleeping entity. The entity is simulated and rendered again from the next frame on.
+	 * @param e - Entity to wake.
+	*/
+	void wakeEntity(Entity e);
+
+	/**
+	 * @brief Puts an entity to sleep at the start of the next frame. Sleeping entities are skipped by the physics, animations and rendering until they are woken.
+	 * Entities close to the camera or to a moving collider are woken again, so the player and visible entities never sleep.
+	 * @param e - Entity to put to sleep.
+	*/
+	void sleepEntity(Entity e);
+
+	/**
+	 * @brief Checks if an entity is sleeping.
+	 * @param e - Entity to check.
+	 * @return Whether the entity is sleeping.
+	*/
+	bool isEntityAsleep(Entity e);
+
+	/**
+	 * @brief Gets the number of awake entities. The work per frame of the physics and rendering grows with this number instead of the number of entities.
+	 * @return Number of awake entities.
+	*/
+	size_t getAwakeEntityCount() {
+		return (this->posManager != nullptr) ? this->posManager->getAwakeCount() : 0;
+	}
+
+	/**
+	 * @brief Calls a function once after a delay. The function is called at the start of a frame.
+	 * @param delayMS - Delay in milliseconds.
+	 * @param callback - Function to call.
+	 * @return Handle of the timer, used to cancel it.
+	*/
+	TimerHandle addTimer(Uint32 delayMS, TimerWheel::timerFunction callback);
+
+	/**
+	 * @brief Cancels a timer before it fires.
+	 * @param handle - Handle of the timer.
+	 * @return Whether the timer was scheduled.
+	*/
+	bool cancelTimer(TimerHandle handle);
+
+	/**
+	 * @brief Destroys an entity after a lifetime. Projectiles of the object pool are returned to the pool. Setting a new lifetime replaces the previous one.
+	 * @param e - Entity to destroy.
+	 * @param lifetimeMS - Milliseconds until the entity is destroyed.
+	*/
+	void setEntityLifetime(Entity e, Uint32 lifetimeMS);
+
+	/**
+	 * @brief Cancels the lifetime of an entity. The entity is kept until it is destroyed.
+	 * @param e - Entity to keep.
+	*/
+	void cancelEntityLifetime(Entity e);
+
 	/**
 	 * @brief Gets sprite component of the entity.
 	 * @param e - Entity to get component off.
@@ -476,6 +604,104 @@ public:
 	void debugDisableObjectPools() {
 		this->debugDisableObjectPoolInit = true;
 	}
+
+	/**
+	 * @brief Sets the maximum number of components per component manager. Has to be called before the game engine is initialized.
+	 * @param capacity - Maximum number of components per component manager.
+	*/
+	void setComponentCapacity(size_t capacity) {
+		this->componentCapacity = capacity;
+	}
+
+	/**
+	 * @brief Sets the search algorithm of the enemy pathfinding. Jump point search is only used while every walkable tile has the same cost.
+	 * @param algorithm - Search algorithm.
+	*/
+	void setPathfindingAlgorithm(PATHFINDING_ALGORITHMS algorithm) {
+		this->pathfindingAlgorithm = algorithm;
+		if (this->physicSystem != nullptr) {
+			this->physicSystem->setPathfindingAlgorithm(algorithm);
+		}
+	}
+
+	/**
+	 * @brief Sets the time budget per frame for the path requests of enemies. Requests that do not fit into the budget are solved in the next frames, enemies keep following their old route meanwhile.
+	 * @param budgetMS - Time budget in milliseconds. 0 solves every request in the frame it was made.
+	*/
+	void setPathfindingBudget(float budgetMS) {
+		this->pathfindingBudgetMS = budgetMS;
+		if (this->physicSystem != nullptr) {
+			this->physicSystem->setPathfindingBudget(budgetMS);
+		}
+	}
+
+	/**
+	 * @brief Sets whether enemies steer around each other with local avoidance instead of searching a new path whenever another enemy stands on their route.
+	 * @param enabled - Whether the local avoidance is enabled.
+	*/
+	void setCrowdAvoidance(bool enabled) {
+		this->crowdAvoidance = enabled;
+		if (this->physicSystem != nullptr) {
+			this->physicSystem->setCrowdAvoidance(enabled);
+		}
+	}
+
+	/**
+	 * @brief Sets the maximum number of paths cached for reuse. Enemies asking for the same destination reuse the rest of a cached path passing their position instead of searching.
+	 * @param capacity - Maximum number of cached paths. 0 disables the cache.
+	*/
+	void setPathCacheCapacity(size_t capacity) {
+		this->pathCacheCapacity = capacity;
+		if (this->physicSystem != nullptr) {
+			this->physicSystem->setPathCacheCapacity(capacity);
+		}
+	}
+
+	/**
+	 * @brief Sets the level of detail of the enemy movement in the current scene. Enemies far from the camera are updated less often. Loading a scene applies the level of detail of the scene.
+	 * @param settings - Distances and update intervals of the tiers.
+	*/
+	void setAILevelOfDetail(AILevelOfDetail settings) {
+		this->aiLevelOfDetail = settings;
+		if (this->physicSystem != nullptr) {
+			this->physicSystem->setAILevelOfDetail(settings);
+		}
+	}
+
+	/**
+	 * @brief Gets the number of enemies per level of detail tier and how many of them were updated in the last frame.
+	 * @return Counters of the last frame.
+	*/
+	AILevelOfDetailStats getAILevelOfDetailStats() {
+		return (this->physicSystem != nullptr) ? this->physicSystem->getAILevelOfDetailStats() : AILevelOfDetailStats();
+	}
+
+	/**
+	 * @brief Sets whether idle entities far from the camera are put to sleep automatically. Entities are idle unless they are an enemy with a destination or an active projectile.
+	 * Enemies waiting for their target only notice it while they are awake, so the sleep distance should be larger than their maximum distance to the target.
+	 * @param enabled - Whether idle entities sleep. Disabling wakes every sleeping entity.
+	*/
+	void setSimulationSleeping(bool enabled) {
+		this->simulationSleeping = enabled;
+	}
+
+	/**
+	 * @brief Sets the distance to the camera view from which idle entities are put to sleep. Sleeping entities within the distance are woken.
+	 * @param distance - Distance in pixels.
+	*/
+	void setSleepDistance(int distance) {
+		this->sleepDistance = distance;
+	}
+
+	/**
+	 * @brief Notifies the enemy pathfinding that the walkable area inside of the area changed. Colliders are tracked automatically and do not need a notification.
+	 * @param area - Changed area in world coordinates.
+	*/
+	void updateStaticObstacles(SDL_Rect area) {
+		if (this->physicSystem != nullptr) {
+			this->physicSystem->updateStaticObstacles(area);
+		}
+	}
 private:
 	/**
 	 * @brief Delay between frames.
@@ -514,6 +740,97 @@ private:
 	ObjectPool* projectilePool = nullptr;
 	bool debugDisableObjectPoolInit = false;
 
+	/**
+	 * @brief Maximum number of components per component manager.
+	*/
+	size_t componentCapacity = 1024;
+
+	/**
+	 * @brief Search algorithm of the enemy pathfinding.
+	*/
+	PATHFINDING_ALGORITHMS pathfindingAlgorithm = PATHFINDING_ASTAR;
+
+	/**
+	 * @brief Time budget per frame for the path requests of enemies in milliseconds.
+	*/
+	float pathfindingBudgetMS = PathService::DEFAULT_BUDGET_MS;
+
+	/**
+	 * @brief Maximum number of cached paths of the enemy pathfinding.
+	*/
+	size_t pathCacheCapacity = PathCache::DEFAULT_CAPACITY;
+
+	/**
+	 * @brief Whether enemies steer around each other with local avoidance.
+	*/
+	bool crowdAvoidance = true;
+
+	/**
+	 * @brief Level of detail of the enemy movement.
+	*/
+	AILevelOfDetail aiLevelOfDetail;
+
+	/**
+	 * @brief Frames between the checks for idle entities to put to sleep.
+	*/
+	static const size_t SLEEP_CHECK_INTERVAL = 30;
+
+	/**
+	 * @brief Whether idle entities far from the camera are put to sleep automatically.
+	*/
+	bool simulationSleeping = true;
+
+	/**
+	 * @brief Distance in pixels to the camera view from which idle entities are put to sleep.
+	*/
+	int sleepDistance = 512;
+
+	/**
+	 * @brief Number of frames since the last check for idle entities.
+	*/
+	size_t framesSinceSleepCheck = 0;
+
+	/**
+	 * @brief Sleeping entities by position.
+	*/
+	SleepGrid sleepGrid;
+
+	/**
+	 * @brief Entities to wake at the start of the next frame.
+	*/
+	std::vector<unsigned int> wakeRequests;
+
+	/**
+	 * @brief Entities to put to sleep at the start of the next frame.
+	*/
+	std::vector<unsigned int> sleepRequests;
+
+	/**
+	 * @brief Timers of the engine and the game: pathfinding timers, entity lifetimes and callbacks.
+	*/
+	TimerWheel timers;
+
+	/**
+	 * @brief Lifetime timer per entity uid.
+	*/
+	std::unordered_map<unsigned int, TimerHandle> entityLifetimes;
+
+	/**
+	 * @brief Initial size of the frame arena in bytes.
+	*/
+	static const size_t FRAME_ARENA_SIZE = 1024 * 1024;
+
+	/**
+	 * @brief Arena for transient data of the current frame. Reset at the end of each frame.
+	*/
+	FrameArena* frameArena = nullptr;
+
+	/**
+	 * @brief Executes one iteration of the game loop.
+	 * @return Whether the game loop should continue.
+	*/
+	bool runFrame();
+
 	/**
 	 * @brief Initializes the managers of the game engine.
 	*/
@@ -574,6 +891,43 @@ private:
 	*/
 	void removeEntityComponents(Entity e);
 
+	/**
+	 * @brief Advances the timers and handles the fired timers. Called at the start of a frame, because expired lifetimes destroy entities.
+	*/
+	void updateTimers();
+
+	/**
+	 * @brief Puts the requested and idle entities far from the camera to sleep and wakes the requested entities and the entities close to the camera or a moving collider.
+	 * Called at the start of a frame, because changing the sleep state reorders the components.
+	*/
+	void updateSleeping();
+
+	/**
+	 * @brief Wakes the components of an entity or puts them to sleep.
+	 * @param e - Entity to change.
+	 * @param awake - Whether the components are awake.
+	*/
+	void setEntityAwake(Entity e, bool awake);
+
+	/**
+	 * @brief Puts an awake entity to sleep and adds it to the sleep grid.
+	 * @param e - Entity to put to sleep.
+	*/
+	void putToSleep(Entity e);
+
+	/**
+	 * @brief Checks if an entity has nothing to simulate. The player, the camera target, enemies with a destination and active projectiles are never idle.
+	 * @param e - Entity to check.
+	 * @return Whether the entity is idle.
+	*/
+	bool isEntityIdle(Entity e);
+
+	/**
+	 * @brief Gets the area around the camera view in which entities are kept awake.
+	 * @return Area in world coordinates. Empty if the camera is not initialized.
+	*/
+	SDL_Rect getWakeArea();
+
 	/**
 	 * @brief Calculates the angle of the vector a->b in the unit circle.
 	 * @param a - Point a
@@ -4,6 +4,7 @@
 */
 void InputManager::update() {
 	mouseButton = -1;
+	renderTargetsReset = false;
 	checkForEvent();
 	setCurrentMousePosition();
 }
@@ -19,6 +20,9 @@ void InputManager::checkForEvent() {
 		case SDL_QUIT:
 			interrupted = true;
 			break;
+		case SDL_RENDER_TARGETS_RESET:
+			renderTargetsReset = true;
+			break;
 		case SDL_MOUSEBUTTONDOWN:
 			// mouse click
 			mouseButton = inputEvent.button.button;
@@ -21,6 +21,11 @@ public:
 	*/
 	bool interrupted;
 
+	/**
+	 * @brief If the renderer lost the content of its render target textures since the last update.
+	*/
+	bool renderTargetsReset = false;
+
 	/**
 	 * @brief Gets the direction.
 	 * @return Current direction.
@@ -0,0 +1,225 @@
+#include "stressscene.h"
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+/**
+* @brief Initialization function of the generated scene. The entities are spawned by the stress scene after the scene was loaded.
+*/
+static void initStressScene() {}
+
+/**
+* @brief Creates settings that scale the scene with the number of enemies. Projectiles and colliders grow with the enemies and the tilemap keeps the entity density constant.
+* @param enemyCount - Number of enemies.
+* @param seed - Seed of the random generator.
+* @return Settings of the scaled scene.
+*/
+StressSceneSettings StressSceneSettings::scaled(size_t enemyCount, unsigned int seed) {
+	StressSceneSettings result;
+	result.seed = seed;
+	result.enemyCount = enemyCount;
+	result.projectileCount = enemyCount / 10;
+	result.colliderCount = enemyCount / 10;
+
+	// about four tiles per enemy and collider
+	int size = (int)std::ceil(std::sqrt((double)(result.enemyCount + result.colliderCount) * 4.0));
+	result.tilemapWidth = (size < 64) ? 64 : size;
+	result.tilemapHeight = result.tilemapWidth;
+	return result;
+}
+
+/**
+* @brief Creates stress scene.
+* @param settings - Settings of the scene.
+* @param filePrefix - Prefix of the generated files.
+*/
+StressScene::StressScene(const StressSceneSettings& settings, const char* filePrefix) : settings{ settings } {
+	this->tilemapPath = std::string(filePrefix) + "_tilemap.json";
+	this->tilesetPath = std::string(filePrefix) + "_tileset.bmp";
+	this->spritePath = std::string(filePrefix) + "_sprite.bmp";
+}
+
+/**
+* @brief Destructor of the stress scene. Removes the generated files.
+*/
+StressScene::~StressScene() {
+	std::remove(tilemapPath.c_str());
+	std::remove(tilesetPath.c_str());
+	std::remove(spritePath.c_str());
+}
+
+/**
+* @brief Gets the number of components per component manager needed by the scene.
+* @return Needed component capacity.
+*/
+size_t StressScene::getComponentCapacity() {
+	return settings.enemyCount + settings.projectileCount + settings.colliderCount + RESERVED_COMPONENTS;
+}
+
+/**
+* @brief Generates the scene in the game engine. Replaces every entity of the current scene.
+* @param engine - Initialized game engine. The component capacity of the engine has to be at least getComponentCapacity().
+* @return Whether the scene was generated.
+*/
+bool StressScene::generate(GameEngine* engine) {
+	size_t cellCount = (size_t)settings.tilemapWidth * settings.tilemapHeight;
+	if (settings.tilemapWidth < 1 || settings.tilemapHeight < 1 || settings.enemyCount + settings.colliderCount + 1 > cellCount) {
+		Log::error("Stress scene error", "The tilemap is too small for the enemies and colliders.");
+		return false;
+	}
+	if (engine->getPositionManager()->getCapacity() < this->getComponentCapacity()) {
+		Log::error("Stress scene error", "The component capacity of the game engine is too small for the stress scene.");
+		return false;
+	}
+
+	std::mt19937 random(settings.seed);
+	std::uniform_int_distribution<size_t> cellDistribution(0, cellCount - 1);
+	std::vector<bool> occupied(cellCount, false);
+	int tileSize = settings.tileSize;
+
+	// player starts in the center
+	size_t playerCell = (size_t)(settings.tilemapHeight / 2) * settings.tilemapWidth + settings.tilemapWidth / 2;
+	occupied[playerCell] = true;
+
+	// static colliders on free cells
+	std::vector<SDL_Rect> colliders;
+	colliders.reserve(settings.colliderCount);
+	while (colliders.size() < settings.colliderCount) {
+		size_t cell = cellDistribution(random);
+		if (occupied[cell]) continue;
+
+		occupied[cell] = true;
+		int x = (int)(cell % settings.tilemapWidth);
+		int y = (int)(cell / settings.tilemapWidth);
+		colliders.push_back({ x * tileSize, y * tileSize, tileSize, tileSize });
+	}
+
+	if (!writeTilemapFile(tilemapPath.c_str(), settings.tilemapWidth, settings.tilemapHeight, tileSize, TILESET_TILES_PER_ROW * TILESET_TILES_PER_ROW, colliders)
+		|| !writeTilesetFile(tilesetPath.c_str(), TILESET_TILES_PER_ROW, tileSize)
+		|| !writeTilesetFile(spritePath.c_str(), 1, tileSize)) {
+		Log::error("Stress scene error", "Could not write the files of the stress scene.");
+		return false;
+	}
+
+	// load tilemap and colliders
+	Scene scene(tilesetPath.c_str(), tilemapPath.c_str(), colliders.empty() ? 1 : 2, nullptr, initStressScene);
+	engine->changeScene(&scene, true, false);
+
+	// player
+	SDL_Point playerPosition = { (int)(playerCell % settings.tilemapWidth) * tileSize + tileSize / 2, (int)(playerCell / settings.tilemapWidth) * tileSize + tileSize / 2 };
+	this->player = engine->addPlayer("player", false, playerPosition, 2);
+	this->addActorComponents(engine, player);
+	engine->setCameraFollowTarget(player);
+
+	// enemies on free cells
+	for (size_t i = 0; i < settings.enemyCount; i++) {
+		size_t cell = cellDistribution(random);
+		while (occupied[cell]) {
+			cell = cellDistribution(random);
+		}
+		occupied[cell] = true;
+
+		SDL_Point position = { (int)(cell % settings.tilemapWidth) * tileSize + tileSize / 2, (int)(cell / settings.tilemapWidth) * tileSize + tileSize / 2 };
+		Entity enemy = engine->addEntity("enemy", false, position);
+		this->addActorComponents(engine, enemy);
+
+		EnemyMovement* movement = engine->addEnemyMovementComponent(enemy, settings.enemyMovementSpeed, settings.pathfindingTimerMS, player);
+		movement->setMaxDistance(settings.enemyMaxDistance);
+		movement->setFlowField(settings.useFlowField);
+	}
+
+	// projectiles between random points of the tilemap
+	int totalWidth = settings.tilemapWidth * tileSize;
+	int totalHeight = settings.tilemapHeight * tileSize;
+	std::uniform_int_distribution<int> xDistribution(0, totalWidth - 1);
+	std::uniform_int_distribution<int> yDistribution(0, totalHeight - 1);
+	std::uniform_real_distribution<float> speedDistribution(1.0f, 4.0f);
+	int projectileSize = tileSize / 2;
+
+	for (size_t i = 0; i < settings.projectileCount; i++) {
+		SDL_Point start = { xDistribution(random), yDistribution(random) };
+		SDL_Point target = { xDistribution(random), yDistribution(random) };
+
+		Entity projectile = engine->addEntity("projectile", false, start);
+		engine->addSpriteComponent(projectile, spritePath.c_str(), { projectileSize, projectileSize }, 1.0f);
+		engine->addColliderComponent(projectile, { 0,0 }, { projectileSize, projectileSize }, true);
+		engine->addProjectileMovementComponent(projectile, start, target, speedDistribution(random), false);
+	}
+	return true;
+}
+
+/**
+* @brief Adds sprite, animator with movement animations and collider to a player or enemy entity.
+* @param engine - Game engine of the scene.
+* @param e - Entity to add the components to.
+*/
+void StressScene::addActorComponents(GameEngine* engine, Entity e) {
+	int tileSize = settings.tileSize;
+	engine->addSpriteComponent(e, spritePath.c_str(), { tileSize, tileSize }, 1.0f);
+
+	// every state the physic system switches to needs an animation
+	engine->addAnimatorComponent(e);
+	for (size_t state = STATES::IDLE_SIDE; state <= STATES::WALK_DOWN; state++) {
+		engine->addAnimation(e, state, 1, 100);
+	}
+
+	engine->addColliderComponent(e, { 0,0 }, { tileSize, tileSize }, false);
+}
+
+/**
+* @brief Writes a tiled compatible tilemap json file with a ground layer and an optional collision layer.
+* @param path - Output path.
+* @param width - Tiles per row.
+* @param height - Tiles per column.
+* @param tileSize - Width and height of each tile.
+* @param tilesetTiles - Number of tiles in the tileset.
+* @param colliders - Colliders of the collision layer. The collision layer is only written if there are colliders.
+* @return Whether the file was written.
+*/
+bool StressScene::writeTilemapFile(const char* path, unsigned int width, unsigned int height, unsigned int tileSize, unsigned int tilesetTiles, const std::vector<SDL_Rect>& colliders) {
+	std::vector<unsigned int> data(width * height);
+	for (size_t i = 0; i < data.size(); i++) {
+		data[i] = (unsigned int)(i % tilesetTiles) + 1;
+	}
+
+	json tilemap;
+	tilemap["tilewidth"] = tileSize;
+	tilemap["tileheight"] = tileSize;
+	tilemap["width"] = width;
+	tilemap["height"] = height;
+	tilemap["layers"] = json::array();
+	tilemap["layers"].push_back({ { "name", "Ground" }, { "type", "tilelayer" }, { "data", data } });
+
+	if (!colliders.empty()) {
+		json objects = json::array();
+		for (size_t i = 0; i < colliders.size(); i++) {
+			objects.push_back({ { "x", colliders[i].x }, { "y", colliders[i].y }, { "width", colliders[i].w }, { "height", colliders[i].h } });
+		}
+		tilemap["layers"].push_back({ { "name", "Collision" }, { "type", "objectgroup" }, { "objects", objects } });
+	}
+
+	std::ofstream file(path);
+	if (!file.is_open()) {
+		return false;
+	}
+	file << tilemap.dump();
+	return true;
+}
+
+/**
+* @brief Writes a tileset image with the given number of tiles per row and column.
+* @param path - Output path.
+* @param tilesPerRow - Tiles per row and column of the tileset.
+* @param tileSize - Width and height of each tile.
+* @return Whether the file was written.
+*/
+bool StressScene::writeTilesetFile(const char* path, int tilesPerRow, int tileSize) {
+	SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, tilesPerRow * tileSize, tilesPerRow * tileSize, 32, SDL_PIXELFORMAT_RGBA8888);
+	if (surface == nullptr) {
+		return false;
+	}
+	SDL_FillRect(surface, NULL, SDL_MapRGBA(surface->format, 40, 120, 40, 255));
+	bool success = SDL_SaveBMP(surface, path) == 0;
+	SDL_FreeSurface(surface);
+	return success;
+}
@@ -0,0 +1,179 @@
+#pragma once
+#include "gameengine.h"
+#include <string>
+#include <vector>
+
+/**
+ * @brief Settings of a generated stress scene. The same settings always generate the same scene.
+*/
+struct StressSceneSettings {
+	/**
+	 * @brief Seed of the random generator placing the entities.
+	*/
+	unsigned int seed = 1;
+
+	/**
+	 * @brief Number of tiles per row.
+	*/
+	int tilemapWidth = 64;
+
+	/**
+	 * @brief Number of tiles per column.
+	*/
+	int tilemapHeight = 64;
+
+	/**
+	 * @brief Width and height of each tile.
+	*/
+	int tileSize = 16;
+
+	/**
+	 * @brief Number of enemies targeting the player.
+	*/
+	size_t enemyCount = 100;
+
+	/**
+	 * @brief Number of moving projectiles.
+	*/
+	size_t projectileCount = 0;
+
+	/**
+	 * @brief Number of static colliders in the collision layer of the tilemap.
+	*/
+	size_t colliderCount = 0;
+
+	/**
+	 * @brief Movement speed of the enemies.
+	*/
+	float enemyMovementSpeed = 1.0f;
+
+	/**
+	 * @brief Timer how often the enemies calculate their path.
+	*/
+	int pathfindingTimerMS = 3000;
+
+	/**
+	 * @brief Maximum distance in tiles at which enemies start following the player.
+	*/
+	int enemyMaxDistance = 10;
+
+	/**
+	 * @brief Whether the enemies follow the shared flow field instead of searching their own path.
+	*/
+	bool useFlowField = false;
+
+	/**
+	 * @brief Creates settings that scale the scene with the number of enemies. Projectiles and colliders grow with the enemies and the tilemap keeps the entity density constant.
+	 * @param enemyCount - Number of enemies.
+	 * @param seed - Seed of the random generator.
+	 * @return Settings of the scaled scene.
+	*/
+	static StressSceneSettings scaled(size_t enemyCount, unsigned int seed);
+};
+
+/**
+ * @brief Generates reproducible scenes with a configurable number of enemies, projectiles and static colliders to measure how the engine scales.
+ * The tilemap, tileset and sprite files of the scene are written on generation and removed when the stress scene is deleted.
+*/
+class StressScene {
+public:
+	/**
+	 * @brief Creates stress scene.
+	 * @param settings - Settings of the scene.
+	 * @param filePrefix - Prefix of the generated files.
+	*/
+	StressScene(const StressSceneSettings& settings, const char* filePrefix = "stress_scene");
+
+	/**
+	 * @brief Destructor of the stress scene. Removes the generated files.
+	*/
+	~StressScene();
+
+	/**
+	 * @brief Generates the scene in the game engine. Replaces every entity of the current scene.
+	 * @param engine - Initialized game engine. The component capacity of the engine has to be at least getComponentCapacity().
+	 * @return Whether the scene was generated.
+	*/
+	bool generate(GameEngine* engine);
+
+	/**
+	 * @brief Gets the number of components per component manager needed by the scene.
+	 * @return Needed component capacity.
+	*/
+	size_t getComponentCapacity();
+
+	/**
+	 * @brief Gets the player entity of the generated scene.
+	 * @return Player entity.
+	*/
+	Entity getPlayer() { return player; }
+
+	/**
+	 * @brief Gets the settings of the scene.
+	 * @return Settings of the scene.
+	*/
+	const StressSceneSettings& getSettings() { return settings; }
+
+	/**
+	 * @brief Writes a tiled compatible tilemap json file with a ground layer and an optional collision layer.
+	 * @param path - Output path.
+	 * @param width - Tiles per row.
+	 * @param height - Tiles per column.
+	 * @param tileSize - Width and height of each tile.
+	 * @param tilesetTiles - Number of tiles in the tileset.
+	 * @param colliders - Colliders of the collision layer. The collision layer is only written if there are colliders.
+	 * @return Whether the file was written.
+	*/
+	static bool writeTilemapFile(const char* path, unsigned int width, unsigned int height, unsigned int tileSize, unsigned int tilesetTiles, const std::vector<SDL_Rect>& colliders);
+
+	/**
+	 * @brief Writes a tileset image with the given number of tiles per row and column.
+	 * @param path - Output path.
+	 * @param tilesPerRow - Tiles per row and column of the tileset.
+	 * @param tileSize - Width and height of each tile.
+	 * @return Whether the file was written.
+	*/
+	static bool writeTilesetFile(const char* path, int tilesPerRow, int tileSize);
+private:
+	/**
+	 * @brief Components reserved for the player and the projectile object pool.
+	*/
+	static const size_t RESERVED_COMPONENTS = 128;
+
+	/**
+	 * @brief Tiles per row and column of the generated tileset.
+	*/
+	static const int TILESET_TILES_PER_ROW = 8;
+
+	/**
+	 * @brief Settings of the scene.
+	*/
+	StressSceneSettings settings;
+
+	/**
+	 * @brief File path of the generated tilemap.
+	*/
+	std::string tilemapPath;
+
+	/**
+	 * @brief File path of the generated tileset.
+	*/
+	std::string tilesetPath;
+
+	/**
+	 * @brief File path of the generated sprite used by every entity.
+	*/
+	std::string spritePath;
+
+	/**
+	 * @brief Player entity of the generated scene.
+	*/
+	Entity player = { 0, "", false };
+
+	/**
+	 * @brief Adds sprite, animator with movement animations and collider to a player or enemy entity.
+	 * @param engine - Game engine of the scene.
+	 * @param e - Entity to add the components to.
+	*/
+	void addActorComponents(GameEngine* engine, Entity e);
+};
@@ -39,7 +39,7 @@ void AudioSystem::update() {
 void AudioSystem::init() {
 	// initializes SDL_mixer with frequency of 44100, default sample format, 8 hardware channels and 2048 byte chunk size
 	if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 8, 2048) < 0) {
-		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "SDL Mixer Error", "Could not initialize SDL Mixer!", NULL);
+		Log::error("SDL Mixer Error", "Could not initialize SDL Mixer!");
 	}
 }
 
@@ -50,7 +50,7 @@ void AudioSystem::init() {
 void AudioSystem::addBGM(const char* filePath) {
 	bgm = Mix_LoadMUS(filePath);
 	if (bgm == NULL) {
-		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "SDL Mixer Error", "Could not load background music file!", NULL);
+		Log::error("SDL Mixer Error", "Could not load background music file!");
 	}
 }
 
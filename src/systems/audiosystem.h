@@ -2,6 +2,7 @@
 #include "gamesystem.h"
 #include "../componentmanager.h"
 #include "../components/components.h"
+#include "../util/log.h"
 /**
  * @brief Audio system to manage the ingame audio.
 */
@@ -4,6 +4,11 @@
 */
 class GameSystem {
 public:
+	/**
+	 * @brief Virtual destructor, so game systems can be deleted through the base class.
+	*/
+	virtual ~GameSystem() {}
+
 	/**
 	 * @brief Virtual function that initializes the game system.
 	*/
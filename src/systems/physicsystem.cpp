@@ -1,4 +1,5 @@
 #include "physicsystem.h"
+#include <algorithm>
 /**
 * @brief Constructor of physic system to set needed references.
 * @param inputManager - Input manager to handle user inputs.
@@ -26,6 +27,7 @@ PhysicSystem::PhysicSystem(InputManager* inputManager, Movement* playerMovement,
 * @brief Render system update loop. Iterates over every movement component and changes the position component of the same entity. 
 */
 void PhysicSystem::update() {
+	updateOccupancy();
 	handleEnemyMovement();
 	handlePlayerMovement();
 	handleProjectileMovement();
@@ -47,70 +49,23 @@ void PhysicSystem::initGrid(int row, int col, SDL_Point tileSize, int tilesPerRo
 	this->tileHeight = (int)(tileSize.y*cameraZoomY);
 	this->tilesPerRow = tilesPerRow;
 
-	if (row < 1 || col < 1) {
-		return;
-	}
-
-	nodes = new Node[this->row*this->col];
-	for (int x = 0; x < row; x++)
-	{
-		for (int y = 0; y < col; y++)
-		{
-			nodes[y * row + x].x = x;
-			nodes[y * row + x].y = y;
-			nodes[y * row + x].visited = false;
-			nodes[y * row + x].parent = nullptr;
-			nodeCount++;
-		}
+	// rows are the height and columns the width of the tilemap
+	grid.init(col, row);
+	hierarchicalGrid.init(col, row);
+	pathBuffer.reserve(grid.getNodeCount());
+	crowd.init(col * tileWidth, row * tileHeight, CROWD_NEIGHBOUR_TILES * std::max(tileWidth, tileHeight));
+	pathService.clear();
+	pathCache.clear();
+	for (size_t i = 0; i < MAX_INCREMENTAL_PLANNERS; i++) {
+		planners[i].planner.reset();
+		planners[i].assigned = false;
 	}
+	this->invalidateFlowFields();
 
-	// determine neighbours
-	for (int x = 0; x < row; x++)
-	{
-		for (int y = 0; y < col; y++)
-		{
-			// left
-			if (x > 0) {
-				nodes[y * row + x].neighbours.push_back(&nodes[y * row + (x - 1)]);
-
-				// top
-				if (y > 0) {
-					nodes[y * row + x].neighbours.push_back(&nodes[(y - 1) * row + (x-1)]);
-				}
-
-				//down
-				if (y < (col - 1)) {
-					nodes[y * row + x].neighbours.push_back(&nodes[(y + 1) * row + (x-1)]);
-				}
-			}
-
-			// right
-			if (x < (row - 1)) {
-				nodes[y * row + x].neighbours.push_back(&nodes[y * row + (x + 1)]);
-
-				// top
-				if (y > 0) {
-					nodes[y * row + x].neighbours.push_back(&nodes[(y - 1) * row + (x + 1)]);
-				}
-
-				//down
-				if (y < (col - 1)) {
-					nodes[y * row + x].neighbours.push_back(&nodes[(y + 1) * row + (x + 1)]);
-				}
-			}
-
-			// top
-			if (y > 0) {
-				nodes[y * row + x].neighbours.push_back(&nodes[(y-1) * row + x ]);
-			}
-
-			//down
-			if (y < (col) - 1) {
-				nodes[y * row + x].neighbours.push_back(&nodes[(y + 1) * row + x]);
-			}
-		}
-	}
+	// every collider occupies the new grid at the next update
+	occupancyGeneration++;
 }
+
 /**
 * @brief Handles the player movement each frame.
 */
@@ -240,7 +195,7 @@ void PhysicSystem::controlAnimationStates(Entity e, Vector2* direction, bool che
 * @brief Handles the movement of projectiles.
 */
 void PhysicSystem::handleProjectileMovement() {
-	size_t componentCount = this->projManager->getComponentCount();
+	size_t componentCount = this->projManager->getAwakeCount();
 
 	for (size_t i = 0; i < componentCount; i++)
 	{
@@ -260,45 +215,96 @@ void PhysicSystem::handleProjectileMovement() {
 */
 void PhysicSystem::handleEnemyMovement() {
 	// TODO: handle fps drops when no path was found
-	size_t componentCount = this->enemyMovementManager->getComponentCount();
-	Uint32 newTimestamp = SDL_GetTicks();
+	size_t componentCount = this->enemyMovementManager->getAwakeCount();
+	enemyMovementFrame++;
+	levelOfDetailStats = AILevelOfDetailStats();
+	crowd.clear();
+	crowdMembers.clear();
+	sightQueries.clear();
+	sightQueryEnemies.clear();
+	this->updateSquads();
+
+	// enemies surround the player instead of walking into it
+	if (playerMovement != nullptr && playerMovement->getEntity().uid != 0) {
+		this->addCrowdAgent(playerMovement->getEntity(), nullptr);
+	}
 
 	for (size_t i = 0; i < componentCount; i++)
 	{
 		EnemyMovement* currentComponent = this->enemyMovementManager->getComponentWithIndex(i);
 		Vector2 direction = { 0,0 };
+		AI_LOD_TIERS tier = AI_LOD_NEAR;
+		uint32_t elapsedFrames = 1;
+
+		if (currentComponent->isActive()) {
+			tier = this->getLevelOfDetailTier(this->positionManager->getComponent(currentComponent->getEntity()));
+			int interval = (tier == AI_LOD_NEAR) ? 1 : (tier == AI_LOD_MID) ? std::max(levelOfDetail.midInterval, 1) : levelOfDetail.farInterval;
+			levelOfDetailStats.enemies[tier]++;
+
+			// the updates of a tier are spread over the frames of its interval
+			if (interval <= 0 || (enemyMovementFrame + i) % interval != 0) {
+				// enemies close to the skipped one still avoid it
+				if (tier != AI_LOD_FAR) this->addCrowdAgent(currentComponent->getEntity(), currentComponent);
+				continue;
+			}
+			levelOfDetailStats.updated[tier]++;
+
+			if (currentComponent->getLastUpdateFrame() != 0) {
+				elapsedFrames = std::min(enemyMovementFrame - currentComponent->getLastUpdateFrame(), (uint32_t)interval);
+			}
+		}
+		currentComponent->setLastUpdate(enemyMovementFrame);
+
+		// far enemies do not steer
+		size_t agent = (tier != AI_LOD_FAR) ? this->addCrowdAgent(currentComponent->getEntity(), currentComponent) : CrowdAvoidance::NO_AGENT;
+
+		// squad followers keep their formation slot instead of following an own route
+		if (currentComponent->isActive() && currentComponent->isSquadFollower()) {
+			Position* currPos = this->positionManager->getComponent(currentComponent->getEntity());
+			Collider* collider = this->colliderManager->getComponent(currentComponent->getEntity());
+			if (this->moveFollower(currentComponent, currPos, collider, agent, tier, elapsedFrames, direction)) {
+				if (tier != AI_LOD_FAR) {
+					this->controlAnimationStates(currentComponent->getEntity(), &direction, false);
+				}
+				continue;
+			}
+		}
 		// check if the component is active and has currently a destination node.
-		if (currentComponent->isActive() && (currentComponent->getDestination() != nullptr)) {
+		if (currentComponent->isActive() && (currentComponent->getDestination() != INVALID_NODE)) {
 			Position* currPos = this->positionManager->getComponent(currentComponent->getEntity());
 
-			// calculate path
+			// request path
 			if (currentComponent->isFlagged()) {
 				currentComponent->flag(false);
+				this->schedulePathfindingTimer(currentComponent);
 
 				// check if the component has a target
 				if (currentComponent->hasTarget()) {
 					Position* targetPosition = this->positionManager->getComponent(currentComponent->getTarget());
 					if (targetPosition != nullptr) {
-						Node* newDest = this->getCurrentNode(targetPosition);
-						if (newDest != nullptr) {
-							currentComponent->setDestination(newDest);
+						NodeIndex newDest = this->getCurrentNode(targetPosition);
+						if (newDest != INVALID_NODE && newDest != currentComponent->getDestination()) {
+							// follow the old route until the new one arrives
+							currentComponent->setDestination(newDest, true);
 						}
 					}
 				}
+				this->requestPath(currentComponent, this->getCurrentNode(currPos));
+			}
+			Collider* collider = this->colliderManager->getComponent(currentComponent->getEntity());
 
-				// get current node of enemy
-				Node* curr = this->getCurrentNode(currPos);
-
-				if (curr != nullptr) {
-					currentComponent->setRoute(this->aStar(currentComponent->getEntity(),curr, currentComponent->getDestination()));
-				}
+			// far enemies are not visible, so they skip the animations
+			if (tier == AI_LOD_FAR) {
+				this->moveAlongRoute(currentComponent, currPos, collider, elapsedFrames);
+				continue;
 			}
+
 			//move
-			if (currentComponent->arrivedAtNextNode(currPos->x() / tileWidth, currPos->y() / tileHeight)) {
-				currentComponent->setNextNode();
+			if (currentComponent->arrivedAtNextNode(routes, this->getCurrentNode(currPos))) {
+				currentComponent->setNextNode(routes);
 
 				// is next node currently an obstacle (e.g. there is a collider)
-				if (currentComponent->hasNextNode() && currentComponent->getNextNode()->obstacle && currentComponent->getNextNode() != currentComponent->getDestination()) {
+				if (currentComponent->hasNextNode() && this->isRouteBlocked(currentComponent->getNextNode(routes), collider) && currentComponent->getNextNode(routes) != currentComponent->getDestination()) {
 					currentComponent->flag(true);
 					continue;
 				}
@@ -306,36 +312,53 @@ void PhysicSystem::handleEnemyMovement() {
 
 			// check if there is another node to traverse to.
 			if (currentComponent->hasNextNode()) {
-				Node* currentTarget = currentComponent->getNextNode();
+				NodeIndex currentTarget = currentComponent->getNextNode(routes);
 
 				// is target node currently an obstacle (e.g. there is a collider)
-				if (currentTarget->obstacle) {
+				if (this->isRouteBlocked(currentTarget, collider)) {
 					currentComponent->flag(true);
 					continue;
 				}
-				direction.x = (currentTarget->x * tileWidth + tileWidth / 2) - currPos->x();
-				direction.y = (currentTarget->y * tileHeight + tileHeight / 2) - currPos->y();
+				direction.x = (grid.getX(currentTarget) * tileWidth + tileWidth / 2) - currPos->x();
+				direction.y = (grid.getY(currentTarget) * tileHeight + tileHeight / 2) - currPos->y();
 
 				// normalize direction
 				float newX = direction.getNormalizedX();
 				float newY = direction.getNormalizedY();
 
-				currPos->movePosition(newX * (currentComponent->getMovementSpeed()*cameraZoomX), newY * (currentComponent->getMovementSpeed()*cameraZoomY));
+				float velocityX = (float)(newX * (currentComponent->getMovementSpeed()*cameraZoomX));
+				float velocityY = (float)(newY * (currentComponent->getMovementSpeed()*cameraZoomY));
+
+				// steering enemies are moved once every preferred velocity is known
+				if (agent != CrowdAvoidance::NO_AGENT && tier == AI_LOD_NEAR) {
+					crowd.setPreferredVelocity(agent, { velocityX, velocityY });
+				}
+				else if (elapsedFrames > 1) {
+					// mid-range enemies catch up on the skipped frames without passing the next node
+					float scale = std::min((float)elapsedFrames, (float)direction.getMagnitude() / std::max(std::sqrt(velocityX * velocityX + velocityY * velocityY), 0.001f));
+					currPos->movePosition(velocityX * scale, velocityY * scale);
+				}
+				else {
+					currPos->movePosition(velocityX, velocityY);
+				}
 			}
-			// increase component timer
-			currentComponent->increaseTimer(newTimestamp- lastEnemyMovementTimestamp);
 		}
 		// check if component has target
-		else if (currentComponent->getDestination() == nullptr && currentComponent->hasTarget()) {
+		else if (currentComponent->getDestination() == INVALID_NODE && currentComponent->hasTarget()) {
 			Position* currPos = this->positionManager->getComponent(currentComponent->getEntity());
-			Node* curr = this->getCurrentNode(currPos);
+			NodeIndex curr = this->getCurrentNode(currPos);
 
 			Position* targetPosition = this->positionManager->getComponent(currentComponent->getTarget());
 			if (targetPosition != nullptr) {
-				Node* newDest = this->getCurrentNode(targetPosition);
+				NodeIndex newDest = this->getCurrentNode(targetPosition);
 
-				if (calculateHCost(curr, newDest) <= currentComponent->getMaxDistance()*((cameraZoomX+cameraZoomY)/2.0)) {
-					if (newDest != nullptr) {
+				if (grid.getDistance(curr, newDest) <= currentComponent->getMaxDistance()*((cameraZoomX+cameraZoomY)/2.0)) {
+					if (newDest != INVALID_NODE && currentComponent->requiresLineOfSight()) {
+						// walls are checked for every noticing enemy at once
+						sightQueries.push_back({ curr, newDest, false });
+						sightQueryEnemies.push_back(currentComponent);
+					}
+					else if (newDest != INVALID_NODE) {
 						currentComponent->setDestination(newDest);
 						currentComponent->flag(true);
 					}
@@ -343,9 +366,391 @@ void PhysicSystem::handleEnemyMovement() {
 			}
 		}
 		// control animation state
-		this->controlAnimationStates(currentComponent->getEntity(), &direction, false);
+		if (tier != AI_LOD_FAR) {
+			this->controlAnimationStates(currentComponent->getEntity(), &direction, false);
+		}
+	}
+	this->resolveSightQueries();
+	this->moveCrowd();
+
+	this->solvePathRequests();
+}
+
+/**
+* @brief Checks the line of sight of the queued enemies to their target in one batch. Enemies that see their target start chasing it.
+*/
+void PhysicSystem::resolveSightQueries() {
+	if (sightQueries.empty()) return;
+	grid.checkLineOfSight(sightQueries.data(), sightQueries.size());
+
+	for (size_t i = 0; i < sightQueries.size(); i++) {
+		if (!sightQueries[i].visible) continue;
+		sightQueryEnemies[i]->setDestination(sightQueries[i].to);
+		sightQueryEnemies[i]->flag(true);
+	}
+}
+
+/**
+* @brief Creates a squad. Only the leader searches paths, the followers keep their formation slot around the leader and walk along the trail of the leader if they can not see their slot.
+* Enemies leading another squad disband it, followers of another squad leave it.
+* @param leader - Entity leading the squad.
+* @param followers - Entities following the leader. Entities without an enemy movement component are ignored.
+* @param formation - Formation of the followers.
+* @param spacing - Distance between the formation slots in pixels.
+* @return Index of the squad. Squad::NO_SQUAD if the leader has no enemy movement component.
+*/
+int PhysicSystem::createSquad(Entity leader, const std::vector<Entity>& followers, SQUAD_FORMATIONS formation, float spacing) {
+	EnemyMovement* leaderComponent = this->enemyMovementManager->getComponent(leader);
+	Position* leaderPosition = this->positionManager->getComponent(leader);
+	if (leaderComponent == nullptr || leaderPosition == nullptr) return Squad::NO_SQUAD;
+	if (leaderComponent->getSquad() != Squad::NO_SQUAD && !leaderComponent->isSquadFollower()) {
+		this->disbandSquad(leaderComponent->getSquad());
+	}
+
+	// reuse a disbanded squad
+	int index = 0;
+	while (index < (int)squads.size() && squads[index].leader != 0) index++;
+	if (index == (int)squads.size()) squads.push_back(Squad());
+
+	Squad& squad = squads[index];
+	squad.leader = leader.uid;
+	squad.formation = formation;
+	squad.spacing = spacing;
+	squad.headingX = 1.0f;
+	squad.headingY = 0.0f;
+	squad.leaderX = (float)leaderPosition->x();
+	squad.leaderY = (float)leaderPosition->y();
+	squad.trail.clear();
+	squad.followers.clear();
+	squad.moveLeader(squad.leaderX, squad.leaderY, this->getCurrentNode(leaderPosition));
+	leaderComponent->setSquad(index, -1);
+
+	for (size_t i = 0; i < followers.size(); i++) {
+		EnemyMovement* component = this->enemyMovementManager->getComponent(followers[i]);
+		if (component == nullptr || followers[i].uid == leader.uid) continue;
+		if (component->getSquad() != Squad::NO_SQUAD && !component->isSquadFollower()) {
+			this->disbandSquad(component->getSquad());
+		}
+
+		// followers drop their own route
+		component->setSquad(index, (int)squad.followers.size());
+		component->setDestination(INVALID_NODE);
+		component->flag(true);
+		squad.followers.push_back(followers[i].uid);
+	}
+	return index;
+}
+
+/**
+* @brief Disbands a squad. The followers search their own paths again.
+* @param squad - Index of the squad.
+*/
+void PhysicSystem::disbandSquad(int squad) {
+	if (squad < 0 || squad >= (int)squads.size() || squads[squad].leader == 0) return;
+
+	// members may have joined another squad since
+	EnemyMovement* leader = this->enemyMovementManager->getComponent(Entity{ squads[squad].leader, "", false });
+	if (leader != nullptr && leader->getSquad() == squad) leader->setSquad(Squad::NO_SQUAD, 0);
+	for (size_t i = 0; i < squads[squad].followers.size(); i++) {
+		EnemyMovement* component = this->enemyMovementManager->getComponent(Entity{ squads[squad].followers[i], "", false });
+		if (component != nullptr && component->getSquad() == squad) component->setSquad(Squad::NO_SQUAD, 0);
+	}
+	squads[squad].leader = 0;
+	squads[squad].followers.clear();
+	squads[squad].trail.clear();
+}
+
+/**
+* @brief Gets the leader of a squad.
+* @param squad - Index of the squad.
+* @return Unique identifier of the leader. 0 if the squad does not exist.
+*/
+unsigned int PhysicSystem::getSquadLeader(int squad) {
+	if (squad < 0 || squad >= (int)squads.size()) return 0;
+	return squads[squad].leader;
+}
+
+/**
+* @brief Updates the heading and the trail of every squad from the movement of its leader. Squads whose leader was removed are disbanded.
+*/
+void PhysicSystem::updateSquads() {
+	for (size_t i = 0; i < squads.size(); i++) {
+		if (squads[i].leader == 0) continue;
+
+		Entity leader = { squads[i].leader, "", false };
+		EnemyMovement* component = this->enemyMovementManager->getComponent(leader);
+		Position* position = this->positionManager->getComponent(leader);
+		if (component == nullptr || position == nullptr || component->getSquad() != (int)i) {
+			this->disbandSquad((int)i);
+			continue;
+		}
+		squads[i].moveLeader((float)position->x(), (float)position->y(), this->getCurrentNode(position));
+	}
+}
+
+/**
+* @brief Moves a squad follower to its formation slot. Followers that can not see their slot walk to the leader or the latest node of the trail of the leader they see.
+* @param component - Enemy movement component of the follower.
+* @param position - Position of the follower.
+* @param collider - Collider of the follower. May be nullptr.
+* @param agent - Agent index of the follower in the local avoidance.
+* @param tier - Level of detail tier of the follower.
+* @param frames - Number of frames since the last update of the follower.
+* @param direction - Set to the movement direction for the animations.
+* @return Whether the follower was moved. Otherwise the leader is set as destination of a flagged follower, so it searches an own path once per pathfinding timer.
+*/
+bool PhysicSystem::moveFollower(EnemyMovement* component, Position* position, Collider* collider, size_t agent, AI_LOD_TIERS tier, uint32_t frames, Vector2& direction) {
+	int index = component->getSquad();
+	if (index < 0 || index >= (int)squads.size() || squads[index].leader == 0) {
+		component->setSquad(Squad::NO_SQUAD, 0);
+		return false;
+	}
+	Squad& squad = squads[index];
+	Position* leaderPosition = this->positionManager->getComponent(Entity{ squad.leader, "", false });
+	NodeIndex current = (position != nullptr) ? this->getCurrentNode(position) : INVALID_NODE;
+	if (leaderPosition == nullptr || current == INVALID_NODE) return false;
+	NodeIndex leaderNode = this->getCurrentNode(leaderPosition);
+
+	// the formation scales with the zoom like the movement speed
+	float offsetX, offsetY;
+	squad.getSlotOffset(component->getSquadSlot(), offsetX, offsetY);
+	float targetX = leaderPosition->x() + offsetX * cameraZoomX;
+	float targetY = leaderPosition->y() + offsetY * cameraZoomY;
+	NodeIndex slotNode = this->getCurrentNode(SDL_Point{ (int)std::floor(targetX), (int)std::floor(targetY) });
+	bool found = slotNode != INVALID_NODE && !this->isRouteBlocked(slotNode, collider) && grid.hasLineOfSight(current, slotNode);
+
+	if (!found && leaderNode != INVALID_NODE && grid.hasLineOfSight(current, leaderNode)) {
+		targetX = (float)leaderPosition->x();
+		targetY = (float)leaderPosition->y();
+		found = true;
+	}
+	// the latest trail node in sight is the furthest along the corridor of the leader
+	for (size_t i = squad.trail.size(); !found && i > 0; i--) {
+		NodeIndex node = squad.trail[i - 1];
+		if (grid.hasLineOfSight(current, node)) {
+			targetX = (float)(grid.getX(node) * tileWidth + tileWidth / 2);
+			targetY = (float)(grid.getY(node) * tileHeight + tileHeight / 2);
+			found = true;
+		}
+	}
+
+	if (!found) {
+		// cut off from the leader, the follower searches its own way back once per pathfinding timer
+		if (component->getDestination() == INVALID_NODE && leaderNode != INVALID_NODE && component->isFlagged()) {
+			component->setDestination(leaderNode);
+			component->flag(true);
+		}
+		return false;
+	}
+	if (component->getDestination() != INVALID_NODE) component->setDestination(INVALID_NODE);
+
+	float deltaX = targetX - position->x();
+	float deltaY = targetY - position->y();
+	float distance = std::sqrt(deltaX * deltaX + deltaY * deltaY);
+	float speed = component->getMovementSpeed() * ((cameraZoomX + cameraZoomY) / 2.0f);
+	direction.x = (int)deltaX;
+	direction.y = (int)deltaY;
+	if (distance < 1.0f || speed <= 0.0f) {
+		// followers in their slot stand still
+		direction = { 0,0 };
+		component->setVelocity(0.0f, 0.0f);
+		return true;
+	}
+
+	// the follower stops at the target instead of passing it
+	float velocityX = deltaX / distance * std::min(speed, distance);
+	float velocityY = deltaY / distance * std::min(speed, distance);
+	if (agent != CrowdAvoidance::NO_AGENT && tier == AI_LOD_NEAR) {
+		crowd.setPreferredVelocity(agent, { velocityX, velocityY });
+	}
+	else {
+		float scale = std::min((float)frames, distance / speed);
+		position->movePosition(deltaX / distance * speed * scale, deltaY / distance * speed * scale);
+		component->setVelocity(0.0f, 0.0f);
+	}
+	return true;
+}
+
+/**
+* @brief Schedules the pathfinding timer of an enemy. The previous timer of the enemy is canceled.
+* @param component - Enemy movement component of the enemy.
+*/
+void PhysicSystem::schedulePathfindingTimer(EnemyMovement* component) {
+	if (timerWheel == nullptr) return;
+
+	timerWheel->cancel(component->getPathfindingTimerHandle());
+	int delay = std::max(component->getPathfindingTimer(), 0);
+	component->setPathfindingTimerHandle(timerWheel->schedule((uint32_t)delay, TIMER_EVENT_PATHFINDING, component->getEntity().uid));
+}
+
+/**
+* @brief Adds an entity with a collider to the local avoidance of the frame. The entity is avoided by the enemies and only steers itself once its preferred velocity is set.
+* @param e - Entity to add.
+* @param component - Enemy movement component of the entity. nullptr for entities that are only avoided, like the player.
+* @return Index of the agent. CrowdAvoidance::NO_AGENT if the avoidance is disabled or the entity has no active collider.
+*/
+size_t PhysicSystem::addCrowdAgent(Entity e, EnemyMovement* component) {
+	if (!crowdAvoidance || (component != nullptr && !component->isActive())) return CrowdAvoidance::NO_AGENT;
+
+	Collider* collider = this->colliderManager->getComponent(e);
+	Position* position = this->positionManager->getComponent(e);
+	if (collider == nullptr || position == nullptr || !collider->isActive() || collider->isTrigger()) return CrowdAvoidance::NO_AGENT;
+
+	// the circle encloses the collider, so colliders of agents passing diagonally do not intersect
+	SDL_Point* size = collider->getColliderSize();
+	float radius = std::sqrt((float)(size->x * size->x + size->y * size->y)) / 2.0f;
+	CrowdAvoidance::Vec2 velocity = { 0.0f, 0.0f };
+	if (component != nullptr) {
+		velocity = { component->getVelocityX(), component->getVelocityY() };
+	}
+	crowdMembers.push_back({ component, position });
+	return crowd.addAgent({ (float)position->x(), (float)position->y() }, radius, velocity);
+}
+
+/**
+* @brief Solves the local avoidance and moves the steering enemies. Enemies that would be steered onto a statically blocked node follow their route instead.
+*/
+void PhysicSystem::moveCrowd() {
+	if (crowdMembers.empty()) return;
+	crowd.solve();
+
+	for (size_t i = 0; i < crowdMembers.size(); i++) {
+		CrowdMember& member = crowdMembers[i];
+		if (!crowd.isReactive(i)) {
+			if (member.movement != nullptr) member.movement->setVelocity(0.0f, 0.0f);
+			continue;
+		}
+
+		// the avoidance only knows the other enemies, walls are avoided by the route
+		CrowdAvoidance::Vec2 velocity = crowd.getVelocity(i);
+		NodeIndex current = this->getCurrentNode(member.position);
+		NodeIndex next = this->getCurrentNode(SDL_Point{ (int)(member.position->x() + velocity.x), (int)(member.position->y() + velocity.y) });
+		if (next != current && this->isRouteBlocked(next, nullptr)) {
+			velocity = crowd.getPreferredVelocity(i);
+		}
+
+		member.position->movePosition(velocity.x, velocity.y);
+		member.movement->setVelocity(velocity.x, velocity.y);
+	}
+}
+
+/**
+* @brief Gets the level of detail tier of an enemy from its distance to the view area of the camera.
+* @param position - Position of the enemy.
+* @return Tier of the enemy. Always AI_LOD_NEAR if the level of detail is disabled or the camera is not set.
+*/
+AI_LOD_TIERS PhysicSystem::getLevelOfDetailTier(Position* position) {
+	if (!levelOfDetail.enabled || position == nullptr || camera.w <= 0 || camera.h <= 0) return AI_LOD_NEAR;
+
+	// distance to the closest border, 0 inside of the view
+	int distanceX = std::max(std::max(camera.x - position->x(), position->x() - (camera.x + camera.w)), 0);
+	int distanceY = std::max(std::max(camera.y - position->y(), position->y() - (camera.y + camera.h)), 0);
+	int distance = std::max(distanceX, distanceY);
+
+	if (distance <= levelOfDetail.nearDistance) return AI_LOD_NEAR;
+	if (distance <= levelOfDetail.farDistance) return AI_LOD_MID;
+	return AI_LOD_FAR;
+}
+
+/**
+* @brief Moves an enemy far from the camera along its route without steering. The enemy walks the distance of the skipped frames from node to node at once.
+* @param component - Enemy movement component of the enemy.
+* @param position - Position of the enemy.
+* @param collider - Collider of the enemy. May be nullptr.
+* @param frames - Number of frames since the last update of the enemy.
+*/
+void PhysicSystem::moveAlongRoute(EnemyMovement* component, Position* position, Collider* collider, uint32_t frames) {
+	float distance = component->getMovementSpeed() * ((cameraZoomX + cameraZoomY) / 2.0f) * frames;
+	component->setVelocity(0.0f, 0.0f);
+
+	while (distance > 0.0f && component->hasNextNode()) {
+		NodeIndex next = component->getNextNode(routes);
+		if (this->isRouteBlocked(next, collider) && next != component->getDestination()) {
+			component->flag(true);
+			return;
+		}
+
+		float deltaX = (grid.getX(next) * tileWidth + tileWidth / 2) - position->x();
+		float deltaY = (grid.getY(next) * tileHeight + tileHeight / 2) - position->y();
+		float length = std::sqrt(deltaX * deltaX + deltaY * deltaY);
+		if (length > distance) {
+			position->movePosition(deltaX / length * distance, deltaY / length * distance);
+			return;
+		}
+
+		// the next node is reached within the skipped frames
+		position->movePosition(deltaX, deltaY);
+		distance -= length;
+		if (component->setNextNode(routes) == INVALID_NODE) return;
+	}
+}
+
+/**
+* @brief Queues a path request for the enemy in the path service. Enemies without a route to follow are urgent, a pending request is only queued again if it becomes urgent. Requests to an unreachable destination are rejected immediately and flagged on the component.
+* @param component - Enemy movement component requesting the path.
+* @param current - Index of the node the enemy currently occupies.
+*/
+void PhysicSystem::requestPath(EnemyMovement* component, NodeIndex current) {
+	// the search would explore the whole connected area before failing
+	if (current != INVALID_NODE && !grid.isReachable(current, component->getDestination())) {
+		component->setDestinationUnreachable(true);
+		component->setRoutePending(false);
+		pathBuffer.clear();
+		component->setRoute(routes, pathBuffer);
+		return;
+	}
+
+	Collider* collider = this->colliderManager->getComponent(component->getEntity());
+	bool waiting = component->reachedEndOfRoute(routes, current) || this->isNodeBlocked(component->getNextNode(routes), collider);
+	PATH_PRIORITIES priority = waiting ? PATH_PRIORITY_URGENT : PATH_PRIORITY_NORMAL;
+
+	if (!component->isRoutePending() || priority < component->getRoutePriority()) {
+		component->setRoutePending(true, priority);
+		pathService.request(component->getEntity().uid, priority);
+	}
+}
+
+/**
+* @brief Solves the queued path requests within the time budget of the path service and delivers the routes to the enemies.
+*/
+void PhysicSystem::solvePathRequests() {
+	pathService.beginFrame();
+	pathUpdate++;
+
+	unsigned int uid = 0;
+	while (pathService.hasBudget() && pathService.nextRequest(uid)) {
+		EnemyMovement* component = this->enemyMovementManager->getComponent(Entity{ uid, "", false });
+
+		// request was already solved or the component was removed
+		if (component == nullptr || !component->isRoutePending()) continue;
+		component->setRoutePending(false);
+
+		if (!component->isActive() || component->getDestination() == INVALID_NODE) continue;
+
+		// the enemy may have moved along its old route since the request
+		Position* position = this->positionManager->getComponent(component->getEntity());
+		NodeIndex curr = (position != nullptr) ? this->getCurrentNode(position) : INVALID_NODE;
+		if (curr == INVALID_NODE) continue;
+
+		bool complete = true;
+		bool reachable = grid.isReachable(curr, component->getDestination());
+		component->setDestinationUnreachable(!reachable);
+		FlowField* field = nullptr;
+		if (!reachable) {
+			pathBuffer.clear();
+		}
+		else if (component->usesFlowField() && (field = this->getFlowField(component->getDestination())) != nullptr) {
+			// the nodes of the enemy do not block its own path
+			Collider* collider = this->colliderManager->getComponent(component->getEntity());
+			this->excludeOwnOccupancy(collider, true);
+			field->tracePath(grid, curr, pathBuffer);
+			this->excludeOwnOccupancy(collider, false);
+		}
+		else {
+			this->searchPath(component->getEntity(), curr, component->getDestination(), pathBuffer, complete);
+		}
+		component->setRoute(routes, pathBuffer, complete);
 	}
-	lastEnemyMovementTimestamp = newTimestamp;
 }
 
 /**
@@ -360,7 +765,7 @@ void PhysicSystem::handleCollision(){
  * @brief Calculates the positions of the colliders.
 */
 void PhysicSystem::calculateColliderPositions(){
-	size_t componentCount = colliderManager->getComponentCount();
+	size_t componentCount = colliderManager->getAwakeCount();
 
 	for (size_t i = 0; i < componentCount; i++) {
 		Collider* currentCollider = colliderManager->getComponentWithIndex(i);
@@ -391,8 +796,9 @@ void PhysicSystem::adjustColliderPosition(Collider* collider, Position* position
 * @brief Detects collisions between colliders.
 */
 void PhysicSystem::detectCollisions() {
-	size_t colliderCount = colliderManager->getComponentCount();
-	size_t projectileMovementCount = projManager->getComponentCount();
+	// sleeping colliders are woken before a moving collider gets close to them
+	size_t colliderCount = colliderManager->getAwakeCount();
+	size_t projectileMovementCount = projManager->getAwakeCount();
 
 	if(playerMovement != nullptr) {
 		size_t collisionCounter = 0;
@@ -508,254 +914,329 @@ void PhysicSystem::detectCollisions() {
 
 #pragma region AStar
 /**
-* @brief Calculates the heuristic cost of the position to the destination.
-* @param pos - Position to calculate the heuristic cost of.
-* @param dest - Destination node.
-* @return Heuristic cost from the position to the destination.
-*/
-float PhysicSystem::calculateHCost(Node* pos, Node* dest) {
-	float hCost = 0.0f;
-	if (pos != nullptr && dest != nullptr) {
-		hCost = std::sqrt((pos->x - dest->x) * (pos->x - dest->x) + (pos->y - dest->y) * (pos->y - dest->y));
-	}
-	return hCost;
-}
-
-/**
-* @brief Calculates the path from the start node to the destination node using the a* algorithm.
+* @brief Calculates the path from the start node to the destination node using the selected search algorithm. Nodes occupied by colliders other than the one of the entity are treated as obstacles. Destinations that are not connected to the start node fail without a search.
 * @param e - Entity to calculate path for.
 * @param start - Startnode.
-* @param dest - Destinationnode.
-* @return Path from the start node to the destination node.
+* @param dest - Destination node.
+* @param path - Buffer the path is written to, from the destination node back to the start node. Cleared if no path was found.
+* @param complete - Set to whether the path ends at the destination node.
+* @return Whether a path was found.
 */
-std::vector<Node*> PhysicSystem::aStar(Entity e, Node* start, Node* dest) {
-	// reset nodes
-	for (size_t x = 0; x < row; x++)
-	{
-		for (size_t y = 0; y < col; y++)
-		{
-			nodes[y * row + x].visited = false;
-			nodes[y * row + x].fcost = INFINITY;
-			nodes[y * row + x].gcost = INFINITY;
-			nodes[y * row + x].parent = nullptr;
-			nodes[y * row + x].obstacle = false;
-		}
+bool PhysicSystem::searchPath(Entity e, NodeIndex start, NodeIndex dest, std::vector<NodeIndex>& path, bool& complete) {
+	complete = true;
+
+	// destinations in another connected area are rejected without a search
+	if (!grid.isReachable(start, dest)) {
+		path.clear();
+		return false;
 	}
 
-	this->markNodesAsObstacles(e, dest);
+	// the jump table and the clusters only store the static colliders
+	if (algorithm == PATHFINDING_JPS_PLUS && !grid.hasJumpTable()) {
+		grid.setDynamicObstacles(false);
+		grid.buildJumpTable();
+		grid.setDynamicObstacles(true);
+	}
+	else if (algorithm == PATHFINDING_HIERARCHICAL && hierarchicalGrid.isDirty()) {
+		grid.setDynamicObstacles(false);
+		hierarchicalGrid.update(grid);
+		grid.setDynamicObstacles(true);
+	}
 
-	Node* current = start;
-	start->gcost = 0.0f;
-	start->fcost = calculateHCost(start, dest);
+	// the nodes of the entity do not block its own path
+	Collider* collider = this->colliderManager->getComponent(e);
+	this->excludeOwnOccupancy(collider, true);
 
-	// nodes to test
-	PriorityQueue<Node*, float>  openNodes;
-	openNodes.put(start, 0.0f);
+	bool found = false;
+	IncrementalPlanner* planner = nullptr;
+	if (pathCache.findPath(grid, start, dest, path)) {
+		found = true;
+	}
+	else if (algorithm == PATHFINDING_HIERARCHICAL) {
+		found = hierarchicalGrid.findPath(grid, start, dest, path, complete);
+	}
+	else if (algorithm == PATHFINDING_INCREMENTAL && (planner = this->getPlanner(e)) != nullptr) {
+		found = planner->findPath(grid, start, dest, path);
+	}
+	// jump point search assumes the same cost for every walkable node
+	else if (algorithm == PATHFINDING_ASTAR || algorithm == PATHFINDING_INCREMENTAL || !grid.isUniformCost()) {
+		found = grid.findPath(start, dest, path);
+	}
+	else if (algorithm == PATHFINDING_JPS) {
+		found = grid.findPathJps(start, dest, path);
+	}
+	else {
+		found = grid.findPathJpsPlus(start, dest, path);
+	}
 
-	while (!openNodes.empty()) {
+	// the first part of a hierarchical path is only valid until the route is requested again
+	if (found && complete) {
+		pathCache.addPath(grid, path);
+	}
+	this->excludeOwnOccupancy(collider, false);
+	return found;
+}
 
-		if (current == dest) {
-			break;
+/**
+* @brief Gets the incremental search of an entity. The least recently used search is given to the entity if it has none and the search was unused for PLANNER_IDLE_MS.
+* @param e - Entity to get the search for.
+* @return Pointer to the search. nullptr if every search is in use.
+*/
+IncrementalPlanner* PhysicSystem::getPlanner(Entity e) {
+	Uint32 now = SDL_GetTicks();
+	size_t oldest = 0;
+	for (size_t i = 0; i < MAX_INCREMENTAL_PLANNERS; i++) {
+		if (planners[i].assigned && planners[i].uid == e.uid) {
+			planners[i].lastUse = now;
+			return &planners[i].planner;
 		}
-
-		if (openNodes.empty()) {
-			break;
+		if (!planners[i].assigned || (planners[oldest].assigned && planners[i].lastUse < planners[oldest].lastUse)) {
+			oldest = i;
 		}
+	}
 
-		current = openNodes.get();
-
-		while (!openNodes.empty() && current->visited) {
-			current = openNodes.get();
-		}
-		current->visited = true;
-
-		// check neighbours
-		for (auto neighbour : current->neighbours) {
-			if (!neighbour->obstacle || neighbour == dest) {
-				float gCostNeighbour = current->gcost + calculateHCost(current, neighbour);
-
-				if (gCostNeighbour < neighbour->gcost) {
-					neighbour->parent = current;
-					neighbour->gcost = gCostNeighbour;
+	// taking the search of an active entity would start both searches from scratch again and again
+	if (planners[oldest].assigned && now - planners[oldest].lastUse < PLANNER_IDLE_MS) {
+		return nullptr;
+	}
+	planners[oldest].assigned = true;
+	planners[oldest].uid = e.uid;
+	planners[oldest].lastUse = now;
+	planners[oldest].planner.reset();
+	return &planners[oldest].planner;
+}
 
-					neighbour->fcost = neighbour->gcost + calculateHCost(neighbour, dest);
-				}
+/**
+* @brief Notifies the pathfinding that the walkable area inside of the area changed without a collider being added, removed or moved. The jump table and the flow fields are rebuilt and the clusters overlapping the area are updated at the next search.
+* @param area - Changed area in world coordinates.
+*/
+void PhysicSystem::updateStaticObstacles(SDL_Rect area) {
+	if (grid.getNodeCount() == 0 || tileWidth <= 0 || tileHeight <= 0) return;
+
+	grid.clearJumpTable();
+	int minX = std::max(area.x, 0) / tileWidth;
+	int minY = std::max(area.y, 0) / tileHeight;
+	int maxX = std::max(area.x + area.w, 0) / tileWidth;
+	int maxY = std::max(area.y + area.h, 0) / tileHeight;
+	hierarchicalGrid.invalidateArea(minX, minY, maxX - minX + 1, maxY - minY + 1);
+	this->invalidateFlowFields();
+}
 
-				if (!neighbour->visited) {
-					openNodes.put(neighbour, neighbour->fcost);
-				}
-			}
+/**
+* @brief Gets the flow field towards the destination node. If no field belongs to the destination, the least recently used field is built for it unless it was used in the current update.
+* Static colliders are avoided by the field, nodes occupied by enemies are avoided while following it.
+* @param dest - Destination node.
+* @return Pointer to the field. nullptr if every field was used for another destination in the current update.
+*/
+FlowField* PhysicSystem::getFlowField(NodeIndex dest) {
+	size_t oldest = 0;
+	for (size_t i = 0; i < MAX_FLOW_FIELDS; i++) {
+		if (flowFields[i].field.getDestination() == dest) {
+			flowFields[i].lastUpdate = pathUpdate;
+			return &flowFields[i].field;
+		}
+		if (flowFields[i].lastUpdate < flowFields[oldest].lastUpdate) {
+			oldest = i;
 		}
 	}
 
-	std::vector<Node*> result;
-
-	// backtrack found path
-	if (current == dest) {
-		result.push_back(current);
-		while (current->parent != nullptr) {
-			current = current->parent;
-			result.push_back(current);
-		}
+	// rebuilding a field of this update would alternate between the destinations for every enemy, they search their own path instead
+	if (flowFields[oldest].lastUpdate == pathUpdate) {
+		return nullptr;
 	}
 
-	return result;
+	flowFields[oldest].lastUpdate = pathUpdate;
+	grid.setDynamicObstacles(false);
+	flowFields[oldest].field.build(grid, dest);
+	grid.setDynamicObstacles(true);
+	return &flowFields[oldest].field;
+}
+
+/**
+* @brief Invalidates every flow field. The fields are built again when they are used next.
+*/
+void PhysicSystem::invalidateFlowFields() {
+	for (size_t i = 0; i < MAX_FLOW_FIELDS; i++) {
+		flowFields[i].field.invalidate();
+	}
 }
 
 /**
 * @brief Gets the current Node based on the position.
 * @param pos - Position to get the current node off.
-* @return Current Node.
+* @return Index of the current node. INVALID_NODE if the position is outside of the grid.
 */
-Node* PhysicSystem::getCurrentNode(Position* pos) {
-	int newX = pos->x() / tileWidth;
-	int newY = pos->y() / tileHeight;
-
-	int idx = newY * tilesPerRow + newX;
-
-	if (idx < this->nodeCount) {
-		return &this->nodes[idx];
-	}
-	return nullptr;
+NodeIndex PhysicSystem::getCurrentNode(Position* pos) {
+	return this->getCurrentNode(SDL_Point{ pos->x(), pos->y() });
 }
 
 /**
 * @brief Gets the current Node based on the position.
 * @param pos - Position to get the current node off.
-* @return Current Node.
+* @return Index of the current node. INVALID_NODE if the position is outside of the grid.
 */
-Node* PhysicSystem::getCurrentNode(SDL_Point pos) {
-	int newX = pos.x / tileWidth;
-	int newY = pos.y / tileHeight;
+NodeIndex PhysicSystem::getCurrentNode(SDL_Point pos) {
+	// negative positions would be truncated onto the first row or column
+	if (grid.getNodeCount() == 0 || pos.x < 0 || pos.y < 0) {
+		return INVALID_NODE;
+	}
+	return grid.getIndex(pos.x / tileWidth, pos.y / tileHeight);
+}
 
-	int idx = newY * tilesPerRow + newX;
+/**
+* @brief Calculates the path between two positions. Nodes occupied by other enemies are treated as obstacles.
+* @param e - Entity to calculate the path for.
+* @param start - Start position.
+* @param dest - Destination position.
+* @param path - Buffer the path is written to, from the destination back to the start. Cleared if no path was found.
+* @param complete - Set to whether the path ends at the destination. With the hierarchical search only the first part of a long path is calculated.
+* @return Whether a path was found.
+*/
+bool PhysicSystem::findPath(Entity e, SDL_Point start, SDL_Point dest, std::vector<NodeIndex>& path, bool* complete) {
+	NodeIndex startNode = getCurrentNode(start);
+	NodeIndex destNode = getCurrentNode(dest);
 
-	if (idx < this->nodeCount) {
-		return &this->nodes[idx];
+	if (startNode == INVALID_NODE || destNode == INVALID_NODE) {
+		path.clear();
+		return false;
 	}
-	return nullptr;
+	bool pathComplete = true;
+	bool found = searchPath(e, startNode, destNode, path, pathComplete);
+	if (complete != nullptr) *complete = pathComplete;
+	return found;
 }
 
 /**
-* @brief Marks nodes as obstacle when the match the collider positions.
-* @param e - Entity to mark the obstacles for
-* @param dest - Destination node.
+* @brief Updates the nodes occupied by the colliders. Only colliders that moved to other nodes, were added or were disabled change the grid.
 */
-void PhysicSystem::markNodesAsObstacles(Entity e, Node* dest) {
-	size_t componentCount = colliderManager->getComponentCount();
+void PhysicSystem::updateOccupancy() {
+	if (grid.getNodeCount() == 0 || tileWidth <= 0 || tileHeight <= 0) return;
+
+	// sleeping colliders do not move, only a new grid has to be occupied by every collider
+	size_t componentCount = (occupiedGeneration != occupancyGeneration) ? colliderManager->getComponentCount() : colliderManager->getAwakeCount();
+	occupiedGeneration = occupancyGeneration;
+	Entity player = (playerMovement != nullptr) ? playerMovement->getEntity() : Entity{ 0, "", false };
 
 	for (size_t i = 0; i < componentCount; i++)
 	{
 		Collider* collider = colliderManager->getComponentWithIndex(i);
+		Position* pos = positionManager->getComponent(collider->getEntity());
 
-		// skip self
-		if (collider->getEntity().uid == e.uid) continue;
-
-		if (collider->isActive() && !collider->isTrigger()) {
-			Position* pos = positionManager->getComponent(collider->getEntity());
-
-			SDL_Point* size = collider->getColliderSize();
-			
-			int colX = size->x / tileWidth;
-			int colY = size->y / tileHeight;
-
-			SDL_Point position = { 0,0 };
-
-			// handle moving unit 
-			if (enemyMovementManager->hasComponent(collider->getEntity())) {
-				if (colX == 1 && colY == 1) {
-					// collider equal to a tile
-					Node* node = nullptr;
+		if (!collider->isActive() || collider->isTrigger() || pos == nullptr) {
+			this->releaseCollider(collider);
+			continue;
+		}
 
-					//check corners
-					// top-left
-					position = { pos->x() - (size->x / 2),  pos->y() - (size->y / 2) };
-					node = this->getCurrentNode(position);
-					this->markNodeAsObstacle(node, dest);
+		bool registered = collider->getOccupancyGeneration() == occupancyGeneration;
+		OCCUPANCY_LAYERS layer = collider->getOccupancyLayer();
+		if (!registered) {
+			// colliders of moving entities are dynamic
+			Entity e = collider->getEntity();
+			bool moving = (player.uid != 0 && e.uid == player.uid) || enemyMovementManager->hasComponent(e) || projManager->hasComponent(e);
+			layer = moving ? OCCUPANCY_DYNAMIC : OCCUPANCY_STATIC;
+		}
 
-					// top-right
-					position = { pos->x() + (size->x / 2),  pos->y() - (size->y / 2) };
-					node = this->getCurrentNode(position);
-					this->markNodeAsObstacle(node, dest);
+		SDL_Point* size = collider->getColliderSize();
+		int colX = size->x / tileWidth;
+		int colY = size->y / tileHeight;
+		int left = pos->x() - (size->x / 2);
+		int top = pos->y() - (size->y / 2);
+
+		SDL_Rect nodes = { floorDiv(left, tileWidth), floorDiv(top, tileHeight), std::max(colX, 1), std::max(colY, 1) };
+		if (layer == OCCUPANCY_DYNAMIC && colX <= 1 && colY <= 1) {
+			// a collider up to the size of a tile occupies every node one of its corners is on
+			nodes.w = floorDiv(left + size->x / 2 * 2, tileWidth) - nodes.x + 1;
+			nodes.h = floorDiv(top + size->y / 2 * 2, tileHeight) - nodes.y + 1;
+		}
 
-					// bottom-left
-					position = { pos->x() - (size->x / 2),  pos->y() + (size->y / 2) };
-					node = this->getCurrentNode(position);
-					this->markNodeAsObstacle(node, dest);
+		if (registered) {
+			const SDL_Rect& occupied = collider->getOccupiedNodes();
+			if (occupied.x == nodes.x && occupied.y == nodes.y && occupied.w == nodes.w && occupied.h == nodes.h) continue;
+			this->setOccupants(occupied, layer, false);
+		}
+		this->setOccupants(nodes, layer, true);
+		collider->setOccupiedNodes(nodes, layer, occupancyGeneration);
+	}
+}
 
-					// bottom-right
-					position = { pos->x() + (size->x / 2),  pos->y() + (size->y / 2) };
-					node = this->getCurrentNode(position);
-					this->markNodeAsObstacle(node, dest);
+/**
+* @brief Removes the collider from the nodes it occupies. Has to be called before the collider is removed from the collider manager.
+* @param collider - Collider to release.
+*/
+void PhysicSystem::releaseCollider(Collider* collider) {
+	if (collider->getOccupancyGeneration() == occupancyGeneration) {
+		this->setOccupants(collider->getOccupiedNodes(), collider->getOccupancyLayer(), false);
+	}
+	collider->setOccupiedNodes({ 0,0,0,0 }, OCCUPANCY_STATIC, 0);
+}
 
-				}
-				else {
-					// collider equal to a tile
-					Node* node = nullptr;
-
-					int remainingSizeX = size->x;
-					int remainingSizeY = size->y;
-
-					for (int x = 0; x < colX; x++)
-					{
-						for (int y = 0; y < colY; y++)
-						{
-							position = { pos->x() - (size->x / 2) + (tileWidth*x) ,  pos->y() - (size->y / 2) + (tileHeight*y)};
-							node = this->getCurrentNode(position);
-							this->markNodeAsObstacle(node, dest);
-						}
-					}
-				}
+/**
+* @brief Adds or removes an occupant to every node of the area. Changes of the static layer invalidate the jump table, the clusters and the flow field.
+* @param nodes - Area in node coordinates.
+* @param layer - Occupancy layer.
+* @param add - Whether the occupant is added or removed.
+*/
+void PhysicSystem::setOccupants(const SDL_Rect& nodes, OCCUPANCY_LAYERS layer, bool add) {
+	for (int y = nodes.y; y < nodes.y + nodes.h; y++) {
+		for (int x = nodes.x; x < nodes.x + nodes.w; x++) {
+			NodeIndex node = grid.getIndex(x, y);
+			if (add) {
+				grid.addOccupant(node, layer);
 			}
 			else {
-				position = { pos->x() - (size->x / 2),  pos->y() - (size->y / 2) };
-				Node* colNode = nullptr;
-
-				if (colX > 0 && colY > 0) {
-					// collider bigger or equal to a tile
-					for (int x = 0; x < colX; x++)
-					{
-						for (int y = 0; y < colY; y++)
-						{
-							colNode = this->getCurrentNode({ position.x + x * tileWidth, position.y + y * tileHeight });
-							this->markNodeAsObstacle(colNode, dest);
-						}
-					}
-				}
-				else if (colX > 0) {
-					// collider height smaller than a tile
-					for (int x = 0; x < colX; x++)
-					{
-						colNode = this->getCurrentNode({ position.x + x * tileWidth, position.y });
-						this->markNodeAsObstacle(colNode, dest);
-					}
-				}
-				else if (colY > 0) {
-					// collider width smaller than a tile
-					for (int y = 0; y < colY; y++)
-					{
-						colNode = this->getCurrentNode({ position.x, position.y + y * tileHeight });
-						this->markNodeAsObstacle(colNode, dest);
-					}
-				}
-				else {
-					// collider smaller than a tile
-					colNode = this->getCurrentNode({ position.x, position.y });
-					this->markNodeAsObstacle(colNode, dest);
-				}
+				grid.removeOccupant(node, layer);
 			}
 		}
 	}
+
+	if (layer == OCCUPANCY_STATIC) {
+		grid.clearJumpTable();
+		hierarchicalGrid.invalidateArea(nodes.x, nodes.y, nodes.w, nodes.h);
+		this->invalidateFlowFields();
+	}
 }
 
 /**
-* @brief Marks node as obstacle if not destination node.
-* @param node - Node to mark as obstacle.
-* @param dest - Destination node.
+* @brief Removes or restores the nodes occupied by a dynamic collider, so an entity does not block its own path.
+* @param collider - Collider of the entity. Ignored if nullptr or not dynamic.
+* @param excluded - Whether the nodes are removed or restored.
 */
-void PhysicSystem::markNodeAsObstacle(Node* node, Node* dest) {
-	if (node != nullptr && node != dest) {
-		node->obstacle = true;
+void PhysicSystem::excludeOwnOccupancy(Collider* collider, bool excluded) {
+	if (collider != nullptr && collider->getOccupancyGeneration() == occupancyGeneration && collider->getOccupancyLayer() == OCCUPANCY_DYNAMIC) {
+		this->setOccupants(collider->getOccupiedNodes(), OCCUPANCY_DYNAMIC, !excluded);
 	}
 }
+
+/**
+* @brief Checks if the route of an enemy is blocked at the node. With local avoidance only static colliders and blocked nodes block the route, other enemies are steered around.
+* @param node - Node of the route.
+* @param own - Collider of the enemy. May be nullptr.
+* @return Whether the enemy has to search a new route.
+*/
+bool PhysicSystem::isRouteBlocked(NodeIndex node, Collider* own) {
+	if (!crowdAvoidance) return this->isNodeBlocked(node, own);
+	if (!grid.isValid(node)) return false;
+	return grid.getCost(node) == 0 || grid.getOccupants(node, OCCUPANCY_STATIC) > 0;
+}
+
+/**
+* @brief Checks if a node is blocked for an entity. The nodes occupied by the collider of the entity itself are ignored.
+* @param node - Node index.
+* @param own - Collider of the entity. May be nullptr.
+* @return Whether the node is blocked.
+*/
+bool PhysicSystem::isNodeBlocked(NodeIndex node, Collider* own) {
+	if (!grid.isValid(node) || !grid.isObstacle(node)) return false;
+
+	bool occupiedByOwn = false;
+	if (own != nullptr && own->getOccupancyGeneration() == occupancyGeneration && own->getOccupancyLayer() == OCCUPANCY_DYNAMIC) {
+		const SDL_Rect& occupied = own->getOccupiedNodes();
+		int x = grid.getX(node);
+		int y = grid.getY(node);
+		occupiedByOwn = x >= occupied.x && x < occupied.x + occupied.w && y >= occupied.y && y < occupied.y + occupied.h;
+	}
+	if (!occupiedByOwn) return true;
+
+	return grid.getOccupants(node, OCCUPANCY_STATIC) > 0 || grid.getOccupants(node, OCCUPANCY_DYNAMIC) > 1;
+}
 #pragma endregion AStar
\ No newline at end of file
@@ -3,6 +3,17 @@
 #include "../componentmanager.h"
 #include "../components/components.h"
 #include "../inputmanager.h"
+#include "../util/navigation/navgrid.h"
+#include "../util/navigation/flowfield.h"
+#include "../util/navigation/hierarchicalgrid.h"
+#include "../util/navigation/pathservice.h"
+#include "../util/navigation/pathcache.h"
+#include "../util/navigation/incrementalplanner.h"
+#include "../util/navigation/crowdavoidance.h"
+#include "../util/navigation/squad.h"
+#include "../util/navigation/routepool.h"
+#include "../util/ailevelofdetail.h"
+#include "../util/timerwheel.h"
 #include <cmath>
 #include <list>
 
@@ -43,16 +54,177 @@ public:
 	/**
 	 * @brief Gets the current Node based on the position.
 	 * @param pos - Position to get the current node off.
-	 * @return Current Node.
+	 * @return Index of the current node. INVALID_NODE if the position is outside of the grid.
 	*/
-	Node* getCurrentNode(Position* pos);
+	NodeIndex getCurrentNode(Position* pos);
 
 	/**
 	 * @brief Gets the current Node based on the position.
 	 * @param pos - Position to get the current node off.
-	 * @return Current Node.
+	 * @return Index of the current node. INVALID_NODE if the position is outside of the grid.
 	*/
-	Node* getCurrentNode(SDL_Point pos);
+	NodeIndex getCurrentNode(SDL_Point pos);
+
+	/**
+	 * @brief Calculates the path between two positions. Nodes occupied by other enemies are treated as obstacles.
+	 * @param e - Entity to calculate the path for.
+	 * @param start - Start position.
+	 * @param dest - Destination position.
+	 * @param path - Buffer the path is written to, from the destination back to the start. Cleared if no path was found.
+	 * @param complete - Set to whether the path ends at the destination. With the hierarchical search only the first part of a long path is calculated.
+	 * @return Whether a path was found.
+	*/
+	bool findPath(Entity e, SDL_Point start, SDL_Point dest, std::vector<NodeIndex>& path, bool* complete = nullptr);
+
+	/**
+	 * @brief Sets the search algorithm of the enemy pathfinding. Jump point search is only used while every walkable node has the same cost.
+	 * With jump point search plus the static colliders are stored in a jump table at the next search, enemies are not avoided by the search.
+	 * With the hierarchical search the static colliders are stored in the clusters at the next search, enemies are only avoided near the start and destination.
+	 * With the incremental search every enemy keeps its own search, enemies are only avoided near the searching enemy once the search was started.
+	 * @param algorithm - Search algorithm.
+	*/
+	void setPathfindingAlgorithm(PATHFINDING_ALGORITHMS algorithm) {
+		this->algorithm = algorithm;
+	}
+
+	/**
+	 * @brief Notifies the pathfinding that the walkable area inside of the area changed without a collider being added, removed or moved. The jump table and the flow fields are rebuilt and the clusters overlapping the area are updated at the next search.
+	 * Colliders are tracked by the occupancy of the grid and do not need a notification.
+	 * @param area - Changed area in world coordinates.
+	*/
+	void updateStaticObstacles(SDL_Rect area);
+
+	/**
+	 * @brief Updates the nodes occupied by the colliders. Only colliders that moved to other nodes, were added or were disabled change the grid.
+	 * Colliders of the player, enemies and projectiles are dynamic, every other collider is static.
+	*/
+	void updateOccupancy();
+
+	/**
+	 * @brief Removes the collider from the nodes it occupies. Has to be called before the collider is removed from the collider manager.
+	 * @param collider - Collider to release.
+	*/
+	void releaseCollider(Collider* collider);
+
+	/**
+	 * @brief Releases the route of an enemy in the route pool. Has to be called before the enemy movement component is removed from the enemy movement manager.
+	 * @param component - Enemy movement component of the enemy. Ignored if nullptr.
+	*/
+	void releaseRoute(EnemyMovement* component) {
+		if (component != nullptr) routes.release(component->getRouteHandle());
+	}
+
+	/**
+	 * @brief Gets the route pool storing the routes of the enemies.
+	 * @return Pointer to the route pool.
+	*/
+	RoutePool* getRoutePool() { return &routes; }
+
+	/**
+	 * @brief Sets whether enemies steer around each other with local avoidance. With avoidance enemies only search a new path if their route is blocked by a static collider, otherwise every enemy on the route triggers a new search.
+	 * @param enabled - Whether the local avoidance is enabled.
+	*/
+	void setCrowdAvoidance(bool enabled) { this->crowdAvoidance = enabled; }
+
+	/**
+	 * @brief Checks if enemies steer around each other with local avoidance.
+	 * @return Whether the local avoidance is enabled.
+	*/
+	bool usesCrowdAvoidance() { return crowdAvoidance; }
+
+	/**
+	 * @brief Sets the level of detail of the enemy movement. Enemies far from the camera are updated less often.
+	 * @param settings - Distances and update intervals of the tiers.
+	*/
+	void setAILevelOfDetail(AILevelOfDetail settings) { this->levelOfDetail = settings; }
+
+	/**
+	 * @brief Gets the level of detail of the enemy movement.
+	 * @return Distances and update intervals of the tiers.
+	*/
+	AILevelOfDetail getAILevelOfDetail() { return levelOfDetail; }
+
+	/**
+	 * @brief Gets the number of enemies per level of detail tier and how many of them were updated in the last frame.
+	 * @return Counters of the last frame.
+	*/
+	AILevelOfDetailStats getAILevelOfDetailStats() { return levelOfDetailStats; }
+
+	/**
+	 * @brief Sets the view area of the camera the level of detail of the enemies is measured from. Set before every update.
+	 * @param camera - View area of the camera in world coordinates.
+	*/
+	void setCamera(SDL_Rect camera) { this->camera = camera; }
+
+	/**
+	 * @brief Sets the timer wheel the pathfinding timers of the enemies are scheduled in. Without a timer wheel enemies only search a new path when their route is blocked.
+	 * @param timerWheel - Timer wheel of the engine.
+	*/
+	void setTimerWheel(TimerWheel* timerWheel) { this->timerWheel = timerWheel; }
+
+	/**
+	 * @brief Checks if two positions see each other on the navigation grid. Blocked tiles and static colliders block the sight.
+	 * @param a - First position.
+	 * @param b - Second position.
+	 * @return Whether the tiles of the positions see each other. false if a position is outside of the grid.
+	*/
+	bool hasLineOfSight(Position* a, Position* b) {
+		return this->grid.hasLineOfSight(this->getCurrentNode(a), this->getCurrentNode(b));
+	}
+
+	/**
+	 * @brief Creates a squad. Only the leader searches paths, the followers keep their formation slot around the leader and walk along the trail of the leader if they can not see their slot.
+	 * Enemies leading another squad disband it, followers of another squad leave it.
+	 * @param leader - Entity leading the squad.
+	 * @param followers - Entities following the leader. Entities without an enemy movement component are ignored.
+	 * @param formation - Formation of the followers.
+	 * @param spacing - Distance between the formation slots in pixels.
+	 * @return Index of the squad. Squad::NO_SQUAD if the leader has no enemy movement component.
+	*/
+	int createSquad(Entity leader, const std::vector<Entity>& followers, SQUAD_FORMATIONS formation, float spacing);
+
+	/**
+	 * @brief Disbands a squad. The followers search their own paths again.
+	 * @param squad - Index of the squad.
+	*/
+	void disbandSquad(int squad);
+
+	/**
+	 * @brief Gets the leader of a squad.
+	 * @param squad - Index of the squad.
+	 * @return Unique identifier of the leader. 0 if the squad does not exist.
+	*/
+	unsigned int getSquadLeader(int squad);
+
+	/**
+	 * @brief Gets the search algorithm of the enemy pathfinding.
+	 * @return Search algorithm.
+	*/
+	PATHFINDING_ALGORITHMS getPathfindingAlgorithm() { return algorithm; }
+
+	/**
+	 * @brief Sets the time budget per frame for the path requests of enemies. Requests that do not fit into the budget are solved in the next frames, at least one request is solved per frame.
+	 * @param budgetMS - Time budget in milliseconds. 0 solves every request in the frame it was made.
+	*/
+	void setPathfindingBudget(float budgetMS) { pathService.setBudget(budgetMS); }
+
+	/**
+	 * @brief Sets the maximum number of paths cached for reuse by later searches to the same destination. Removes every cached path.
+	 * @param capacity - Maximum number of cached paths. 0 disables the cache.
+	*/
+	void setPathCacheCapacity(size_t capacity) { pathCache.setCapacity(capacity); }
+
+	/**
+	 * @brief Gets the path cache of the enemy pathfinding.
+	 * @return Pointer to the path cache.
+	*/
+	PathCache* getPathCache() { return &pathCache; }
+
+	/**
+	 * @brief Gets the path service of the enemy pathfinding.
+	 * @return Pointer to the path service.
+	*/
+	PathService* getPathService() { return &pathService; }
 
 	/**
 	 * @brief Sets the current camera zoom values.
@@ -64,8 +236,164 @@ public:
 		this->cameraZoomY = cameraZoomY;
 	}
 private:
-	Node* nodes = nullptr;
-	size_t nodeCount = 0;
+	/**
+	 * @brief Navigation grid of the current tilemap.
+	*/
+	NavGrid grid;
+
+	/**
+	 * @brief Search algorithm of the enemy pathfinding.
+	*/
+	PATHFINDING_ALGORITHMS algorithm = PATHFINDING_ASTAR;
+
+	/**
+	 * @brief Maximum number of flow fields towards different destinations kept at the same time.
+	*/
+	static const size_t MAX_FLOW_FIELDS = 4;
+
+	/**
+	 * @brief Flow field towards one destination.
+	*/
+	struct FlowFieldSlot {
+		/**
+		 * @brief Number of the last update of the path requests the field was used in.
+		*/
+		unsigned int lastUpdate = 0;
+
+		/**
+		 * @brief Field state.
+		*/
+		FlowField field;
+	};
+
+	/**
+	 * @brief Flow fields shared by the enemies using the flow field, keyed by their destination. Each field is built at most once per update of the path requests.
+	*/
+	FlowFieldSlot flowFields[MAX_FLOW_FIELDS];
+
+	/**
+	 * @brief Number of the current update of the path requests.
+	*/
+	unsigned int pathUpdate = 0;
+
+	/**
+	 * @brief Clusters of the navigation grid for the hierarchical search.
+	*/
+	HierarchicalGrid hierarchicalGrid;
+
+	/**
+	 * @brief Queue of the path requests of enemies.
+	*/
+	PathService pathService;
+
+	/**
+	 * @brief Cache of the paths found by the searches.
+	*/
+	PathCache pathCache;
+
+	/**
+	 * @brief Occupancy generation of the current grid. Colliders that occupy nodes of an older generation occupy the current grid at the next update.
+	*/
+	uint32_t occupancyGeneration = 0;
+
+	/**
+	 * @brief Occupancy generation every collider occupied the grid with. Sleeping colliders are only updated if it is older than the current generation.
+	*/
+	uint32_t occupiedGeneration = UINT32_MAX;
+
+	/**
+	 * @brief Distance in tiles up to which enemies avoid each other.
+	*/
+	static const int CROWD_NEIGHBOUR_TILES = 3;
+
+	/**
+	 * @brief Entity taking part in the local avoidance of the current frame.
+	*/
+	struct CrowdMember {
+		// nullptr if the entity is only avoided
+		EnemyMovement* movement;
+		Position* position;
+	};
+
+	/**
+	 * @brief Whether enemies steer around each other with local avoidance.
+	*/
+	bool crowdAvoidance = true;
+
+	/**
+	 * @brief Local avoidance between the enemies.
+	*/
+	CrowdAvoidance crowd;
+
+	/**
+	 * @brief Entities of the local avoidance by agent index.
+	*/
+	std::vector<CrowdMember> crowdMembers;
+
+	/**
+	 * @brief Line of sight queries of the enemies noticing their target in the current frame.
+	*/
+	std::vector<NavGrid::SightQuery> sightQueries;
+
+	/**
+	 * @brief Enemies of the line of sight queries by query index.
+	*/
+	std::vector<EnemyMovement*> sightQueryEnemies;
+
+	/**
+	 * @brief Squads of enemies by index. Disbanded squads are reused.
+	*/
+	std::vector<Squad> squads;
+
+	/**
+	 * @brief Maximum number of entities with an own incremental search at the same time.
+	*/
+	static const size_t MAX_INCREMENTAL_PLANNERS = 32;
+
+	/**
+	 * @brief Time in milliseconds an incremental search has to be unused before it is given to another entity.
+	*/
+	static const Uint32 PLANNER_IDLE_MS = 2000;
+
+	/**
+	 * @brief Incremental search of an entity.
+	*/
+	struct PlannerSlot {
+		/**
+		 * @brief Whether the search belongs to an entity.
+		*/
+		bool assigned = false;
+
+		/**
+		 * @brief Unique identifier of the entity the search belongs to.
+		*/
+		unsigned int uid = 0;
+
+		/**
+		 * @brief Timestamp of the last use of the search.
+		*/
+		Uint32 lastUse = 0;
+
+		/**
+		 * @brief Search state.
+		*/
+		IncrementalPlanner planner;
+	};
+
+	/**
+	 * @brief Incremental searches of the entities. Entities without a search use a* while every search is in use.
+	*/
+	PlannerSlot planners[MAX_INCREMENTAL_PLANNERS];
+
+	/**
+	 * @brief Path buffer of the enemy movement. Reused by every search.
+	*/
+	std::vector<NodeIndex> pathBuffer;
+
+	/**
+	 * @brief Routes of the enemies, referenced by handle from the enemy movement components.
+	*/
+	RoutePool routes;
 
 	/**
 	 * @brief Pointer to input manager to use the user input.
@@ -107,9 +435,29 @@ private:
 	ComponentManager<EnemyMovement>* enemyMovementManager;
 
 	/**
-	 * @brief Last timestamp of enemy movement simulation. Used to increase the pathfinding timers to the enemy movement components accordingly.
+	 * @brief Number of enemy movement simulations. Used to schedule the updates of enemies that are not updated every frame.
 	*/
-	Uint32 lastEnemyMovementTimestamp = 0;
+	uint32_t enemyMovementFrame = 0;
+
+	/**
+	 * @brief Level of detail of the enemy movement.
+	*/
+	AILevelOfDetail levelOfDetail;
+
+	/**
+	 * @brief Level of detail counters of the last frame.
+	*/
+	AILevelOfDetailStats levelOfDetailStats;
+
+	/**
+	 * @brief View area of the camera in world coordinates.
+	*/
+	SDL_Rect camera = { 0,0,0,0 };
+
+	/**
+	 * @brief Timer wheel of the pathfinding timers.
+	*/
+	TimerWheel* timerWheel = nullptr;
 
 	/**
 	 * @brief Tilewidth of the current tilemap.
@@ -181,38 +529,149 @@ private:
 	void detectCollisions();
 
 	/**
-	 * @brief Calculates the heuristic cost of the position to the destination.
-	 * @param pos - Position to calculate the heuristic cost of.
+	 * @brief Calculates the path from the start node to the destination node using the selected search algorithm. Nodes occupied by colliders other than the one of the entity are treated as obstacles. Destinations that are not connected to the start node fail without a search.
+	 * @param e - Entity to calculate path for.
+	 * @param start - Startnode.
 	 * @param dest - Destination node.
-	 * @return Heuristic cost from the position to the destination.
+	 * @param path - Buffer the path is written to, from the destination node back to the start node. Cleared if no path was found.
+	 * @param complete - Set to whether the path ends at the destination node.
+	 * @return Whether a path was found.
 	*/
-	float calculateHCost(Node* pos, Node* dest);
+	bool searchPath(Entity e, NodeIndex start, NodeIndex dest, std::vector<NodeIndex>& path, bool& complete);
 
 	/**
-	 * @brief Marks nodes as obstacle when the match the collider positions.
-	 * @param e - Entity to mark the obstacles for
-	 * @param dest - Destination node.
+	 * @brief Adds or removes an occupant to every node of the area. Changes of the static layer invalidate the jump table, the clusters and the flow field.
+	 * @param nodes - Area in node coordinates.
+	 * @param layer - Occupancy layer.
+	 * @param add - Whether the occupant is added or removed.
 	*/
-	void markNodesAsObstacles(Entity e, Node* dest);
+	void setOccupants(const SDL_Rect& nodes, OCCUPANCY_LAYERS layer, bool add);
 
 	/**
-	 * @brief Calculates the path from the start node to the destination node using the a* algorithm.
-	 * @param e - Entity to calculate path for.
-	 * @param start - Startnode.
-	 * @param dest - Destination node.
-	 * @return Path from the start node to the destination node.
+	 * @brief Removes or restores the nodes occupied by a dynamic collider, so an entity does not block its own path.
+	 * @param collider - Collider of the entity. Ignored if nullptr or not dynamic.
+	 * @param excluded - Whether the nodes are removed or restored.
 	*/
-	std::vector<Node*> aStar(Entity e, Node* start, Node* dest);
+	void excludeOwnOccupancy(Collider* collider, bool excluded);
 
 	/**
-	 * @brief Handles the movement of enemies.
+	 * @brief Checks if a node is blocked for an entity. The nodes occupied by the collider of the entity itself are ignored.
+	 * @param node - Node index.
+	 * @param own - Collider of the entity. May be nullptr.
+	 * @return Whether the node is blocked.
 	*/
-	void handleEnemyMovement();
+	bool isNodeBlocked(NodeIndex node, Collider* own);
+
+	/**
+	 * @brief Divides and rounds towards negative infinity, so positions left of or above the grid get negative node coordinates.
+	 * @param value - Dividend.
+	 * @param divisor - Positive divisor.
+	 * @return Rounded quotient.
+	*/
+	static int floorDiv(int value, int divisor) {
+		return (value >= 0) ? value / divisor : -((-value + divisor - 1) / divisor);
+	}
+
+	/**
+	 * @brief Gets the incremental search of an entity. The least recently used search is given to the entity if it has none and the search was unused for PLANNER_IDLE_MS.
+	 * @param e - Entity to get the search for.
+	 * @return Pointer to the search. nullptr if every search is in use.
+	*/
+	IncrementalPlanner* getPlanner(Entity e);
+
+	/**
+	 * @brief Gets the level of detail tier of an enemy from its distance to the view area of the camera.
+	 * @param position - Position of the enemy.
+	 * @return Tier of the enemy. Always AI_LOD_NEAR if the level of detail is disabled or the camera is not set.
+	*/
+	AI_LOD_TIERS getLevelOfDetailTier(Position* position);
+
+	/**
+	 * @brief Moves an enemy far from the camera along its route without steering. The enemy walks the distance of the skipped frames from node to node at once.
+	 * @param component - Enemy movement component of the enemy.
+	 * @param position - Position of the enemy.
+	 * @param collider - Collider of the enemy. May be nullptr.
+	 * @param frames - Number of frames since the last update of the enemy.
+	*/
+	void moveAlongRoute(EnemyMovement* component, Position* position, Collider* collider, uint32_t frames);
+
+	/**
+	 * @brief Schedules the pathfinding timer of an enemy. The previous timer of the enemy is canceled.
+	 * @param component - Enemy movement component of the enemy.
+	*/
+	void schedulePathfindingTimer(EnemyMovement* component);
+
+	/**
+	 * @brief Updates the heading and the trail of every squad from the movement of its leader. Squads whose leader was removed are disbanded.
+	*/
+	void updateSquads();
+
+	/**
+	 * @brief Moves a squad follower to its formation slot. Followers that can not see their slot walk to the leader or the latest node of the trail of the leader they see.
+	 * @param component - Enemy movement component of the follower.
+	 * @param position - Position of the follower.
+	 * @param collider - Collider of the follower. May be nullptr.
+	 * @param agent - Agent index of the follower in the local avoidance.
+	 * @param tier - Level of detail tier of the follower.
+	 * @param frames - Number of frames since the last update of the follower.
+	 * @param direction - Set to the movement direction for the animations.
+	 * @return Whether the follower was moved. Otherwise the leader is set as destination of a flagged follower, so it searches an own path once per pathfinding timer.
+	*/
+	bool moveFollower(EnemyMovement* component, Position* position, Collider* collider, size_t agent, AI_LOD_TIERS tier, uint32_t frames, Vector2& direction);
+
+	/**
+	 * @brief Checks the line of sight of the queued enemies to their target in one batch. Enemies that see their target start chasing it.
+	*/
+	void resolveSightQueries();
+
+	/**
+	 * @brief Adds an entity with a collider to the local avoidance of the frame. The entity is avoided by the enemies and only steers itself once its preferred velocity is set.
+	 * @param e - Entity to add.
+	 * @param component - Enemy movement component of the entity. nullptr for entities that are only avoided, like the player.
+	 * @return Index of the agent. CrowdAvoidance::NO_AGENT if the avoidance is disabled or the entity has no active collider.
+	*/
+	size_t addCrowdAgent(Entity e, EnemyMovement* component);
 
 	/**
-	 * @brief Marks node as obstacle if not destination node.
-	 * @param node - Node to mark as obstacle.
+	 * @brief Solves the local avoidance and moves the steering enemies. Enemies that would be steered onto a statically blocked node follow their route instead.
+	*/
+	void moveCrowd();
+
+	/**
+	 * @brief Checks if the route of an enemy is blocked at the node. With local avoidance only static colliders and blocked nodes block the route, other enemies are steered around.
+	 * @param node - Node of the route.
+	 * @param own - Collider of the enemy. May be nullptr.
+	 * @return Whether the enemy has to search a new route.
+	*/
+	bool isRouteBlocked(NodeIndex node, Collider* own);
+
+	/**
+	 * @brief Queues a path request for the enemy in the path service. Enemies without a route to follow are urgent, a pending request is only queued again if it becomes urgent. Requests to an unreachable destination are rejected immediately and flagged on the component.
+	 * @param component - Enemy movement component requesting the path.
+	 * @param current - Index of the node the enemy currently occupies.
+	*/
+	void requestPath(EnemyMovement* component, NodeIndex current);
+
+	/**
+	 * @brief Solves the queued path requests within the time budget of the path service and delivers the routes to the enemies.
+	*/
+	void solvePathRequests();
+
+	/**
+	 * @brief Gets the flow field towards the destination node. If no field belongs to the destination, the least recently used field is built for it unless it was used in the current update.
+	 * Static colliders are avoided by the field, nodes occupied by enemies are avoided while following it.
 	 * @param dest - Destination node.
+	 * @return Pointer to the field. nullptr if every field was used for another destination in the current update.
 	*/
-	void markNodeAsObstacle(Node* node, Node* dest);
+	FlowField* getFlowField(NodeIndex dest);
+
+	/**
+	 * @brief Invalidates every flow field. The fields are built again when they are used next.
+	*/
+	void invalidateFlowFields();
+
+	/**
+	 * @brief Handles the movement of enemies.
+	*/
+	void handleEnemyMovement();
 };
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "rendersystem.h"
+#include <algorithm>
+#include <cmath>
 /**
 * @brief Constructor for RenderSystem objects to set needed references.
 * @param frameDelay - Delay between frames.
@@ -19,6 +21,19 @@ RenderSystem::RenderSystem(int frameDelay, ComponentManager<Sprite>* spriteManag
 	this->uiManager = uiManager;
 	this->colliderManager = colliderManager;
 	this->enemyMovementManager = enemyMovementManager;
+
+	// sorting buffers match the sprite capacity, so sorting never allocates during the game loop
+	this->sortedSpritePositions.resize(spriteManager->getCapacity());
+	this->sortArr.resize(spriteManager->getCapacity());
+}
+
+/**
+* @brief Destructor of the render system. Deletes the current tilemap and tileset.
+*/
+RenderSystem::~RenderSystem() {
+	this->destroyTilemapChunks();
+	delete tilemap;
+	delete tileset;
 }
 
 /**
@@ -56,7 +71,7 @@ void RenderSystem::render() {
 */
 void RenderSystem::debugPosition() {
 	if (debug) {
-		size_t componentCount = positionManager->getComponentCount();
+		size_t componentCount = positionManager->getAwakeCount();
 
 		for (size_t i = 0; i < componentCount; i++)
 		{
@@ -72,7 +87,7 @@ void RenderSystem::debugPosition() {
 */
 void RenderSystem::debugColliders() {
 	if (debug) {
-		size_t componentCount = colliderManager->getComponentCount();
+		size_t componentCount = colliderManager->getAwakeCount();
 
 		for (size_t i = 0; i < componentCount; i++)
 		{
@@ -91,22 +106,30 @@ void RenderSystem::debugColliders() {
 * @brief Debug functrion that visualizes the enemy pathing.
 */
 void RenderSystem::debugEnemyPathing() {
-	if (debug) {
-		size_t componentCount = enemyMovementManager->getComponentCount();
+	if (debug && routePool != nullptr) {
+		size_t componentCount = enemyMovementManager->getAwakeCount();
 		unsigned w = (unsigned)(this->getTileWidth()*this->cameraZoomX);
 		unsigned h = (unsigned)(this->getTileHeight()*this->cameraZoomY);
 
-		Node* prev = nullptr;
+		int tilesPerRow = this->getTilesPerRow();
+		if (tilesPerRow < 1) return;
+
+		NodeIndex prev = INVALID_NODE;
 		for (size_t i = 0; i < componentCount; i++)
 		{
 			EnemyMovement* component = enemyMovementManager->getComponentWithIndex(i);
-			for (auto node : component->getRoute()) {
-				if (prev != nullptr) {
-					SDL_RenderDrawLine(renderer, (prev->x * w + (w/2))-camera.x, (prev->y * h + (h/2))-camera.y, (node->x * w + (w / 2))-camera.x, (node->y * h + (h / 2))-camera.y);
+			for (int j = 0; j < component->getRouteLength(); j++) {
+				NodeIndex node = routePool->getNode(component->getRouteHandle(), j);
+				if (prev != INVALID_NODE) {
+					int prevX = prev % tilesPerRow;
+					int prevY = prev / tilesPerRow;
+					int nodeX = node % tilesPerRow;
+					int nodeY = node / tilesPerRow;
+					SDL_RenderDrawLine(renderer, (prevX * w + (w/2))-camera.x, (prevY * h + (h/2))-camera.y, (nodeX * w + (w / 2))-camera.x, (nodeY * h + (h / 2))-camera.y);
 				}
 				prev = node;
 			}
-			prev = nullptr;
+			prev = INVALID_NODE;
 		}
 	}
 }
@@ -199,9 +222,7 @@ void RenderSystem::renderButtons() {
 */
 void RenderSystem::renderSprites() {
 	// sort sprites to display depth in 2d environment
-	sortSprites();
-
-	size_t index = spriteManager->getComponentCount();
+	size_t index = sortSprites();
 	for (size_t i = 0; i < index; i++)
 	{
 		Position* spritePosition = &sortedSpritePositions[i];
@@ -213,12 +234,13 @@ void RenderSystem::renderSprites() {
 }
 
 /**
-* @brief Sorts the sprite before rendering. Needed to be able to display depth in 2d environment.
+* @brief Sorts the sprites of the awake entities before rendering. Needed to be able to display depth in 2d environment.
+* @return Number of sorted sprites.
 */
-void RenderSystem::sortSprites() {
+size_t RenderSystem::sortSprites() {
 	// copy current array
 	size_t counter = 0;
-	size_t componentCount = positionManager->getComponentCount();
+	size_t componentCount = positionManager->getAwakeCount();
 	if (componentCount != 0) {
 		for (size_t i = 0; i < componentCount; i++) {
 			Position* pos = positionManager->getComponentWithIndex(i);
@@ -233,6 +255,7 @@ void RenderSystem::sortSprites() {
 			mergeSort(&sortedSpritePositions[0], 0, counter - 1);
 		}
 	}
+	return counter;
 }
 
 /**
@@ -416,26 +439,182 @@ void RenderSystem::animateSprite(Sprite* sprite, Animator* animator) {
 */
 Tilemap* RenderSystem::setMap(const char* tilesetPath, const char* tilemapPath, size_t layerCount) {
 	SDL_Point size = { 0,0 };
+	this->destroyTilemapChunks();
+	if (tilemap != nullptr) {
+		delete tilemap;
+	}
 	tilemap = FileLoader::loadTilemap(tilemapPath, layerCount);
 
 	if (tilesetPath != nullptr) {
 		Texture tilesetTexture = FileLoader::loadTexture(tilesetPath, renderer);
 
+		delete tileset;
 		tileset = new Tileset(tilesetTexture);
 	}
 	else if (tileset->getTexture().texture == nullptr) {
-		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Tilemap error", "No tileset was found.", NULL);
+		Log::error("Tilemap error", "No tileset was found.");
 	}
 
-	// set srcRect
-	tileset->initSourceRect(tilemap->getTileWidth(), tilemap->getTileHeight());
+	// source rectangles of the tiles are looked up instead of computed per tile
+	tileset->initTileRects(tilemap->getTileWidth(), tilemap->getTileHeight());
 
 	// set destRect
 	tileset->initDestinationRect(tilemap->getTileWidth(), tilemap->getTileHeight());
 
+	this->createTilemapChunks();
 	return this->tilemap;
 }
 
+/**
+* @brief Changes a tile of a tile layer. Only the chunk containing the tile is rendered again. Colliders and objects created from the tilemap are not changed.
+* @param layer - Index of the layer.
+* @param column - Column of the tile.
+* @param row - Row of the tile.
+* @param tile - New tile. 0 for an empty tile.
+*/
+void RenderSystem::setTile(size_t layer, unsigned int column, unsigned int row, unsigned int tile) {
+	if (tilemap == nullptr || column >= tilemap->getTilesPerRow() || row >= tilemap->getTilesPerCol()) {
+		return;
+	}
+	if (!tilemap->setTile(layer, (size_t)row * tilemap->getTilesPerRow() + column, tile) || tilemapChunks.empty()) {
+		return;
+	}
+	tilemapChunks[(row / chunkTilesY) * chunkColumns + column / chunkTilesX].dirty = true;
+}
+
+/**
+* @brief Renders every tilemap chunk again at the next update. Needed when the renderer lost the content of its render targets.
+*/
+void RenderSystem::invalidateTilemapChunks() {
+	for (size_t i = 0; i < tilemapChunks.size(); i++) {
+		tilemapChunks[i].dirty = true;
+	}
+}
+
+/**
+* @brief Creates and renders the chunks of the current tilemap. Without support for render targets and custom blend modes the tiles are rendered one by one.
+*/
+void RenderSystem::createTilemapChunks() {
+	if (tilemap == nullptr || tileset == nullptr || !SDL_RenderTargetSupported(renderer)) {
+		return;
+	}
+	int tileWidth = (int)tilemap->getTileWidth();
+	int tileHeight = (int)tilemap->getTileHeight();
+	int columns = (int)tilemap->getTilesPerRow();
+	int rows = (int)tilemap->getTilesPerCol();
+	if (tileWidth <= 0 || tileHeight <= 0 || columns <= 0 || rows <= 0) {
+		return;
+	}
+
+	// the chunk is transparent where no tile covers it, so the tiles are stored with premultiplied alpha. Blending the chunk normally would fade semi-transparent tiles twice.
+	chunkBakeBlendMode = SDL_ComposeCustomBlendMode(SDL_BLENDFACTOR_SRC_ALPHA, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+		SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+	chunkBlendMode = SDL_ComposeCustomBlendMode(SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+		SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+	SDL_Texture* tilesetTexture = tileset->getTexture().texture;
+	SDL_BlendMode tilesetBlendMode;
+	SDL_GetTextureBlendMode(tilesetTexture, &tilesetBlendMode);
+	bool supported = SDL_SetTextureBlendMode(tilesetTexture, chunkBakeBlendMode) == 0;
+	SDL_SetTextureBlendMode(tilesetTexture, tilesetBlendMode);
+	if (!supported) {
+		return;
+	}
+
+	// chunks end at tile borders, so no tile is split between two chunks
+	chunkTilesX = std::max(TILEMAP_CHUNK_SIZE / tileWidth, 1);
+	chunkTilesY = std::max(TILEMAP_CHUNK_SIZE / tileHeight, 1);
+	chunkColumns = (columns + chunkTilesX - 1) / chunkTilesX;
+	int chunkRows = (rows + chunkTilesY - 1) / chunkTilesY;
+	tilemapChunks.reserve((size_t)chunkColumns * chunkRows);
+
+	for (int y = 0; y < chunkRows; y++) {
+		for (int x = 0; x < chunkColumns; x++) {
+			SDL_Rect tiles = { x * chunkTilesX, y * chunkTilesY, std::min(chunkTilesX, columns - x * chunkTilesX), std::min(chunkTilesY, rows - y * chunkTilesY) };
+			SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, tiles.w * tileWidth, tiles.h * tileHeight);
+			if (texture == nullptr) {
+				// the tiles are rendered one by one instead
+				Log::error("Tilemap error", SDL_GetError());
+				this->destroyTilemapChunks();
+				return;
+			}
+			if (SDL_SetTextureBlendMode(texture, chunkBlendMode) != 0) {
+				SDL_DestroyTexture(texture);
+				this->destroyTilemapChunks();
+				return;
+			}
+			MemoryTracker::trackAllocation(TAG_TILEMAP, MemoryTracker::getTextureSize(texture));
+			tilemapChunks.push_back({ texture, tiles, true });
+		}
+	}
+
+	// the whole map is rendered at load, so moving the camera does not render chunks
+	for (size_t i = 0; i < tilemapChunks.size(); i++) {
+		this->bakeTilemapChunk(tilemapChunks[i]);
+	}
+}
+
+/**
+* @brief Destroys the chunks of the current tilemap.
+*/
+void RenderSystem::destroyTilemapChunks() {
+	for (size_t i = 0; i < tilemapChunks.size(); i++) {
+		MemoryTracker::trackDeallocation(TAG_TILEMAP, MemoryTracker::getTextureSize(tilemapChunks[i].texture));
+		SDL_DestroyTexture(tilemapChunks[i].texture);
+	}
+	tilemapChunks.clear();
+	chunkColumns = 0;
+}
+
+/**
+* @brief Renders the tile layers of the area of a chunk into its texture.
+* @param chunk - Chunk to render.
+*/
+void RenderSystem::bakeTilemapChunk(TilemapChunk& chunk) {
+	unsigned int maxTilesPerRow = tilemap->getTilesPerRow();
+	unsigned int tileWidth = tilemap->getTileWidth();
+	unsigned int tileHeight = tilemap->getTileHeight();
+	int layers = (int)tilemap->getLayerCount();
+	int collisionLayer = tilemap->getCollisionLayerIndex();
+	int objectLayer = tilemap->getTilemapObjectLayerIndex();
+	SDL_Texture* texture = tileset->getTexture().texture;
+
+	// the chunk is cleared to transparent, the draw color of the renderer and the blend mode of the tileset are kept
+	SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+	Uint8 r, g, b, a;
+	SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+	SDL_BlendMode tilesetBlendMode;
+	SDL_GetTextureBlendMode(texture, &tilesetBlendMode);
+	SDL_SetTextureBlendMode(texture, chunkBakeBlendMode);
+	SDL_SetRenderTarget(renderer, chunk.texture);
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+	SDL_RenderClear(renderer);
+
+	for (int i = 0; i < layers; i++)
+	{
+		if (i == collisionLayer || i == objectLayer) {
+			continue;
+		}
+		TileLayer layer = tilemap->getLayer(i);
+		if (layer.size() == 0) continue;
+
+		for (int y = 0; y < chunk.tiles.h; y++) {
+			size_t rowStart = (size_t)(chunk.tiles.y + y) * maxTilesPerRow + chunk.tiles.x;
+			for (int x = 0; x < chunk.tiles.w; x++) {
+				const SDL_Rect* src = tileset->getTileRect(layer[rowStart + x]);
+				if (src == nullptr) continue;
+
+				SDL_Rect dest = { (int)(x * tileWidth), (int)(y * tileHeight), (int)tileWidth, (int)tileHeight };
+				SDL_RenderCopy(renderer, texture, src, &dest);
+			}
+		}
+	}
+
+	SDL_SetRenderTarget(renderer, previousTarget);
+	SDL_SetRenderDrawColor(renderer, r, g, b, a);
+	SDL_SetTextureBlendMode(texture, tilesetBlendMode);
+	chunk.dirty = false;
+}
+
 /**
 * @brief Renders the tilemap.
 */
@@ -443,80 +622,99 @@ void RenderSystem::renderTilemap() {
 	if (this->tilemap == nullptr || this->tileset == nullptr) {
 		return;
 	}
-	unsigned int currentDestX = 0;
-	unsigned int currentDestY = 0;
+
 	unsigned int maxTilesPerRow = tilemap->getTilesPerRow();
 	unsigned int tileWidth = tilemap->getTileWidth();
 	unsigned int tileHeight = tilemap->getTileHeight();
-	size_t layers = tilemap->getLayerCount();
+	float zoomedWidth = tileWidth * cameraZoomX;
+	float zoomedHeight = tileHeight * cameraZoomY;
+	SDL_Rect visible;
+
+	// only the tiles inside the camera are iterated, so the cost depends on the window instead of the map size
+	if (!this->getVisibleTiles(zoomedWidth, zoomedHeight, visible)) {
+		return;
+	}
+
+	// pre-rendered chunks replace the tiles with one copy per visible chunk
+	if (!tilemapChunks.empty()) {
+		int lastChunkX = (visible.x + visible.w - 1) / chunkTilesX;
+		int lastChunkY = (visible.y + visible.h - 1) / chunkTilesY;
+		for (int y = visible.y / chunkTilesY; y <= lastChunkY; y++) {
+			for (int x = visible.x / chunkTilesX; x <= lastChunkX; x++) {
+				TilemapChunk& chunk = tilemapChunks[(size_t)y * chunkColumns + x];
+
+				// changed chunks are rendered again once they are visible
+				if (chunk.dirty) {
+					this->bakeTilemapChunk(chunk);
+				}
+
+				// neighbouring chunks share their rounded borders, so no gaps appear between them
+				int left = (int)(chunk.tiles.x * zoomedWidth) - camera.x;
+				int top = (int)(chunk.tiles.y * zoomedHeight) - camera.y;
+				int right = (int)((chunk.tiles.x + chunk.tiles.w) * zoomedWidth) - camera.x;
+				int bottom = (int)((chunk.tiles.y + chunk.tiles.h) * zoomedHeight) - camera.y;
+				SDL_Rect dest = { left, top, right - left, bottom - top };
+				SDL_RenderCopy(renderer, chunk.texture, nullptr, &dest);
+			}
+		}
+		return;
+	}
+
+	int layers = (int)tilemap->getLayerCount();
 	int collisionLayer = tilemap->getCollisionLayerIndex();
 	int objectLayer = tilemap->getTilemapObjectLayerIndex();
+	SDL_Texture* texture = tileset->getTexture().texture;
 
-	for (size_t i = 0; i < layers; i++)
+	for (int i = 0; i < layers; i++)
 	{
 		if (i == collisionLayer || i == objectLayer) {
 			continue;
 		}
-		currentDestX = 0;
-		currentDestY = 0;
-		std::vector<unsigned int> layer = tilemap->getLayer(i);
-		for (size_t i = 0; i < layer.size(); i++)
+		TileLayer layer = tilemap->getLayer(i);
+		if (layer.size() == 0) continue;
+
+		for (int y = visible.y; y < visible.y + visible.h; y++)
 		{
-			// checks if current x-position is greater or equals to max tilecount in row
-			if (currentDestX >= maxTilesPerRow) {
-				currentDestX = 0;
-				currentDestY = currentDestY + 1;
-			}
-			// check if spot is empty
-			if (layer[i] != 0) {
-				// calculate part to render
-				setTilesetSrcRectPosition(layer[i], tileWidth, tileHeight);
+			size_t rowStart = (size_t)y * maxTilesPerRow;
+			for (int x = visible.x; x < visible.x + visible.w; x++)
+			{
+				// part to render, nullptr if the spot is empty
+				const SDL_Rect* src = tileset->getTileRect(layer[rowStart + x]);
+				if (src == nullptr) continue;
 
 				// calculate part to render at ingame
-				setTilesetDestRectPosition(currentDestX, currentDestY, tileWidth, tileHeight);
+				setTilesetDestRectPosition(x, y, tileWidth, tileHeight);
 
 				SDL_Rect* rect = tileset->getDestinationRect();
-				SDL_Rect newRect = { rect->x, rect->y, rect->w*cameraZoomX, rect->h*cameraZoomY };
-				
-				if ((newRect.x + newRect.w) < 0 || newRect.x > window.x || (newRect.y + newRect.h) < 0 || newRect.y > window.y) {
-					// skip rendering
-				}
-				else {
-					// if tile is in camera view, render tile.
-					SDL_RenderCopy(renderer, tileset->getTexture().texture, tileset->getSourceRect(), &newRect);
-				} 
+				SDL_Rect newRect = { rect->x, rect->y, (int)(rect->w * cameraZoomX), (int)(rect->h * cameraZoomY) };
+				SDL_RenderCopy(renderer, texture, src, &newRect);
 			}
-			currentDestX = currentDestX + 1;
 		}
 	}
 }
 
 /**
-* @brief Sets the source rectangle of the tileset to display the right part of the tileset. It is important that the size of the tileset is a multiple of the tilesize.
-* @param tilemapData - What tile to display based on the tilemap.
-* @param tileWidth - Width of the tiles.
-* @param tileHeight - Height of the tiles.
+* @brief Gets the tiles of the tilemap that overlap the camera.
+* @param tileWidth - Width of a tile on the screen.
+* @param tileHeight - Height of a tile on the screen.
+* @param visible - Set to the first visible column and row and the number of visible columns and rows.
+* @return Whether any tile is visible.
 */
-void RenderSystem::setTilesetSrcRectPosition(unsigned int tilemapData, unsigned int tileWidth, unsigned int tileHeight) {
-	unsigned int tilesetWidth = tileset->getTexture().textureWidth;
-
-	int newX;
-	int newY;
-	// check if first row tileWidth * maxWidth
-	if ((tilemapData * tileWidth) <= (tilesetWidth)) {
-		newX = (tilemapData == 0) ? tilemapData * tileWidth : (tilemapData - 1) * tileWidth;
-		newY = 0;
-	}
-	else {
-		// calculate row
-		unsigned int yoffset = (tilemapData * tileWidth) / (tilesetWidth);
-		unsigned int xoffset = ((tilemapData * tileWidth) % (tilesetWidth)) / tileWidth;
-
-		newX = (xoffset == 0) ? xoffset * tileWidth : (xoffset - 1) * tileWidth;
-		newY = yoffset * tileHeight;
-	}
-	// set source rect position
-	tileset->setSourceRect(newX, newY);
+bool RenderSystem::getVisibleTiles(float tileWidth, float tileHeight, SDL_Rect& visible) {
+	int columns = (int)tilemap->getTilesPerRow();
+	int rows = (int)tilemap->getTilesPerCol();
+	if (tileWidth <= 0.0f || tileHeight <= 0.0f || columns <= 0 || rows <= 0) {
+		return false;
+	}
+	int firstColumn = std::max((int)std::floor(camera.x / tileWidth), 0);
+	int firstRow = std::max((int)std::floor(camera.y / tileHeight), 0);
+	int lastColumn = std::min((int)std::floor((camera.x + window.x) / tileWidth), columns - 1);
+	int lastRow = std::min((int)std::floor((camera.y + window.y) / tileHeight), rows - 1);
+	if (firstColumn > lastColumn || firstRow > lastRow) {
+		return false;
+	}
+	visible = { firstColumn, firstRow, lastColumn - firstColumn + 1, lastRow - firstRow + 1 };
+	return true;
 }
 
 /**
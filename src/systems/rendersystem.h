@@ -6,6 +6,7 @@
 #include "../util/fileloader.h"
 #include "../util/tilemap.h"
 #include "../uimanager.h"
+#include "../util/log.h"
 /**
  * @brief Render System to render objects and tilemaps in game world.
 */
@@ -24,6 +25,11 @@ public:
 	*/
 	RenderSystem(int frameDelay, ComponentManager<Sprite>* spriteManager, ComponentManager<Position>* positionManager, SDL_Renderer* renderer,ComponentManager<Animator>* animatorManager, UIManager* uiManager,
 		ComponentManager<Collider>* colliderManager, ComponentManager<EnemyMovement>* enemyMovementManager);
+
+	/**
+	 * @brief Destructor of the render system. Deletes the current tilemap and tileset.
+	*/
+	~RenderSystem();
 	/**
 	 * @brief Render system update loop.
 	*/
@@ -38,6 +44,20 @@ public:
 	*/
 	Tilemap* setMap(const char* tilesetPath, const char* tilemapPath, size_t layerCount);
 
+	/**
+	 * @brief Changes a tile of a tile layer. Only the chunk containing the tile is rendered again. Colliders and objects created from the tilemap are not changed.
+	 * @param layer - Index of the layer.
+	 * @param column - Column of the tile.
+	 * @param row - Row of the tile.
+	 * @param tile - New tile. 0 for an empty tile.
+	*/
+	void setTile(size_t layer, unsigned int column, unsigned int row, unsigned int tile);
+
+	/**
+	 * @brief Renders every tilemap chunk again at the next update. Needed when the renderer lost the content of its render targets.
+	*/
+	void invalidateTilemapChunks();
+
 	/**
 	 * @brief Initializes the camera with certain viewport.
 	 * @param viewWidth - Width of viewport.
@@ -47,6 +67,12 @@ public:
 	*/
 	void initCamera(int viewWidth, int viewHeight, int cameraWidth, int cameraHeight);
 
+	/**
+	 * @brief Sorts the sprites of the awake entities before rendering. Needed for to be able to display depth in 2d environment.
+	 * @return Number of sorted sprites.
+	*/
+	size_t sortSprites();
+
 	/**
 	 * @brief Gets the camera x position.
 	 * @return Camera x position.
@@ -59,6 +85,12 @@ public:
 	*/
 	int getCameraY() { return camera.y; }
 
+	/**
+	 * @brief Gets the view area of the camera.
+	 * @return View area rectangle of the camera in world coordinates.
+	*/
+	SDL_Rect getCamera() { return camera; }
+
 	/**
 	 * @brief Sets the current camera follow target component.
 	 * @param cameraFollow - Current camera follow target component.
@@ -67,6 +99,14 @@ public:
 		this->cameraFollow = cameraFollow;
 	}
 
+	/**
+	 * @brief Sets the route pool the routes of the enemies are stored in. Needed to visually debug the pathing of enemies.
+	 * @param routePool - Route pool of the physic system.
+	*/
+	void setRoutePool(RoutePool* routePool) {
+		this->routePool = routePool;
+	}
+
 	/**
 	 * @brief Gets current tileset of tilemap.
 	 * @return Current tileset.
@@ -197,6 +237,11 @@ private:
 	*/
 	ComponentManager<EnemyMovement>* enemyMovementManager = nullptr;
 
+	/**
+	 * @brief Pointer to the route pool of the enemies needed for debugging.
+	*/
+	RoutePool* routePool = nullptr;
+
 	/**
 	 * @brief Pointer to the ui manager to be able to render the ui elements.
 	*/
@@ -210,12 +255,12 @@ private:
 	/**
 	 * @brief Position array of the sprites sorted by y value minus half of the displayed sprite height (ascending).
 	*/
-	Position sortedSpritePositions[1024];
+	std::vector<Position> sortedSpritePositions;
 
 	/**
 	 * @brief Position array for merge sort.
 	*/
-	Position sortArr[1024];
+	std::vector<Position> sortArr;
 
 	/**
 	 * @brief Reference to the current tilemap.
@@ -249,6 +294,61 @@ private:
 	*/
 	int frameDelay = 1000 / 60;
 
+	/**
+	 * @brief Maximum width and height of a tilemap chunk in pixels.
+	*/
+	static const int TILEMAP_CHUNK_SIZE = 512;
+
+	/**
+	 * @brief Part of the tile layers of the tilemap pre-rendered into a texture.
+	*/
+	struct TilemapChunk {
+		/**
+		 * @brief Render target texture of the chunk.
+		*/
+		SDL_Texture* texture;
+
+		/**
+		 * @brief Area of the chunk in tiles.
+		*/
+		SDL_Rect tiles;
+
+		/**
+		 * @brief Whether the tiles of the chunk changed since it was rendered.
+		*/
+		bool dirty;
+	};
+
+	/**
+	 * @brief Chunks of the tilemap, row by row. Empty if the renderer does not support render targets or custom blend modes.
+	*/
+	std::vector<TilemapChunk> tilemapChunks;
+
+	/**
+	 * @brief Number of chunks per row.
+	*/
+	int chunkColumns = 0;
+
+	/**
+	 * @brief Number of tiles per row of a chunk.
+	*/
+	int chunkTilesX = 0;
+
+	/**
+	 * @brief Number of tiles per column of a chunk.
+	*/
+	int chunkTilesY = 0;
+
+	/**
+	 * @brief Blend mode of the tileset while tiles are rendered into a chunk. The chunk stores the blended tiles with premultiplied alpha.
+	*/
+	SDL_BlendMode chunkBakeBlendMode = SDL_BLENDMODE_BLEND;
+
+	/**
+	 * @brief Blend mode of the chunks. Blends the premultiplied colors without applying the alpha of the tiles a second time.
+	*/
+	SDL_BlendMode chunkBlendMode = SDL_BLENDMODE_BLEND;
+
 	/**
 	 * @brief Renders all the ui elements in the window.
 	*/
@@ -284,11 +384,6 @@ private:
 	*/
 	void renderSprites();
 
-	/**
-	 * @brief Sorts the sprite before rendering. Needed for to be able to display depth in 2d environment.
-	*/
-	void sortSprites();
-
 	/**
 	 * @brief Animates the sprite.
 	 * @param  Sprite to animate.
@@ -307,12 +402,29 @@ private:
 	void renderTilemap();
 
 	/**
-	 * @brief Sets the source rectangle of the tileset to display the right part of the tileset.
-	 * @param tilemapData - What tile to display based on the tilemap.
-	 * @param tileWidth - Width of the tiles.
-	 * @param tileHeight - Height of the tiles.
+	 * @brief Creates and renders the chunks of the current tilemap. Without render target support the tiles are rendered one by one.
+	*/
+	void createTilemapChunks();
+
+	/**
+	 * @brief Destroys the chunks of the current tilemap.
+	*/
+	void destroyTilemapChunks();
+
+	/**
+	 * @brief Renders the tile layers of the area of a chunk into its texture.
+	 * @param chunk - Chunk to render.
+	*/
+	void bakeTilemapChunk(TilemapChunk& chunk);
+
+	/**
+	 * @brief Gets the tiles of the tilemap that overlap the camera.
+	 * @param tileWidth - Width of a tile on the screen.
+	 * @param tileHeight - Height of a tile on the screen.
+	 * @param visible - Set to the first visible column and row and the number of visible columns and rows.
+	 * @return Whether any tile is visible.
 	*/
-	void setTilesetSrcRectPosition(unsigned int tilemapData, unsigned int tileWidth, unsigned int tileHeight);
+	bool getVisibleTiles(float tileWidth, float tileHeight, SDL_Rect& visible);
 
 	/**
 	 * @brief Sets the destination rectangle of the tileset to display the tiles in the right area.
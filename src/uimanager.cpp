@@ -42,13 +42,13 @@ void UIManager::update() {
 */
 size_t UIManager::addFont(const char* path, int fontSize){
     if (currentFontIndex == 8) {
-        SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "SDL TTF Error", "Can't load anymore fonts.", NULL);
+        Log::error("SDL TTF Error", "Can't load anymore fonts.");
         return SIZE_MAX;
     }
 
     fonts[currentFontIndex] = TTF_OpenFont(path, fontSize);
     if (!fonts[currentFontIndex]) {
-        SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "SDL TTF Error", TTF_GetError(), NULL);
+        Log::error("SDL TTF Error", TTF_GetError());
         return SIZE_MAX;
     }
 
@@ -78,7 +78,7 @@ void UIManager::clearUI() {
 */
 size_t UIManager::addLabel(int x, int y, std::string text, SDL_Color color, size_t fontIndex){
     if (currentLabelIndex == 32) {
-        SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "SDL TTF Error", "Can't create anymore labels.", NULL);
+        Log::error("SDL TTF Error", "Can't create anymore labels.");
     } else if (fontIndex < currentFontIndex) {
         uiLabels[currentLabelIndex] = *(new Label(x, y, text, color, renderer, fonts[fontIndex]));
         return currentLabelIndex++;
@@ -100,7 +100,7 @@ size_t UIManager::addLabel(int x, int y, std::string text, SDL_Color color, size
 */
 size_t UIManager::addPanel(const char* filePath, int x, int y, int w, int h, SDL_Color panelColor) {
     if (currentPanelIndex == 32) {
-        SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "SDL TTF Error", "Can't create anymore panels.", NULL);
+        Log::error("SDL TTF Error", "Can't create anymore panels.");
         return SIZE_MAX;
     }
     uiPanels[currentPanelIndex] = *(new Panel(renderer,filePath, x, y, w, h, panelColor));
@@ -118,7 +118,7 @@ size_t UIManager::addPanel(const char* filePath, int x, int y, int w, int h, SDL
 */
 size_t UIManager::addPanel(int x, int y, int w, int h, SDL_Color panelColor){
     if (currentPanelIndex == 32) {
-        SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "SDL TTF Error", "Can't create anymore panels.", NULL);
+        Log::error("SDL TTF Error", "Can't create anymore panels.");
         return SIZE_MAX;
     }
     uiPanels[currentPanelIndex] = *(new Panel(renderer, x, y, w, h, panelColor));
@@ -141,7 +141,7 @@ size_t UIManager::addPanel(int x, int y, int w, int h, SDL_Color panelColor){
 */
 size_t UIManager::addProgressBar(const char* bgFilePath, const char* progressFilePath, int x, int y, int w, int h, SDL_Color bgColor, SDL_Color progressColor){
     if (currentProgressBarIndex == 32) {
-        SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "SDL TTF Error", "Can't create anymore progress bars.", NULL);
+        Log::error("SDL TTF Error", "Can't create anymore progress bars.");
         return SIZE_MAX;
     }
     uiProgressBars[currentProgressBarIndex] = *(new ProgressBar(renderer, bgFilePath, progressFilePath, x, y, w, h, bgColor, progressColor));
@@ -160,7 +160,7 @@ size_t UIManager::addProgressBar(const char* bgFilePath, const char* progressFil
 */
 size_t UIManager::addProgressBar(int x, int y, int w, int h, SDL_Color bgColor, SDL_Color progressColor) {
     if (currentProgressBarIndex == 32) {
-        SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "SDL TTF Error", "Can't create anymore progress bars.", NULL);
+        Log::error("SDL TTF Error", "Can't create anymore progress bars.");
         return SIZE_MAX;
     }
     uiProgressBars[currentProgressBarIndex] = *(new ProgressBar(renderer, x, y, w, h, bgColor, progressColor));
@@ -183,7 +183,7 @@ size_t UIManager::addProgressBar(int x, int y, int w, int h, SDL_Color bgColor,
 */
 size_t UIManager::addButton(int x, int y, std::string buttonText, SDL_Color buttonTextColor, SDL_Color buttonBGColor, size_t fontIndex, SDL_Point borderWidth, SDL_Color hoverColor){
     if (currentButtonIndex == 32) {
-        SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "SDL TTF Error", "Can't create anymore buttons.", NULL);
+        Log::error("SDL TTF Error", "Can't create anymore buttons.");
     }else if (fontIndex < currentFontIndex) {
         uiButtons[currentButtonIndex] = *(new Button(renderer,x,y,buttonText, buttonTextColor, buttonBGColor, fonts[fontIndex], borderWidth, hoverColor));
         return currentButtonIndex++;
@@ -206,7 +206,7 @@ size_t UIManager::addButton(int x, int y, std::string buttonText, SDL_Color butt
 */
 size_t UIManager::addButton(const char* panelFilePath, int x, int y, std::string buttonText, SDL_Color buttonTextColor, SDL_Color buttonBGColor, size_t fontIndex, SDL_Point borderWidth, SDL_Color hoverColor) {
     if (currentButtonIndex == 32) {
-        SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "SDL TTF Error", "Can't create anymore buttons.", NULL);
+        Log::error("SDL TTF Error", "Can't create anymore buttons.");
     }else if (fontIndex < currentFontIndex) {
         uiButtons[currentButtonIndex] = *(new Button(renderer, panelFilePath, x, y, buttonText, buttonTextColor, buttonBGColor, fonts[fontIndex], borderWidth, hoverColor));
         return currentButtonIndex++;
@@ -250,7 +250,7 @@ void UIManager::checkButtons() {
 */
 size_t UIManager::addSlider(SDL_Rect background, SDL_Color bgColor, SDL_Color sliderKnobColor, float currentVal) {
     if (currentSliderIndex == 32) {
-        SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "SDL TTF Error", "Can't create anymore sliders.", NULL);
+        Log::error("SDL TTF Error", "Can't create anymore sliders.");
         return SIZE_MAX;
     }
     uiSliders[currentSliderIndex] = *(new Slider(renderer, background, bgColor, sliderKnobColor, currentVal));
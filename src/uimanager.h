@@ -9,6 +9,7 @@
 #include "util/ui/button.h"
 #include "util/ui/slider.h"
 #include "inputmanager.h"
+#include "util/log.h"
 
 /**
  * @brief Manager to manage every ui element.
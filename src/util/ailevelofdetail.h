@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+
+/**
+ * @brief Update frequency tiers of the enemy movement, depending on the distance of the enemy to the camera.
+*/
+enum AI_LOD_TIERS {
+	AI_LOD_NEAR,
+	AI_LOD_MID,
+	AI_LOD_FAR,
+	AI_LOD_COUNT
+};
+
+/**
+ * @brief Settings of the level of detail of the enemy movement. Distances are measured in pixels from the border of the camera view, enemies inside of the view are always near.
+ * Enemies within the near distance are updated every frame. Mid-range enemies are updated every mid interval frames and move the skipped distance at once.
+ * Far enemies skip the local avoidance and animations, they are moved coarsely along their route every far interval frames or suspended.
+*/
+struct AILevelOfDetail {
+	/**
+	 * @brief Whether the update frequency depends on the distance to the camera. If disabled, every enemy is updated every frame.
+	*/
+	bool enabled = true;
+
+	/**
+	 * @brief Distance from the camera view up to which enemies are updated every frame.
+	*/
+	int nearDistance = 256;
+
+	/**
+	 * @brief Distance from the camera view up to which enemies are mid-range. Enemies further away are far.
+	*/
+	int farDistance = 1024;
+
+	/**
+	 * @brief Frames between the updates of mid-range enemies.
+	*/
+	int midInterval = 4;
+
+	/**
+	 * @brief Frames between the updates of far enemies. 0 suspends far enemies until they get closer to the camera.
+	*/
+	int farInterval = 30;
+};
+
+/**
+ * @brief Counters of the level of detail of the enemy movement in the last frame.
+*/
+struct AILevelOfDetailStats {
+	/**
+	 * @brief Number of active enemies per tier.
+	*/
+	size_t enemies[AI_LOD_COUNT] = { 0, 0, 0 };
+
+	/**
+	 * @brief Number of enemies updated per tier.
+	*/
+	size_t updated[AI_LOD_COUNT] = { 0, 0, 0 };
+};
@@ -52,20 +52,24 @@ Tilemap* FileLoader::loadTilemap(const char* path, size_t layerCount) {
 * @brief Loads texture from given path.
 * @param path - File path to texture file.
 * @param renderer - Reference to window renderer.
+* @param tag - Subsystem the texture memory is accounted to.
 * @return Created texture.
 */
-Texture FileLoader::loadTexture(const char* path, SDL_Renderer* renderer) {
+Texture FileLoader::loadTexture(const char* path, SDL_Renderer* renderer, MEMORY_TAGS tag) {
 	Texture result;
 
 	// create texture
 	SDL_Surface* tempSurface = IMG_Load(path);
 	if (!tempSurface) {
-		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Texture IO Error", IMG_GetError(), NULL);
+		Log::error("Texture IO Error", IMG_GetError());
 	}
 	result.texture = SDL_CreateTextureFromSurface(renderer, tempSurface);
 
 	// get width & height of texture
 	SDL_QueryTexture(result.texture, NULL, NULL, &result.textureWidth, &result.textureHeight);
+	if (result.texture != nullptr) {
+		MemoryTracker::trackAllocation(tag, MemoryTracker::getTextureSize(result.texture));
+	}
 
 	// cleanup surface
 	SDL_FreeSurface(tempSurface);
@@ -76,15 +80,19 @@ Texture FileLoader::loadTexture(const char* path, SDL_Renderer* renderer) {
 * @brief Loads SDL_Texture from given path.
 * @param path - File path to texture file.
 * @param renderer - Reference to window renderer.
+* @param tag - Subsystem the texture memory is accounted to.
 * @return Pointer to created SDL_Texture.
 */
-SDL_Texture* FileLoader::loadSDLTexture(const char* path, SDL_Renderer* renderer) {
+SDL_Texture* FileLoader::loadSDLTexture(const char* path, SDL_Renderer* renderer, MEMORY_TAGS tag) {
 	SDL_Surface* tempSurface = IMG_Load(path);
 	if (!tempSurface) {
-		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Texture IO Error", IMG_GetError(), NULL);
+		Log::error("Texture IO Error", IMG_GetError());
 	}
 	SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, tempSurface);
 	SDL_FreeSurface(tempSurface);
+	if (texture != nullptr) {
+		MemoryTracker::trackAllocation(tag, MemoryTracker::getTextureSize(texture));
+	}
 	
 	return texture;
 }
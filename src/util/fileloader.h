@@ -5,6 +5,8 @@
 #include "tilemap.h"
 #include "SDL_image.h"
 #include "texture.h"
+#include "memorytracker.h"
+#include "log.h"
 
 //TODO: research how to handle includes in c++ git repos
 #include "../include/nlohmann/json.hpp"
@@ -27,15 +29,17 @@ public:
 	 * @brief Loads texture from given path.
 	 * @param path - File path to texture file.
 	 * @param renderer - Reference to window renderer.
+	 * @param tag - Subsystem the texture memory is accounted to.
 	 * @return Pointer to created texture.
 	*/
-	static Texture loadTexture(const char* path, SDL_Renderer* renderer);
+	static Texture loadTexture(const char* path, SDL_Renderer* renderer, MEMORY_TAGS tag = TAG_TEXTURES);
 
 	/**
 	 * @brief Loads SDL_Texture from given path.
 	 * @param path - File path to texture file.
 	 * @param renderer - Reference to window renderer.
+	 * @param tag - Subsystem the texture memory is accounted to.
 	 * @return Pointer to created SDL_Texture.
 	*/
-	static SDL_Texture* loadSDLTexture(const char* path, SDL_Renderer* renderer);
+	static SDL_Texture* loadSDLTexture(const char* path, SDL_Renderer* renderer, MEMORY_TAGS tag = TAG_TEXTURES);
 };
\ No newline at end of file
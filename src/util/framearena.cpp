@@ -0,0 +1,70 @@
+#include "framearena.h"
+/**
+* @brief Creates a frame arena.
+* @param capacity - Initial capacity of the arena in bytes.
+*/
+FrameArena::FrameArena(size_t capacity) {
+	this->capacity = capacity;
+	this->buffer = new unsigned char[capacity];
+}
+
+/**
+* @brief Destructor of the frame arena. Frees the arena buffer and remaining overflow blocks.
+*/
+FrameArena::~FrameArena() {
+	for (size_t i = 0; i < overflowBlocks.size(); i++) {
+		::operator delete(overflowBlocks[i]);
+	}
+	delete[] buffer;
+}
+
+/**
+* @brief Allocates memory from the arena. When the arena is exhausted, the memory is taken from the heap and the arena grows on the next reset.
+* @param size - Size of the allocation in bytes.
+* @param alignment - Alignment of the allocation.
+* @return Pointer to the allocated memory.
+*/
+void* FrameArena::allocate(size_t size, size_t alignment) {
+	size_t alignedOffset = (offset + alignment - 1) & ~(alignment - 1);
+
+	if (alignedOffset + size <= capacity) {
+		offset = alignedOffset + size;
+		return &buffer[alignedOffset];
+	}
+
+	// arena is exhausted, use heap until the next reset
+	void* block = ::operator new(size);
+	overflowBlocks.push_back(block);
+	overflowBytes += size;
+	return block;
+}
+
+/**
+* @brief Resets the arena. Every allocation of the current frame becomes invalid.
+*/
+void FrameArena::reset() {
+	size_t usedBytes = offset + overflowBytes;
+	if (usedBytes > peakBytes) {
+		peakBytes = usedBytes;
+	}
+
+	if (overflowBlocks.size() > 0) {
+		for (size_t i = 0; i < overflowBlocks.size(); i++) {
+			::operator delete(overflowBlocks[i]);
+		}
+		overflowBlocks.clear();
+
+		// grow arena so the next frames fit without overflowing
+		if (capacity == 0) {
+			capacity = usedBytes;
+		}
+		while (capacity < usedBytes) {
+			capacity *= 2;
+		}
+		delete[] buffer;
+		buffer = new unsigned char[capacity];
+	}
+
+	offset = 0;
+	overflowBytes = 0;
+}
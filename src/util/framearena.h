@@ -0,0 +1,143 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <vector>
+/**
+ * @brief Linear (bump) allocator for transient data that only lives for one frame. The arena is reset at the end of every game loop iteration, which releases everything allocated during the frame at once.
+*/
+class FrameArena {
+public:
+	/**
+	 * @brief Creates a frame arena.
+	 * @param capacity - Initial capacity of the arena in bytes.
+	*/
+	FrameArena(size_t capacity);
+
+	/**
+	 * @brief Destructor of the frame arena. Frees the arena buffer and remaining overflow blocks.
+	*/
+	~FrameArena();
+
+	/**
+	 * @brief Allocates memory from the arena. When the arena is exhausted, the memory is taken from the heap and the arena grows on the next reset.
+	 * @param size - Size of the allocation in bytes.
+	 * @param alignment - Alignment of the allocation.
+	 * @return Pointer to the allocated memory.
+	*/
+	void* allocate(size_t size, size_t alignment);
+
+	/**
+	 * @brief Resets the arena. Every allocation of the current frame becomes invalid.
+	*/
+	void reset();
+
+	/**
+	 * @brief Gets the number of bytes used in the current frame.
+	 * @return Used bytes of the current frame.
+	*/
+	size_t getUsedBytes() { return offset + overflowBytes; }
+
+	/**
+	 * @brief Gets the highest number of bytes used in a single frame.
+	 * @return Peak of used bytes.
+	*/
+	size_t getPeakBytes() { return peakBytes; }
+
+	/**
+	 * @brief Gets the capacity of the arena.
+	 * @return Capacity of the arena in bytes.
+	*/
+	size_t getCapacity() { return capacity; }
+private:
+	/**
+	 * @brief Memory of the arena.
+	*/
+	unsigned char* buffer = nullptr;
+
+	/**
+	 * @brief Capacity of the arena buffer in bytes.
+	*/
+	size_t capacity = 0;
+
+	/**
+	 * @brief Offset of the next free byte in the arena buffer.
+	*/
+	size_t offset = 0;
+
+	/**
+	 * @brief Highest number of bytes used in a single frame.
+	*/
+	size_t peakBytes = 0;
+
+	/**
+	 * @brief Bytes allocated from the heap because the arena was exhausted in the current frame.
+	*/
+	size_t overflowBytes = 0;
+
+	/**
+	 * @brief Heap blocks allocated because the arena was exhausted. Freed on reset.
+	*/
+	std::vector<void*> overflowBlocks;
+};
+
+/**
+ * @brief Std-compatible allocator adapter that allocates from a frame arena. Deallocation is a no-op, the memory is released when the arena is reset. Falls back to the heap if no arena is set.
+ * @tparam T - Allocated type.
+*/
+template <typename T>
+struct FrameAllocator {
+	typedef T value_type;
+
+	/**
+	 * @brief Creates frame allocator.
+	 * @param arena - Frame arena to allocate from.
+	*/
+	FrameAllocator(FrameArena* arena) : arena{ arena } {}
+
+	/**
+	 * @brief Rebinding constructor needed by the std containers.
+	 * @param other - Allocator of another type.
+	*/
+	template <typename U>
+	FrameAllocator(const FrameAllocator<U>& other) : arena{ other.arena } {}
+
+	/**
+	 * @brief Allocates memory for n objects of type T.
+	 * @param n - Number of objects.
+	 * @return Pointer to the allocated memory.
+	*/
+	T* allocate(size_t n) {
+		if (arena == nullptr) {
+			return static_cast<T*>(::operator new(n * sizeof(T)));
+		}
+		return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+	}
+
+	/**
+	 * @brief Deallocates memory. Only frees memory if no arena is set.
+	 * @param p - Pointer to the memory.
+	 * @param n - Number of objects. Unused, the arena frees all objects at the end of the frame.
+	*/
+	void deallocate(T* p, size_t /*n*/) {
+		if (arena == nullptr) {
+			::operator delete(p);
+		}
+	}
+
+	/**
+	 * @brief Frame arena to allocate from.
+	*/
+	FrameArena* arena;
+};
+
+template <typename T, typename U>
+bool operator==(const FrameAllocator<T>& a, const FrameAllocator<U>& b) { return a.arena == b.arena; }
+
+template <typename T, typename U>
+bool operator!=(const FrameAllocator<T>& a, const FrameAllocator<U>& b) { return a.arena != b.arena; }
+
+/**
+ * @brief Vector that allocates from a frame arena.
+*/
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
@@ -0,0 +1,17 @@
+#include "log.h"
+
+bool Log::headless = false;
+
+/**
+* @brief Reports an error.
+* @param title - Title of the error.
+* @param message - Error message.
+*/
+void Log::error(const char* title, const char* message) {
+	if (headless) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%s: %s", title, message);
+	}
+	else {
+		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, title, message, NULL);
+	}
+}
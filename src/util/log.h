@@ -0,0 +1,35 @@
+#pragma once
+#include "SDL.h"
+/**
+ * @brief Utility class to report engine errors. Shows a message box or, in headless mode, writes the error to the SDL log.
+*/
+class Log {
+public:
+	/**
+	 * @brief Reports an error.
+	 * @param title - Title of the error.
+	 * @param message - Error message.
+	*/
+	static void error(const char* title, const char* message);
+
+	/**
+	 * @brief Sets whether errors are written to the log instead of being shown in a message box.
+	 * @param headless - Whether the engine runs headless.
+	*/
+	static void setHeadless(bool headless) {
+		Log::headless = headless;
+	}
+
+	/**
+	 * @brief Checks if errors are written to the log.
+	 * @return Whether the engine runs headless.
+	*/
+	static bool isHeadless() {
+		return headless;
+	}
+private:
+	/**
+	 * @brief Whether errors are written to the log instead of being shown in a message box.
+	*/
+	static bool headless;
+};
@@ -0,0 +1,224 @@
+#include "memorytracker.h"
+#include <cstdlib>
+#include <fstream>
+#include "../include/nlohmann/json.hpp"
+using json = nlohmann::json;
+
+std::atomic<size_t> MemoryTracker::liveBytes[TAG_COUNT] = {};
+std::atomic<size_t> MemoryTracker::peakBytes[TAG_COUNT] = {};
+std::atomic<size_t> MemoryTracker::liveAllocations[TAG_COUNT] = {};
+std::atomic<size_t> MemoryTracker::totalAllocations[TAG_COUNT] = {};
+std::atomic<size_t> MemoryTracker::frameAllocations{ 0 };
+std::atomic<size_t> MemoryTracker::heapAllocations{ 0 };
+size_t MemoryTracker::frameStartHeapAllocations = 0;
+size_t MemoryTracker::frameCount = 0;
+bool MemoryTracker::strictFrameMode = false;
+size_t MemoryTracker::steadyStateFrame = 0;
+size_t MemoryTracker::frameViolations = 0;
+
+#pragma region Accounting
+/**
+* @brief Accounts an allocation to a subsystem.
+* @param tag - Subsystem of the allocation.
+* @param bytes - Size of the allocation in bytes.
+*/
+void MemoryTracker::trackAllocation(MEMORY_TAGS tag, size_t bytes) {
+	size_t current = liveBytes[tag].fetch_add(bytes) + bytes;
+	size_t peak = peakBytes[tag].load();
+	while (current > peak && !peakBytes[tag].compare_exchange_weak(peak, current)) {}
+
+	liveAllocations[tag]++;
+	totalAllocations[tag]++;
+	frameAllocations++;
+}
+
+/**
+* @brief Accounts a deallocation to a subsystem.
+* @param tag - Subsystem of the deallocation.
+* @param bytes - Size of the deallocation in bytes.
+*/
+void MemoryTracker::trackDeallocation(MEMORY_TAGS tag, size_t bytes) {
+	liveBytes[tag] -= bytes;
+	liveAllocations[tag]--;
+}
+
+/**
+* @brief Calculates the memory used by a texture.
+* @param texture - Texture to calculate the size of.
+* @return Size of the texture in bytes. Returns 0 if the texture is null.
+*/
+size_t MemoryTracker::getTextureSize(SDL_Texture* texture) {
+	if (texture == nullptr) {
+		return 0;
+	}
+
+	Uint32 format = 0;
+	int w = 0;
+	int h = 0;
+	SDL_QueryTexture(texture, &format, NULL, &w, &h);
+
+	size_t bytesPerPixel = SDL_BYTESPERPIXEL(format);
+	if (bytesPerPixel == 0) {
+		bytesPerPixel = 4;
+	}
+	return (size_t)w * (size_t)h * bytesPerPixel;
+}
+
+/**
+* @brief Gets the memory statistics of a subsystem.
+* @param tag - Subsystem to get the statistics from.
+* @return Memory statistics of the subsystem.
+*/
+MemoryStats MemoryTracker::getStats(MEMORY_TAGS tag) {
+	MemoryStats result;
+	result.liveBytes = liveBytes[tag];
+	result.peakBytes = peakBytes[tag];
+	result.liveAllocations = liveAllocations[tag];
+	result.totalAllocations = totalAllocations[tag];
+	return result;
+}
+
+/**
+* @brief Gets the name of a subsystem.
+* @param tag - Subsystem to get the name from.
+* @return Name of the subsystem.
+*/
+const char* MemoryTracker::getTagName(MEMORY_TAGS tag) {
+	switch (tag) {
+	case TAG_COMPONENTS:
+		return "components";
+	case TAG_TEXTURES:
+		return "textures";
+	case TAG_AUDIO:
+		return "audio";
+	case TAG_TILEMAP:
+		return "tilemap";
+	case TAG_UI:
+		return "ui";
+	case TAG_PATHFINDING:
+		return "pathfinding";
+	default:
+		return "unknown";
+	}
+}
+#pragma endregion Accounting
+
+#pragma region Output
+/**
+* @brief Serializes the memory statistics of every subsystem and the frame allocation check to json.
+* @return Json string of the memory statistics.
+*/
+std::string MemoryTracker::toJSON() {
+	json result;
+	size_t totalLiveBytes = 0;
+
+	for (int i = 0; i < TAG_COUNT; i++) {
+		MemoryStats stats = getStats((MEMORY_TAGS)i);
+		result["subsystems"][getTagName((MEMORY_TAGS)i)] = {
+			{ "liveBytes", stats.liveBytes },
+			{ "peakBytes", stats.peakBytes },
+			{ "liveAllocations", stats.liveAllocations },
+			{ "totalAllocations", stats.totalAllocations }
+		};
+		totalLiveBytes += stats.liveBytes;
+	}
+
+	result["totalLiveBytes"] = totalLiveBytes;
+	result["heapAllocations"] = (size_t)heapAllocations;
+	result["frames"] = {
+		{ "count", frameCount },
+		{ "strict", strictFrameMode },
+		{ "steadyStateFrame", steadyStateFrame },
+		{ "violations", frameViolations }
+	};
+	return result.dump(4);
+}
+
+/**
+* @brief Writes the memory statistics as json to a file.
+* @param path - Path of the output file.
+* @return Whether the file was written.
+*/
+bool MemoryTracker::dumpJSON(const char* path) {
+	std::ofstream file;
+	file.open(path);
+	if (!file.is_open()) {
+		return false;
+	}
+	file << toJSON();
+	file.close();
+	return true;
+}
+#pragma endregion Output
+
+#pragma region Frames
+/**
+* @brief Marks the start of a game loop iteration.
+*/
+void MemoryTracker::beginFrame() {
+	frameAllocations = 0;
+	frameStartHeapAllocations = heapAllocations;
+}
+
+/**
+* @brief Marks the end of a game loop iteration. In strict mode every allocation after the warmup frames is reported as a violation.
+* @return Number of allocations in the frame.
+*/
+size_t MemoryTracker::endFrame() {
+	size_t heapCount = heapAllocations - frameStartHeapAllocations;
+	size_t tagCount = frameAllocations;
+	// tagged allocations are also counted by operator new if it is replaced
+	size_t count = (heapCount > tagCount) ? heapCount : tagCount;
+
+	if (strictFrameMode && frameCount >= steadyStateFrame && count > 0) {
+		frameViolations++;
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Frame %u allocated %u times in steady state.", (unsigned int)frameCount, (unsigned int)count);
+	}
+	frameCount++;
+	return count;
+}
+
+/**
+* @brief Enables or disables the strict frame mode. In strict mode every frame after the warmup frames has to be free of allocations.
+* @param enabled - Whether the strict frame mode is enabled.
+* @param warmupFrames - Number of frames allowed to allocate before the steady state is reached.
+*/
+void MemoryTracker::setStrictFrameMode(bool enabled, size_t warmupFrames) {
+	MemoryTracker::strictFrameMode = enabled;
+	MemoryTracker::steadyStateFrame = frameCount + warmupFrames;
+	MemoryTracker::frameViolations = 0;
+}
+#pragma endregion Frames
+
+#ifdef ENGINE_COUNT_HEAP_ALLOCATIONS
+#pragma region HeapCounter
+void* operator new(size_t size) {
+	MemoryTracker::countHeapAllocation();
+	void* p = std::malloc(size == 0 ? 1 : size);
+	if (p == nullptr) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void* operator new[](size_t size) {
+	return ::operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, size_t size) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void* p, size_t size) noexcept {
+	std::free(p);
+}
+#pragma endregion HeapCounter
+#endif
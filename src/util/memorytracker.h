@@ -0,0 +1,239 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <string>
+#include "SDL.h"
+
+/**
+ * @brief Subsystems the tracked memory is accounted to.
+*/
+enum MEMORY_TAGS {
+	TAG_COMPONENTS,
+	TAG_TEXTURES,
+	TAG_AUDIO,
+	TAG_TILEMAP,
+	TAG_UI,
+	TAG_PATHFINDING,
+	TAG_COUNT
+};
+
+/**
+ * @brief Snapshot of the memory statistics of one subsystem.
+*/
+struct MemoryStats {
+	/**
+	 * @brief Bytes currently allocated.
+	*/
+	size_t liveBytes = 0;
+
+	/**
+	 * @brief Highest number of bytes allocated at the same time.
+	*/
+	size_t peakBytes = 0;
+
+	/**
+	 * @brief Number of allocations that are currently alive.
+	*/
+	size_t liveAllocations = 0;
+
+	/**
+	 * @brief Total number of allocations since the start of the engine.
+	*/
+	size_t totalAllocations = 0;
+};
+
+/**
+ * @brief Utility class to account the memory usage of the engine per subsystem. Also checks that the steady-state frames of the game loop do not allocate.
+ * Heap allocations outside of the tagged subsystems are only counted if the engine is compiled with ENGINE_COUNT_HEAP_ALLOCATIONS, which replaces the global operator new.
+*/
+class MemoryTracker {
+public:
+	/**
+	 * @brief Accounts an allocation to a subsystem.
+	 * @param tag - Subsystem of the allocation.
+	 * @param bytes - Size of the allocation in bytes.
+	*/
+	static void trackAllocation(MEMORY_TAGS tag, size_t bytes);
+
+	/**
+	 * @brief Accounts a deallocation to a subsystem.
+	 * @param tag - Subsystem of the deallocation.
+	 * @param bytes - Size of the deallocation in bytes.
+	*/
+	static void trackDeallocation(MEMORY_TAGS tag, size_t bytes);
+
+	/**
+	 * @brief Calculates the memory used by a texture.
+	 * @param texture - Texture to calculate the size of.
+	 * @return Size of the texture in bytes. Returns 0 if the texture is null.
+	*/
+	static size_t getTextureSize(SDL_Texture* texture);
+
+	/**
+	 * @brief Gets the memory statistics of a subsystem.
+	 * @param tag - Subsystem to get the statistics from.
+	 * @return Memory statistics of the subsystem.
+	*/
+	static MemoryStats getStats(MEMORY_TAGS tag);
+
+	/**
+	 * @brief Gets the name of a subsystem.
+	 * @param tag - Subsystem to get the name from.
+	 * @return Name of the subsystem.
+	*/
+	static const char* getTagName(MEMORY_TAGS tag);
+
+	/**
+	 * @brief Serializes the memory statistics of every subsystem and the frame allocation check to json.
+	 * @return Json string of the memory statistics.
+	*/
+	static std::string toJSON();
+
+	/**
+	 * @brief Writes the memory statistics as json to a file.
+	 * @param path - Path of the output file.
+	 * @return Whether the file was written.
+	*/
+	static bool dumpJSON(const char* path);
+
+	/**
+	 * @brief Marks the start of a game loop iteration.
+	*/
+	static void beginFrame();
+
+	/**
+	 * @brief Marks the end of a game loop iteration. In strict mode every allocation after the warmup frames is reported as a violation.
+	 * @return Number of allocations in the frame.
+	*/
+	static size_t endFrame();
+
+	/**
+	 * @brief Enables or disables the strict frame mode. In strict mode every frame after the warmup frames has to be free of allocations.
+	 * @param enabled - Whether the strict frame mode is enabled.
+	 * @param warmupFrames - Number of frames allowed to allocate before the steady state is reached.
+	*/
+	static void setStrictFrameMode(bool enabled, size_t warmupFrames);
+
+	/**
+	 * @brief Gets the number of steady-state frames that allocated while the strict frame mode was enabled.
+	 * @return Number of frames that violated the strict frame mode.
+	*/
+	static size_t getFrameViolationCount() { return frameViolations; }
+
+	/**
+	 * @brief Gets the number of heap allocations counted by the global operator new. Always 0 if the engine is not compiled with ENGINE_COUNT_HEAP_ALLOCATIONS.
+	 * @return Number of heap allocations.
+	*/
+	static size_t getHeapAllocationCount() { return heapAllocations; }
+
+	/**
+	 * @brief Counts a heap allocation. Called by the global operator new.
+	*/
+	static void countHeapAllocation() { heapAllocations++; }
+private:
+	/**
+	 * @brief Bytes currently allocated per subsystem.
+	*/
+	static std::atomic<size_t> liveBytes[TAG_COUNT];
+
+	/**
+	 * @brief Highest number of allocated bytes per subsystem.
+	*/
+	static std::atomic<size_t> peakBytes[TAG_COUNT];
+
+	/**
+	 * @brief Number of alive allocations per subsystem.
+	*/
+	static std::atomic<size_t> liveAllocations[TAG_COUNT];
+
+	/**
+	 * @brief Total number of allocations per subsystem.
+	*/
+	static std::atomic<size_t> totalAllocations[TAG_COUNT];
+
+	/**
+	 * @brief Number of tagged allocations in the current frame.
+	*/
+	static std::atomic<size_t> frameAllocations;
+
+	/**
+	 * @brief Number of heap allocations counted by the global operator new.
+	*/
+	static std::atomic<size_t> heapAllocations;
+
+	/**
+	 * @brief Heap allocation count at the start of the current frame.
+	*/
+	static size_t frameStartHeapAllocations;
+
+	/**
+	 * @brief Number of finished frames.
+	*/
+	static size_t frameCount;
+
+	/**
+	 * @brief Whether the strict frame mode is enabled.
+	*/
+	static bool strictFrameMode;
+
+	/**
+	 * @brief First frame that is checked by the strict frame mode.
+	*/
+	static size_t steadyStateFrame;
+
+	/**
+	 * @brief Number of steady-state frames that allocated.
+	*/
+	static size_t frameViolations;
+};
+
+/**
+ * @brief Std-compatible allocator adapter that accounts its allocations to a subsystem.
+ * @tparam T - Allocated type.
+ * @tparam tag - Subsystem of the allocations.
+*/
+template <typename T, MEMORY_TAGS tag>
+struct TrackingAllocator {
+	typedef T value_type;
+
+	template <typename U>
+	struct rebind {
+		typedef TrackingAllocator<U, tag> other;
+	};
+
+	TrackingAllocator() {}
+
+	/**
+	 * @brief Rebinding constructor needed by the std containers.
+	 * @param other - Allocator of another type.
+	*/
+	template <typename U>
+	TrackingAllocator(const TrackingAllocator<U, tag>& other) {}
+
+	/**
+	 * @brief Allocates memory for n objects of type T.
+	 * @param n - Number of objects.
+	 * @return Pointer to the allocated memory.
+	*/
+	T* allocate(size_t n) {
+		MemoryTracker::trackAllocation(tag, n * sizeof(T));
+		return static_cast<T*>(::operator new(n * sizeof(T)));
+	}
+
+	/**
+	 * @brief Deallocates memory for n objects of type T.
+	 * @param p - Pointer to the memory.
+	 * @param n - Number of objects.
+	*/
+	void deallocate(T* p, size_t n) {
+		MemoryTracker::trackDeallocation(tag, n * sizeof(T));
+		::operator delete(p);
+	}
+};
+
+template <typename T, typename U, MEMORY_TAGS tag>
+bool operator==(const TrackingAllocator<T, tag>& a, const TrackingAllocator<U, tag>& b) { return true; }
+
+template <typename T, typename U, MEMORY_TAGS tag>
+bool operator!=(const TrackingAllocator<T, tag>& a, const TrackingAllocator<U, tag>& b) { return false; }
@@ -0,0 +1,420 @@
+#include "crowdavoidance.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+* @brief Time in frames for which the chosen velocities are collision free.
+*/
+const float CrowdAvoidance::TIME_HORIZON = 20.0f;
+
+/**
+* @brief Length of the random offset of the preferred velocities relative to the maximum speed.
+*/
+const float CrowdAvoidance::PERTURBATION = 0.03f;
+
+/**
+* @brief Tolerance of the linear programs for parallel lines.
+*/
+static const float EPSILON = 0.00001f;
+
+/**
+* @brief Vector arithmetic of the avoidance.
+*/
+static inline CrowdAvoidance::Vec2 add(CrowdAvoidance::Vec2 a, CrowdAvoidance::Vec2 b) { return { a.x + b.x, a.y + b.y }; }
+static inline CrowdAvoidance::Vec2 subtract(CrowdAvoidance::Vec2 a, CrowdAvoidance::Vec2 b) { return { a.x - b.x, a.y - b.y }; }
+static inline CrowdAvoidance::Vec2 scale(CrowdAvoidance::Vec2 a, float s) { return { a.x * s, a.y * s }; }
+static inline float dot(CrowdAvoidance::Vec2 a, CrowdAvoidance::Vec2 b) { return a.x * b.x + a.y * b.y; }
+
+/**
+* @brief Calculates the determinant of two vectors. Positive if the second vector points to the left of the first vector.
+* @param a - First vector.
+* @param b - Second vector.
+* @return Determinant of the vectors.
+*/
+static inline float det(CrowdAvoidance::Vec2 a, CrowdAvoidance::Vec2 b) { return a.x * b.y - a.y * b.x; }
+
+/**
+* @brief Destructor of the avoidance. Removes the agents from the memory tracker.
+*/
+CrowdAvoidance::~CrowdAvoidance() {
+	MemoryTracker::trackDeallocation(TAG_PATHFINDING, trackedBytes);
+}
+
+/**
+* @brief Initializes the cells of the avoidance and removes every agent.
+* @param worldWidth - Width of the world in pixels.
+* @param worldHeight - Height of the world in pixels.
+* @param neighbourDistance - Distance in pixels between the centers of two agents up to which they avoid each other.
+*/
+void CrowdAvoidance::init(int worldWidth, int worldHeight, int neighbourDistance) {
+	this->cellSize = std::max(neighbourDistance, 1);
+	this->neighbourDistance = (float)neighbourDistance;
+	cellsX = std::max((worldWidth + cellSize - 1) / cellSize, 1);
+	cellsY = std::max((worldHeight + cellSize - 1) / cellSize, 1);
+	std::vector<int32_t>((size_t)cellsX * cellsY + 1, 0).swap(cellStarts);
+	this->clear();
+}
+
+/**
+* @brief Removes every agent. Called before the agents of a frame are added.
+*/
+void CrowdAvoidance::clear() {
+	agents.clear();
+	cellAgents.clear();
+}
+
+/**
+* @brief Adds an agent that does not react to its neighbours. Its velocity is kept unless a preferred velocity is set.
+* @param position - Position of the agent in pixels.
+* @param radius - Radius of the agent in pixels.
+* @param velocity - Velocity of the agent in the last frame in pixels per frame.
+* @return Index of the agent.
+*/
+size_t CrowdAvoidance::addAgent(Vec2 position, float radius, Vec2 velocity) {
+	Agent agent;
+	agent.position = position;
+	agent.velocity = velocity;
+	agent.preferredVelocity = velocity;
+	agent.newVelocity = velocity;
+	agent.radius = radius;
+	agent.maxSpeed = std::sqrt(dot(velocity, velocity));
+	agent.reactive = false;
+	agents.push_back(agent);
+	return agents.size() - 1;
+}
+
+/**
+* @brief Sets the velocity the agent wants to move with. The agent reacts to its neighbours from now on.
+* @param agent - Index of the agent.
+* @param velocity - Preferred velocity in pixels per frame. Its length is the maximum speed of the agent.
+*/
+void CrowdAvoidance::setPreferredVelocity(size_t agent, Vec2 velocity) {
+	agents[agent].preferredVelocity = velocity;
+	agents[agent].newVelocity = velocity;
+	agents[agent].maxSpeed = std::sqrt(dot(velocity, velocity));
+	agents[agent].reactive = true;
+}
+
+/**
+* @brief Calculates the new velocities of the reactive agents.
+*/
+void CrowdAvoidance::solve() {
+	if (agents.empty()) return;
+	this->buildCells();
+
+	for (size_t i = 0; i < agents.size(); i++) {
+		if (agents[i].reactive) {
+			agents[i].newVelocity = this->computeVelocity(i);
+		}
+	}
+	this->trackMemory();
+}
+
+/**
+* @brief Gets the cell of a position. Positions outside of the world are clamped to the border cells.
+* @param position - Position in pixels.
+* @return Index of the cell.
+*/
+int CrowdAvoidance::getCell(Vec2 position) {
+	int x = std::min(std::max((int)std::floor(position.x / cellSize), 0), cellsX - 1);
+	int y = std::min(std::max((int)std::floor(position.y / cellSize), 0), cellsY - 1);
+	return y * cellsX + x;
+}
+
+/**
+* @brief Sorts the agents into the cells.
+*/
+void CrowdAvoidance::buildCells() {
+	// counting sort, the agents of a cell are stored consecutively
+	std::fill(cellStarts.begin(), cellStarts.end(), 0);
+	for (size_t i = 0; i < agents.size(); i++) {
+		cellStarts[this->getCell(agents[i].position) + 1]++;
+	}
+	for (size_t i = 1; i < cellStarts.size(); i++) {
+		cellStarts[i] += cellStarts[i - 1];
+	}
+
+	cellAgents.resize(agents.size());
+	for (size_t i = agents.size(); i-- > 0;) {
+		int cell = this->getCell(agents[i].position);
+		cellAgents[--cellStarts[cell + 1]] = (int32_t)i;
+	}
+	// the decrements moved the end of every cell to its start, one entry too far
+	for (size_t i = 0; i + 1 < cellStarts.size(); i++) {
+		cellStarts[i] = cellStarts[i + 1];
+	}
+	cellStarts.back() = (int32_t)agents.size();
+}
+
+/**
+* @brief Finds the closest agents within the neighbour distance of an agent.
+* @param agent - Index of the agent.
+* @param neighbours - Buffer of MAX_NEIGHBOURS agent indices, sorted by distance.
+* @return Number of found neighbours.
+*/
+size_t CrowdAvoidance::findNeighbours(size_t agent, size_t* neighbours) {
+	float distances[MAX_NEIGHBOURS];
+	size_t count = 0;
+	Vec2 position = agents[agent].position;
+	int cell = this->getCell(position);
+	int cellX = cell % cellsX;
+	int cellY = cell / cellsX;
+
+	// the cells have the size of the neighbour distance and neighbours are measured between the centers, so the surrounding cells contain every neighbour
+	for (int y = std::max(cellY - 1, 0); y <= std::min(cellY + 1, cellsY - 1); y++) {
+		for (int x = std::max(cellX - 1, 0); x <= std::min(cellX + 1, cellsX - 1); x++) {
+			int current = y * cellsX + x;
+			for (int32_t i = cellStarts[current]; i < cellStarts[current + 1]; i++) {
+				size_t other = (size_t)cellAgents[i];
+				if (other == agent) continue;
+
+				Vec2 offset = subtract(agents[other].position, position);
+				float distance = dot(offset, offset);
+				if (distance > neighbourDistance * neighbourDistance) continue;
+				if (count == MAX_NEIGHBOURS && distance >= distances[count - 1]) continue;
+
+				// insertion into the sorted buffer, the furthest neighbour drops out of a full buffer
+				size_t slot = (count < MAX_NEIGHBOURS) ? count++ : count - 1;
+				while (slot > 0 && distances[slot - 1] > distance) {
+					distances[slot] = distances[slot - 1];
+					neighbours[slot] = neighbours[slot - 1];
+					slot--;
+				}
+				distances[slot] = distance;
+				neighbours[slot] = other;
+			}
+		}
+	}
+	return count;
+}
+
+/**
+* @brief Calculates the velocity of an agent that avoids its neighbours and is closest to its preferred velocity.
+* @param agent - Index of the agent.
+* @return New velocity of the agent.
+*/
+CrowdAvoidance::Vec2 CrowdAvoidance::computeVelocity(size_t agent) {
+	const Agent& self = agents[agent];
+	size_t neighbours[MAX_NEIGHBOURS];
+	size_t count = this->findNeighbours(agent, neighbours);
+	if (count == 0) return self.preferredVelocity;
+
+	lines.clear();
+	float invTimeHorizon = 1.0f / TIME_HORIZON;
+	for (size_t i = 0; i < count; i++) {
+		const Agent& other = agents[neighbours[i]];
+		Vec2 relativePosition = subtract(other.position, self.position);
+		Vec2 relativeVelocity = subtract(self.velocity, other.velocity);
+		float distSq = dot(relativePosition, relativePosition);
+		float combinedRadius = self.radius + other.radius;
+		float combinedRadiusSq = combinedRadius * combinedRadius;
+
+		Line line;
+		Vec2 u;
+		if (distSq > combinedRadiusSq) {
+			// vector from the cutoff center of the velocity obstacle to the relative velocity
+			Vec2 w = subtract(relativeVelocity, scale(relativePosition, invTimeHorizon));
+			float wLengthSq = dot(w, w);
+			float dotProduct = dot(w, relativePosition);
+
+			if (dotProduct < 0.0f && dotProduct * dotProduct > combinedRadiusSq * wLengthSq) {
+				// closest to the cutoff circle
+				float wLength = std::sqrt(wLengthSq);
+				Vec2 unitW = scale(w, 1.0f / wLength);
+				line.direction = { unitW.y, -unitW.x };
+				u = scale(unitW, combinedRadius * invTimeHorizon - wLength);
+			}
+			else {
+				// closest to one of the legs
+				float leg = std::sqrt(distSq - combinedRadiusSq);
+				if (det(relativePosition, w) > 0.0f) {
+					line.direction = scale({ relativePosition.x * leg - relativePosition.y * combinedRadius, relativePosition.x * combinedRadius + relativePosition.y * leg }, 1.0f / distSq);
+				}
+				else {
+					line.direction = scale({ relativePosition.x * leg + relativePosition.y * combinedRadius, -relativePosition.x * combinedRadius + relativePosition.y * leg }, -1.0f / distSq);
+				}
+				u = subtract(scale(line.direction, dot(relativeVelocity, line.direction)), relativeVelocity);
+			}
+		}
+		else {
+			// the agents overlap, they are pushed apart within the next frame
+			Vec2 w = subtract(relativeVelocity, relativePosition);
+			float wLength = std::sqrt(dot(w, w));
+			// agents on the same position with the same velocity are separated by their index
+			Vec2 unitW = (wLength > EPSILON) ? scale(w, 1.0f / wLength) : Vec2{ (agent < neighbours[i]) ? -1.0f : 1.0f, 0.0f };
+			line.direction = { unitW.y, -unitW.x };
+			u = scale(unitW, combinedRadius - wLength);
+		}
+
+		// reactive neighbours take the other half of the avoidance
+		float responsibility = other.reactive ? 0.5f : 1.0f;
+		line.point = add(self.velocity, scale(u, responsibility));
+		lines.push_back(line);
+	}
+
+	// perfectly symmetric crowds would block each other
+	float angle = this->nextRandom() * 6.28318531f;
+	float offset = self.maxSpeed * PERTURBATION;
+	Vec2 optVelocity = { self.preferredVelocity.x + offset * std::cos(angle), self.preferredVelocity.y + offset * std::sin(angle) };
+
+	Vec2 result = { 0.0f, 0.0f };
+	size_t lineFail = this->linearProgram2(lines, self.maxSpeed, optVelocity, false, result);
+	if (lineFail < lines.size()) {
+		this->linearProgram3(lineFail, self.maxSpeed, result);
+	}
+	return result;
+}
+
+/**
+* @brief Finds the permitted velocity on a line closest to the optimization velocity, satisfying the previous lines and the maximum speed.
+* @param constraints - Half planes.
+* @param lineNo - Index of the line to search on.
+* @param radius - Maximum speed.
+* @param optVelocity - Optimization velocity.
+* @param directionOpt - Whether the optimization velocity is a direction, the velocity furthest in the direction is chosen.
+* @param result - Set to the found velocity.
+* @return Whether a permitted velocity exists on the line.
+*/
+bool CrowdAvoidance::linearProgram1(const std::vector<Line>& constraints, size_t lineNo, float radius, Vec2 optVelocity, bool directionOpt, Vec2& result) {
+	const Line& line = constraints[lineNo];
+	float dotProduct = dot(line.point, line.direction);
+	float discriminant = dotProduct * dotProduct + radius * radius - dot(line.point, line.point);
+
+	// the maximum speed circle does not reach the line
+	if (discriminant < 0.0f) return false;
+
+	float sqrtDiscriminant = std::sqrt(discriminant);
+	float tLeft = -dotProduct - sqrtDiscriminant;
+	float tRight = -dotProduct + sqrtDiscriminant;
+
+	for (size_t i = 0; i < lineNo; i++) {
+		float denominator = det(line.direction, constraints[i].direction);
+		float numerator = det(constraints[i].direction, subtract(line.point, constraints[i].point));
+
+		if (std::fabs(denominator) <= EPSILON) {
+			// parallel lines, either every or no point of the line is permitted
+			if (numerator < 0.0f) return false;
+			continue;
+		}
+
+		float t = numerator / denominator;
+		if (denominator >= 0.0f) {
+			tRight = std::min(tRight, t);
+		}
+		else {
+			tLeft = std::max(tLeft, t);
+		}
+		if (tLeft > tRight) return false;
+	}
+
+	if (directionOpt) {
+		result = add(line.point, scale(line.direction, (dot(optVelocity, line.direction) > 0.0f) ? tRight : tLeft));
+	}
+	else {
+		float t = dot(line.direction, subtract(optVelocity, line.point));
+		result = add(line.point, scale(line.direction, std::min(std::max(t, tLeft), tRight)));
+	}
+	return true;
+}
+
+/**
+* @brief Finds the velocity closest to the optimization velocity that satisfies every half plane and the maximum speed.
+* @param constraints - Half planes.
+* @param radius - Maximum speed.
+* @param optVelocity - Optimization velocity.
+* @param directionOpt - Whether the optimization velocity is a direction, the velocity furthest in the direction is chosen.
+* @param result - Set to the found velocity.
+* @return Number of satisfied half planes. Equal to the number of half planes if the program succeeded.
+*/
+size_t CrowdAvoidance::linearProgram2(const std::vector<Line>& constraints, float radius, Vec2 optVelocity, bool directionOpt, Vec2& result) {
+	float optLengthSq = dot(optVelocity, optVelocity);
+	if (directionOpt) {
+		result = scale(optVelocity, radius);
+	}
+	else if (optLengthSq > radius * radius) {
+		result = scale(optVelocity, radius / std::sqrt(optLengthSq));
+	}
+	else {
+		result = optVelocity;
+	}
+
+	for (size_t i = 0; i < constraints.size(); i++) {
+		// the result violates the half plane, the optimum lies on its line
+		if (det(constraints[i].direction, subtract(constraints[i].point, result)) > 0.0f) {
+			Vec2 previous = result;
+			if (!this->linearProgram1(constraints, i, radius, optVelocity, directionOpt, result)) {
+				result = previous;
+				return i;
+			}
+		}
+	}
+	return constraints.size();
+}
+
+/**
+* @brief Finds the velocity that minimizes the largest violation of the half planes, if no velocity satisfies every half plane. Used in dense crowds.
+* @param beginLine - Index of the first half plane that could not be satisfied.
+* @param radius - Maximum speed.
+* @param result - Velocity satisfying the half planes before beginLine. Set to the found velocity.
+*/
+void CrowdAvoidance::linearProgram3(size_t beginLine, float radius, Vec2& result) {
+	float distance = 0.0f;
+
+	for (size_t i = beginLine; i < lines.size(); i++) {
+		if (det(lines[i].direction, subtract(lines[i].point, result)) <= distance) continue;
+
+		// the velocity violates this half plane more than the previous ones
+		projectedLines.clear();
+		for (size_t j = 0; j < i; j++) {
+			Line line;
+			float determinant = det(lines[i].direction, lines[j].direction);
+
+			if (std::fabs(determinant) <= EPSILON) {
+				// same direction, the half plane is contained in the other one
+				if (dot(lines[i].direction, lines[j].direction) > 0.0f) continue;
+				line.point = scale(add(lines[i].point, lines[j].point), 0.5f);
+			}
+			else {
+				line.point = add(lines[i].point, scale(lines[i].direction, det(lines[j].direction, subtract(lines[i].point, lines[j].point)) / determinant));
+			}
+
+			Vec2 direction = subtract(lines[j].direction, lines[i].direction);
+			float length = std::sqrt(dot(direction, direction));
+			if (length <= EPSILON) continue;
+			line.direction = scale(direction, 1.0f / length);
+			projectedLines.push_back(line);
+		}
+
+		Vec2 previous = result;
+		if (this->linearProgram2(projectedLines, radius, { -lines[i].direction.y, lines[i].direction.x }, true, result) < projectedLines.size()) {
+			// can only fail because of rounding errors, the previous result is kept
+			result = previous;
+		}
+		distance = det(lines[i].direction, subtract(lines[i].point, result));
+	}
+}
+
+/**
+* @brief Generates the next random number of the perturbation (xorshift).
+* @return Random number from 0 to 1.
+*/
+float CrowdAvoidance::nextRandom() {
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 17;
+	randomState ^= randomState << 5;
+	return (randomState & 0xFFFFFF) / (float)0x1000000;
+}
+
+/**
+* @brief Accounts the current storage of the agents and cells in the memory tracker.
+*/
+void CrowdAvoidance::trackMemory() {
+	size_t bytes = agents.capacity() * sizeof(Agent) + (cellStarts.capacity() + cellAgents.capacity()) * sizeof(int32_t)
+		+ (lines.capacity() + projectedLines.capacity()) * sizeof(Line);
+
+	if (bytes != trackedBytes) {
+		MemoryTracker::trackDeallocation(TAG_PATHFINDING, trackedBytes);
+		MemoryTracker::trackAllocation(TAG_PATHFINDING, bytes);
+		trackedBytes = bytes;
+	}
+}
@@ -0,0 +1,251 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "../memorytracker.h"
+
+/**
+ * @brief Local avoidance between moving agents with optimal reciprocal collision avoidance (ORCA).
+ * Every agent takes half of the responsibility to avoid each reactive neighbour and the full responsibility for agents that do not react. The velocity closest to the preferred velocity of the agent that avoids every neighbour within the time horizon is chosen by a 2D linear program.
+ * Agents are collected every frame, neighbours are looked up in a uniform grid of cells with the size of the neighbour distance.
+*/
+class CrowdAvoidance {
+public:
+	/**
+	 * @brief Two dimensional vector of the avoidance.
+	*/
+	struct Vec2 {
+		float x;
+		float y;
+	};
+
+	/**
+	 * @brief Index of no agent.
+	*/
+	static const size_t NO_AGENT = SIZE_MAX;
+
+	/**
+	 * @brief Maximum number of closest neighbours avoided by an agent.
+	*/
+	static const size_t MAX_NEIGHBOURS = 10;
+
+	/**
+	 * @brief Time in frames for which the chosen velocities are collision free.
+	*/
+	static const float TIME_HORIZON;
+
+	/**
+	 * @brief Length of the random offset of the preferred velocities relative to the maximum speed. Perfectly symmetric crowds would block each other without it.
+	*/
+	static const float PERTURBATION;
+
+	/**
+	 * @brief Destructor of the avoidance. Removes the agents from the memory tracker.
+	*/
+	~CrowdAvoidance();
+
+	/**
+	 * @brief Initializes the cells of the avoidance and removes every agent.
+	 * @param worldWidth - Width of the world in pixels.
+	 * @param worldHeight - Height of the world in pixels.
+	 * @param neighbourDistance - Distance in pixels between the centers of two agents up to which they avoid each other.
+	*/
+	void init(int worldWidth, int worldHeight, int neighbourDistance);
+
+	/**
+	 * @brief Removes every agent. Called before the agents of a frame are added.
+	*/
+	void clear();
+
+	/**
+	 * @brief Adds an agent that does not react to its neighbours. Its velocity is kept unless a preferred velocity is set.
+	 * @param position - Position of the agent in pixels.
+	 * @param radius - Radius of the agent in pixels.
+	 * @param velocity - Velocity of the agent in the last frame in pixels per frame.
+	 * @return Index of the agent.
+	*/
+	size_t addAgent(Vec2 position, float radius, Vec2 velocity);
+
+	/**
+	 * @brief Sets the velocity the agent wants to move with. The agent reacts to its neighbours from now on.
+	 * @param agent - Index of the agent.
+	 * @param velocity - Preferred velocity in pixels per frame. Its length is the maximum speed of the agent.
+	*/
+	void setPreferredVelocity(size_t agent, Vec2 velocity);
+
+	/**
+	 * @brief Calculates the new velocities of the reactive agents.
+	*/
+	void solve();
+
+	/**
+	 * @brief Gets the velocity of an agent calculated by the last solve.
+	 * @param agent - Index of the agent.
+	 * @return New velocity in pixels per frame.
+	*/
+	Vec2 getVelocity(size_t agent) { return agents[agent].newVelocity; }
+
+	/**
+	 * @brief Gets the preferred velocity of an agent.
+	 * @param agent - Index of the agent.
+	 * @return Preferred velocity in pixels per frame.
+	*/
+	Vec2 getPreferredVelocity(size_t agent) { return agents[agent].preferredVelocity; }
+
+	/**
+	 * @brief Checks if the agent reacts to its neighbours.
+	 * @param agent - Index of the agent.
+	 * @return Whether a preferred velocity was set for the agent.
+	*/
+	bool isReactive(size_t agent) { return agents[agent].reactive; }
+
+	/**
+	 * @brief Gets the number of agents.
+	 * @return Number of agents.
+	*/
+	size_t getAgentCount() { return agents.size(); }
+private:
+	/**
+	 * @brief Agent of the avoidance.
+	*/
+	struct Agent {
+		Vec2 position;
+		Vec2 velocity;
+		Vec2 preferredVelocity;
+		Vec2 newVelocity;
+		float radius;
+		float maxSpeed;
+		bool reactive;
+	};
+
+	/**
+	 * @brief Directed line of a half plane of permitted velocities. The permitted velocities are on the left side of the line.
+	*/
+	struct Line {
+		Vec2 point;
+		Vec2 direction;
+	};
+
+	/**
+	 * @brief Width and height of a cell in pixels.
+	*/
+	int cellSize = 1;
+
+	/**
+	 * @brief Number of cells per row.
+	*/
+	int cellsX = 0;
+
+	/**
+	 * @brief Number of cells per column.
+	*/
+	int cellsY = 0;
+
+	/**
+	 * @brief Distance in pixels between the centers of two agents up to which they avoid each other.
+	*/
+	float neighbourDistance = 0.0f;
+
+	/**
+	 * @brief Agents of the current frame.
+	*/
+	std::vector<Agent> agents;
+
+	/**
+	 * @brief Index of the first agent per cell in cellAgents. One more entry than cells, so the agents of a cell end at the start of the next cell.
+	*/
+	std::vector<int32_t> cellStarts;
+
+	/**
+	 * @brief Agent indices sorted by cell.
+	*/
+	std::vector<int32_t> cellAgents;
+
+	/**
+	 * @brief Half planes of the agent whose velocity is calculated.
+	*/
+	std::vector<Line> lines;
+
+	/**
+	 * @brief Half planes projected onto a violated half plane, if no velocity satisfies every half plane.
+	*/
+	std::vector<Line> projectedLines;
+
+	/**
+	 * @brief State of the random generator of the perturbation.
+	*/
+	uint32_t randomState = 1;
+
+	/**
+	 * @brief Bytes of the agents and cells accounted to the memory tracker.
+	*/
+	size_t trackedBytes = 0;
+
+	/**
+	 * @brief Generates the next random number of the perturbation (xorshift).
+	 * @return Random number from 0 to 1.
+	*/
+	float nextRandom();
+
+	/**
+	 * @brief Gets the cell of a position. Positions outside of the world are clamped to the border cells.
+	 * @param position - Position in pixels.
+	 * @return Index of the cell.
+	*/
+	int getCell(Vec2 position);
+
+	/**
+	 * @brief Sorts the agents into the cells.
+	*/
+	void buildCells();
+
+	/**
+	 * @brief Finds the closest agents within the neighbour distance of an agent.
+	 * @param agent - Index of the agent.
+	 * @param neighbours - Buffer of MAX_NEIGHBOURS agent indices, sorted by distance.
+	 * @return Number of found neighbours.
+	*/
+	size_t findNeighbours(size_t agent, size_t* neighbours);
+
+	/**
+	 * @brief Calculates the velocity of an agent that avoids its neighbours and is closest to its preferred velocity.
+	 * @param agent - Index of the agent.
+	 * @return New velocity of the agent.
+	*/
+	Vec2 computeVelocity(size_t agent);
+
+	/**
+	 * @brief Finds the permitted velocity on a line closest to the optimization velocity, satisfying the previous lines and the maximum speed.
+	 * @param constraints - Half planes.
+	 * @param lineNo - Index of the line to search on.
+	 * @param radius - Maximum speed.
+	 * @param optVelocity - Optimization velocity.
+	 * @param directionOpt - Whether the optimization velocity is a direction, the velocity furthest in the direction is chosen.
+	 * @param result - Set to the found velocity.
+	 * @return Whether a permitted velocity exists on the line.
+	*/
+	bool linearProgram1(const std::vector<Line>& constraints, size_t lineNo, float radius, Vec2 optVelocity, bool directionOpt, Vec2& result);
+
+	/**
+	 * @brief Finds the velocity closest to the optimization velocity that satisfies every half plane and the maximum speed.
+	 * @param constraints - Half planes.
+	 * @param radius - Maximum speed.
+	 * @param optVelocity - Optimization velocity.
+	 * @param directionOpt - Whether the optimization velocity is a direction, the velocity furthest in the direction is chosen.
+	 * @param result - Set to the found velocity.
+	 * @return Number of satisfied half planes. Equal to the number of half planes if the program succeeded.
+	*/
+	size_t linearProgram2(const std::vector<Line>& constraints, float radius, Vec2 optVelocity, bool directionOpt, Vec2& result);
+
+	/**
+	 * @brief Finds the velocity that minimizes the largest violation of the half planes, if no velocity satisfies every half plane. Used in dense crowds.
+	 * @param beginLine - Index of the first half plane that could not be satisfied.
+	 * @param radius - Maximum speed.
+	 * @param result - Velocity satisfying the half planes before beginLine. Set to the found velocity.
+	*/
+	void linearProgram3(size_t beginLine, float radius, Vec2& result);
+
+	/**
+	 * @brief Accounts the current storage of the agents and cells in the memory tracker.
+	*/
+	void trackMemory();
+};
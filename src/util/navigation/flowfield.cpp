@@ -0,0 +1,132 @@
+#include "flowfield.h"
+#include <algorithm>
+#include <functional>
+
+/**
+* @brief Destructor of the flow field. Removes the field from the memory tracker.
+*/
+FlowField::~FlowField() {
+	MemoryTracker::trackDeallocation(TAG_PATHFINDING, trackedBytes);
+}
+
+/**
+* @brief Builds the integration field of the grid towards the destination. Blocked nodes and obstacles of the grid are avoided.
+* @param grid - Navigation grid to build the field for.
+* @param dest - Destination node.
+* @return Whether the field was built.
+*/
+bool FlowField::build(NavGrid& grid, NodeIndex dest) {
+	if (!grid.isValid(dest)) {
+		this->invalidate();
+		return false;
+	}
+
+	size_t nodeCount = grid.getNodeCount();
+	if (integration.size() != nodeCount) {
+		std::vector<float>(nodeCount).swap(integration);
+		openNodes.reserve(nodeCount);
+	}
+	std::fill(integration.begin(), integration.end(), INFINITY);
+	openNodes.clear();
+
+	std::greater<std::pair<float, NodeIndex>> compare;
+	integration[dest] = 0.0f;
+	openNodes.push_back(std::make_pair(0.0f, dest));
+
+	while (!openNodes.empty()) {
+		std::pop_heap(openNodes.begin(), openNodes.end(), compare);
+		float cost = openNodes.back().first;
+		NodeIndex current = openNodes.back().second;
+		openNodes.pop_back();
+
+		// outdated entry of a node that was reached cheaper
+		if (cost > integration[current]) continue;
+
+		// agents on a neighbour pay the cost of entering the current node
+		uint8_t enterCost = grid.getCost(current);
+		float stepCost = (enterCost > 0) ? enterCost : 1.0f;
+
+		for (int i = 0; i < NavGrid::NEIGHBOUR_COUNT; i++) {
+			NodeIndex neighbour = grid.getNeighbour(current, i);
+			if (neighbour == INVALID_NODE || !grid.isWalkable(neighbour)) continue;
+
+			float neighbourCost = cost + NavGrid::getNeighbourDistance(i) * stepCost;
+			if (neighbourCost < integration[neighbour]) {
+				integration[neighbour] = neighbourCost;
+				openNodes.push_back(std::make_pair(neighbourCost, neighbour));
+				std::push_heap(openNodes.begin(), openNodes.end(), compare);
+			}
+		}
+	}
+	destination = dest;
+
+	// the open list only grows beyond the number of nodes on maps with many different costs
+	size_t bytes = integration.capacity() * sizeof(float) + openNodes.capacity() * sizeof(std::pair<float, NodeIndex>);
+	if (bytes != trackedBytes) {
+		MemoryTracker::trackDeallocation(TAG_PATHFINDING, trackedBytes);
+		MemoryTracker::trackAllocation(TAG_PATHFINDING, bytes);
+		trackedBytes = bytes;
+	}
+	return true;
+}
+
+/**
+* @brief Gets the neighbour to move to from the node. Neighbours marked as obstacle are only chosen if there is no other neighbour closer to the destination.
+* @param grid - Navigation grid the field was built for.
+* @param node - Valid node index.
+* @return Index of the next node. INVALID_NODE if no neighbour is closer to the destination.
+*/
+NodeIndex FlowField::getNextNode(NavGrid& grid, NodeIndex node) {
+	NodeIndex next = INVALID_NODE;
+	float nextCost = INFINITY;
+	NodeIndex blockedNext = INVALID_NODE;
+	float blockedCost = INFINITY;
+
+	for (int i = 0; i < NavGrid::NEIGHBOUR_COUNT; i++) {
+		NodeIndex neighbour = grid.getNeighbour(node, i);
+		if (neighbour == INVALID_NODE || !(integration[neighbour] < integration[node])) continue;
+
+		// cost of the path over the neighbour, the cheapest neighbour lies on the cheapest path
+		uint8_t enterCost = grid.getCost(neighbour);
+		float cost = integration[neighbour] + NavGrid::getNeighbourDistance(i) * ((enterCost > 0) ? enterCost : 1.0f);
+		if (neighbour != destination && grid.isObstacle(neighbour)) {
+			if (cost < blockedCost) {
+				blockedNext = neighbour;
+				blockedCost = cost;
+			}
+		}
+		else if (cost < nextCost) {
+			next = neighbour;
+			nextCost = cost;
+		}
+	}
+	return (next != INVALID_NODE) ? next : blockedNext;
+}
+
+/**
+* @brief Follows the field from the start node to the destination.
+* @param grid - Navigation grid the field was built for.
+* @param start - Start node.
+* @param path - Buffer the path is written to, from the destination node back to the start node. Cleared if the destination can not be reached.
+* @return Whether the destination can be reached.
+*/
+bool FlowField::tracePath(NavGrid& grid, NodeIndex start, std::vector<NodeIndex>& path) {
+	path.clear();
+	if (destination == INVALID_NODE || !grid.isValid(start)) {
+		return false;
+	}
+
+	// every step strictly decreases the cost, so the path can not loop
+	NodeIndex current = start;
+	path.push_back(current);
+	while (current != destination) {
+		current = this->getNextNode(grid, current);
+		if (current == INVALID_NODE) {
+			path.clear();
+			return false;
+		}
+		path.push_back(current);
+	}
+	std::reverse(path.begin(), path.end());
+	return true;
+}
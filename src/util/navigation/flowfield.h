@@ -0,0 +1,79 @@
+#pragma once
+#include <utility>
+#include <vector>
+#include "navgrid.h"
+
+/**
+ * @brief Flow field towards one destination node. Every node stores the cost of the cheapest path to the destination (integration field), so any number of agents can follow the field to the destination without an own search.
+ * The field is built with a single dijkstra search from the destination and is only valid until the costs or obstacles of the grid change.
+*/
+class FlowField {
+public:
+	/**
+	 * @brief Destructor of the flow field. Removes the field from the memory tracker.
+	*/
+	~FlowField();
+
+	/**
+	 * @brief Builds the integration field of the grid towards the destination. Blocked nodes and obstacles of the grid are avoided.
+	 * @param grid - Navigation grid to build the field for.
+	 * @param dest - Destination node.
+	 * @return Whether the field was built.
+	*/
+	bool build(NavGrid& grid, NodeIndex dest);
+
+	/**
+	 * @brief Invalidates the field. The field has to be built again before it can be used.
+	*/
+	void invalidate() { destination = INVALID_NODE; }
+
+	/**
+	 * @brief Gets the destination node of the field.
+	 * @return Index of the destination node. INVALID_NODE if the field was not built.
+	*/
+	NodeIndex getDestination() { return destination; }
+
+	/**
+	 * @brief Gets the cost of the cheapest path from the node to the destination.
+	 * @param node - Valid node index.
+	 * @return Cost to the destination. INFINITY if the destination can not be reached from the node.
+	*/
+	float getCost(NodeIndex node) { return integration[node]; }
+
+	/**
+	 * @brief Gets the neighbour to move to from the node. Neighbours marked as obstacle are only chosen if there is no other neighbour closer to the destination.
+	 * @param grid - Navigation grid the field was built for.
+	 * @param node - Valid node index.
+	 * @return Index of the next node. INVALID_NODE if no neighbour is closer to the destination.
+	*/
+	NodeIndex getNextNode(NavGrid& grid, NodeIndex node);
+
+	/**
+	 * @brief Follows the field from the start node to the destination.
+	 * @param grid - Navigation grid the field was built for.
+	 * @param start - Start node.
+	 * @param path - Buffer the path is written to, from the destination node back to the start node. Cleared if the destination can not be reached.
+	 * @return Whether the destination can be reached.
+	*/
+	bool tracePath(NavGrid& grid, NodeIndex start, std::vector<NodeIndex>& path);
+private:
+	/**
+	 * @brief Destination node of the field.
+	*/
+	NodeIndex destination = INVALID_NODE;
+
+	/**
+	 * @brief Cost of the cheapest path to the destination per node.
+	*/
+	std::vector<float> integration;
+
+	/**
+	 * @brief Open list of the dijkstra search as binary min heap of cost and node. Outdated entries are skipped when they are removed.
+	*/
+	std::vector<std::pair<float, NodeIndex>> openNodes;
+
+	/**
+	 * @brief Bytes of the field accounted to the memory tracker.
+	*/
+	size_t trackedBytes = 0;
+};
@@ -0,0 +1,694 @@
+#include "hierarchicalgrid.h"
+#include <algorithm>
+#include <functional>
+
+/**
+* @brief Gets the distance between two nodes when moving with a cost of 1 in 8 directions. Never overestimates the cost of a path.
+* @param grid - Navigation grid.
+* @param a - First node.
+* @param b - Second node.
+* @return Octile distance of the nodes.
+*/
+static inline float getOctileDistance(NavGrid& grid, NodeIndex a, NodeIndex b) {
+	int dx = std::abs(grid.getX(a) - grid.getX(b));
+	int dy = std::abs(grid.getY(a) - grid.getY(b));
+	return (dx > dy) ? (dx + 0.41421356f * dy) : (dy + 0.41421356f * dx);
+}
+
+/**
+* @brief Gets the cost of entering a node. Blocked nodes can only be entered as destination and cost 1.
+* @param grid - Navigation grid.
+* @param node - Valid node index.
+* @return Cost of entering the node.
+*/
+static inline float getEnterCost(NavGrid& grid, NodeIndex node) {
+	uint8_t cost = grid.getCost(node);
+	return (cost > 0) ? cost : 1.0f;
+}
+
+/**
+* @brief Gets the cost of a step between two neighbouring nodes.
+* @param grid - Navigation grid.
+* @param from - Node that is left.
+* @param to - Node that is entered.
+* @return Cost of the step.
+*/
+static inline float getStepCost(NavGrid& grid, NodeIndex from, NodeIndex to) {
+	bool diagonal = grid.getX(from) != grid.getX(to) && grid.getY(from) != grid.getY(to);
+	return (diagonal ? 1.41421356f : 1.0f) * getEnterCost(grid, to);
+}
+
+/**
+* @brief Destructor of the hierarchical grid. Removes the abstract graph from the memory tracker.
+*/
+HierarchicalGrid::~HierarchicalGrid() {
+	MemoryTracker::trackDeallocation(TAG_PATHFINDING, trackedBytes);
+}
+
+/**
+* @brief Initializes the clusters for a grid. Every cluster is built at the next update.
+* @param width - Number of nodes per row of the grid.
+* @param height - Number of nodes per column of the grid.
+* @param clusterSize - Width and height of a cluster in nodes.
+*/
+void HierarchicalGrid::init(int width, int height, int clusterSize) {
+	this->width = (width > 0) ? width : 0;
+	this->height = (height > 0) ? height : 0;
+	// a node can lie on at most two borders of its cluster
+	this->clusterSize = (clusterSize > 1) ? clusterSize : DEFAULT_CLUSTER_SIZE;
+	this->clustersX = (this->width + this->clusterSize - 1) / this->clusterSize;
+	this->clustersY = (this->height + this->clusterSize - 1) / this->clusterSize;
+
+	std::vector<Cluster>((size_t)clustersX * clustersY).swap(clusters);
+	std::vector<int32_t>().swap(clusterOffsets);
+	std::vector<NodeIndex>().swap(abstractNodes);
+	std::vector<float>().swap(abstractCosts);
+	std::vector<int32_t>().swap(abstractParents);
+	dirtyClusters = clusters.size();
+
+	size_t clusterNodes = (size_t)this->clusterSize * this->clusterSize;
+	for (int i = 0; i < MAX_ENDPOINT_CLUSTERS; i++) {
+		std::vector<float>(clusterNodes).swap(startSearches[i].costs);
+		std::vector<int32_t>(clusterNodes).swap(startSearches[i].parents);
+		std::vector<float>(clusterNodes).swap(destSearches[i].costs);
+		std::vector<int32_t>(clusterNodes).swap(destSearches[i].parents);
+	}
+	std::vector<float>(clusterNodes).swap(clusterCosts);
+	std::vector<int32_t>(clusterNodes).swap(clusterParents);
+	std::vector<std::pair<float, int32_t>>().swap(openNodes);
+	openNodes.reserve(clusterNodes);
+	this->trackMemory();
+}
+
+/**
+* @brief Marks the clusters overlapping the area as changed. They are rebuilt at the next update.
+* @param x - X-position of the area on the grid.
+* @param y - Y-position of the area on the grid.
+* @param w - Width of the area in nodes.
+* @param h - Height of the area in nodes.
+*/
+void HierarchicalGrid::invalidateArea(int x, int y, int w, int h) {
+	int minX = std::max(x, 0);
+	int minY = std::max(y, 0);
+	int maxX = std::min(x + w, width) - 1;
+	int maxY = std::min(y + h, height) - 1;
+	if (minX > maxX || minY > maxY) return;
+
+	for (int cy = minY / clusterSize; cy <= maxY / clusterSize; cy++) {
+		for (int cx = minX / clusterSize; cx <= maxX / clusterSize; cx++) {
+			Cluster& cluster = clusters[(size_t)cy * clustersX + cx];
+			if (!cluster.dirty) {
+				cluster.dirty = true;
+				dirtyClusters++;
+			}
+		}
+	}
+}
+
+/**
+* @brief Marks every cluster as changed.
+*/
+void HierarchicalGrid::invalidate() {
+	for (size_t i = 0; i < clusters.size(); i++) {
+		clusters[i].dirty = true;
+	}
+	dirtyClusters = clusters.size();
+}
+
+/**
+* @brief Rebuilds the changed clusters and their neighbours. The currently blocked nodes and obstacles of the grid are stored in the abstract graph.
+* @param grid - Navigation grid the clusters were initialized for.
+*/
+void HierarchicalGrid::update(NavGrid& grid) {
+	if (dirtyClusters == 0) return;
+
+	// the entrances of the neighbours change with the shared borders and corners
+	std::vector<uint8_t> rebuild(clusters.size(), 0);
+	for (int cy = 0; cy < clustersY; cy++) {
+		for (int cx = 0; cx < clustersX; cx++) {
+			if (!clusters[(size_t)cy * clustersX + cx].dirty) continue;
+
+			for (int ny = std::max(cy - 1, 0); ny <= std::min(cy + 1, clustersY - 1); ny++) {
+				for (int nx = std::max(cx - 1, 0); nx <= std::min(cx + 1, clustersX - 1); nx++) {
+					rebuild[(size_t)ny * clustersX + nx] = 1;
+				}
+			}
+		}
+	}
+
+	for (size_t i = 0; i < clusters.size(); i++) {
+		if (rebuild[i]) clusters[i].entrances.clear();
+	}
+
+	// every border of a rebuilt cluster is scanned once, entrances of kept clusters stay as they are
+	for (int cy = 0; cy < clustersY; cy++) {
+		for (int cx = 0; cx < clustersX; cx++) {
+			int cluster = cy * clustersX + cx;
+			if (!rebuild[cluster]) continue;
+
+			if (cx < clustersX - 1) {
+				this->addBorderEntrances(grid, cluster, cluster + 1, true, true, rebuild[cluster + 1] != 0);
+			}
+			if (cy < clustersY - 1) {
+				this->addBorderEntrances(grid, cluster, cluster + clustersX, false, true, rebuild[cluster + clustersX] != 0);
+			}
+			if (cx > 0 && !rebuild[cluster - 1]) {
+				this->addBorderEntrances(grid, cluster - 1, cluster, true, false, true);
+			}
+			if (cy > 0 && !rebuild[cluster - clustersX]) {
+				this->addBorderEntrances(grid, cluster - clustersX, cluster, false, false, true);
+			}
+
+			if (cy < clustersY - 1 && cx < clustersX - 1) {
+				this->addCornerEntrances(grid, cluster, cluster + clustersX + 1, true, rebuild[cluster + clustersX + 1] != 0);
+			}
+			if (cy < clustersY - 1 && cx > 0) {
+				this->addCornerEntrances(grid, cluster, cluster + clustersX - 1, true, rebuild[cluster + clustersX - 1] != 0);
+			}
+			if (cy > 0 && cx > 0 && !rebuild[cluster - clustersX - 1]) {
+				this->addCornerEntrances(grid, cluster - clustersX - 1, cluster, false, true);
+			}
+			if (cy > 0 && cx < clustersX - 1 && !rebuild[cluster - clustersX + 1]) {
+				this->addCornerEntrances(grid, cluster - clustersX + 1, cluster, false, true);
+			}
+		}
+	}
+
+	// costs between the entrances of each rebuilt cluster
+	for (size_t i = 0; i < clusters.size(); i++) {
+		Cluster& cluster = clusters[i];
+		cluster.dirty = false;
+		if (!rebuild[i]) continue;
+
+		size_t count = cluster.entrances.size();
+		cluster.costs.assign(count * count, INFINITY);
+		for (size_t from = 0; from < count; from++) {
+			this->searchCluster(grid, (int)i, cluster.entrances[from].node, false, clusterCosts, clusterParents);
+			for (size_t to = 0; to < count; to++) {
+				cluster.costs[from * count + to] = clusterCosts[getLocalIndex(cluster.entrances[to].node)];
+			}
+		}
+	}
+	dirtyClusters = 0;
+
+	// ids of the abstract nodes
+	clusterOffsets.resize(clusters.size());
+	abstractNodes.clear();
+	for (size_t i = 0; i < clusters.size(); i++) {
+		clusterOffsets[i] = (int32_t)abstractNodes.size();
+		for (size_t j = 0; j < clusters[i].entrances.size(); j++) {
+			abstractNodes.push_back(clusters[i].entrances[j].node);
+		}
+	}
+	for (size_t i = 0; i < clusters.size(); i++) {
+		for (size_t j = 0; j < clusters[i].entrances.size(); j++) {
+			Entrance& entrance = clusters[i].entrances[j];
+			for (int l = 0; l < MAX_ENTRANCE_LINKS; l++) {
+				entrance.linkIds[l] = (entrance.links[l] != INVALID_NODE) ? this->findAbstractNode(entrance.links[l]) : -1;
+			}
+		}
+	}
+
+	// start and destination of a search are appended to the abstract nodes
+	abstractCosts.resize(abstractNodes.size() + 2);
+	abstractParents.resize(abstractNodes.size() + 2);
+	this->trackMemory();
+}
+
+/**
+* @brief Calculates the path from the start node to the destination node. Nodes in the same cluster and neighbouring nodes are searched with a* on the grid, otherwise the abstract graph is searched and only the first segment up to the next cluster is refined.
+* Blocked nodes and obstacles are avoided in the clusters of the start and destination node, the start node can always be left and the destination node can always be entered.
+* @param grid - Navigation grid the clusters were built for.
+* @param start - Start node.
+* @param dest - Destination node.
+* @param path - Buffer the path is written to, from the last refined node back to the start node. Cleared if no path was found.
+* @param complete - Set to whether the path ends at the destination node.
+* @return Whether a path was found.
+*/
+bool HierarchicalGrid::findPath(NavGrid& grid, NodeIndex start, NodeIndex dest, std::vector<NodeIndex>& path, bool& complete) {
+	path.clear();
+	complete = false;
+	if (!grid.isValid(start) || !grid.isValid(dest) || clusters.empty() || abstractCosts.empty()) {
+		return false;
+	}
+
+	int startCluster = this->getCluster(start);
+	int destCluster = this->getCluster(dest);
+	// neighbouring nodes are also connected if both are blocked and no cluster search can reach the other one
+	if (startCluster == destCluster || grid.getDistance(start, dest) < 1.5f) {
+		complete = true;
+		return grid.findPath(start, dest, path);
+	}
+
+	// connect the start and destination to the entrances of their clusters
+	destSearchCount = this->searchEndpoint(grid, dest, true, destSearches);
+	startSearchCount = this->searchEndpoint(grid, start, false, startSearches);
+
+	int32_t startId = (int32_t)abstractNodes.size();
+	int32_t destId = startId + 1;
+	std::fill(abstractCosts.begin(), abstractCosts.end(), INFINITY);
+	std::fill(abstractParents.begin(), abstractParents.end(), -1);
+	openNodes.clear();
+
+	std::greater<std::pair<float, int32_t>> compare;
+	abstractCosts[startId] = 0.0f;
+	openNodes.push_back(std::make_pair(getOctileDistance(grid, start, dest), startId));
+
+	// a blocked start or destination next to the cluster of the other one is connected to it inside of that cluster
+	EndpointSearch* directStart = nullptr;
+	EndpointSearch* directDest = nullptr;
+	int32_t directLocal = -1;
+	for (int i = 0; i < startSearchCount; i++) {
+		EndpointSearch* destSearch = this->findEndpointSearch(destSearches, destSearchCount, startSearches[i].cluster);
+		if (destSearch == nullptr) continue;
+
+		for (int32_t local = 0; local < (int32_t)startSearches[i].costs.size(); local++) {
+			float cost = startSearches[i].costs[local] + destSearch->costs[local];
+			if (cost < abstractCosts[destId]) {
+				abstractCosts[destId] = cost;
+				abstractParents[destId] = startId;
+				directStart = &startSearches[i];
+				directDest = destSearch;
+				directLocal = local;
+			}
+		}
+	}
+	if (directLocal >= 0) {
+		openNodes.push_back(std::make_pair(abstractCosts[destId], destId));
+		std::push_heap(openNodes.begin(), openNodes.end(), compare);
+	}
+
+	bool found = false;
+	while (!openNodes.empty()) {
+		std::pop_heap(openNodes.begin(), openNodes.end(), compare);
+		float estimate = openNodes.back().first;
+		int32_t current = openNodes.back().second;
+		openNodes.pop_back();
+
+		if (current == destId) {
+			found = true;
+			break;
+		}
+
+		NodeIndex node = (current == startId) ? start : abstractNodes[current];
+		float cost = abstractCosts[current];
+
+		// outdated entry of a node that was reached cheaper
+		if (estimate > cost + getOctileDistance(grid, node, dest)) continue;
+
+		if (current == startId) {
+			for (int i = 0; i < startSearchCount; i++) {
+				int clusterIndex = startSearches[i].cluster;
+				const Cluster& cluster = clusters[clusterIndex];
+				for (size_t j = 0; j < cluster.entrances.size(); j++) {
+					NodeIndex entrance = cluster.entrances[j].node;
+					this->openAbstractNode(grid, clusterOffsets[clusterIndex] + (int32_t)j, current, cost + startSearches[i].costs[getLocalIndex(entrance)], entrance, dest);
+				}
+			}
+			continue;
+		}
+
+		int clusterIndex = this->getCluster(node);
+		const Cluster& cluster = clusters[clusterIndex];
+		int32_t offset = clusterOffsets[clusterIndex];
+		size_t count = cluster.entrances.size();
+		size_t from = (size_t)(current - offset);
+
+		// the start already reached every entrance of its clusters directly
+		if (abstractParents[current] != startId) {
+			for (size_t to = 0; to < count; to++) {
+				if (to == from) continue;
+				this->openAbstractNode(grid, offset + (int32_t)to, current, cost + cluster.costs[from * count + to], cluster.entrances[to].node, dest);
+			}
+		}
+
+		const Entrance& entrance = cluster.entrances[from];
+		for (int l = 0; l < MAX_ENTRANCE_LINKS; l++) {
+			if (entrance.linkIds[l] < 0) continue;
+			this->openAbstractNode(grid, entrance.linkIds[l], current, cost + getStepCost(grid, node, entrance.links[l]), entrance.links[l], dest);
+		}
+
+		EndpointSearch* destSearch = this->findEndpointSearch(destSearches, destSearchCount, clusterIndex);
+		if (destSearch != nullptr) {
+			this->openAbstractNode(grid, destId, current, cost + destSearch->costs[getLocalIndex(node)], dest, dest);
+		}
+	}
+	if (!found) return false;
+
+	// first entrance on the path and the node after it
+	int32_t first = destId;
+	int32_t second = -1;
+	while (abstractParents[first] != startId) {
+		second = first;
+		first = abstractParents[first];
+	}
+
+	EndpointSearch* startSearch;
+	int32_t local;
+	if (first == destId) {
+		// refine the whole way inside of the shared cluster, from the destination to the node where both searches meet
+		int originX = (directDest->cluster % clustersX) * clusterSize;
+		int originY = (directDest->cluster / clustersX) * clusterSize;
+		for (local = directLocal; local >= 0; local = directDest->parents[local]) {
+			path.push_back(grid.getIndex(originX + local % clusterSize, originY + local / clusterSize));
+		}
+		if (this->getCluster(dest) != directDest->cluster) {
+			path.push_back(dest);
+		}
+		std::reverse(path.begin(), path.end());
+		path.pop_back();
+
+		startSearch = directStart;
+		local = directLocal;
+	}
+	else {
+		// refine the way to the first entrance and the step into the next cluster
+		startSearch = this->findEndpointSearch(startSearches, startSearchCount, this->getCluster(abstractNodes[first]));
+		if (second >= 0 && second != destId && this->getCluster(abstractNodes[second]) != startSearch->cluster) {
+			path.push_back(abstractNodes[second]);
+		}
+		local = getLocalIndex(abstractNodes[first]);
+	}
+
+	int originX = (startSearch->cluster % clustersX) * clusterSize;
+	int originY = (startSearch->cluster / clustersX) * clusterSize;
+	while (local >= 0) {
+		path.push_back(grid.getIndex(originX + local % clusterSize, originY + local / clusterSize));
+		local = startSearch->parents[local];
+	}
+	if (startSearch->cluster != startCluster) {
+		path.push_back(start);
+	}
+	complete = (path.front() == dest);
+	return true;
+}
+
+/**
+* @brief Searches the cheapest paths inside of a cluster from or to a node (dijkstra).
+* @param grid - Navigation grid.
+* @param cluster - Index of the cluster containing the node.
+* @param source - Node the search starts at.
+* @param reverse - Whether the costs to the node are searched instead of the costs from the node.
+* @param costs - Cost per local node index.
+* @param parents - Parent per local node index. The parent of the source is -1.
+*/
+void HierarchicalGrid::searchCluster(NavGrid& grid, int cluster, NodeIndex source, bool reverse, std::vector<float>& costs, std::vector<int32_t>& parents) {
+	int minX = (cluster % clustersX) * clusterSize;
+	int minY = (cluster / clustersX) * clusterSize;
+	int maxX = std::min(minX + clusterSize, width);
+	int maxY = std::min(minY + clusterSize, height);
+
+	std::fill(costs.begin(), costs.end(), INFINITY);
+	openNodes.clear();
+
+	std::greater<std::pair<float, int32_t>> compare;
+	if (this->getCluster(source) == cluster) {
+		int32_t sourceLocal = getLocalIndex(source);
+		costs[sourceLocal] = 0.0f;
+		parents[sourceLocal] = -1;
+		openNodes.push_back(std::make_pair(0.0f, sourceLocal));
+	}
+	else {
+		for (int i = 0; i < NavGrid::NEIGHBOUR_COUNT; i++) {
+			NodeIndex neighbour = grid.getNeighbour(source, i);
+			if (neighbour == INVALID_NODE || this->getCluster(neighbour) != cluster || !grid.isWalkable(neighbour)) continue;
+
+			int32_t neighbourLocal = getLocalIndex(neighbour);
+			costs[neighbourLocal] = reverse ? getStepCost(grid, neighbour, source) : getStepCost(grid, source, neighbour);
+			parents[neighbourLocal] = -1;
+			openNodes.push_back(std::make_pair(costs[neighbourLocal], neighbourLocal));
+		}
+		std::make_heap(openNodes.begin(), openNodes.end(), compare);
+	}
+
+	while (!openNodes.empty()) {
+		std::pop_heap(openNodes.begin(), openNodes.end(), compare);
+		float cost = openNodes.back().first;
+		int32_t local = openNodes.back().second;
+		openNodes.pop_back();
+
+		// outdated entry of a node that was reached cheaper
+		if (cost > costs[local]) continue;
+
+		NodeIndex current = grid.getIndex(minX + local % clusterSize, minY + local / clusterSize);
+		// searching backwards, the neighbour pays the cost of entering the current node
+		float reverseCost = reverse ? getEnterCost(grid, current) : 0.0f;
+
+		for (int i = 0; i < NavGrid::NEIGHBOUR_COUNT; i++) {
+			NodeIndex neighbour = grid.getNeighbour(current, i);
+			if (neighbour == INVALID_NODE || !grid.isWalkable(neighbour)) continue;
+
+			int x = grid.getX(neighbour);
+			int y = grid.getY(neighbour);
+			if (x < minX || y < minY || x >= maxX || y >= maxY) continue;
+
+			float stepCost = reverse ? reverseCost : getEnterCost(grid, neighbour);
+			float neighbourCost = cost + NavGrid::getNeighbourDistance(i) * stepCost;
+			int32_t neighbourLocal = (y - minY) * clusterSize + (x - minX);
+			if (neighbourCost < costs[neighbourLocal]) {
+				costs[neighbourLocal] = neighbourCost;
+				parents[neighbourLocal] = local;
+				openNodes.push_back(std::make_pair(neighbourCost, neighbourLocal));
+				std::push_heap(openNodes.begin(), openNodes.end(), compare);
+			}
+		}
+	}
+}
+
+/**
+* @brief Searches the cluster of the start or destination node of a search. A blocked node can only be left or entered through its walkable neighbours, so the clusters of its neighbours are searched as well.
+* @param grid - Navigation grid.
+* @param node - Start or destination node.
+* @param reverse - Whether the costs to the node are searched instead of the costs from the node.
+* @param searches - Buffer of MAX_ENDPOINT_CLUSTERS searches.
+* @return Number of searched clusters.
+*/
+int HierarchicalGrid::searchEndpoint(NavGrid& grid, NodeIndex node, bool reverse, EndpointSearch* searches) {
+	searches[0].cluster = this->getCluster(node);
+	this->searchCluster(grid, searches[0].cluster, node, reverse, searches[0].costs, searches[0].parents);
+	int count = 1;
+
+	// a walkable node reaches the neighbouring clusters through the entrances of its own cluster
+	if (grid.isWalkable(node)) return count;
+
+	for (int i = 0; i < NavGrid::NEIGHBOUR_COUNT; i++) {
+		NodeIndex neighbour = grid.getNeighbour(node, i);
+		if (neighbour == INVALID_NODE || !grid.isWalkable(neighbour)) continue;
+
+		int cluster = this->getCluster(neighbour);
+		if (this->findEndpointSearch(searches, count, cluster) != nullptr) continue;
+
+		searches[count].cluster = cluster;
+		this->searchCluster(grid, cluster, node, reverse, searches[count].costs, searches[count].parents);
+		count++;
+	}
+	return count;
+}
+
+/**
+* @brief Finds the search of a cluster.
+* @param searches - Searches of the start or destination node.
+* @param count - Number of searches.
+* @param cluster - Index of the cluster.
+* @return Pointer to the search. nullptr if the cluster was not searched.
+*/
+HierarchicalGrid::EndpointSearch* HierarchicalGrid::findEndpointSearch(EndpointSearch* searches, int count, int cluster) {
+	for (int i = 0; i < count; i++) {
+		if (searches[i].cluster == cluster) {
+			return &searches[i];
+		}
+	}
+	return nullptr;
+}
+
+/**
+* @brief Adds the entrances of the border between two neighbouring clusters. Runs of straight transitions get one or two entrances, diagonal steps over the border that are not next to a straight transition get their own.
+* @param grid - Navigation grid.
+* @param first - Index of the left or upper cluster.
+* @param second - Index of the right or lower cluster.
+* @param vertical - Whether the border is vertical (clusters next to each other) or horizontal.
+* @param addFirst - Whether entrances are added to the first cluster.
+* @param addSecond - Whether entrances are added to the second cluster.
+*/
+void HierarchicalGrid::addBorderEntrances(NavGrid& grid, int first, int second, bool vertical, bool addFirst, bool addSecond) {
+	int originX = (first % clustersX) * clusterSize;
+	int originY = (first / clustersX) * clusterSize;
+
+	// last row or column of the first cluster, walked along the border
+	NodeIndex base;
+	int length;
+	NodeIndex step;
+	NodeIndex across;
+	if (vertical) {
+		base = grid.getIndex(originX + clusterSize - 1, originY);
+		length = std::min(clusterSize, height - originY);
+		step = width;
+		across = 1;
+	}
+	else {
+		base = grid.getIndex(originX, originY + clusterSize - 1);
+		length = std::min(clusterSize, width - originX);
+		step = 1;
+		across = width;
+	}
+
+	int runStart = -1;
+	for (int i = 0; i <= length; i++) {
+		NodeIndex node = base + i * step;
+		if (i < length && grid.isWalkable(node) && grid.isWalkable(node + across)) {
+			if (runStart < 0) runStart = i;
+			continue;
+		}
+		if (runStart < 0) continue;
+
+		// short transitions get one entrance in the middle, long ones one at each end
+		int positions[2] = { runStart + (i - runStart) / 2, -1 };
+		if (i - runStart >= ENTRANCE_SPLIT_LENGTH) {
+			positions[0] = runStart;
+			positions[1] = i - 1;
+		}
+		for (int p = 0; p < 2; p++) {
+			if (positions[p] < 0) continue;
+
+			NodeIndex firstNode = base + positions[p] * step;
+			if (addFirst) this->addEntrance(first, firstNode, firstNode + across);
+			if (addSecond) this->addEntrance(second, firstNode + across, firstNode);
+		}
+		runStart = -1;
+	}
+
+	// a diagonal step next to a straight transition is covered by the entrance of the transition
+	for (int i = 0; i + 1 < length; i++) {
+		NodeIndex firstNode = base + i * step;
+		NodeIndex nextNode = firstNode + step;
+		bool walkable[4] = { grid.isWalkable(firstNode), grid.isWalkable(nextNode), grid.isWalkable(firstNode + across), grid.isWalkable(nextNode + across) };
+
+		NodeIndex from = INVALID_NODE;
+		NodeIndex to = INVALID_NODE;
+		if (walkable[0] && walkable[3] && !walkable[1] && !walkable[2]) {
+			from = firstNode;
+			to = nextNode + across;
+		}
+		else if (walkable[1] && walkable[2] && !walkable[0] && !walkable[3]) {
+			from = nextNode;
+			to = firstNode + across;
+		}
+		if (from == INVALID_NODE) continue;
+
+		if (addFirst) this->addEntrance(first, from, to);
+		if (addSecond) this->addEntrance(second, to, from);
+	}
+}
+
+/**
+* @brief Adds the entrances of the corner between two diagonal neighbouring clusters. The corner nodes are only connected if both nodes next to them are blocked, otherwise the step is covered by the entrances of the borders.
+* @param grid - Navigation grid.
+* @param upper - Index of the upper cluster.
+* @param lower - Index of the lower left or lower right cluster.
+* @param addUpper - Whether an entrance is added to the upper cluster.
+* @param addLower - Whether an entrance is added to the lower cluster.
+*/
+void HierarchicalGrid::addCornerEntrances(NavGrid& grid, int upper, int lower, bool addUpper, bool addLower) {
+	int dx = (lower % clustersX > upper % clustersX) ? 1 : -1;
+	int x = (upper % clustersX) * clusterSize + ((dx > 0) ? clusterSize - 1 : 0);
+	int y = (upper / clustersX) * clusterSize + clusterSize - 1;
+
+	NodeIndex upperNode = grid.getIndex(x, y);
+	NodeIndex lowerNode = grid.getIndex(x + dx, y + 1);
+	if (!grid.isWalkable(upperNode) || !grid.isWalkable(lowerNode)) return;
+	if (grid.isWalkable(grid.getIndex(x + dx, y)) || grid.isWalkable(grid.getIndex(x, y + 1))) return;
+
+	if (addUpper) this->addEntrance(upper, upperNode, lowerNode);
+	if (addLower) this->addEntrance(lower, lowerNode, upperNode);
+}
+
+/**
+* @brief Adds an entrance to a cluster or a link to an existing entrance.
+* @param cluster - Index of the cluster.
+* @param node - Grid node of the entrance.
+* @param link - Grid node of the neighbouring cluster connected to the entrance.
+*/
+void HierarchicalGrid::addEntrance(int cluster, NodeIndex node, NodeIndex link) {
+	std::vector<Entrance>& entrances = clusters[cluster].entrances;
+	for (size_t i = 0; i < entrances.size(); i++) {
+		if (entrances[i].node != node) continue;
+
+		for (int l = 0; l < MAX_ENTRANCE_LINKS; l++) {
+			if (entrances[i].links[l] == INVALID_NODE || entrances[i].links[l] == link) {
+				entrances[i].links[l] = link;
+				return;
+			}
+		}
+		return;
+	}
+
+	Entrance entrance;
+	entrance.node = node;
+	for (int l = 0; l < MAX_ENTRANCE_LINKS; l++) {
+		entrance.links[l] = INVALID_NODE;
+		entrance.linkIds[l] = -1;
+	}
+	entrance.links[0] = link;
+	entrances.push_back(entrance);
+}
+
+/**
+* @brief Finds the abstract node id of a grid node.
+* @param node - Grid node of an entrance.
+* @return Abstract node id. -1 if the node is no entrance.
+*/
+int32_t HierarchicalGrid::findAbstractNode(NodeIndex node) {
+	int cluster = this->getCluster(node);
+	const std::vector<Entrance>& entrances = clusters[cluster].entrances;
+	for (size_t i = 0; i < entrances.size(); i++) {
+		if (entrances[i].node == node) {
+			return clusterOffsets[cluster] + (int32_t)i;
+		}
+	}
+	return -1;
+}
+
+/**
+* @brief Updates an abstract node of the current search if it is reached cheaper and adds it to the open list.
+* @param grid - Navigation grid.
+* @param id - Abstract node id.
+* @param parent - Abstract node id of the parent.
+* @param cost - Cost from the start over the parent.
+* @param node - Grid node of the abstract node.
+* @param dest - Destination node of the search.
+*/
+void HierarchicalGrid::openAbstractNode(NavGrid& grid, int32_t id, int32_t parent, float cost, NodeIndex node, NodeIndex dest) {
+	if (!(cost < abstractCosts[id])) return;
+
+	abstractCosts[id] = cost;
+	abstractParents[id] = parent;
+	openNodes.push_back(std::make_pair(cost + getOctileDistance(grid, node, dest), id));
+	std::push_heap(openNodes.begin(), openNodes.end(), std::greater<std::pair<float, int32_t>>());
+}
+
+/**
+* @brief Accounts the current storage of the abstract graph in the memory tracker.
+*/
+void HierarchicalGrid::trackMemory() {
+	size_t bytes = clusters.capacity() * sizeof(Cluster)
+		+ clusterOffsets.capacity() * sizeof(int32_t)
+		+ abstractNodes.capacity() * sizeof(NodeIndex)
+		+ abstractCosts.capacity() * sizeof(float)
+		+ abstractParents.capacity() * sizeof(int32_t)
+		+ openNodes.capacity() * sizeof(std::pair<float, int32_t>)
+		+ clusterCosts.capacity() * sizeof(float)
+		+ clusterParents.capacity() * sizeof(int32_t);
+	for (int i = 0; i < MAX_ENDPOINT_CLUSTERS; i++) {
+		bytes += (startSearches[i].costs.capacity() + destSearches[i].costs.capacity()) * sizeof(float)
+			+ (startSearches[i].parents.capacity() + destSearches[i].parents.capacity()) * sizeof(int32_t);
+	}
+	for (size_t i = 0; i < clusters.size(); i++) {
+		bytes += clusters[i].entrances.capacity() * sizeof(Entrance) + clusters[i].costs.capacity() * sizeof(float);
+	}
+
+	if (bytes != trackedBytes) {
+		MemoryTracker::trackDeallocation(TAG_PATHFINDING, trackedBytes);
+		MemoryTracker::trackAllocation(TAG_PATHFINDING, bytes);
+		trackedBytes = bytes;
+	}
+}
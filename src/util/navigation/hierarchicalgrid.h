@@ -0,0 +1,345 @@
+#pragma once
+#include <utility>
+#include <vector>
+#include "navgrid.h"
+
+/**
+ * @brief Hierarchical pathfinding (HPA*) on top of the navigation grid. The grid is split into square clusters, the walkable transitions between neighbouring clusters form an abstract graph.
+ * Diagonal steps over a border or corner of a cluster get their own entrances if both straight steps next to them are blocked, so every path of the grid searches has a path in the abstract graph.
+ * The costs between the entrances of a cluster are precomputed, so a search only explores the clusters of the start and destination node and the abstract graph.
+ * Only the first segment of the found path is refined to grid nodes. Clusters are rebuilt lazily after their area was invalidated.
+*/
+class HierarchicalGrid {
+public:
+	/**
+	 * @brief Default width and height of a cluster in nodes.
+	*/
+	static const int DEFAULT_CLUSTER_SIZE = 16;
+
+	/**
+	 * @brief Destructor of the hierarchical grid. Removes the abstract graph from the memory tracker.
+	*/
+	~HierarchicalGrid();
+
+	/**
+	 * @brief Initializes the clusters for a grid. Every cluster is built at the next update.
+	 * @param width - Number of nodes per row of the grid.
+	 * @param height - Number of nodes per column of the grid.
+	 * @param clusterSize - Width and height of a cluster in nodes.
+	*/
+	void init(int width, int height, int clusterSize = DEFAULT_CLUSTER_SIZE);
+
+	/**
+	 * @brief Marks the clusters overlapping the area as changed. They are rebuilt at the next update.
+	 * @param x - X-position of the area on the grid.
+	 * @param y - Y-position of the area on the grid.
+	 * @param w - Width of the area in nodes.
+	 * @param h - Height of the area in nodes.
+	*/
+	void invalidateArea(int x, int y, int w, int h);
+
+	/**
+	 * @brief Marks every cluster as changed.
+	*/
+	void invalidate();
+
+	/**
+	 * @brief Checks if a cluster has to be rebuilt.
+	 * @return Whether a cluster has to be rebuilt.
+	*/
+	bool isDirty() { return dirtyClusters > 0; }
+
+	/**
+	 * @brief Rebuilds the changed clusters and their neighbours. The currently blocked nodes and obstacles of the grid are stored in the abstract graph.
+	 * @param grid - Navigation grid the clusters were initialized for.
+	*/
+	void update(NavGrid& grid);
+
+	/**
+	 * @brief Calculates the path from the start node to the destination node. Nodes in the same cluster and neighbouring nodes are searched with a* on the grid, otherwise the abstract graph is searched and only the first segment up to the next cluster is refined.
+	 * Blocked nodes and obstacles are avoided in the clusters of the start and destination node, the start node can always be left and the destination node can always be entered.
+	 * @param grid - Navigation grid the clusters were built for.
+	 * @param start - Start node.
+	 * @param dest - Destination node.
+	 * @param path - Buffer the path is written to, from the last refined node back to the start node. Cleared if no path was found.
+	 * @param complete - Set to whether the path ends at the destination node.
+	 * @return Whether a path was found.
+	*/
+	bool findPath(NavGrid& grid, NodeIndex start, NodeIndex dest, std::vector<NodeIndex>& path, bool& complete);
+
+	/**
+	 * @brief Gets the number of nodes of the abstract graph.
+	 * @return Number of entrances of every cluster.
+	*/
+	size_t getAbstractNodeCount() { return abstractNodes.size(); }
+private:
+	/**
+	 * @brief Walkable transitions of a border longer than this are split into two entrances at their ends.
+	*/
+	static const int ENTRANCE_SPLIT_LENGTH = 6;
+
+	/**
+	 * @brief Maximum number of links of an entrance. A node on the corner of a cluster has five neighbours outside of the cluster.
+	*/
+	static const int MAX_ENTRANCE_LINKS = 5;
+
+	/**
+	 * @brief Maximum number of clusters the start or destination node of a search is connected to. A node on the corner of a cluster touches four clusters.
+	*/
+	static const int MAX_ENDPOINT_CLUSTERS = 4;
+
+	/**
+	 * @brief Grid node of a cluster that is connected to a node of a neighbouring cluster.
+	*/
+	struct Entrance {
+		/**
+		 * @brief Grid node of the entrance.
+		*/
+		NodeIndex node;
+
+		/**
+		 * @brief Grid nodes of the neighbouring clusters connected to the entrance. Nodes on a corner of the cluster can lie on two borders and link diagonally to a third cluster. INVALID_NODE if there is no link.
+		*/
+		NodeIndex links[MAX_ENTRANCE_LINKS];
+
+		/**
+		 * @brief Abstract node ids of the linked nodes. -1 if there is no link.
+		*/
+		int32_t linkIds[MAX_ENTRANCE_LINKS];
+	};
+
+	/**
+	 * @brief Square part of the grid with its entrances.
+	*/
+	struct Cluster {
+		/**
+		 * @brief Entrances of the cluster.
+		*/
+		std::vector<Entrance> entrances;
+
+		/**
+		 * @brief Cost of the cheapest path inside the cluster between each pair of entrances (entrances x entrances). INFINITY if there is no path.
+		*/
+		std::vector<float> costs;
+
+		/**
+		 * @brief Whether the cluster has to be rebuilt.
+		*/
+		bool dirty = true;
+	};
+
+	/**
+	 * @brief Search from the start node or to the destination node inside of one cluster.
+	*/
+	struct EndpointSearch {
+		/**
+		 * @brief Index of the searched cluster.
+		*/
+		int cluster;
+
+		/**
+		 * @brief Cost per node of the cluster.
+		*/
+		std::vector<float> costs;
+
+		/**
+		 * @brief Parent per node of the cluster. The nodes next to the start or destination node have no parent.
+		*/
+		std::vector<int32_t> parents;
+	};
+
+	/**
+	 * @brief Number of nodes per row of the grid.
+	*/
+	int width = 0;
+
+	/**
+	 * @brief Number of nodes per column of the grid.
+	*/
+	int height = 0;
+
+	/**
+	 * @brief Width and height of a cluster in nodes.
+	*/
+	int clusterSize = DEFAULT_CLUSTER_SIZE;
+
+	/**
+	 * @brief Number of clusters per row.
+	*/
+	int clustersX = 0;
+
+	/**
+	 * @brief Number of clusters per column.
+	*/
+	int clustersY = 0;
+
+	/**
+	 * @brief Number of clusters that have to be rebuilt.
+	*/
+	size_t dirtyClusters = 0;
+
+	/**
+	 * @brief Clusters of the grid, row by row.
+	*/
+	std::vector<Cluster> clusters;
+
+	/**
+	 * @brief Abstract node id of the first entrance of each cluster.
+	*/
+	std::vector<int32_t> clusterOffsets;
+
+	/**
+	 * @brief Grid node of each abstract node.
+	*/
+	std::vector<NodeIndex> abstractNodes;
+
+	/**
+	 * @brief Cost from the start per abstract node of the current search. The start and destination are the last two abstract nodes.
+	*/
+	std::vector<float> abstractCosts;
+
+	/**
+	 * @brief Parent per abstract node of the current search.
+	*/
+	std::vector<int32_t> abstractParents;
+
+	/**
+	 * @brief Open list of the abstract search and the cluster searches as binary min heap of cost and id. Outdated entries are skipped when they are removed.
+	*/
+	std::vector<std::pair<float, int32_t>> openNodes;
+
+	/**
+	 * @brief Searches from the start node of the current search. The first search belongs to the cluster of the start node.
+	*/
+	EndpointSearch startSearches[MAX_ENDPOINT_CLUSTERS];
+
+	/**
+	 * @brief Number of searches from the start node of the current search.
+	*/
+	int startSearchCount = 0;
+
+	/**
+	 * @brief Searches to the destination node of the current search. The first search belongs to the cluster of the destination node.
+	*/
+	EndpointSearch destSearches[MAX_ENDPOINT_CLUSTERS];
+
+	/**
+	 * @brief Number of searches to the destination node of the current search.
+	*/
+	int destSearchCount = 0;
+
+	/**
+	 * @brief Cost per node of a cluster from an entrance while building the clusters.
+	*/
+	std::vector<float> clusterCosts;
+
+	/**
+	 * @brief Parents of the cluster search while building the clusters.
+	*/
+	std::vector<int32_t> clusterParents;
+
+	/**
+	 * @brief Bytes of the abstract graph accounted to the memory tracker.
+	*/
+	size_t trackedBytes = 0;
+
+	/**
+	 * @brief Gets the cluster of a grid node.
+	 * @param node - Valid node index.
+	 * @return Index of the cluster.
+	*/
+	int getCluster(NodeIndex node) {
+		return ((node / width) / clusterSize) * clustersX + (node % width) / clusterSize;
+	}
+
+	/**
+	 * @brief Gets the index of a grid node inside of its cluster.
+	 * @param node - Valid node index.
+	 * @return Local index of the node.
+	*/
+	int32_t getLocalIndex(NodeIndex node) {
+		return ((node / width) % clusterSize) * clusterSize + (node % width) % clusterSize;
+	}
+
+	/**
+	 * @brief Searches the cheapest paths inside of a cluster from or to a node (dijkstra).
+	 * @param grid - Navigation grid.
+	 * @param cluster - Index of the cluster containing the node or a neighbour of the node.
+	 * @param source - Node the search starts at. If it lies outside of the cluster, the search starts at its walkable neighbours inside of the cluster.
+	 * @param reverse - Whether the costs to the node are searched instead of the costs from the node.
+	 * @param costs - Cost per local node index.
+	 * @param parents - Parent per local node index. The parent of the source is -1.
+	*/
+	void searchCluster(NavGrid& grid, int cluster, NodeIndex source, bool reverse, std::vector<float>& costs, std::vector<int32_t>& parents);
+
+	/**
+	 * @brief Searches the cluster of the start or destination node of a search. A blocked node can only be left or entered through its walkable neighbours, so the clusters of its neighbours are searched as well.
+	 * @param grid - Navigation grid.
+	 * @param node - Start or destination node.
+	 * @param reverse - Whether the costs to the node are searched instead of the costs from the node.
+	 * @param searches - Buffer of MAX_ENDPOINT_CLUSTERS searches.
+	 * @return Number of searched clusters.
+	*/
+	int searchEndpoint(NavGrid& grid, NodeIndex node, bool reverse, EndpointSearch* searches);
+
+	/**
+	 * @brief Finds the search of a cluster.
+	 * @param searches - Searches of the start or destination node.
+	 * @param count - Number of searches.
+	 * @param cluster - Index of the cluster.
+	 * @return Pointer to the search. nullptr if the cluster was not searched.
+	*/
+	EndpointSearch* findEndpointSearch(EndpointSearch* searches, int count, int cluster);
+
+	/**
+	 * @brief Adds the entrances of the border between two neighbouring clusters. Runs of straight transitions get one or two entrances, diagonal steps over the border that are not next to a straight transition get their own.
+	 * @param grid - Navigation grid.
+	 * @param first - Index of the left or upper cluster.
+	 * @param second - Index of the right or lower cluster.
+	 * @param vertical - Whether the border is vertical (clusters next to each other) or horizontal.
+	 * @param addFirst - Whether entrances are added to the first cluster.
+	 * @param addSecond - Whether entrances are added to the second cluster.
+	*/
+	void addBorderEntrances(NavGrid& grid, int first, int second, bool vertical, bool addFirst, bool addSecond);
+
+	/**
+	 * @brief Adds the entrances of the corner between two diagonal neighbouring clusters. The corner nodes are only connected if both nodes next to them are blocked, otherwise the step is covered by the entrances of the borders.
+	 * @param grid - Navigation grid.
+	 * @param upper - Index of the upper cluster.
+	 * @param lower - Index of the lower left or lower right cluster.
+	 * @param addUpper - Whether an entrance is added to the upper cluster.
+	 * @param addLower - Whether an entrance is added to the lower cluster.
+	*/
+	void addCornerEntrances(NavGrid& grid, int upper, int lower, bool addUpper, bool addLower);
+
+	/**
+	 * @brief Adds an entrance to a cluster or a link to an existing entrance.
+	 * @param cluster - Index of the cluster.
+	 * @param node - Grid node of the entrance.
+	 * @param link - Grid node of the neighbouring cluster connected to the entrance.
+	*/
+	void addEntrance(int cluster, NodeIndex node, NodeIndex link);
+
+	/**
+	 * @brief Finds the abstract node id of a grid node.
+	 * @param node - Grid node of an entrance.
+	 * @return Abstract node id. -1 if the node is no entrance.
+	*/
+	int32_t findAbstractNode(NodeIndex node);
+
+	/**
+	 * @brief Updates an abstract node of the current search if it is reached cheaper and adds it to the open list.
+	 * @param grid - Navigation grid.
+	 * @param id - Abstract node id.
+	 * @param parent - Abstract node id of the parent.
+	 * @param cost - Cost from the start over the parent.
+	 * @param node - Grid node of the abstract node.
+	 * @param dest - Destination node of the search.
+	*/
+	void openAbstractNode(NavGrid& grid, int32_t id, int32_t parent, float cost, NodeIndex node, NodeIndex dest);
+
+	/**
+	 * @brief Accounts the current storage of the abstract graph in the memory tracker.
+	*/
+	void trackMemory();
+};
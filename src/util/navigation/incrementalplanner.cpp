@@ -0,0 +1,432 @@
+#include "incrementalplanner.h"
+#include <algorithm>
+
+const float IncrementalPlanner::KEY_TOLERANCE = 0.001f;
+
+/**
+* @brief Gets the distance between two nodes when moving with a cost of 1 in 8 directions. Never overestimates the cost of a path.
+* @param grid - Navigation grid.
+* @param a - First node.
+* @param b - Second node.
+* @return Octile distance of the nodes.
+*/
+static inline float getOctileDistance(NavGrid& grid, NodeIndex a, NodeIndex b) {
+	int dx = std::abs(grid.getX(a) - grid.getX(b));
+	int dy = std::abs(grid.getY(a) - grid.getY(b));
+	return (dx > dy) ? (dx + 0.41421356f * dy) : (dy + 0.41421356f * dx);
+}
+
+/**
+* @brief Gets the cost of entering a node as seen by the planner.
+* @param grid - Navigation grid.
+* @param node - Valid node index.
+* @return Cost of entering the node. 0 if the node is blocked or an obstacle.
+*/
+static inline uint8_t getCurrentCost(NavGrid& grid, NodeIndex node) {
+	return grid.isWalkable(node) ? grid.getCost(node) : 0;
+}
+
+/**
+* @brief Destructor of the planner. Removes the search state from the memory tracker.
+*/
+IncrementalPlanner::~IncrementalPlanner() {
+	MemoryTracker::trackDeallocation(TAG_PATHFINDING, trackedBytes);
+}
+
+/**
+* @brief Calculates the path from the start node to the destination node. The previous search is repaired if the planner was used on the same grid before, otherwise a new search is started.
+* Blocked nodes and obstacles are avoided, the destination node can always be entered.
+* @param grid - Navigation grid.
+* @param start - Start node, usually the node of the agent.
+* @param dest - Destination node.
+* @param path - Buffer the path is written to, from the destination node back to the start node. Cleared if no path was found.
+* @return Whether a path was found.
+*/
+bool IncrementalPlanner::findPath(NavGrid& grid, NodeIndex start, NodeIndex dest, std::vector<NodeIndex>& path) {
+	path.clear();
+	if (!grid.isValid(start) || !grid.isValid(dest)) {
+		return false;
+	}
+	updatedNodes = 0;
+
+	// the version restarts when the grid is initialized again
+	bool restart = gcosts.empty() || width != grid.getWidth() || height != grid.getHeight() || grid.getVersion() < knownVersion;
+
+	// moving the root of the search changes the cost of nearly every node, a new search is cheaper than the repair.
+	// The detour over the old root has to stay small compared to the remaining way and the old root has to stay walkable.
+	if (!restart && destination != dest) {
+		float drift = getOctileDistance(grid, destination, dest);
+		restart = drift > REROOT_DISTANCE || drift * REROOT_DISTANCE > getOctileDistance(grid, start, dest) || !grid.isWalkable(destination);
+	}
+	if (restart) {
+		this->init(grid, start, dest);
+	}
+	else {
+		// keys of queued nodes stay valid when the start moves, the difference is added to new keys instead
+		if (start != this->start) {
+			keyModifier += getOctileDistance(grid, this->start, start);
+			this->start = start;
+		}
+
+		// only regions that changed since the last plan are compared
+		if (grid.getVersion() != knownVersion) {
+			int regionsX = (width + NavGrid::REGION_SIZE - 1) / NavGrid::REGION_SIZE;
+			int regionsY = (height + NavGrid::REGION_SIZE - 1) / NavGrid::REGION_SIZE;
+			for (int y = 0; y < regionsY; y++) {
+				for (int x = 0; x < regionsX; x++) {
+					if (grid.getRegionVersion(y * regionsX + x) > knownVersion) {
+						this->senseArea(grid, x * NavGrid::REGION_SIZE, y * NavGrid::REGION_SIZE, (x + 1) * NavGrid::REGION_SIZE - 1, (y + 1) * NavGrid::REGION_SIZE - 1);
+					}
+				}
+			}
+			knownVersion = grid.getVersion();
+		}
+
+		// dynamic occupants do not change the version and are only sensed near the agent
+		int x = grid.getX(start);
+		int y = grid.getY(start);
+		this->senseArea(grid, x - SENSOR_RANGE, y - SENSOR_RANGE, x + SENSOR_RANGE, y + SENSOR_RANGE);
+	}
+
+	this->computeShortestPath(grid);
+	bool found = this->followPath(grid, path);
+
+	// a change of the grid can cut the old root off from the agent or the destination
+	if (destination != dest && (!found || !grid.findPath(destination, dest, connection))) {
+		this->init(grid, start, dest);
+		this->computeShortestPath(grid);
+		found = this->followPath(grid, path);
+	}
+	this->trackMemory();
+	if (!found) {
+		return false;
+	}
+
+	// the search stays rooted at the old destination, the rest of the way is searched locally
+	if (destination != dest) {
+		// the path is cut at the first node that is also part of the connection, so it does not walk back and forth
+		for (size_t i = 0; i < path.size(); i++) {
+			std::vector<NodeIndex>::iterator node = std::find(connection.begin(), connection.end(), path[i]);
+			if (node != connection.end()) {
+				path.resize(i);
+				std::reverse(path.begin(), path.end());
+				path.insert(path.begin(), connection.begin(), node + 1);
+				return true;
+			}
+		}
+	}
+	std::reverse(path.begin(), path.end());
+	return true;
+}
+
+/**
+* @brief Follows the cheapest neighbours from the start node to the root of the search.
+* @param grid - Navigation grid.
+* @param path - Buffer the path is written to, from the start node to the root. Cleared if there is no path.
+* @return Whether the root was reached.
+*/
+bool IncrementalPlanner::followPath(NavGrid& grid, std::vector<NodeIndex>& path) {
+	path.clear();
+	if (gcosts[start] == INFINITY) {
+		return false;
+	}
+
+	NodeIndex current = start;
+	path.push_back(current);
+	while (current != destination && path.size() <= grid.getNodeCount()) {
+		NodeIndex next = INVALID_NODE;
+		float nextCost = INFINITY;
+		for (int i = 0; i < NavGrid::NEIGHBOUR_COUNT; i++) {
+			NodeIndex neighbour = grid.getNeighbour(current, i);
+			if (neighbour == INVALID_NODE) continue;
+
+			float cost = this->getStepCost(neighbour, i) + gcosts[neighbour];
+			if (cost < nextCost) {
+				next = neighbour;
+				nextCost = cost;
+			}
+		}
+		if (next == INVALID_NODE) break;
+		current = next;
+		path.push_back(current);
+	}
+
+	if (current != destination) {
+		path.clear();
+		return false;
+	}
+	return true;
+}
+
+/**
+* @brief Removes the search state. The next plan starts a new search.
+*/
+void IncrementalPlanner::reset() {
+	std::vector<uint8_t>().swap(knownCosts);
+	std::vector<float>().swap(gcosts);
+	std::vector<float>().swap(lookaheads);
+	std::vector<int32_t>().swap(heapIndices);
+	std::vector<OpenNode>().swap(openNodes);
+	std::vector<NodeIndex>().swap(connection);
+	start = INVALID_NODE;
+	destination = INVALID_NODE;
+	this->trackMemory();
+}
+
+/**
+* @brief Starts a new search on the grid.
+* @param grid - Navigation grid.
+* @param start - Start node.
+* @param dest - Destination node.
+*/
+void IncrementalPlanner::init(NavGrid& grid, NodeIndex start, NodeIndex dest) {
+	width = grid.getWidth();
+	height = grid.getHeight();
+	size_t nodeCount = grid.getNodeCount();
+
+	knownCosts.resize(nodeCount);
+	for (size_t i = 0; i < nodeCount; i++) {
+		knownCosts[i] = getCurrentCost(grid, (NodeIndex)i);
+	}
+	gcosts.assign(nodeCount, INFINITY);
+	lookaheads.assign(nodeCount, INFINITY);
+	heapIndices.assign(nodeCount, -1);
+	openNodes.clear();
+
+	this->start = start;
+	destination = dest;
+	keyModifier = 0.0f;
+	knownVersion = grid.getVersion();
+
+	lookaheads[dest] = 0.0f;
+	this->updateNode(grid, dest);
+}
+
+/**
+* @brief Compares the costs of the nodes of an area with the known costs and repairs the nodes next to the changed ones.
+* @param grid - Navigation grid.
+* @param minX - First column of the area.
+* @param minY - First row of the area.
+* @param maxX - Last column of the area.
+* @param maxY - Last row of the area.
+*/
+void IncrementalPlanner::senseArea(NavGrid& grid, int minX, int minY, int maxX, int maxY) {
+	minX = std::max(minX, 0);
+	minY = std::max(minY, 0);
+	maxX = std::min(maxX, width - 1);
+	maxY = std::min(maxY, height - 1);
+
+	for (int y = minY; y <= maxY; y++) {
+		for (int x = minX; x <= maxX; x++) {
+			NodeIndex node = grid.getIndex(x, y);
+			uint8_t cost = getCurrentCost(grid, node);
+			if (cost == knownCosts[node]) continue;
+			knownCosts[node] = cost;
+
+			// the steps onto the node changed, so only the costs of its neighbours are affected
+			for (int i = 0; i < NavGrid::NEIGHBOUR_COUNT; i++) {
+				NodeIndex neighbour = grid.getNeighbour(node, i);
+				if (neighbour != INVALID_NODE) {
+					this->updateLookahead(grid, neighbour);
+					this->updateNode(grid, neighbour);
+				}
+			}
+		}
+	}
+}
+
+/**
+* @brief Expands the inconsistent nodes until the path of the start node is known.
+* @param grid - Navigation grid.
+*/
+void IncrementalPlanner::computeShortestPath(NavGrid& grid) {
+	// nodes with the same key as the start can lie on its path, the keys are only compared up to rounding errors
+	while (!openNodes.empty() && (openNodes[0].key.first <= this->calculateKey(grid, start).first + KEY_TOLERANCE || lookaheads[start] != gcosts[start])) {
+		NodeIndex node = openNodes[0].node;
+		Key oldKey = openNodes[0].key;
+		Key newKey = this->calculateKey(grid, node);
+		updatedNodes++;
+
+		if (oldKey < newKey) {
+			// the key is outdated since the start moved
+			openNodes[0].key = newKey;
+			this->siftDown(0);
+		}
+		else if (gcosts[node] > lookaheads[node]) {
+			// the node got cheaper, its neighbours may get cheaper over it
+			gcosts[node] = lookaheads[node];
+			this->remove(node);
+
+			for (int i = 0; i < NavGrid::NEIGHBOUR_COUNT; i++) {
+				NodeIndex neighbour = grid.getNeighbour(node, i);
+				if (neighbour == INVALID_NODE || neighbour == destination) continue;
+
+				float cost = this->getStepCost(node, i) + gcosts[node];
+				if (cost < lookaheads[neighbour]) {
+					lookaheads[neighbour] = cost;
+					this->updateNode(grid, neighbour);
+				}
+			}
+		}
+		else {
+			// the node got more expensive, every neighbour using it has to look for another way
+			gcosts[node] = INFINITY;
+			this->updateLookahead(grid, node);
+			this->updateNode(grid, node);
+
+			for (int i = 0; i < NavGrid::NEIGHBOUR_COUNT; i++) {
+				NodeIndex neighbour = grid.getNeighbour(node, i);
+				if (neighbour != INVALID_NODE) {
+					this->updateLookahead(grid, neighbour);
+					this->updateNode(grid, neighbour);
+				}
+			}
+		}
+	}
+}
+
+/**
+* @brief Gets the cost of moving from a node to its neighbour with the known costs. The destination can always be entered.
+* @param neighbour - Node that is entered.
+* @param direction - Direction of the neighbour.
+* @return Cost of the step. INFINITY if the neighbour is blocked.
+*/
+float IncrementalPlanner::getStepCost(NodeIndex neighbour, int direction) {
+	uint8_t cost = knownCosts[neighbour];
+	if (cost == 0) {
+		if (neighbour != destination) return INFINITY;
+		cost = 1;
+	}
+	return NavGrid::getNeighbourDistance(direction) * cost;
+}
+
+/**
+* @brief Calculates the lookahead cost of a node from the costs of its neighbours.
+* @param grid - Navigation grid.
+* @param node - Valid node index.
+*/
+void IncrementalPlanner::updateLookahead(NavGrid& grid, NodeIndex node) {
+	if (node == destination) {
+		lookaheads[node] = 0.0f;
+		return;
+	}
+
+	float lookahead = INFINITY;
+	for (int i = 0; i < NavGrid::NEIGHBOUR_COUNT; i++) {
+		NodeIndex neighbour = grid.getNeighbour(node, i);
+		if (neighbour != INVALID_NODE) {
+			lookahead = std::min(lookahead, this->getStepCost(neighbour, i) + gcosts[neighbour]);
+		}
+	}
+	lookaheads[node] = lookahead;
+}
+
+/**
+* @brief Queues, updates or removes a node in the open list depending on whether it is inconsistent.
+* @param grid - Navigation grid.
+* @param node - Valid node index.
+*/
+void IncrementalPlanner::updateNode(NavGrid& grid, NodeIndex node) {
+	int32_t index = heapIndices[node];
+	if (gcosts[node] != lookaheads[node]) {
+		Key key = this->calculateKey(grid, node);
+		if (index < 0) {
+			openNodes.push_back({ key, node });
+			index = (int32_t)openNodes.size() - 1;
+			heapIndices[node] = index;
+		}
+		else {
+			openNodes[index].key = key;
+			this->siftDown(index);
+		}
+		this->siftUp(heapIndices[node]);
+	}
+	else if (index >= 0) {
+		this->remove(node);
+	}
+}
+
+/**
+* @brief Calculates the key of a node.
+* @param grid - Navigation grid.
+* @param node - Valid node index.
+* @return Key of the node.
+*/
+IncrementalPlanner::Key IncrementalPlanner::calculateKey(NavGrid& grid, NodeIndex node) {
+	float cost = std::min(gcosts[node], lookaheads[node]);
+	return { cost + getOctileDistance(grid, start, node) + keyModifier, cost };
+}
+
+/**
+* @brief Removes a node from the open list.
+* @param node - Queued node.
+*/
+void IncrementalPlanner::remove(NodeIndex node) {
+	size_t index = (size_t)heapIndices[node];
+	heapIndices[node] = -1;
+
+	OpenNode last = openNodes.back();
+	openNodes.pop_back();
+	if (index < openNodes.size()) {
+		openNodes[index] = last;
+		heapIndices[last.node] = (int32_t)index;
+		this->siftUp(index);
+		this->siftDown(heapIndices[last.node]);
+	}
+}
+
+/**
+* @brief Moves an entry of the open list up until the heap is valid.
+* @param index - Index in the open list.
+*/
+void IncrementalPlanner::siftUp(size_t index) {
+	OpenNode entry = openNodes[index];
+	while (index > 0) {
+		size_t parent = (index - 1) / 2;
+		if (!(entry.key < openNodes[parent].key)) break;
+
+		openNodes[index] = openNodes[parent];
+		heapIndices[openNodes[index].node] = (int32_t)index;
+		index = parent;
+	}
+	openNodes[index] = entry;
+	heapIndices[entry.node] = (int32_t)index;
+}
+
+/**
+* @brief Moves an entry of the open list down until the heap is valid.
+* @param index - Index in the open list.
+*/
+void IncrementalPlanner::siftDown(size_t index) {
+	OpenNode entry = openNodes[index];
+	size_t count = openNodes.size();
+	while (true) {
+		size_t child = index * 2 + 1;
+		if (child >= count) break;
+		if (child + 1 < count && openNodes[child + 1].key < openNodes[child].key) child++;
+		if (!(openNodes[child].key < entry.key)) break;
+
+		openNodes[index] = openNodes[child];
+		heapIndices[openNodes[index].node] = (int32_t)index;
+		index = child;
+	}
+	openNodes[index] = entry;
+	heapIndices[entry.node] = (int32_t)index;
+}
+
+/**
+* @brief Accounts the current storage of the search state in the memory tracker.
+*/
+void IncrementalPlanner::trackMemory() {
+	size_t bytes = knownCosts.capacity() * sizeof(uint8_t)
+		+ (gcosts.capacity() + lookaheads.capacity()) * sizeof(float)
+		+ heapIndices.capacity() * sizeof(int32_t)
+		+ openNodes.capacity() * sizeof(OpenNode)
+		+ connection.capacity() * sizeof(NodeIndex);
+
+	if (bytes != trackedBytes) {
+		MemoryTracker::trackDeallocation(TAG_PATHFINDING, trackedBytes);
+		MemoryTracker::trackAllocation(TAG_PATHFINDING, bytes);
+		trackedBytes = bytes;
+	}
+}
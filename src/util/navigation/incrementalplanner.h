@@ -0,0 +1,228 @@
+#pragma once
+#include <vector>
+#include "navgrid.h"
+
+/**
+ * @brief Incremental path planner of a single agent (D* Lite). The search runs from the destination to the agent and is kept between plans.
+ * When the agent moves or nodes change, only the affected nodes are repaired instead of searching again. Changes of the blocked nodes and costs are detected with the region versions of the grid, dynamic occupants are only sensed around the agent.
+ * Moving the destination changes the cost of every node, so the search keeps its old destination as root and the rest of the way is searched locally until the destination moved too far.
+*/
+class IncrementalPlanner {
+public:
+	/**
+	 * @brief Distance in nodes around the agent in which the dynamic occupants of the grid are sensed at every plan.
+	*/
+	static const int SENSOR_RANGE = 3;
+
+	/**
+	 * @brief Distance in nodes the destination can move away from the root of the search before a new search is started. Closer to the agent the destination can move at most the distance to the agent divided by this value.
+	*/
+	static const int REROOT_DISTANCE = 4;
+
+	/**
+	 * @brief Destructor of the planner. Removes the search state from the memory tracker.
+	*/
+	~IncrementalPlanner();
+
+	/**
+	 * @brief Calculates the path from the start node to the destination node. The previous search is repaired if the planner was used on the same grid before, otherwise a new search is started.
+	 * Blocked nodes and obstacles are avoided, the destination node can always be entered.
+	 * @param grid - Navigation grid.
+	 * @param start - Start node, usually the node of the agent.
+	 * @param dest - Destination node.
+	 * @param path - Buffer the path is written to, from the destination node back to the start node. Cleared if no path was found.
+	 * @return Whether a path was found.
+	*/
+	bool findPath(NavGrid& grid, NodeIndex start, NodeIndex dest, std::vector<NodeIndex>& path);
+
+	/**
+	 * @brief Removes the search state. The next plan starts a new search.
+	*/
+	void reset();
+
+	/**
+	 * @brief Gets the number of nodes updated by the last plan.
+	 * @return Number of updated nodes.
+	*/
+	size_t getUpdatedCount() { return updatedNodes; }
+private:
+	/**
+	 * @brief Difference up to which the keys of two nodes are treated as equal.
+	*/
+	static const float KEY_TOLERANCE;
+
+	/**
+	 * @brief Priority of a node in the open list, compared by the first and then by the second value.
+	*/
+	struct Key {
+		float first;
+		float second;
+
+		bool operator< (const Key& other) const {
+			return first < other.first || (first == other.first && second < other.second);
+		}
+	};
+
+	/**
+	 * @brief Entry of the open list.
+	*/
+	struct OpenNode {
+		Key key;
+		NodeIndex node;
+	};
+
+	/**
+	 * @brief Number of nodes per row of the grid of the search.
+	*/
+	int width = 0;
+
+	/**
+	 * @brief Number of nodes per column of the grid of the search.
+	*/
+	int height = 0;
+
+	/**
+	 * @brief Start node of the last plan.
+	*/
+	NodeIndex start = INVALID_NODE;
+
+	/**
+	 * @brief Destination node the search is rooted at.
+	*/
+	NodeIndex destination = INVALID_NODE;
+
+	/**
+	 * @brief Sum of the heuristic distances the start moved, added to the keys instead of updating the open list.
+	*/
+	float keyModifier = 0.0f;
+
+	/**
+	 * @brief Version of the grid the known costs were read at.
+	*/
+	uint32_t knownVersion = 0;
+
+	/**
+	 * @brief Cost of entering each node as known to the search. 0 if the node is blocked or an obstacle.
+	*/
+	std::vector<uint8_t> knownCosts;
+
+	/**
+	 * @brief Cost of the path to the destination per node.
+	*/
+	std::vector<float> gcosts;
+
+	/**
+	 * @brief Cost of the path to the destination per node looking one step ahead (rhs). Nodes with a different cost than gcosts are inconsistent and queued.
+	*/
+	std::vector<float> lookaheads;
+
+	/**
+	 * @brief Position of each node in the open list. -1 if the node is not queued.
+	*/
+	std::vector<int32_t> heapIndices;
+
+	/**
+	 * @brief Inconsistent nodes as binary min heap.
+	*/
+	std::vector<OpenNode> openNodes;
+
+	/**
+	 * @brief Path from the root of the search to the current destination.
+	*/
+	std::vector<NodeIndex> connection;
+
+	/**
+	 * @brief Number of nodes updated by the last plan.
+	*/
+	size_t updatedNodes = 0;
+
+	/**
+	 * @brief Bytes of the search state accounted to the memory tracker.
+	*/
+	size_t trackedBytes = 0;
+
+	/**
+	 * @brief Starts a new search on the grid.
+	 * @param grid - Navigation grid.
+	 * @param start - Start node.
+	 * @param dest - Destination node.
+	*/
+	void init(NavGrid& grid, NodeIndex start, NodeIndex dest);
+
+	/**
+	 * @brief Compares the costs of the nodes of an area with the known costs and repairs the nodes next to the changed ones.
+	 * @param grid - Navigation grid.
+	 * @param minX - First column of the area.
+	 * @param minY - First row of the area.
+	 * @param maxX - Last column of the area.
+	 * @param maxY - Last row of the area.
+	*/
+	void senseArea(NavGrid& grid, int minX, int minY, int maxX, int maxY);
+
+	/**
+	 * @brief Follows the cheapest neighbours from the start node to the root of the search.
+	 * @param grid - Navigation grid.
+	 * @param path - Buffer the path is written to, from the start node to the root. Cleared if there is no path.
+	 * @return Whether the root was reached.
+	*/
+	bool followPath(NavGrid& grid, std::vector<NodeIndex>& path);
+
+	/**
+	 * @brief Expands the inconsistent nodes until the path of the start node is known.
+	 * @param grid - Navigation grid.
+	*/
+	void computeShortestPath(NavGrid& grid);
+
+	/**
+	 * @brief Gets the cost of moving from a node to its neighbour with the known costs. The destination can always be entered.
+	 * @param neighbour - Node that is entered.
+	 * @param direction - Direction of the neighbour.
+	 * @return Cost of the step. INFINITY if the neighbour is blocked.
+	*/
+	float getStepCost(NodeIndex neighbour, int direction);
+
+	/**
+	 * @brief Calculates the lookahead cost of a node from the costs of its neighbours.
+	 * @param grid - Navigation grid.
+	 * @param node - Valid node index.
+	*/
+	void updateLookahead(NavGrid& grid, NodeIndex node);
+
+	/**
+	 * @brief Queues, updates or removes a node in the open list depending on whether it is inconsistent.
+	 * @param grid - Navigation grid.
+	 * @param node - Valid node index.
+	*/
+	void updateNode(NavGrid& grid, NodeIndex node);
+
+	/**
+	 * @brief Calculates the key of a node.
+	 * @param grid - Navigation grid.
+	 * @param node - Valid node index.
+	 * @return Key of the node.
+	*/
+	Key calculateKey(NavGrid& grid, NodeIndex node);
+
+	/**
+	 * @brief Removes a node from the open list.
+	 * @param node - Queued node.
+	*/
+	void remove(NodeIndex node);
+
+	/**
+	 * @brief Moves an entry of the open list up until the heap is valid.
+	 * @param index - Index in the open list.
+	*/
+	void siftUp(size_t index);
+
+	/**
+	 * @brief Moves an entry of the open list down until the heap is valid.
+	 * @param index - Index in the open list.
+	*/
+	void siftDown(size_t index);
+
+	/**
+	 * @brief Accounts the current storage of the search state in the memory tracker.
+	*/
+	void trackMemory();
+};
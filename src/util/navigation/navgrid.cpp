@@ -0,0 +1,994 @@
+#include "navgrid.h"
+#include <algorithm>
+#include <cstdlib>
+
+/**
+* @brief X-offsets of the 8 neighbours of a node.
+*/
+const int NavGrid::NEIGHBOUR_X[NEIGHBOUR_COUNT] = { -1, 1, 0, 0, -1, 1, -1, 1 };
+
+/**
+* @brief Y-offsets of the 8 neighbours of a node.
+*/
+const int NavGrid::NEIGHBOUR_Y[NEIGHBOUR_COUNT] = { 0, 0, -1, 1, -1, -1, 1, 1 };
+
+/**
+* @brief Distance to each neighbour. The first four neighbours are straight, the others diagonal.
+*/
+const float NavGrid::NEIGHBOUR_DISTANCE[NEIGHBOUR_COUNT] = { 1.0f, 1.0f, 1.0f, 1.0f, 1.41421356f, 1.41421356f, 1.41421356f, 1.41421356f };
+
+/**
+* @brief Component label of nodes that are not walkable. Defined here, because it is passed by reference to fill the labels.
+*/
+const int32_t NavGrid::NO_COMPONENT;
+
+/**
+* @brief Calculates the length of the shortest path with straight and diagonal steps on an empty grid. Used as heuristic of the a* search, it never overestimates the remaining cost.
+* @param dx - Distance on the x-axis in tiles.
+* @param dy - Distance on the y-axis in tiles.
+* @return Octile distance.
+*/
+static inline float getOctileDistance(int dx, int dy) {
+	dx = std::abs(dx);
+	dy = std::abs(dy);
+	return (dx > dy) ? (dx + 0.41421356f * dy) : (dy + 0.41421356f * dx);
+}
+
+/**
+* @brief Gets the neighbour direction of a movement.
+* @param dx - X-direction from -1 to 1.
+* @param dy - Y-direction from -1 to 1.
+* @return Index of the neighbour direction. -1 if there is no movement.
+*/
+static inline int getDirection(int dx, int dy) {
+	static const int DIRECTIONS[3][3] = { { 4, 2, 5 }, { 0, -1, 1 }, { 6, 3, 7 } };
+	return DIRECTIONS[dy + 1][dx + 1];
+}
+
+/**
+* @brief Gets the sign of the value.
+* @param value - Value to get the sign of.
+* @return -1, 0 or 1.
+*/
+static inline int getSign(int value) {
+	return (value > 0) - (value < 0);
+}
+
+/**
+* @brief Destructor of the navigation grid. Removes the grid from the memory tracker.
+*/
+NavGrid::~NavGrid() {
+	this->clearJumpTable();
+	MemoryTracker::trackDeallocation(TAG_PATHFINDING, trackedBytes);
+}
+
+/**
+* @brief Initializes the grid. Every node is walkable with a cost of 1. The storage of a previous grid is reused or released.
+* @param width - Number of nodes per row.
+* @param height - Number of nodes per column.
+*/
+void NavGrid::init(int width, int height) {
+	MemoryTracker::trackDeallocation(TAG_PATHFINDING, trackedBytes);
+
+	if (width < 1 || height < 1) {
+		width = 0;
+		height = 0;
+	}
+	this->width = width;
+	this->height = height;
+	size_t nodeCount = (size_t)width * height;
+
+	// the storage of a bigger previous grid is released
+	std::vector<uint8_t>(nodeCount, 1).swap(costs);
+	std::vector<uint8_t>(nodeCount, 0).swap(obstacles);
+	std::vector<uint16_t>(nodeCount, 0).swap(staticOccupants);
+	std::vector<uint16_t>(nodeCount, 0).swap(dynamicOccupants);
+	std::vector<uint32_t>(nodeCount, 0).swap(generations);
+	regionsX = (width + REGION_SIZE - 1) / REGION_SIZE;
+	std::vector<uint32_t>((size_t)regionsX * ((height + REGION_SIZE - 1) / REGION_SIZE), 0).swap(regionVersions);
+	version = 0;
+	std::vector<float>(nodeCount).swap(gcosts);
+	std::vector<float>(nodeCount).swap(fcosts);
+	std::vector<NodeIndex>(nodeCount).swap(parents);
+	std::vector<int32_t>(nodeCount).swap(heapIndices);
+	searchGeneration = 0;
+	weightedNodes = 0;
+	this->clearJumpTable();
+
+	// 8-connected components are at least one node apart, so a quarter of the nodes is the maximum number of components
+	std::vector<int32_t>(nodeCount, NO_COMPONENT).swap(components);
+	std::vector<int32_t>().swap(componentSizes);
+	componentSizes.reserve((size_t)((width + 1) / 2) * ((height + 1) / 2) + 1);
+	componentsDirty = true;
+
+	sightWordsPerRow = ((size_t)width + 63) / 64;
+	sightWordsPerColumn = ((size_t)height + 63) / 64;
+	std::vector<uint64_t>(sightWordsPerRow * height, 0).swap(sightBlockers);
+	std::vector<uint64_t>(sightWordsPerColumn * width, 0).swap(sightBlockersTransposed);
+
+	// search buffers never grow beyond the number of nodes
+	std::vector<NodeIndex>().swap(obstacleNodes);
+	std::vector<NodeIndex>().swap(openNodes);
+	obstacleNodes.reserve(nodeCount);
+	openNodes.reserve(nodeCount);
+
+	trackedBytes = nodeCount * (2 * sizeof(uint8_t) + 2 * sizeof(uint16_t) + sizeof(uint32_t) + 2 * sizeof(float) + 4 * sizeof(NodeIndex) + sizeof(int32_t))
+		+ (regionVersions.size() + componentSizes.capacity()) * sizeof(uint32_t) + (sightBlockers.size() + sightBlockersTransposed.size()) * sizeof(uint64_t);
+	MemoryTracker::trackAllocation(TAG_PATHFINDING, trackedBytes);
+}
+
+/**
+* @brief Removes every obstacle mark. Only the marked nodes are touched, occupied nodes stay obstacles.
+*/
+void NavGrid::clearObstacles() {
+	for (size_t i = 0; i < obstacleNodes.size(); i++) {
+		obstacles[obstacleNodes[i]] &= ~OBSTACLE_MARKED;
+	}
+	obstacleNodes.clear();
+}
+
+/**
+* @brief Adds an occupant to the node. The node is an obstacle while it has at least one occupant. Invalid nodes are ignored.
+* @param node - Node index.
+* @param layer - Occupancy layer of the occupant.
+*/
+void NavGrid::addOccupant(NodeIndex node, OCCUPANCY_LAYERS layer) {
+	if (!isValid(node)) return;
+
+	if (layer == OCCUPANCY_STATIC) {
+		if (staticOccupants[node]++ == 0) {
+			changeRegion(node);
+			if (costs[node] != 0) {
+				updateSightBlocker(node);
+				changeComponent(node);
+			}
+		}
+		obstacles[node] |= OBSTACLE_STATIC;
+	}
+	else {
+		dynamicOccupants[node]++;
+		obstacles[node] |= OBSTACLE_DYNAMIC;
+	}
+}
+
+/**
+* @brief Removes an occupant from the node. Invalid nodes are ignored.
+* @param node - Node index.
+* @param layer - Occupancy layer of the occupant.
+*/
+void NavGrid::removeOccupant(NodeIndex node, OCCUPANCY_LAYERS layer) {
+	if (!isValid(node)) return;
+
+	if (layer == OCCUPANCY_STATIC) {
+		if (staticOccupants[node] > 0 && --staticOccupants[node] == 0) {
+			obstacles[node] &= ~OBSTACLE_STATIC;
+			changeRegion(node);
+			if (costs[node] != 0) {
+				updateSightBlocker(node);
+				changeComponent(node);
+			}
+		}
+	}
+	else if (dynamicOccupants[node] > 0 && --dynamicOccupants[node] == 0) {
+		obstacles[node] &= ~OBSTACLE_DYNAMIC;
+	}
+}
+
+/**
+* @brief Checks if a path between two nodes can exist. Blocked nodes and static occupants separate the connected components, dynamic occupants and marked obstacles are ignored.
+* Like the searches, the start node is left and the destination node is entered even if they are blocked. The components are labeled again first if a change may have split one.
+* @param a - Start node.
+* @param b - Destination node.
+* @return Whether the nodes are connected. false if one of the nodes is invalid.
+*/
+bool NavGrid::isReachable(NodeIndex a, NodeIndex b) {
+	if (!isValid(a) || !isValid(b)) return false;
+
+	// neighbours are reached in one step, even between blocked nodes
+	if (std::abs(getX(a) - getX(b)) <= 1 && std::abs(getY(a) - getY(b)) <= 1) return true;
+
+	if (componentsDirty) this->labelComponents();
+
+	int32_t labelsA[NEIGHBOUR_COUNT];
+	int32_t labelsB[NEIGHBOUR_COUNT];
+	int countA = this->getAdjacentComponents(a, labelsA);
+	int countB = this->getAdjacentComponents(b, labelsB);
+	for (int i = 0; i < countA; i++) {
+		for (int j = 0; j < countB; j++) {
+			if (labelsA[i] == labelsB[j]) return true;
+		}
+	}
+	return false;
+}
+
+/**
+* @brief Updates the components after the node became walkable or blocked. An opened node joins or merges the components of its neighbours, a closed node only marks the components for labeling if its neighbours are not connected around it.
+* @param node - Changed node.
+*/
+void NavGrid::changeComponent(NodeIndex node) {
+	// every component is labeled at the next query anyway
+	if (componentsDirty) return;
+
+	int x = getX(node);
+	int y = getY(node);
+
+	if (isConnectable(node)) {
+		// join the largest neighbouring component, the others are relabeled into it
+		int32_t label = NO_COMPONENT;
+		for (int i = 0; i < NEIGHBOUR_COUNT; i++) {
+			NodeIndex neighbour = getIndex(x + NEIGHBOUR_X[i], y + NEIGHBOUR_Y[i]);
+			if (neighbour == INVALID_NODE || components[neighbour] == NO_COMPONENT) continue;
+			if (label == NO_COMPONENT || componentSizes[components[neighbour]] > componentSizes[label]) {
+				label = components[neighbour];
+			}
+		}
+
+		if (label == NO_COMPONENT) {
+			// labels are not reused, labeling again compacts them
+			if (componentSizes.size() == componentSizes.capacity()) {
+				componentsDirty = true;
+				return;
+			}
+			label = (int32_t)componentSizes.size();
+			componentSizes.push_back(0);
+		}
+		components[node] = label;
+		componentSizes[label]++;
+
+		for (int i = 0; i < NEIGHBOUR_COUNT; i++) {
+			NodeIndex neighbour = getIndex(x + NEIGHBOUR_X[i], y + NEIGHBOUR_Y[i]);
+			if (neighbour == INVALID_NODE || components[neighbour] == NO_COMPONENT || components[neighbour] == label) continue;
+			componentSizes[components[neighbour]] = 0;
+			componentSizes[label] += this->fillComponent(neighbour, label);
+		}
+		return;
+	}
+
+	int32_t label = components[node];
+	if (label == NO_COMPONENT) return;
+	components[node] = NO_COMPONENT;
+	componentSizes[label]--;
+
+	// the neighbours of the closed node in ring order. Without a blocked node between them, consecutive neighbours stay connected.
+	static const int RING_X[NEIGHBOUR_COUNT] = { -1, 0, 1, 1, 1, 0, -1, -1 };
+	static const int RING_Y[NEIGHBOUR_COUNT] = { -1, -1, -1, 0, 1, 1, 1, 0 };
+	bool open[NEIGHBOUR_COUNT];
+	for (int i = 0; i < NEIGHBOUR_COUNT; i++) {
+		NodeIndex neighbour = getIndex(x + RING_X[i], y + RING_Y[i]);
+		open[i] = neighbour != INVALID_NODE && components[neighbour] != NO_COMPONENT;
+	}
+
+	// straight neighbours separated by a blocked diagonal neighbour are still connected diagonally
+	int groups = 0;
+	for (int i = 0; i < NEIGHBOUR_COUNT; i++) {
+		int previous = (i + NEIGHBOUR_COUNT - 1) % NEIGHBOUR_COUNT;
+		int beforePrevious = (i + NEIGHBOUR_COUNT - 2) % NEIGHBOUR_COUNT;
+		bool straight = (i % 2) == 1;
+		if (open[i] && !open[previous] && !(straight && open[beforePrevious])) groups++;
+	}
+
+	// the ring is closed or has a single gap, so the neighbours are connected around the node
+	if (groups > 1) {
+		componentsDirty = true;
+	}
+}
+
+/**
+* @brief Labels every connected component of the grid from scratch.
+*/
+void NavGrid::labelComponents() {
+	std::fill(components.begin(), components.end(), NO_COMPONENT);
+	componentSizes.clear();
+	componentSizes.push_back(0);
+
+	for (NodeIndex node = 0; node < (NodeIndex)components.size(); node++) {
+		if (components[node] != NO_COMPONENT || !isConnectable(node)) continue;
+		int32_t label = (int32_t)componentSizes.size();
+		componentSizes.push_back(0);
+		componentSizes[label] = this->fillComponent(node, label);
+	}
+	componentsDirty = false;
+}
+
+/**
+* @brief Assigns a label to every walkable node connected to the start node that has another label.
+* @param start - Walkable node to start from.
+* @param label - Label to assign.
+* @return Number of relabeled nodes.
+*/
+int32_t NavGrid::fillComponent(NodeIndex start, int32_t label) {
+	// the open list is only used during a search and holds every node at most once
+	openNodes.clear();
+	openNodes.push_back(start);
+	components[start] = label;
+	int32_t count = 1;
+
+	while (!openNodes.empty()) {
+		NodeIndex current = openNodes.back();
+		openNodes.pop_back();
+		int x = getX(current);
+		int y = getY(current);
+
+		for (int i = 0; i < NEIGHBOUR_COUNT; i++) {
+			NodeIndex neighbour = getIndex(x + NEIGHBOUR_X[i], y + NEIGHBOUR_Y[i]);
+			if (neighbour == INVALID_NODE || components[neighbour] == label || !isConnectable(neighbour)) continue;
+			components[neighbour] = label;
+			openNodes.push_back(neighbour);
+			count++;
+		}
+	}
+	return count;
+}
+
+/**
+* @brief Gets the components a search can reach from the node in its first step. A walkable node only belongs to its own component, a blocked node reaches the components of its neighbours.
+* @param node - Valid node index.
+* @param labels - Buffer of NEIGHBOUR_COUNT labels.
+* @return Number of written labels.
+*/
+int NavGrid::getAdjacentComponents(NodeIndex node, int32_t* labels) {
+	if (components[node] != NO_COMPONENT) {
+		labels[0] = components[node];
+		return 1;
+	}
+
+	int count = 0;
+	for (int i = 0; i < NEIGHBOUR_COUNT; i++) {
+		NodeIndex neighbour = getNeighbour(node, i);
+		if (neighbour != INVALID_NODE && components[neighbour] != NO_COMPONENT) {
+			labels[count++] = components[neighbour];
+		}
+	}
+	return count;
+}
+
+/**
+* @brief Calculates the euclidean distance between two nodes in tiles.
+* @param a - First node.
+* @param b - Second node.
+* @return Distance between the nodes. 0 if one of the nodes is invalid.
+*/
+float NavGrid::getDistance(NodeIndex a, NodeIndex b) {
+	if (!isValid(a) || !isValid(b)) {
+		return 0.0f;
+	}
+	float dx = (float)(getX(a) - getX(b));
+	float dy = (float)(getY(a) - getY(b));
+	return std::sqrt(dx * dx + dy * dy);
+}
+
+/**
+* @brief Checks if the line between the centers of two nodes is not blocked. Blocked nodes and static occupants block the sight, dynamic occupants and marked obstacles do not.
+* The nodes of both ends are not checked. A line passing exactly through the corner of two blocked nodes is blocked.
+* @param from - First node.
+* @param to - Second node.
+* @return Whether the nodes see each other. false if one of the nodes is invalid.
+*/
+bool NavGrid::hasLineOfSight(NodeIndex from, NodeIndex to) {
+	if (!isValid(from) || !isValid(to)) return false;
+
+	int fromX = getX(from);
+	int fromY = getY(from);
+	int toX = getX(to);
+	int toY = getY(to);
+
+	// flat lines are tested row by row, steep lines column by column on the transposed bitmask
+	if (std::abs(toX - fromX) >= std::abs(toY - fromY)) {
+		return this->isLineClear(sightBlockers.data(), sightWordsPerRow, fromX, fromY, toX, toY);
+	}
+	return this->isLineClear(sightBlockersTransposed.data(), sightWordsPerColumn, fromY, fromX, toY, toX);
+}
+
+/**
+* @brief Checks the line of sight of many node pairs in one call.
+* @param queries - Queries of the batch. The visible flag of each query is set.
+* @param count - Number of queries.
+*/
+void NavGrid::checkLineOfSight(SightQuery* queries, size_t count) {
+	for (size_t i = 0; i < count; i++) {
+		SightQuery& query = queries[i];
+		// enemies crowding the same node share the result
+		if (i > 0 && query.from == queries[i - 1].from && query.to == queries[i - 1].to) {
+			query.visible = queries[i - 1].visible;
+			continue;
+		}
+		query.visible = this->hasLineOfSight(query.from, query.to);
+	}
+}
+
+/**
+* @brief Checks if a line between two nodes passes no blocker of a bitmask. The line is split into one run of nodes per bitmask line, each run is tested with a few word operations.
+* @param bitmask - Sight bitmask, lines along the major axis of the line.
+* @param wordsPerLine - Number of 64 bit words per bitmask line.
+* @param fromU - Coordinate of the first node along the bitmask lines.
+* @param fromV - Bitmask line of the first node.
+* @param toU - Coordinate of the second node along the bitmask lines.
+* @param toV - Bitmask line of the second node.
+* @return Whether no node between the ends blocks the sight.
+*/
+bool NavGrid::isLineClear(const uint64_t* bitmask, size_t wordsPerLine, int fromU, int fromV, int toU, int toV) {
+	int nu = std::abs(toU - fromU);
+	int nv = std::abs(toV - fromV);
+	int stepU = (toU > fromU) ? 1 : -1;
+	int stepV = (toV > fromV) ? 1 : -1;
+
+	// the line crosses the border to the next bitmask line at u = (nv + (2i + 1) * nu) / (2 * nv), kept as quotient and remainder
+	int divisor = 2 * nv;
+	int crossing = (nv > 0) ? (nv + nu) / divisor : 0;
+	int remainder = (nv > 0) ? (nv + nu) % divisor : 0;
+	int crossingStep = (nv > 0) ? (2 * nu) / divisor : 0;
+	int remainderStep = (nv > 0) ? (2 * nu) % divisor : 0;
+
+	// run of the current line in steps from the first node
+	int runStart = 1;
+	for (int i = 0; i <= nv; i++) {
+		int runEnd = nu - 1;
+		int nextStart = 0;
+
+		if (i < nv) {
+			nextStart = crossing;
+			runEnd = nextStart;
+
+			if (remainder == 0) {
+				// the line passes through the corner of the next run
+				runEnd = nextStart - 1;
+				if (isBitSet(bitmask, wordsPerLine, fromU + stepU * nextStart, fromV + stepV * i)
+					&& isBitSet(bitmask, wordsPerLine, fromU + stepU * runEnd, fromV + stepV * (i + 1))) {
+					return false;
+				}
+			}
+		}
+
+		if (runStart <= runEnd) {
+			int first = fromU + stepU * runStart;
+			int last = fromU + stepU * runEnd;
+			if (isRangeSet(bitmask + (size_t)(fromV + stepV * i) * wordsPerLine, std::min(first, last), std::max(first, last))) return false;
+		}
+		runStart = nextStart;
+
+		crossing += crossingStep;
+		remainder += remainderStep;
+		if (remainder >= divisor) {
+			crossing++;
+			remainder -= divisor;
+		}
+	}
+	return true;
+}
+
+/**
+* @brief Checks if any bit of a range of a bitmask line is set.
+* @param line - First word of the bitmask line.
+* @param first - First bit of the range.
+* @param last - Last bit of the range.
+* @return Whether a bit is set.
+*/
+bool NavGrid::isRangeSet(const uint64_t* line, int first, int last) {
+	size_t firstWord = (size_t)(first >> 6);
+	size_t lastWord = (size_t)(last >> 6);
+	uint64_t firstMask = ~(uint64_t)0 << (first & 63);
+	uint64_t lastMask = ~(uint64_t)0 >> (63 - (last & 63));
+
+	if (firstWord == lastWord) return (line[firstWord] & firstMask & lastMask) != 0;
+	if ((line[firstWord] & firstMask) || (line[lastWord] & lastMask)) return true;
+	for (size_t word = firstWord + 1; word < lastWord; word++) {
+		if (line[word]) return true;
+	}
+	return false;
+}
+
+/**
+* @brief Starts a new search generation.
+*/
+void NavGrid::beginSearch() {
+	searchGeneration++;
+	if (searchGeneration == 0) {
+		// generation counter wrapped around, every node has to be reset once
+		std::fill(generations.begin(), generations.end(), 0);
+		searchGeneration = 1;
+	}
+	openNodes.clear();
+}
+
+/**
+* @brief Calculates the path from the start node to the destination node using the a* algorithm. Blocked nodes and obstacles are avoided, the destination node can always be entered.
+* @param start - Start node.
+* @param dest - Destination node.
+* @param path - Buffer the path is written to, from the destination node back to the start node. Cleared if no path was found.
+* @return Whether a path was found.
+*/
+bool NavGrid::findPath(NodeIndex start, NodeIndex dest, std::vector<NodeIndex>& path) {
+	path.clear();
+	if (!isValid(start) || !isValid(dest)) {
+		return false;
+	}
+	this->beginSearch();
+	int destX = getX(dest);
+	int destY = getY(dest);
+
+	touch(start);
+	gcosts[start] = 0.0f;
+	fcosts[start] = getOctileDistance(getX(start) - destX, getY(start) - destY);
+	push(start);
+
+	bool found = false;
+	while (!openNodes.empty()) {
+		NodeIndex current = pop();
+
+		if (current == dest) {
+			found = true;
+			break;
+		}
+
+		int x = getX(current);
+		int y = getY(current);
+
+		// check neighbours
+		for (int i = 0; i < NEIGHBOUR_COUNT; i++) {
+			int neighbourX = x + NEIGHBOUR_X[i];
+			int neighbourY = y + NEIGHBOUR_Y[i];
+			if (neighbourX < 0 || neighbourY < 0 || neighbourX >= width || neighbourY >= height) continue;
+
+			NodeIndex neighbour = neighbourY * width + neighbourX;
+			uint8_t cost = costs[neighbour];
+			if (neighbour != dest && (cost == 0 || (obstacles[neighbour] & obstacleMask))) continue;
+
+			touch(neighbour);
+			if (heapIndices[neighbour] == CLOSED) continue;
+
+			float gCostNeighbour = gcosts[current] + NEIGHBOUR_DISTANCE[i] * (cost > 0 ? cost : 1);
+			if (gCostNeighbour < gcosts[neighbour]) {
+				parents[neighbour] = current;
+				gcosts[neighbour] = gCostNeighbour;
+				fcosts[neighbour] = gCostNeighbour + getOctileDistance(neighbourX - destX, neighbourY - destY);
+
+				if (heapIndices[neighbour] == NOT_QUEUED) {
+					push(neighbour);
+				}
+				else {
+					siftUp(heapIndices[neighbour]);
+				}
+			}
+		}
+	}
+
+	// backtrack found path
+	if (found) {
+		NodeIndex current = dest;
+		path.push_back(current);
+		while (parents[current] != INVALID_NODE) {
+			current = parents[current];
+			path.push_back(current);
+		}
+	}
+	return found;
+}
+
+#pragma region JumpPointSearch
+/**
+* @brief Calculates the path from the start node to the destination node using jump point search. Symmetric paths are pruned, so only jump points are added to the open list.
+* Every walkable node is treated with a cost of 1. Blocked nodes and obstacles are avoided, the destination node can always be entered.
+* @param start - Start node.
+* @param dest - Destination node.
+* @param path - Buffer the path is written to, from the destination node back to the start node. Contains every node of the path. Cleared if no path was found.
+* @return Whether a path was found.
+*/
+bool NavGrid::findPathJps(NodeIndex start, NodeIndex dest, std::vector<NodeIndex>& path) {
+	path.clear();
+	if (!isValid(start) || !isValid(dest)) {
+		return false;
+	}
+	this->beginSearch();
+	int destX = getX(dest);
+	int destY = getY(dest);
+
+	touch(start);
+	gcosts[start] = 0.0f;
+	fcosts[start] = getOctileDistance(getX(start) - destX, getY(start) - destY);
+	push(start);
+
+	bool found = false;
+	while (!openNodes.empty()) {
+		NodeIndex current = pop();
+
+		if (current == dest) {
+			found = true;
+			break;
+		}
+
+		int x = getX(current);
+		int y = getY(current);
+		int directions = getJumpDirections(current, dest, false);
+
+		for (int i = 0; i < NEIGHBOUR_COUNT; i++) {
+			if (!(directions & (1 << i))) continue;
+
+			NodeIndex jumpPoint = jump(x, y, NEIGHBOUR_X[i], NEIGHBOUR_Y[i], dest);
+			if (jumpPoint == INVALID_NODE) continue;
+
+			// jump points are reached in a straight or diagonal line
+			openSuccessor(current, jumpPoint, getOctileDistance(getX(jumpPoint) - x, getY(jumpPoint) - y), destX, destY);
+		}
+	}
+
+	if (found) {
+		writeJumpPointPath(dest, path);
+	}
+	return found;
+}
+
+/**
+* @brief Precomputes the jump distances of every node for jump point search plus. The currently blocked nodes and obstacles are stored in the table.
+*/
+void NavGrid::buildJumpTable() {
+	size_t tableSize = costs.size() * NEIGHBOUR_COUNT;
+	if (jumpDistances.size() != tableSize) {
+		this->clearJumpTable();
+		jumpDistances.resize(tableSize);
+		MemoryTracker::trackAllocation(TAG_PATHFINDING, jumpDistances.capacity() * sizeof(int16_t));
+	}
+
+	// straight directions first, the diagonal distances depend on them
+	for (int i = 0; i < NEIGHBOUR_COUNT; i++) {
+		int dx = NEIGHBOUR_X[i];
+		int dy = NEIGHBOUR_Y[i];
+		int straightX = getDirection(dx, 0);
+		int straightY = getDirection(0, dy);
+
+		// the next node in the direction is always computed before the node itself
+		for (int row = 0; row < height; row++) {
+			int y = (dy > 0) ? height - 1 - row : row;
+			for (int column = 0; column < width; column++) {
+				int x = (dx > 0) ? width - 1 - column : column;
+				int nextX = x + dx;
+				int nextY = y + dy;
+				int16_t& distance = jumpDistances[(size_t)(y * width + x) * NEIGHBOUR_COUNT + i];
+
+				if (!isPassable(nextX, nextY, INVALID_NODE)) {
+					distance = 0;
+					continue;
+				}
+
+				NodeIndex next = nextY * width + nextX;
+				bool isJumpPoint = hasForcedNeighbour(nextX, nextY, dx, dy, INVALID_NODE);
+				if (dx != 0 && dy != 0 && !isJumpPoint) {
+					isJumpPoint = jumpDistances[(size_t)next * NEIGHBOUR_COUNT + straightX] > 0 || jumpDistances[(size_t)next * NEIGHBOUR_COUNT + straightY] > 0;
+				}
+
+				if (isJumpPoint) {
+					distance = 1;
+				}
+				else {
+					int16_t nextDistance = jumpDistances[(size_t)next * NEIGHBOUR_COUNT + i];
+					distance = (nextDistance > 0) ? nextDistance + 1 : nextDistance - 1;
+				}
+			}
+		}
+	}
+}
+
+/**
+* @brief Removes the precomputed jump distances.
+*/
+void NavGrid::clearJumpTable() {
+	MemoryTracker::trackDeallocation(TAG_PATHFINDING, jumpDistances.capacity() * sizeof(int16_t));
+	std::vector<int16_t>().swap(jumpDistances);
+}
+
+/**
+* @brief Calculates the path from the start node to the destination node using jump point search with the precomputed jump distances. No node is scanned during the search.
+* Obstacles marked after the jump table was built are ignored. The destination node can always be entered, blocked destinations are searched with findPathJps.
+* @param start - Start node.
+* @param dest - Destination node.
+* @param path - Buffer the path is written to, from the destination node back to the start node. Contains every node of the path. Cleared if no path was found.
+* @return Whether a path was found.
+*/
+bool NavGrid::findPathJpsPlus(NodeIndex start, NodeIndex dest, std::vector<NodeIndex>& path) {
+	path.clear();
+	if (!isValid(start) || !isValid(dest) || !hasJumpTable()) {
+		return false;
+	}
+
+	// the jump distances can not lead into a blocked destination
+	for (int i = 0; i < NEIGHBOUR_COUNT; i++) {
+		NodeIndex neighbour = getNeighbour(dest, i);
+		if (neighbour != INVALID_NODE) {
+			if (jumpDistances[(size_t)neighbour * NEIGHBOUR_COUNT + getDirection(-NEIGHBOUR_X[i], -NEIGHBOUR_Y[i])] == 0) {
+				return this->findPathJps(start, dest, path);
+			}
+			break;
+		}
+	}
+	this->beginSearch();
+	int destX = getX(dest);
+	int destY = getY(dest);
+
+	touch(start);
+	gcosts[start] = 0.0f;
+	fcosts[start] = getOctileDistance(getX(start) - destX, getY(start) - destY);
+	push(start);
+
+	bool found = false;
+	while (!openNodes.empty()) {
+		NodeIndex current = pop();
+
+		if (current == dest) {
+			found = true;
+			break;
+		}
+
+		int x = getX(current);
+		int y = getY(current);
+		int offsetX = destX - x;
+		int offsetY = destY - y;
+		int directions = getJumpDirections(current, dest, true);
+
+		for (int i = 0; i < NEIGHBOUR_COUNT; i++) {
+			if (!(directions & (1 << i))) continue;
+
+			int dx = NEIGHBOUR_X[i];
+			int dy = NEIGHBOUR_Y[i];
+			int distance = jumpDistances[(size_t)current * NEIGHBOUR_COUNT + i];
+			// free nodes in the direction, the destination may be the blocked node behind them
+			int reach = (distance > 0) ? distance : -distance;
+			int destReach = (distance > 0) ? distance : reach + 1;
+			int steps = 0;
+
+			if (dx == 0 || dy == 0) {
+				// destination on the line
+				int destSteps = (dx != 0) ? offsetX * dx : offsetY * dy;
+				bool onLine = (dx != 0) ? offsetY == 0 : offsetX == 0;
+				if (onLine && destSteps > 0 && destSteps <= destReach) {
+					steps = destSteps;
+				}
+			}
+			else if (getSign(offsetX) == dx && getSign(offsetY) == dy) {
+				// stop on the row or column of the destination
+				int destSteps = std::min(offsetX * dx, offsetY * dy);
+				bool isDest = offsetX * dx == offsetY * dy;
+				if (destSteps <= reach || (isDest && destSteps <= destReach)) {
+					steps = destSteps;
+				}
+			}
+
+			if (steps == 0 && distance > 0) {
+				steps = distance;
+			}
+			if (steps == 0) continue;
+
+			NodeIndex successor = (y + dy * steps) * width + (x + dx * steps);
+			openSuccessor(current, successor, getOctileDistance(dx * steps, dy * steps), destX, destY);
+		}
+	}
+
+	if (found) {
+		writeJumpPointPath(dest, path);
+	}
+	return found;
+}
+
+/**
+* @brief Relaxes the path over the current node to a successor. Opens the successor or decreases its cost if the path is cheaper.
+* @param current - Expanded node.
+* @param successor - Successor of the node.
+* @param stepCost - Cost from the current node to the successor.
+* @param destX - X-position of the destination.
+* @param destY - Y-position of the destination.
+*/
+void NavGrid::openSuccessor(NodeIndex current, NodeIndex successor, float stepCost, int destX, int destY) {
+	touch(successor);
+	if (heapIndices[successor] == CLOSED) return;
+
+	float gCostSuccessor = gcosts[current] + stepCost;
+	if (gCostSuccessor < gcosts[successor]) {
+		parents[successor] = current;
+		gcosts[successor] = gCostSuccessor;
+		fcosts[successor] = gCostSuccessor + getOctileDistance(getX(successor) - destX, getY(successor) - destY);
+
+		if (heapIndices[successor] == NOT_QUEUED) {
+			push(successor);
+		}
+		else {
+			siftUp(heapIndices[successor]);
+		}
+	}
+}
+
+/**
+* @brief Backtracks the found path of a jump point search. The nodes between two jump points are filled in.
+* @param dest - Destination node.
+* @param path - Buffer the path is written to, from the destination node back to the start node.
+*/
+void NavGrid::writeJumpPointPath(NodeIndex dest, std::vector<NodeIndex>& path) {
+	NodeIndex current = dest;
+	path.push_back(current);
+	while (parents[current] != INVALID_NODE) {
+		NodeIndex parent = parents[current];
+		int x = getX(current);
+		int y = getY(current);
+		int dx = getSign(getX(parent) - x);
+		int dy = getSign(getY(parent) - y);
+
+		while (current != parent) {
+			x += dx;
+			y += dy;
+			current = y * width + x;
+			path.push_back(current);
+		}
+	}
+}
+
+/**
+* @brief Checks if the position has a forced neighbour when it is entered in the direction. A forced neighbour can only be reached optimally over this position.
+* @param x - X-position on the grid.
+* @param y - Y-position on the grid.
+* @param dx - X-direction of the movement.
+* @param dy - Y-direction of the movement.
+* @param dest - Destination node of the search.
+* @return Whether the position has a forced neighbour.
+*/
+bool NavGrid::hasForcedNeighbour(int x, int y, int dx, int dy, NodeIndex dest) {
+	if (dx != 0 && dy != 0) {
+		return (!isPassable(x - dx, y, dest) && isPassable(x - dx, y + dy, dest))
+			|| (!isPassable(x, y - dy, dest) && isPassable(x + dx, y - dy, dest));
+	}
+	if (dx != 0) {
+		return (!isPassable(x, y + 1, dest) && isPassable(x + dx, y + 1, dest))
+			|| (!isPassable(x, y - 1, dest) && isPassable(x + dx, y - 1, dest));
+	}
+	return (!isPassable(x + 1, y, dest) && isPassable(x + 1, y + dy, dest))
+		|| (!isPassable(x - 1, y, dest) && isPassable(x - 1, y + dy, dest));
+}
+
+/**
+* @brief Gets the directions to search from a node of the jump point search. Directions without optimal paths over the node are pruned.
+* @param node - Expanded node.
+* @param dest - Destination node of the search.
+* @param useJumpTable - Whether the blocked neighbours are taken from the jump table instead of the grid.
+* @return Bit mask of the neighbour directions.
+*/
+int NavGrid::getJumpDirections(NodeIndex node, NodeIndex dest, bool useJumpTable) {
+	NodeIndex parent = parents[node];
+	if (parent == INVALID_NODE) {
+		// start node
+		return (1 << NEIGHBOUR_COUNT) - 1;
+	}
+
+	int x = getX(node);
+	int y = getY(node);
+	int dx = getSign(x - getX(parent));
+	int dy = getSign(y - getY(parent));
+	int directions = 1 << getDirection(dx, dy);
+
+	if (dx != 0 && dy != 0) {
+		directions |= 1 << getDirection(dx, 0);
+		directions |= 1 << getDirection(0, dy);
+		if (isNeighbourBlocked(node, -dx, 0, dest, useJumpTable)) directions |= 1 << getDirection(-dx, dy);
+		if (isNeighbourBlocked(node, 0, -dy, dest, useJumpTable)) directions |= 1 << getDirection(dx, -dy);
+	}
+	else if (dx != 0) {
+		if (isNeighbourBlocked(node, 0, 1, dest, useJumpTable)) directions |= 1 << getDirection(dx, 1);
+		if (isNeighbourBlocked(node, 0, -1, dest, useJumpTable)) directions |= 1 << getDirection(dx, -1);
+	}
+	else {
+		if (isNeighbourBlocked(node, 1, 0, dest, useJumpTable)) directions |= 1 << getDirection(1, dy);
+		if (isNeighbourBlocked(node, -1, 0, dest, useJumpTable)) directions |= 1 << getDirection(-1, dy);
+	}
+	return directions;
+}
+
+/**
+* @brief Checks if a neighbour of the node can not be entered during a jump point search.
+* @param node - Valid node index.
+* @param dx - X-direction of the neighbour.
+* @param dy - Y-direction of the neighbour.
+* @param dest - Destination node of the search.
+* @param useJumpTable - Whether the neighbour is checked in the jump table instead of the grid.
+* @return Whether the neighbour is blocked or outside of the grid.
+*/
+bool NavGrid::isNeighbourBlocked(NodeIndex node, int dx, int dy, NodeIndex dest, bool useJumpTable) {
+	if (useJumpTable) {
+		// a jump distance of 0 means the next node in the direction is blocked
+		return jumpDistances[(size_t)node * NEIGHBOUR_COUNT + getDirection(dx, dy)] == 0;
+	}
+	return !isPassable(getX(node) + dx, getY(node) + dy, dest);
+}
+
+/**
+* @brief Moves from the position in the direction until a jump point, the destination or a blocked node is reached.
+* @param x - X-position to jump from.
+* @param y - Y-position to jump from.
+* @param dx - X-direction of the jump.
+* @param dy - Y-direction of the jump.
+* @param dest - Destination node of the search.
+* @return Reached jump point. INVALID_NODE if a blocked node was reached first.
+*/
+NodeIndex NavGrid::jump(int x, int y, int dx, int dy, NodeIndex dest) {
+	while (true) {
+		x += dx;
+		y += dy;
+		if (!isPassable(x, y, dest)) {
+			return INVALID_NODE;
+		}
+
+		NodeIndex node = y * width + x;
+		if (node == dest || hasForcedNeighbour(x, y, dx, dy, dest)) {
+			return node;
+		}
+
+		// diagonal jumps stop where a straight jump finds a jump point
+		if (dx != 0 && dy != 0 && (jump(x, y, dx, 0, dest) != INVALID_NODE || jump(x, y, 0, dy, dest) != INVALID_NODE)) {
+			return node;
+		}
+	}
+}
+#pragma endregion JumpPointSearch
+
+#pragma region OpenList
+/**
+* @brief Adds the node to the open list.
+* @param node - Node to add.
+*/
+void NavGrid::push(NodeIndex node) {
+	openNodes.push_back(node);
+	siftUp((int32_t)openNodes.size() - 1);
+}
+
+/**
+* @brief Removes the node with the smallest fcost from the open list and closes it.
+* @return Node with the smallest fcost.
+*/
+NodeIndex NavGrid::pop() {
+	NodeIndex result = openNodes[0];
+	heapIndices[result] = CLOSED;
+
+	NodeIndex last = openNodes.back();
+	openNodes.pop_back();
+	if (!openNodes.empty()) {
+		openNodes[0] = last;
+		siftDown(0);
+	}
+	return result;
+}
+
+/**
+* @brief Moves the queued node at the heap position up until its parent has a smaller fcost.
+* @param position - Heap position of the node.
+*/
+void NavGrid::siftUp(int32_t position) {
+	NodeIndex node = openNodes[position];
+	while (position > 0) {
+		int32_t parent = (position - 1) / 2;
+		if (!isCloser(node, openNodes[parent])) break;
+
+		openNodes[position] = openNodes[parent];
+		heapIndices[openNodes[position]] = position;
+		position = parent;
+	}
+	openNodes[position] = node;
+	heapIndices[node] = position;
+}
+
+/**
+* @brief Moves the queued node at the heap position down until its children have a larger fcost.
+* @param position - Heap position of the node.
+*/
+void NavGrid::siftDown(int32_t position) {
+	NodeIndex node = openNodes[position];
+	int32_t count = (int32_t)openNodes.size();
+	while (true) {
+		int32_t child = position * 2 + 1;
+		if (child >= count) break;
+		if (child + 1 < count && isCloser(openNodes[child + 1], openNodes[child])) {
+			child++;
+		}
+		if (!isCloser(openNodes[child], node)) break;
+
+		openNodes[position] = openNodes[child];
+		heapIndices[openNodes[position]] = position;
+		position = child;
+	}
+	openNodes[position] = node;
+	heapIndices[node] = position;
+}
+#pragma endregion OpenList
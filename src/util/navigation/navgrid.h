@@ -0,0 +1,740 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "../memorytracker.h"
+
+/**
+ * @brief Index of a node on the navigation grid (y * width + x).
+*/
+typedef int32_t NodeIndex;
+
+/**
+ * @brief Index of no node. Returned for positions outside of the grid.
+*/
+const NodeIndex INVALID_NODE = -1;
+
+/**
+ * @brief Layers of the occupancy of the navigation grid.
+*/
+enum OCCUPANCY_LAYERS {
+	// colliders that do not move on their own, e.g. walls. Stored in the jump table and the clusters.
+	OCCUPANCY_STATIC,
+	// colliders of moving agents like enemies and the player
+	OCCUPANCY_DYNAMIC
+};
+
+/**
+ * @brief Search algorithms of the navigation grid.
+*/
+enum PATHFINDING_ALGORITHMS {
+	// a* search, supports weighted nodes
+	PATHFINDING_ASTAR,
+	// jump point search. Only expands jump points on grids where every walkable node has the same cost.
+	PATHFINDING_JPS,
+	// jump point search with precomputed jump distances. Only valid while the blocked nodes do not change.
+	PATHFINDING_JPS_PLUS,
+	// hierarchical search over clusters of the grid (HPA*). Only the first part of a long path is refined.
+	PATHFINDING_HIERARCHICAL,
+	// incremental search (D* Lite) kept per agent. Only the nodes affected by a move of the agent, its destination or a change of the grid are repaired.
+	PATHFINDING_INCREMENTAL
+};
+
+/**
+ * @brief Compact navigation grid of the tilemap. Every tile is one node stored as a cost byte, the 8 neighbours are derived from the index.
+ * The search state of the a* search is kept in separate arrays (structure of arrays) and reset lazily with a search generation, so a search only touches the explored nodes.
+ * Walkable nodes are labeled with their connected component, so queries between unconnected areas are rejected without a search.
+*/
+class NavGrid {
+public:
+	/**
+	 * @brief Line of sight query between two nodes of a batch.
+	*/
+	struct SightQuery {
+		NodeIndex from;
+		NodeIndex to;
+		bool visible;
+	};
+
+	/**
+	 * @brief Number of neighbours of a node.
+	*/
+	static const int NEIGHBOUR_COUNT = 8;
+
+	/**
+	 * @brief Width and height of a region in nodes. Each region stores the version of the last change of its blocked nodes and costs.
+	*/
+	static const int REGION_SIZE = 8;
+
+	/**
+	 * @brief Destructor of the navigation grid. Removes the grid from the memory tracker.
+	*/
+	~NavGrid();
+
+	/**
+	 * @brief Initializes the grid. Every node is walkable with a cost of 1. The storage of a previous grid is reused or released.
+	 * @param width - Number of nodes per row.
+	 * @param height - Number of nodes per column.
+	*/
+	void init(int width, int height);
+
+	/**
+	 * @brief Gets the number of nodes per row.
+	 * @return Number of nodes per row.
+	*/
+	int getWidth() { return width; }
+
+	/**
+	 * @brief Gets the number of nodes per column.
+	 * @return Number of nodes per column.
+	*/
+	int getHeight() { return height; }
+
+	/**
+	 * @brief Gets the number of nodes of the grid.
+	 * @return Number of nodes.
+	*/
+	size_t getNodeCount() { return costs.size(); }
+
+	/**
+	 * @brief Gets the node index of a grid position.
+	 * @param x - X-position on the grid.
+	 * @param y - Y-position on the grid.
+	 * @return Index of the node. INVALID_NODE if the position is outside of the grid.
+	*/
+	NodeIndex getIndex(int x, int y) {
+		if (x < 0 || y < 0 || x >= width || y >= height) {
+			return INVALID_NODE;
+		}
+		return y * width + x;
+	}
+
+	/**
+	 * @brief Gets the x-position of the node on the grid.
+	 * @param node - Valid node index.
+	 * @return X-position on the grid.
+	*/
+	int getX(NodeIndex node) { return node % width; }
+
+	/**
+	 * @brief Gets the y-position of the node on the grid.
+	 * @param node - Valid node index.
+	 * @return Y-position on the grid.
+	*/
+	int getY(NodeIndex node) { return node / width; }
+
+	/**
+	 * @brief Checks if the node index belongs to the grid.
+	 * @param node - Node index to check.
+	 * @return Whether the node index belongs to the grid.
+	*/
+	bool isValid(NodeIndex node) {
+		return node >= 0 && (size_t)node < costs.size();
+	}
+
+	/**
+	 * @brief Gets a neighbour of the node.
+	 * @param node - Valid node index.
+	 * @param direction - Direction of the neighbour from 0 to NEIGHBOUR_COUNT - 1. The first four directions are straight, the others diagonal.
+	 * @return Index of the neighbour. INVALID_NODE if the neighbour is outside of the grid.
+	*/
+	NodeIndex getNeighbour(NodeIndex node, int direction) {
+		return getIndex(getX(node) + NEIGHBOUR_X[direction], getY(node) + NEIGHBOUR_Y[direction]);
+	}
+
+	/**
+	 * @brief Gets the distance to a neighbour in tiles.
+	 * @param direction - Direction of the neighbour from 0 to NEIGHBOUR_COUNT - 1.
+	 * @return Distance to the neighbour.
+	*/
+	static float getNeighbourDistance(int direction) { return NEIGHBOUR_DISTANCE[direction]; }
+
+	/**
+	 * @brief Checks if the node can be entered. Blocked nodes and obstacles can not be entered.
+	 * @param node - Valid node index.
+	 * @return Whether the node can be entered.
+	*/
+	bool isWalkable(NodeIndex node) { return costs[node] != 0 && !(obstacles[node] & obstacleMask); }
+
+	/**
+	 * @brief Sets the movement cost of the node. A cost of 0 blocks the node permanently.
+	 * @param node - Valid node index.
+	 * @param cost - Cost multiplier of moving onto the node.
+	*/
+	void setCost(NodeIndex node, uint8_t cost) {
+		if (costs[node] != cost) changeRegion(node);
+		if (costs[node] > 1) weightedNodes--;
+		if (cost > 1) weightedNodes++;
+		bool wasBlocked = costs[node] == 0;
+		costs[node] = cost;
+		if (wasBlocked != (cost == 0) && staticOccupants[node] == 0) {
+			updateSightBlocker(node);
+			changeComponent(node);
+		}
+	}
+
+	/**
+	 * @brief Gets the movement cost of the node.
+	 * @param node - Valid node index.
+	 * @return Cost multiplier of moving onto the node. 0 if the node is blocked.
+	*/
+	uint8_t getCost(NodeIndex node) { return costs[node]; }
+
+	/**
+	 * @brief Checks if every walkable node has the same cost. Jump point search is only used on grids with uniform cost.
+	 * @return Whether no node has a cost above 1.
+	*/
+	bool isUniformCost() { return weightedNodes == 0; }
+
+	/**
+	 * @brief Marks the node as obstacle until the obstacles are cleared. Invalid nodes are ignored.
+	 * @param node - Node to mark.
+	*/
+	void markObstacle(NodeIndex node) {
+		if (isValid(node) && !(obstacles[node] & OBSTACLE_MARKED)) {
+			obstacles[node] |= OBSTACLE_MARKED;
+			obstacleNodes.push_back(node);
+		}
+	}
+
+	/**
+	 * @brief Checks if the node is an obstacle, either marked or occupied.
+	 * @param node - Valid node index.
+	 * @return Whether the node is an obstacle.
+	*/
+	bool isObstacle(NodeIndex node) { return (obstacles[node] & obstacleMask) != 0; }
+
+	/**
+	 * @brief Removes every obstacle mark. Only the marked nodes are touched, occupied nodes stay obstacles.
+	*/
+	void clearObstacles();
+
+	/**
+	 * @brief Adds an occupant to the node. The node is an obstacle while it has at least one occupant. Invalid nodes are ignored.
+	 * @param node - Node index.
+	 * @param layer - Occupancy layer of the occupant.
+	*/
+	void addOccupant(NodeIndex node, OCCUPANCY_LAYERS layer);
+
+	/**
+	 * @brief Removes an occupant from the node. Invalid nodes are ignored.
+	 * @param node - Node index.
+	 * @param layer - Occupancy layer of the occupant.
+	*/
+	void removeOccupant(NodeIndex node, OCCUPANCY_LAYERS layer);
+
+	/**
+	 * @brief Gets the number of occupants of the node.
+	 * @param node - Valid node index.
+	 * @param layer - Occupancy layer.
+	 * @return Number of occupants in the layer.
+	*/
+	uint16_t getOccupants(NodeIndex node, OCCUPANCY_LAYERS layer) {
+		return (layer == OCCUPANCY_STATIC) ? staticOccupants[node] : dynamicOccupants[node];
+	}
+
+	/**
+	 * @brief Sets whether nodes occupied by dynamic occupants are obstacles. Disabled while static data like the jump table is built.
+	 * @param enabled - Whether dynamic occupants are obstacles.
+	*/
+	void setDynamicObstacles(bool enabled) {
+		obstacleMask = enabled ? (OBSTACLE_MARKED | OBSTACLE_STATIC | OBSTACLE_DYNAMIC) : (OBSTACLE_MARKED | OBSTACLE_STATIC);
+	}
+
+	/**
+	 * @brief Gets the version of the last change of a blocked node or cost. Dynamic occupants do not change the version.
+	 * @return Version of the grid.
+	*/
+	uint32_t getVersion() { return version; }
+
+	/**
+	 * @brief Gets the region of the node.
+	 * @param node - Valid node index.
+	 * @return Index of the region.
+	*/
+	int32_t getRegion(NodeIndex node) {
+		return (getY(node) / REGION_SIZE) * regionsX + getX(node) / REGION_SIZE;
+	}
+
+	/**
+	 * @brief Gets the version of the last change inside of a region.
+	 * @param region - Valid region index.
+	 * @return Version of the region. 0 if the region did not change since the grid was initialized.
+	*/
+	uint32_t getRegionVersion(int32_t region) { return regionVersions[region]; }
+
+	/**
+	 * @brief Checks if a path between two nodes can exist. Blocked nodes and static occupants separate the connected components, dynamic occupants and marked obstacles are ignored.
+	 * Like the searches, the start node is left and the destination node is entered even if they are blocked. The components are labeled again first if a change may have split one.
+	 * @param a - Start node.
+	 * @param b - Destination node.
+	 * @return Whether the nodes are connected. false if one of the nodes is invalid.
+	*/
+	bool isReachable(NodeIndex a, NodeIndex b);
+
+	/**
+	 * @brief Calculates the euclidean distance between two nodes in tiles.
+	 * @param a - First node.
+	 * @param b - Second node.
+	 * @return Distance between the nodes. 0 if one of the nodes is invalid.
+	*/
+	float getDistance(NodeIndex a, NodeIndex b);
+
+	/**
+	 * @brief Checks if the line between the centers of two nodes is not blocked. Blocked nodes and static occupants block the sight, dynamic occupants and marked obstacles do not.
+	 * The nodes of both ends are not checked. A line passing exactly through the corner of two blocked nodes is blocked.
+	 * @param from - First node.
+	 * @param to - Second node.
+	 * @return Whether the nodes see each other. false if one of the nodes is invalid.
+	*/
+	bool hasLineOfSight(NodeIndex from, NodeIndex to);
+
+	/**
+	 * @brief Checks the line of sight of many node pairs in one call.
+	 * @param queries - Queries of the batch. The visible flag of each query is set.
+	 * @param count - Number of queries.
+	*/
+	void checkLineOfSight(SightQuery* queries, size_t count);
+
+	/**
+	 * @brief Calculates the path from the start node to the destination node using the a* algorithm. Blocked nodes and obstacles are avoided, the destination node can always be entered.
+	 * @param start - Start node.
+	 * @param dest - Destination node.
+	 * @param path - Buffer the path is written to, from the destination node back to the start node. Cleared if no path was found.
+	 * @return Whether a path was found.
+	*/
+	bool findPath(NodeIndex start, NodeIndex dest, std::vector<NodeIndex>& path);
+
+	/**
+	 * @brief Calculates the path from the start node to the destination node using jump point search. Symmetric paths are pruned, so only jump points are added to the open list.
+	 * Every walkable node is treated with a cost of 1. Blocked nodes and obstacles are avoided, the destination node can always be entered.
+	 * @param start - Start node.
+	 * @param dest - Destination node.
+	 * @param path - Buffer the path is written to, from the destination node back to the start node. Contains every node of the path. Cleared if no path was found.
+	 * @return Whether a path was found.
+	*/
+	bool findPathJps(NodeIndex start, NodeIndex dest, std::vector<NodeIndex>& path);
+
+	/**
+	 * @brief Precomputes the jump distances of every node for jump point search plus. The currently blocked nodes and obstacles are stored in the table.
+	*/
+	void buildJumpTable();
+
+	/**
+	 * @brief Removes the precomputed jump distances.
+	*/
+	void clearJumpTable();
+
+	/**
+	 * @brief Checks if the jump distances are precomputed.
+	 * @return Whether the jump distances are precomputed.
+	*/
+	bool hasJumpTable() { return !jumpDistances.empty(); }
+
+	/**
+	 * @brief Calculates the path from the start node to the destination node using jump point search with the precomputed jump distances. No node is scanned during the search.
+	 * Obstacles marked after the jump table was built are ignored. The destination node can always be entered, blocked destinations are searched with findPathJps.
+	 * @param start - Start node.
+	 * @param dest - Destination node.
+	 * @param path - Buffer the path is written to, from the destination node back to the start node. Contains every node of the path. Cleared if no path was found.
+	 * @return Whether a path was found.
+	*/
+	bool findPathJpsPlus(NodeIndex start, NodeIndex dest, std::vector<NodeIndex>& path);
+private:
+	/**
+	 * @brief X-offsets of the neighbours of a node.
+	*/
+	static const int NEIGHBOUR_X[NEIGHBOUR_COUNT];
+
+	/**
+	 * @brief Y-offsets of the neighbours of a node.
+	*/
+	static const int NEIGHBOUR_Y[NEIGHBOUR_COUNT];
+
+	/**
+	 * @brief Distance to each neighbour.
+	*/
+	static const float NEIGHBOUR_DISTANCE[NEIGHBOUR_COUNT];
+
+	/**
+	 * @brief Heap index of nodes that are not queued.
+	*/
+	static const int32_t NOT_QUEUED = -1;
+
+	/**
+	 * @brief Heap index of nodes that were already expanded by the current search.
+	*/
+	static const int32_t CLOSED = -2;
+
+	/**
+	 * @brief Number of nodes per row.
+	*/
+	int width = 0;
+
+	/**
+	 * @brief Number of nodes per column.
+	*/
+	int height = 0;
+
+	/**
+	 * @brief Cost multiplier per node. 0 if the node is blocked.
+	*/
+	std::vector<uint8_t> costs;
+
+	/**
+	 * @brief Obstacle flags of a node.
+	*/
+	static const uint8_t OBSTACLE_MARKED = 1;
+	static const uint8_t OBSTACLE_STATIC = 2;
+	static const uint8_t OBSTACLE_DYNAMIC = 4;
+
+	/**
+	 * @brief Obstacle flags per node.
+	*/
+	std::vector<uint8_t> obstacles;
+
+	/**
+	 * @brief Obstacle flags that block a node.
+	*/
+	uint8_t obstacleMask = OBSTACLE_MARKED | OBSTACLE_STATIC | OBSTACLE_DYNAMIC;
+
+	/**
+	 * @brief Version of the last change of a blocked node or cost.
+	*/
+	uint32_t version = 0;
+
+	/**
+	 * @brief Number of regions per row.
+	*/
+	int regionsX = 0;
+
+	/**
+	 * @brief Version of the last change per region.
+	*/
+	std::vector<uint32_t> regionVersions;
+
+	/**
+	 * @brief Number of static occupants per node.
+	*/
+	std::vector<uint16_t> staticOccupants;
+
+	/**
+	 * @brief Number of dynamic occupants per node.
+	*/
+	std::vector<uint16_t> dynamicOccupants;
+
+	/**
+	 * @brief Nodes currently marked as obstacle.
+	*/
+	std::vector<NodeIndex> obstacleNodes;
+
+	/**
+	 * @brief Search generation the search state of each node belongs to.
+	*/
+	std::vector<uint32_t> generations;
+
+	/**
+	 * @brief Cost from the start node per node.
+	*/
+	std::vector<float> gcosts;
+
+	/**
+	 * @brief Cost from the start node plus the estimated cost to the destination per node.
+	*/
+	std::vector<float> fcosts;
+
+	/**
+	 * @brief Node used to reach each node. Needed to backtrack the found path.
+	*/
+	std::vector<NodeIndex> parents;
+
+	/**
+	 * @brief Position of each node in the open list, NOT_QUEUED or CLOSED.
+	*/
+	std::vector<int32_t> heapIndices;
+
+	/**
+	 * @brief Open list of the search as binary min heap ordered by fcost.
+	*/
+	std::vector<NodeIndex> openNodes;
+
+	/**
+	 * @brief Generation of the current search.
+	*/
+	uint32_t searchGeneration = 0;
+
+	/**
+	 * @brief Bytes of the grid accounted to the memory tracker.
+	*/
+	size_t trackedBytes = 0;
+
+	/**
+	 * @brief Number of nodes with a cost above 1.
+	*/
+	size_t weightedNodes = 0;
+
+	/**
+	 * @brief Component label of nodes that are not walkable.
+	*/
+	static const int32_t NO_COMPONENT = 0;
+
+	/**
+	 * @brief Number of 64 bit words per row of the sight bitmask.
+	*/
+	size_t sightWordsPerRow = 0;
+
+	/**
+	 * @brief Number of 64 bit words per column of the transposed sight bitmask.
+	*/
+	size_t sightWordsPerColumn = 0;
+
+	/**
+	 * @brief Bitmask of the nodes that block the line of sight (blocked or statically occupied), one bit per node. Rows start at a new word.
+	*/
+	std::vector<uint64_t> sightBlockers;
+
+	/**
+	 * @brief Sight bitmask stored by column, so steep lines are tested with word operations too.
+	*/
+	std::vector<uint64_t> sightBlockersTransposed;
+
+	/**
+	 * @brief Connected component per node. NO_COMPONENT if the node is blocked or statically occupied.
+	*/
+	std::vector<int32_t> components;
+
+	/**
+	 * @brief Number of nodes per component label. Labels of merged components keep a size of 0 until the components are labeled again.
+	*/
+	std::vector<int32_t> componentSizes;
+
+	/**
+	 * @brief Whether a change may have split a component, so every component has to be labeled again before the next query.
+	*/
+	bool componentsDirty = true;
+
+	/**
+	 * @brief Precomputed jump distances of jump point search plus, NEIGHBOUR_COUNT per node. A positive distance leads to the next jump point in the direction, otherwise the negated distance is the number of free nodes before a blocked node.
+	*/
+	std::vector<int16_t> jumpDistances;
+
+	/**
+	 * @brief Starts a new search generation.
+	*/
+	void beginSearch();
+
+	/**
+	 * @brief Resets the search state of the node if it was last touched by an older search.
+	 * @param node - Node to touch.
+	*/
+	void touch(NodeIndex node) {
+		if (generations[node] != searchGeneration) {
+			generations[node] = searchGeneration;
+			gcosts[node] = INFINITY;
+			parents[node] = INVALID_NODE;
+			heapIndices[node] = NOT_QUEUED;
+		}
+	}
+
+	/**
+	 * @brief Compares two queued nodes. Ties of the fcost are broken in favour of the larger gcost, so nodes closer to the destination are expanded first.
+	 * @param a - First node.
+	 * @param b - Second node.
+	 * @return Whether the first node has to be expanded before the second node.
+	*/
+	bool isCloser(NodeIndex a, NodeIndex b) {
+		return fcosts[a] < fcosts[b] || (fcosts[a] == fcosts[b] && gcosts[a] > gcosts[b]);
+	}
+
+	/**
+	 * @brief Adds the node to the open list.
+	 * @param node - Node to add.
+	*/
+	void push(NodeIndex node);
+
+	/**
+	 * @brief Relaxes the path over the current node to a successor. Opens the successor or decreases its cost if the path is cheaper.
+	 * @param current - Expanded node.
+	 * @param successor - Successor of the node.
+	 * @param stepCost - Cost from the current node to the successor.
+	 * @param destX - X-position of the destination.
+	 * @param destY - Y-position of the destination.
+	*/
+	void openSuccessor(NodeIndex current, NodeIndex successor, float stepCost, int destX, int destY);
+
+	/**
+	 * @brief Backtracks the found path of a jump point search. The nodes between two jump points are filled in.
+	 * @param dest - Destination node.
+	 * @param path - Buffer the path is written to, from the destination node back to the start node.
+	*/
+	void writeJumpPointPath(NodeIndex dest, std::vector<NodeIndex>& path);
+
+	/**
+	 * @brief Stores a change of the blocked state or cost of a node in its region.
+	 * @param node - Valid node index.
+	*/
+	void changeRegion(NodeIndex node) { regionVersions[getRegion(node)] = ++version; }
+
+	/**
+	 * @brief Checks if the node is walkable without the dynamic occupants and marked obstacles. Only these nodes belong to a component.
+	 * @param node - Valid node index.
+	 * @return Whether the node belongs to a component.
+	*/
+	bool isConnectable(NodeIndex node) { return costs[node] != 0 && staticOccupants[node] == 0; }
+
+	/**
+	 * @brief Checks if a bit of a sight bitmask is set.
+	 * @param bitmask - Sight bitmask.
+	 * @param wordsPerLine - Number of 64 bit words per bitmask line.
+	 * @param u - Bit in the line.
+	 * @param v - Line of the bitmask.
+	 * @return Whether the bit is set.
+	*/
+	static bool isBitSet(const uint64_t* bitmask, size_t wordsPerLine, int u, int v) {
+		return ((bitmask[(size_t)v * wordsPerLine + (u >> 6)] >> (u & 63)) & 1) != 0;
+	}
+
+	/**
+	 * @brief Sets or clears a bit of a sight bitmask.
+	 * @param bitmask - Sight bitmask.
+	 * @param wordsPerLine - Number of 64 bit words per bitmask line.
+	 * @param u - Bit in the line.
+	 * @param v - Line of the bitmask.
+	 * @param set - Whether the bit is set.
+	*/
+	static void setBit(std::vector<uint64_t>& bitmask, size_t wordsPerLine, int u, int v, bool set) {
+		uint64_t bit = (uint64_t)1 << (u & 63);
+		uint64_t& word = bitmask[(size_t)v * wordsPerLine + (u >> 6)];
+		word = set ? (word | bit) : (word & ~bit);
+	}
+
+	/**
+	 * @brief Updates the bit of the node in the sight bitmasks after the node became walkable or blocked.
+	 * @param node - Valid node index.
+	*/
+	void updateSightBlocker(NodeIndex node) {
+		bool blocked = !isConnectable(node);
+		setBit(sightBlockers, sightWordsPerRow, getX(node), getY(node), blocked);
+		setBit(sightBlockersTransposed, sightWordsPerColumn, getY(node), getX(node), blocked);
+	}
+
+	/**
+	 * @brief Checks if a line between two nodes passes no blocker of a bitmask. The line is split into one run of nodes per bitmask line, each run is tested with a few word operations.
+	 * @param bitmask - Sight bitmask, lines along the major axis of the line.
+	 * @param wordsPerLine - Number of 64 bit words per bitmask line.
+	 * @param fromU - Coordinate of the first node along the bitmask lines.
+	 * @param fromV - Bitmask line of the first node.
+	 * @param toU - Coordinate of the second node along the bitmask lines.
+	 * @param toV - Bitmask line of the second node.
+	 * @return Whether no node between the ends blocks the sight.
+	*/
+	bool isLineClear(const uint64_t* bitmask, size_t wordsPerLine, int fromU, int fromV, int toU, int toV);
+
+	/**
+	 * @brief Checks if any bit of a range of a bitmask line is set.
+	 * @param line - First word of the bitmask line.
+	 * @param first - First bit of the range.
+	 * @param last - Last bit of the range.
+	 * @return Whether a bit is set.
+	*/
+	static bool isRangeSet(const uint64_t* line, int first, int last);
+
+	/**
+	 * @brief Updates the components after the node became walkable or blocked. An opened node joins or merges the components of its neighbours, a closed node only marks the components for labeling if its neighbours are not connected around it.
+	 * @param node - Changed node.
+	*/
+	void changeComponent(NodeIndex node);
+
+	/**
+	 * @brief Labels every connected component of the grid from scratch.
+	*/
+	void labelComponents();
+
+	/**
+	 * @brief Assigns a label to every walkable node connected to the start node that has another label.
+	 * @param start - Walkable node to start from.
+	 * @param label - Label to assign.
+	 * @return Number of relabeled nodes.
+	*/
+	int32_t fillComponent(NodeIndex start, int32_t label);
+
+	/**
+	 * @brief Gets the components a search can reach from the node in its first step. A walkable node only belongs to its own component, a blocked node reaches the components of its neighbours.
+	 * @param node - Valid node index.
+	 * @param labels - Buffer of NEIGHBOUR_COUNT labels.
+	 * @return Number of written labels.
+	*/
+	int getAdjacentComponents(NodeIndex node, int32_t* labels);
+
+	/**
+	 * @brief Checks if the position can be entered during a jump point search.
+	 * @param x - X-position on the grid.
+	 * @param y - Y-position on the grid.
+	 * @param dest - Destination node of the search, it can always be entered.
+	 * @return Whether the position is inside of the grid and can be entered.
+	*/
+	bool isPassable(int x, int y, NodeIndex dest) {
+		NodeIndex node = getIndex(x, y);
+		return node != INVALID_NODE && (node == dest || (costs[node] != 0 && !(obstacles[node] & obstacleMask)));
+	}
+
+	/**
+	 * @brief Checks if the position has a forced neighbour when it is entered in the direction. A forced neighbour can only be reached optimally over this position.
+	 * @param x - X-position on the grid.
+	 * @param y - Y-position on the grid.
+	 * @param dx - X-direction of the movement.
+	 * @param dy - Y-direction of the movement.
+	 * @param dest - Destination node of the search.
+	 * @return Whether the position has a forced neighbour.
+	*/
+	bool hasForcedNeighbour(int x, int y, int dx, int dy, NodeIndex dest);
+
+	/**
+	 * @brief Gets the directions to search from a node of the jump point search. Directions without optimal paths over the node are pruned.
+	 * @param node - Expanded node.
+	 * @param dest - Destination node of the search.
+	 * @param useJumpTable - Whether the blocked neighbours are taken from the jump table instead of the grid.
+	 * @return Bit mask of the neighbour directions.
+	*/
+	int getJumpDirections(NodeIndex node, NodeIndex dest, bool useJumpTable);
+
+	/**
+	 * @brief Checks if a neighbour of the node can not be entered during a jump point search.
+	 * @param node - Valid node index.
+	 * @param dx - X-direction of the neighbour.
+	 * @param dy - Y-direction of the neighbour.
+	 * @param dest - Destination node of the search.
+	 * @param useJumpTable - Whether the neighbour is checked in the jump table instead of the grid.
+	 * @return Whether the neighbour is blocked or outside of the grid.
+	*/
+	bool isNeighbourBlocked(NodeIndex node, int dx, int dy, NodeIndex dest, bool useJumpTable);
+
+	/**
+	 * @brief Moves from the position in the direction until a jump point, the destination or a blocked node is reached.
+	 * @param x - X-position to jump from.
+	 * @param y - Y-position to jump from.
+	 * @param dx - X-direction of the jump.
+	 * @param dy - Y-direction of the jump.
+	 * @param dest - Destination node of the search.
+	 * @return Reached jump point. INVALID_NODE if a blocked node was reached first.
+	*/
+	NodeIndex jump(int x, int y, int dx, int dy, NodeIndex dest);
+
+	/**
+	 * @brief Removes the node with the smallest fcost from the open list and closes it.
+	 * @return Node with the smallest fcost.
+	*/
+	NodeIndex pop();
+
+	/**
+	 * @brief Moves the queued node at the heap position up until its parent has a smaller fcost.
+	 * @param position - Heap position of the node.
+	*/
+	void siftUp(int32_t position);
+
+	/**
+	 * @brief Moves the queued node at the heap position down until its children have a larger fcost.
+	 * @param position - Heap position of the node.
+	*/
+	void siftDown(int32_t position);
+};
@@ -0,0 +1,158 @@
+#include "pathcache.h"
+
+/**
+* @brief Destructor of the path cache. Removes the cached paths from the memory tracker.
+*/
+PathCache::~PathCache() {
+	MemoryTracker::trackDeallocation(TAG_PATHFINDING, trackedBytes);
+}
+
+/**
+* @brief Sets the maximum number of cached paths and removes every cached path.
+* @param capacity - Maximum number of cached paths. 0 disables the cache.
+*/
+void PathCache::setCapacity(size_t capacity) {
+	this->capacity = capacity;
+	this->clear();
+}
+
+/**
+* @brief Looks up a cached path passing the start node and ending at the destination node. The path is only used if its regions did not change and none of its nodes is currently an obstacle.
+* @param grid - Navigation grid the paths were found on.
+* @param start - Start node.
+* @param dest - Destination node.
+* @param path - Buffer the path is written to, from the destination node back to the start node. Left unchanged if no path was cached.
+* @return Whether a cached path was found.
+*/
+bool PathCache::findPath(NavGrid& grid, NodeIndex start, NodeIndex dest, std::vector<NodeIndex>& path) {
+	if (capacity == 0) return false;
+
+	std::unordered_map<uint64_t, NodeReference>::iterator node = nodes.find(getKey(dest, start));
+	if (node == nodes.end()) {
+		misses++;
+		return false;
+	}
+
+	int32_t index = node->second.entry;
+	int32_t position = node->second.position;
+	CacheEntry& entry = entries[index];
+
+	if (!this->isCurrent(grid, entry)) {
+		this->removeEntry(index);
+		misses++;
+		return false;
+	}
+
+	// agents may stand on the path since it was cached, the destination can always be entered
+	for (int32_t i = 1; i < position; i++) {
+		if (!grid.isWalkable(entry.path[i])) {
+			misses++;
+			return false;
+		}
+	}
+
+	path.assign(entry.path.begin(), entry.path.begin() + position + 1);
+	entry.lastUse = ++useCounter;
+	hits++;
+	return true;
+}
+
+/**
+* @brief Caches a found path. The least recently used path is replaced if the cache is full.
+* @param grid - Navigation grid the path was found on.
+* @param path - Complete path from the destination node back to the start node.
+*/
+void PathCache::addPath(NavGrid& grid, const std::vector<NodeIndex>& path) {
+	// a path without a step is not worth a lookup
+	if (capacity == 0 || path.size() < 2) return;
+
+	int32_t index = 0;
+	if (entries.size() < capacity) {
+		index = (int32_t)entries.size();
+		entries.emplace_back();
+	}
+	else {
+		for (int32_t i = 1; i < (int32_t)entries.size(); i++) {
+			if (entries[i].lastUse < entries[index].lastUse) index = i;
+		}
+		this->removeEntry(index);
+	}
+
+	CacheEntry& entry = entries[index];
+	entry.path.assign(path.begin(), path.end());
+	entry.version = grid.getVersion();
+	entry.lastUse = ++useCounter;
+
+	NodeIndex dest = path[0];
+	for (int32_t i = 0; i < (int32_t)path.size(); i++) {
+		int32_t region = grid.getRegion(path[i]);
+		// consecutive nodes mostly share their region
+		if (entry.regions.empty() || entry.regions.back() != region) {
+			entry.regions.push_back(region);
+		}
+		if (i > 0) {
+			nodes[getKey(dest, path[i])] = { index, i };
+		}
+	}
+	this->trackMemory();
+}
+
+/**
+* @brief Removes every cached path. Has to be called when the grid is initialized again.
+*/
+void PathCache::clear() {
+	entries.clear();
+	nodes.clear();
+	useCounter = 0;
+	this->trackMemory();
+}
+
+/**
+* @brief Checks if no region the cached path passes changed since the path was cached.
+* @param grid - Navigation grid.
+* @param entry - Cache entry.
+* @return Whether the path is still valid.
+*/
+bool PathCache::isCurrent(NavGrid& grid, const CacheEntry& entry) {
+	for (size_t i = 0; i < entry.regions.size(); i++) {
+		if (grid.getRegionVersion(entry.regions[i]) > entry.version) return false;
+	}
+	return true;
+}
+
+/**
+* @brief Removes the path of an entry and its nodes from the node map. The entry is replaced first afterwards.
+* @param index - Index of the entry.
+*/
+void PathCache::removeEntry(int32_t index) {
+	CacheEntry& entry = entries[index];
+	if (!entry.path.empty()) {
+		NodeIndex dest = entry.path[0];
+		for (size_t i = 1; i < entry.path.size(); i++) {
+			// the node may belong to a newer path by now
+			std::unordered_map<uint64_t, NodeReference>::iterator node = nodes.find(getKey(dest, entry.path[i]));
+			if (node != nodes.end() && node->second.entry == index) {
+				nodes.erase(node);
+			}
+		}
+	}
+	entry.path.clear();
+	entry.regions.clear();
+	entry.lastUse = 0;
+}
+
+/**
+* @brief Accounts the current storage of the cached paths in the memory tracker.
+*/
+void PathCache::trackMemory() {
+	size_t bytes = entries.capacity() * sizeof(CacheEntry) + nodes.size() * (sizeof(uint64_t) + sizeof(NodeReference));
+	for (size_t i = 0; i < entries.size(); i++) {
+		bytes += entries[i].path.capacity() * sizeof(NodeIndex) + entries[i].regions.capacity() * sizeof(int32_t);
+	}
+
+	if (bytes != trackedBytes) {
+		MemoryTracker::trackDeallocation(TAG_PATHFINDING, trackedBytes);
+		MemoryTracker::trackAllocation(TAG_PATHFINDING, bytes);
+		trackedBytes = bytes;
+	}
+}
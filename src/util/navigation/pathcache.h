@@ -0,0 +1,172 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "navgrid.h"
+
+/**
+ * @brief Least recently used cache of found paths, so agents asking for the same destination reuse the path of an earlier search.
+ * Every node of a cached path can be used as start, the rest of the path up to the destination is returned. A path is dropped when a region it passes changed after it was cached.
+*/
+class PathCache {
+public:
+	/**
+	 * @brief Default maximum number of cached paths.
+	*/
+	static const size_t DEFAULT_CAPACITY = 64;
+
+	/**
+	 * @brief Destructor of the path cache. Removes the cached paths from the memory tracker.
+	*/
+	~PathCache();
+
+	/**
+	 * @brief Sets the maximum number of cached paths and removes every cached path.
+	 * @param capacity - Maximum number of cached paths. 0 disables the cache.
+	*/
+	void setCapacity(size_t capacity);
+
+	/**
+	 * @brief Gets the maximum number of cached paths.
+	 * @return Maximum number of cached paths.
+	*/
+	size_t getCapacity() { return capacity; }
+
+	/**
+	 * @brief Looks up a cached path passing the start node and ending at the destination node. The path is only used if its regions did not change and none of its nodes is currently an obstacle.
+	 * @param grid - Navigation grid the paths were found on.
+	 * @param start - Start node.
+	 * @param dest - Destination node.
+	 * @param path - Buffer the path is written to, from the destination node back to the start node. Left unchanged if no path was cached.
+	 * @return Whether a cached path was found.
+	*/
+	bool findPath(NavGrid& grid, NodeIndex start, NodeIndex dest, std::vector<NodeIndex>& path);
+
+	/**
+	 * @brief Caches a found path. The least recently used path is replaced if the cache is full.
+	 * @param grid - Navigation grid the path was found on.
+	 * @param path - Complete path from the destination node back to the start node.
+	*/
+	void addPath(NavGrid& grid, const std::vector<NodeIndex>& path);
+
+	/**
+	 * @brief Removes every cached path. Has to be called when the grid is initialized again.
+	*/
+	void clear();
+
+	/**
+	 * @brief Gets the number of lookups that returned a cached path.
+	 * @return Number of hits.
+	*/
+	size_t getHits() { return hits; }
+
+	/**
+	 * @brief Gets the number of lookups that did not return a cached path.
+	 * @return Number of misses.
+	*/
+	size_t getMisses() { return misses; }
+private:
+	/**
+	 * @brief Cached path.
+	*/
+	struct CacheEntry {
+		/**
+		 * @brief Nodes of the path from the destination node back to the start node. Empty if the entry is unused.
+		*/
+		std::vector<NodeIndex> path;
+
+		/**
+		 * @brief Regions of the grid the path passes.
+		*/
+		std::vector<int32_t> regions;
+
+		/**
+		 * @brief Version of the grid when the path was cached.
+		*/
+		uint32_t version = 0;
+
+		/**
+		 * @brief Number of the last use, the entry with the lowest number is replaced first.
+		*/
+		uint32_t lastUse = 0;
+	};
+
+	/**
+	 * @brief Position of a node in a cached path.
+	*/
+	struct NodeReference {
+		/**
+		 * @brief Index of the cache entry.
+		*/
+		int32_t entry;
+
+		/**
+		 * @brief Index of the node in the path of the entry.
+		*/
+		int32_t position;
+	};
+
+	/**
+	 * @brief Maximum number of cached paths.
+	*/
+	size_t capacity = DEFAULT_CAPACITY;
+
+	/**
+	 * @brief Cached paths.
+	*/
+	std::vector<CacheEntry> entries;
+
+	/**
+	 * @brief Position of every node in the cached paths by destination and node. The most recently cached path wins if paths share a node.
+	*/
+	std::unordered_map<uint64_t, NodeReference> nodes;
+
+	/**
+	 * @brief Number of the last use of an entry.
+	*/
+	uint32_t useCounter = 0;
+
+	/**
+	 * @brief Number of lookups that returned a cached path.
+	*/
+	size_t hits = 0;
+
+	/**
+	 * @brief Number of lookups that did not return a cached path.
+	*/
+	size_t misses = 0;
+
+	/**
+	 * @brief Bytes of the cached paths accounted to the memory tracker.
+	*/
+	size_t trackedBytes = 0;
+
+	/**
+	 * @brief Creates the key of a node of a path to a destination.
+	 * @param dest - Destination node of the path.
+	 * @param node - Node of the path.
+	 * @return Key in the node map.
+	*/
+	static uint64_t getKey(NodeIndex dest, NodeIndex node) {
+		return ((uint64_t)(uint32_t)dest << 32) | (uint32_t)node;
+	}
+
+	/**
+	 * @brief Checks if no region the cached path passes changed since the path was cached.
+	 * @param grid - Navigation grid.
+	 * @param entry - Cache entry.
+	 * @return Whether the path is still valid.
+	*/
+	bool isCurrent(NavGrid& grid, const CacheEntry& entry);
+
+	/**
+	 * @brief Removes the path of an entry and its nodes from the node map. The entry is replaced first afterwards.
+	 * @param index - Index of the entry.
+	*/
+	void removeEntry(int32_t index);
+
+	/**
+	 * @brief Accounts the current storage of the cached paths in the memory tracker.
+	*/
+	void trackMemory();
+};
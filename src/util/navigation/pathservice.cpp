@@ -0,0 +1,66 @@
+#include "pathservice.h"
+#include <algorithm>
+
+const float PathService::DEFAULT_BUDGET_MS = 2.0f;
+
+/**
+* @brief Destructor of the path service. Removes the queue from the memory tracker.
+*/
+PathService::~PathService() {
+	MemoryTracker::trackDeallocation(TAG_PATHFINDING, trackedBytes);
+}
+
+/**
+* @brief Queues a path request. Requests that are no longer needed are skipped by the caller when they are dequeued.
+* @param uid - Unique identifier of the requesting entity.
+* @param priority - Priority of the request.
+*/
+void PathService::request(unsigned int uid, PATH_PRIORITIES priority) {
+	requests.push_back({ uid, priority, nextSequence++ });
+	std::push_heap(requests.begin(), requests.end());
+
+	// the queue only grows while more requests are made than solved
+	size_t bytes = requests.capacity() * sizeof(PathRequest);
+	if (bytes != trackedBytes) {
+		MemoryTracker::trackDeallocation(TAG_PATHFINDING, trackedBytes);
+		MemoryTracker::trackAllocation(TAG_PATHFINDING, bytes);
+		trackedBytes = bytes;
+	}
+}
+
+/**
+* @brief Starts the time budget of the current frame.
+*/
+void PathService::beginFrame() {
+	frameStart = SDL_GetPerformanceCounter();
+	dequeued = 0;
+}
+
+/**
+* @brief Checks if there is time left to solve another request in the current frame.
+* @return Whether another request may be solved.
+*/
+bool PathService::hasBudget() {
+	if (dequeued == 0 || budgetMS <= 0.0f) return true;
+
+	double elapsedMS = (double)(SDL_GetPerformanceCounter() - frameStart) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+	return elapsedMS < budgetMS;
+}
+
+/**
+* @brief Removes the request with the highest priority from the queue.
+* @param uid - Set to the unique identifier of the requesting entity.
+* @return Whether there was a request.
+*/
+bool PathService::nextRequest(unsigned int& uid) {
+	if (requests.empty()) return false;
+
+	std::pop_heap(requests.begin(), requests.end());
+	uid = requests.back().uid;
+	requests.pop_back();
+	dequeued++;
+
+	// restart the numbering when the queue is empty to keep the order valid
+	if (requests.empty()) nextSequence = 0;
+	return true;
+}
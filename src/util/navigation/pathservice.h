@@ -0,0 +1,144 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "../memorytracker.h"
+
+/**
+ * @brief Priorities of path requests. Urgent requests are solved before normal ones.
+*/
+enum PATH_PRIORITIES {
+	// the requesting agent has no route to follow or its route is blocked
+	PATH_PRIORITY_URGENT,
+	// the requesting agent keeps following its current route until the new one arrives
+	PATH_PRIORITY_NORMAL
+};
+
+/**
+ * @brief Queue of path requests that are solved within a time budget per frame, so many requests at once are spread over several frames instead of causing a spike.
+ * Requests are ordered by priority and then by the order they were made in. Only complete searches are run, at least one request is solved per frame.
+*/
+class PathService {
+public:
+	/**
+	 * @brief Default time budget per frame in milliseconds.
+	*/
+	static const float DEFAULT_BUDGET_MS;
+
+	/**
+	 * @brief Destructor of the path service. Removes the queue from the memory tracker.
+	*/
+	~PathService();
+
+	/**
+	 * @brief Queues a path request. Requests that are no longer needed are skipped by the caller when they are dequeued.
+	 * @param uid - Unique identifier of the requesting entity.
+	 * @param priority - Priority of the request.
+	*/
+	void request(unsigned int uid, PATH_PRIORITIES priority);
+
+	/**
+	 * @brief Starts the time budget of the current frame.
+	*/
+	void beginFrame();
+
+	/**
+	 * @brief Checks if there is time left to solve another request in the current frame.
+	 * @return Whether another request may be solved.
+	*/
+	bool hasBudget();
+
+	/**
+	 * @brief Removes the request with the highest priority from the queue.
+	 * @param uid - Set to the unique identifier of the requesting entity.
+	 * @return Whether there was a request.
+	*/
+	bool nextRequest(unsigned int& uid);
+
+	/**
+	 * @brief Removes every queued request.
+	*/
+	void clear() { requests.clear(); }
+
+	/**
+	 * @brief Sets the time budget per frame. Requests are solved as long as the budget is not used up, a budget of 0 solves every request in the same frame.
+	 * @param budgetMS - Time budget in milliseconds.
+	*/
+	void setBudget(float budgetMS) { this->budgetMS = budgetMS; }
+
+	/**
+	 * @brief Gets the time budget per frame.
+	 * @return Time budget in milliseconds.
+	*/
+	float getBudget() { return budgetMS; }
+
+	/**
+	 * @brief Gets the number of queued requests.
+	 * @return Number of queued requests.
+	*/
+	size_t getQueuedCount() { return requests.size(); }
+
+	/**
+	 * @brief Gets the number of requests dequeued in the current frame.
+	 * @return Number of dequeued requests.
+	*/
+	size_t getDequeuedCount() { return dequeued; }
+private:
+	/**
+	 * @brief Queued path request.
+	*/
+	struct PathRequest {
+		/**
+		 * @brief Unique identifier of the requesting entity.
+		*/
+		unsigned int uid;
+
+		/**
+		 * @brief Priority of the request.
+		*/
+		PATH_PRIORITIES priority;
+
+		/**
+		 * @brief Number of the request, earlier requests are solved first.
+		*/
+		uint32_t sequence;
+
+		/**
+		 * @brief Orders the requests so the most important request is the top of the max heap.
+		 * @param other - Other request.
+		 * @return Whether the request is solved after the other request.
+		*/
+		bool operator< (const PathRequest& other) const {
+			return priority > other.priority || (priority == other.priority && sequence > other.sequence);
+		}
+	};
+
+	/**
+	 * @brief Queued requests as binary heap.
+	*/
+	std::vector<PathRequest> requests;
+
+	/**
+	 * @brief Number of the next request.
+	*/
+	uint32_t nextSequence = 0;
+
+	/**
+	 * @brief Time budget per frame in milliseconds.
+	*/
+	float budgetMS = DEFAULT_BUDGET_MS;
+
+	/**
+	 * @brief Performance counter at the start of the current frame.
+	*/
+	Uint64 frameStart = 0;
+
+	/**
+	 * @brief Number of requests dequeued in the current frame.
+	*/
+	size_t dequeued = 0;
+
+	/**
+	 * @brief Bytes of the queue accounted to the memory tracker.
+	*/
+	size_t trackedBytes = 0;
+};
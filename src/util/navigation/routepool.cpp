@@ -0,0 +1,76 @@
+#include "routepool.h"
+
+/**
+* @brief Destructor of the route pool. Removes the routes from the memory tracker.
+*/
+RoutePool::~RoutePool() {
+	MemoryTracker::trackDeallocation(TAG_PATHFINDING, trackedBytes);
+}
+
+/**
+* @brief Releases the span of a route. Has to be called when the owner of the route is removed.
+* @param handle - Handle of the route. INVALID_ROUTE is ignored.
+*/
+void RoutePool::release(RouteHandle handle) {
+	if (handle == INVALID_ROUTE || handle > spans.size()) return;
+
+	const Span& span = spans[handle - 1];
+	freeBlocks[span.sizeClass].push_back(span.offset);
+	freeSpans.push_back(handle);
+	this->trackMemory();
+}
+
+/**
+* @brief Gets a span with room for a route. The span of the handle is kept if the route fits, otherwise its block is exchanged for one of a larger size class.
+* @param handle - Handle of the previous route of the owner. May be INVALID_ROUTE.
+* @param units - Number of 16 bit words of the route.
+* @return Handle of the span.
+*/
+RouteHandle RoutePool::reserve(RouteHandle handle, size_t units) {
+	uint8_t sizeClass = 0;
+	while (sizeClass < SIZE_CLASSES - 1 && (MIN_SPAN << sizeClass) < units) sizeClass++;
+
+	if (handle != INVALID_ROUTE) {
+		// replanned routes usually fit into the span of the previous route
+		if (spans[handle - 1].sizeClass >= sizeClass) return handle;
+		freeBlocks[spans[handle - 1].sizeClass].push_back(spans[handle - 1].offset);
+	}
+	else if (!freeSpans.empty()) {
+		handle = freeSpans.back();
+		freeSpans.pop_back();
+	}
+	else {
+		spans.push_back({ 0, 0, 0, false });
+		handle = (RouteHandle)spans.size();
+	}
+
+	Span& span = spans[handle - 1];
+	span.sizeClass = sizeClass;
+	if (!freeBlocks[sizeClass].empty()) {
+		span.offset = freeBlocks[sizeClass].back();
+		freeBlocks[sizeClass].pop_back();
+	}
+	else {
+		span.offset = (uint32_t)storage.size();
+		storage.resize(storage.size() + (MIN_SPAN << sizeClass));
+	}
+	this->trackMemory();
+	return handle;
+}
+
+/**
+* @brief Accounts the current storage of the routes in the memory tracker.
+*/
+void RoutePool::trackMemory() {
+	size_t bytes = storage.capacity() * sizeof(uint16_t) + spans.capacity() * sizeof(Span) + freeSpans.capacity() * sizeof(RouteHandle);
+	for (int i = 0; i < SIZE_CLASSES; i++) {
+		bytes += freeBlocks[i].capacity() * sizeof(uint32_t);
+	}
+	if (bytes > trackedBytes) {
+		MemoryTracker::trackAllocation(TAG_PATHFINDING, bytes - trackedBytes);
+	}
+	else if (bytes < trackedBytes) {
+		MemoryTracker::trackDeallocation(TAG_PATHFINDING, trackedBytes - bytes);
+	}
+	trackedBytes = bytes;
+}
@@ -0,0 +1,144 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "navgrid.h"
+#include "../memorytracker.h"
+
+/**
+ * @brief Handle of a route in the route pool.
+*/
+typedef uint32_t RouteHandle;
+
+/**
+ * @brief Handle of no route.
+*/
+const RouteHandle INVALID_ROUTE = 0;
+
+/**
+ * @brief Shared storage of the routes of the enemies. Every route is a span of 16 bit node offsets from the smallest node of the route, routes spanning more nodes than 16 bits can address use two 16 bit words per node.
+ * Spans are allocated in power of two size classes and kept by their route when it is replaced, so replanning does not allocate once the pool has grown.
+*/
+class RoutePool {
+public:
+	/**
+	 * @brief Destructor of the route pool. Removes the routes from the memory tracker.
+	*/
+	~RoutePool();
+
+	/**
+	 * @brief Stores a route. The span of the handle is reused if the route fits into it.
+	 * @tparam Container - Container type of the route.
+	 * @param handle - Handle of the previous route of the owner. INVALID_ROUTE if the owner has no route yet.
+	 * @param route - Nodes of the route.
+	 * @return Handle of the stored route. INVALID_ROUTE if the route is empty and the owner had no route.
+	*/
+	template<typename Container>
+	RouteHandle assign(RouteHandle handle, const Container& route) {
+		if (route.size() == 0) return handle;
+
+		NodeIndex lowest = *route.begin();
+		NodeIndex highest = lowest;
+		for (NodeIndex node : route) {
+			if (node < lowest) lowest = node;
+			if (node > highest) highest = node;
+		}
+
+		bool wide = (uint32_t)(highest - lowest) > UINT16_MAX;
+		handle = this->reserve(handle, route.size() * (wide ? 2 : 1));
+		Span& span = spans[handle - 1];
+		span.base = lowest;
+		span.wide = wide;
+
+		uint16_t* units = &storage[span.offset];
+		for (NodeIndex node : route) {
+			uint32_t offset = (uint32_t)(node - lowest);
+			*units++ = (uint16_t)offset;
+			if (wide) *units++ = (uint16_t)(offset >> 16);
+		}
+		return handle;
+	}
+
+	/**
+	 * @brief Gets a node of a route.
+	 * @param handle - Handle of the route.
+	 * @param index - Index of the node in the route. Has to be smaller than the length of the stored route.
+	 * @return Index of the node.
+	*/
+	NodeIndex getNode(RouteHandle handle, size_t index) const {
+		const Span& span = spans[handle - 1];
+		if (!span.wide) return span.base + (NodeIndex)storage[span.offset + index];
+
+		const uint16_t* units = &storage[span.offset + index * 2];
+		return span.base + (NodeIndex)((uint32_t)units[0] | ((uint32_t)units[1] << 16));
+	}
+
+	/**
+	 * @brief Releases the span of a route. Has to be called when the owner of the route is removed.
+	 * @param handle - Handle of the route. INVALID_ROUTE is ignored.
+	*/
+	void release(RouteHandle handle);
+
+	/**
+	 * @brief Gets the number of stored routes.
+	 * @return Number of routes.
+	*/
+	size_t getRouteCount() { return spans.size() - freeSpans.size(); }
+private:
+	/**
+	 * @brief Number of size classes of the spans.
+	*/
+	static const int SIZE_CLASSES = 28;
+
+	/**
+	 * @brief Number of 16 bit words of the smallest size class.
+	*/
+	static const size_t MIN_SPAN = 16;
+
+	/**
+	 * @brief Part of the storage holding a route.
+	*/
+	struct Span {
+		uint32_t offset;
+		NodeIndex base;
+		uint8_t sizeClass;
+		bool wide;
+	};
+
+	/**
+	 * @brief Node offsets of every route.
+	*/
+	std::vector<uint16_t> storage;
+
+	/**
+	 * @brief Spans by handle - 1.
+	*/
+	std::vector<Span> spans;
+
+	/**
+	 * @brief Handles of released spans.
+	*/
+	std::vector<RouteHandle> freeSpans;
+
+	/**
+	 * @brief Storage offsets of the unused blocks of each size class.
+	*/
+	std::vector<uint32_t> freeBlocks[SIZE_CLASSES];
+
+	/**
+	 * @brief Bytes of the routes accounted to the memory tracker.
+	*/
+	size_t trackedBytes = 0;
+
+	/**
+	 * @brief Gets a span with room for a route. The span of the handle is kept if the route fits, otherwise its block is exchanged for one of a larger size class.
+	 * @param handle - Handle of the previous route of the owner. May be INVALID_ROUTE.
+	 * @param units - Number of 16 bit words of the route.
+	 * @return Handle of the span.
+	*/
+	RouteHandle reserve(RouteHandle handle, size_t units);
+
+	/**
+	 * @brief Accounts the current storage of the routes in the memory tracker.
+	*/
+	void trackMemory();
+};
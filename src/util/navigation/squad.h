@@ -0,0 +1,132 @@
+#pragma once
+#include <cmath>
+#include <vector>
+#include "navgrid.h"
+
+/**
+ * @brief Formations of the followers of a squad, relative to the heading of the leader.
+*/
+enum SQUAD_FORMATIONS {
+	// followers walk behind the leader in single file
+	SQUAD_FORMATION_COLUMN,
+	// followers walk next to the leader, alternating between both sides
+	SQUAD_FORMATION_LINE,
+	// followers spread diagonally behind the leader, alternating between both sides
+	SQUAD_FORMATION_WEDGE
+};
+
+/**
+ * @brief Group of enemies moving to the same destination. Only the leader searches a path, the followers keep their formation slot around the leader.
+ * Followers that can not see their slot walk to the leader or along the trail of nodes the leader passed, so they only search a path of their own if they lost the trail.
+*/
+struct Squad {
+	/**
+	 * @brief Squad index of enemies that belong to no squad.
+	*/
+	static const int NO_SQUAD = -1;
+
+	/**
+	 * @brief Maximum number of nodes of the trail of the leader.
+	*/
+	static const size_t TRAIL_LENGTH = 32;
+
+	/**
+	 * @brief Unique identifier of the leader. 0 if the squad is unused.
+	*/
+	unsigned int leader = 0;
+
+	/**
+	 * @brief Unique identifiers of the followers.
+	*/
+	std::vector<unsigned int> followers;
+
+	/**
+	 * @brief Formation of the followers.
+	*/
+	SQUAD_FORMATIONS formation = SQUAD_FORMATION_COLUMN;
+
+	/**
+	 * @brief Distance between the formation slots in pixels.
+	*/
+	float spacing = 32.0f;
+
+	/**
+	 * @brief Normalized x-direction the leader moved in last.
+	*/
+	float headingX = 1.0f;
+
+	/**
+	 * @brief Normalized y-direction the leader moved in last.
+	*/
+	float headingY = 0.0f;
+
+	/**
+	 * @brief X-position of the leader in the last frame.
+	*/
+	float leaderX = 0.0f;
+
+	/**
+	 * @brief Y-position of the leader in the last frame.
+	*/
+	float leaderY = 0.0f;
+
+	/**
+	 * @brief Nodes the leader entered, the last node is the current node of the leader.
+	*/
+	std::vector<NodeIndex> trail;
+
+	/**
+	 * @brief Updates the heading and the trail after the leader moved.
+	 * @param x - X-position of the leader.
+	 * @param y - Y-position of the leader.
+	 * @param node - Current node of the leader.
+	*/
+	void moveLeader(float x, float y, NodeIndex node) {
+		float deltaX = x - leaderX;
+		float deltaY = y - leaderY;
+		float length = std::sqrt(deltaX * deltaX + deltaY * deltaY);
+
+		// standing leaders keep the heading, so the formation does not rotate
+		if (length > 0.5f) {
+			headingX = deltaX / length;
+			headingY = deltaY / length;
+		}
+		leaderX = x;
+		leaderY = y;
+
+		if (node != INVALID_NODE && (trail.empty() || trail.back() != node)) {
+			if (trail.size() == TRAIL_LENGTH) trail.erase(trail.begin());
+			trail.push_back(node);
+		}
+	}
+
+	/**
+	 * @brief Gets the offset of a formation slot from the leader, rotated into the heading of the leader.
+	 * @param slot - Index of the follower.
+	 * @param x - Set to the x-offset in pixels.
+	 * @param y - Set to the y-offset in pixels.
+	*/
+	void getSlotOffset(int slot, float& x, float& y) {
+		// offset in slots along (forward) and across (right) the heading
+		float forward = 0.0f;
+		float right = 0.0f;
+		float side = (slot % 2 == 0) ? 1.0f : -1.0f;
+		int row = slot / 2 + 1;
+
+		switch (formation) {
+			case SQUAD_FORMATION_LINE:
+				right = side * row;
+				break;
+			case SQUAD_FORMATION_WEDGE:
+				forward = -(float)row;
+				right = side * row;
+				break;
+			case SQUAD_FORMATION_COLUMN:
+			default:
+				forward = -(float)(slot + 1);
+				break;
+		}
+		x = (forward * headingX - right * headingY) * spacing;
+		y = (forward * headingY + right * headingX) * spacing;
+	}
+};
@@ -13,7 +13,7 @@ void ObjectPool::init(const char* entityTag) {
 			pos->setPosition(0,0);
 		}
 		else {
-			SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Entity Initialization error", "Could not add position component to entity in object pool.", NULL);
+			Log::error("Entity Initialization error", "Could not add position component to entity in object pool.");
 		}
 	}
 }
@@ -34,7 +34,7 @@ Entity ObjectPool::getNext() {
 	}
 
 	if (result.uid == 0) {
-		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Object Pool error", "No free entity in object pool.", NULL);
+		Log::error("Object Pool error", "No free entity in object pool.");
 	}
 
 	return result;
@@ -56,4 +56,19 @@ bool ObjectPool::collect(Entity e) {
 		}
 	}
 	return false;
+}
+
+/**
+* @brief Checks if an entity belongs to the pool.
+* @param e - Entity to check.
+* @return Whether the entity is an object of the pool.
+*/
+bool ObjectPool::contains(Entity e) {
+	for (size_t i = 0; i < POOL_SIZE; i++)
+	{
+		if (entites[i].uid == e.uid) {
+			return true;
+		}
+	}
+	return false;
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "../componentmanager.h"
 #include "../components/position.h"
 #include "SDL.h"
+#include "log.h"
 /**
  * @brief Object(Entity) pool of precreated objects. Can be used to avoid the overhead of creating/destroying objects.
 */
@@ -34,6 +35,13 @@ public:
 	 * @return Whether the object was succesfully collected.
 	*/
 	bool collect(Entity e);
+
+	/**
+	 * @brief Checks if an entity belongs to the pool.
+	 * @param e - Entity to check.
+	 * @return Whether the entity is an object of the pool.
+	*/
+	bool contains(Entity e);
 	/**
 	 * @brief Gets the size of the object pool.
 	 * @return Size of the object pool.
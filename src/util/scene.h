@@ -1,5 +1,6 @@
 #pragma once
 #include <iostream>
+#include "ailevelofdetail.h"
 
 /**
  * @brief Struct representing a game scene.
@@ -57,6 +58,18 @@ public:
 	 * @return The file path to the background music.
 	*/
 	const char* getBGMFilePath() { return bgmFilePath; }
+
+	/**
+	 * @brief Sets the level of detail of the enemy movement in the scene. Applied when the scene is loaded.
+	 * @param settings - Distances and update intervals of the tiers.
+	*/
+	void setAILevelOfDetail(AILevelOfDetail settings) { this->aiLevelOfDetail = settings; }
+
+	/**
+	 * @brief Gets the level of detail of the enemy movement in the scene.
+	 * @return Distances and update intervals of the tiers.
+	*/
+	AILevelOfDetail getAILevelOfDetail() { return aiLevelOfDetail; }
 private:
 	/**
 	 * @brief File path to the tileset.
@@ -78,4 +91,8 @@ private:
 	 * @brief Function pointer to the initialization function of the scene.
 	*/
 	sceneInitFunction sceneInit;
+	/**
+	 * @brief Level of detail of the enemy movement in the scene.
+	*/
+	AILevelOfDetail aiLevelOfDetail;
 };
\ No newline at end of file
@@ -0,0 +1,144 @@
+#include "sleepgrid.h"
+#include <algorithm>
+
+/**
+* @brief Destructor of the grid. Removes the cells from the memory tracker.
+*/
+SleepGrid::~SleepGrid() {
+	MemoryTracker::trackDeallocation(TAG_COMPONENTS, trackedBytes);
+}
+
+/**
+* @brief Initializes the cells of the grid and removes every entity.
+* @param worldWidth - Width of the world in pixels.
+* @param worldHeight - Height of the world in pixels.
+*/
+void SleepGrid::init(int worldWidth, int worldHeight) {
+	cellsX = std::max((worldWidth + CELL_SIZE - 1) / CELL_SIZE, 1);
+	cellsY = std::max((worldHeight + CELL_SIZE - 1) / CELL_SIZE, 1);
+	std::vector<std::vector<unsigned int>>((size_t)cellsX * cellsY).swap(cells);
+	count = 0;
+	maxReach = 0;
+	this->trackMemory(cells.capacity() * sizeof(std::vector<unsigned int>));
+}
+
+/**
+* @brief Adds a sleeping entity.
+* @param uid - Unique identifier of the entity.
+* @param position - Position of the entity in pixels. Positions outside of the world are added to the border cells.
+* @param reach - Distance in pixels the entity reaches out of its position, e.g. with its collider. The collected areas are extended by the largest reach of the sleeping entities.
+* @return Whether the entity was added. False if the grid was not initialized.
+*/
+bool SleepGrid::add(unsigned int uid, SDL_Point position, int reach) {
+	if (cells.empty()) return false;
+
+	if (count == 0) maxReach = 0;
+	maxReach = std::max(maxReach, reach);
+
+	std::vector<unsigned int>& cell = cells[getCellCoordinate(position.y, cellsY) * cellsX + getCellCoordinate(position.x, cellsX)];
+	size_t capacity = cell.capacity();
+	cell.push_back(uid);
+	count++;
+
+	if (cell.capacity() != capacity) {
+		this->trackMemory(trackedBytes + (cell.capacity() - capacity) * sizeof(unsigned int));
+	}
+	return true;
+}
+
+/**
+* @brief Removes a sleeping entity. Every cell is searched if the entity is not found in the cell of the position.
+* @param uid - Unique identifier of the entity.
+* @param position - Position of the entity when it was added.
+* @return Whether the entity was found.
+*/
+bool SleepGrid::remove(unsigned int uid, SDL_Point position) {
+	if (count == 0) return false;
+
+	size_t cell = (size_t)getCellCoordinate(position.y, cellsY) * cellsX + getCellCoordinate(position.x, cellsX);
+	if (this->removeFromCell(cell, uid)) return true;
+
+	// the position was changed while the entity was sleeping
+	for (size_t i = 0; i < cells.size(); i++) {
+		if (i != cell && this->removeFromCell(i, uid)) return true;
+	}
+	return false;
+}
+
+/**
+* @brief Removes the entities of every cell overlapping the area extended by the largest reach of the sleeping entities.
+* @param area - Area in pixels.
+* @param uids - Buffer the unique identifiers of the removed entities are appended to.
+*/
+void SleepGrid::collect(SDL_Rect area, std::vector<unsigned int>& uids) {
+	if (count == 0) return;
+
+	// entities are stored by their position, but may overlap the area with their collider from a neighbouring cell
+	int minX = getCellCoordinate(area.x - maxReach, cellsX);
+	int minY = getCellCoordinate(area.y - maxReach, cellsY);
+	int maxX = getCellCoordinate(area.x + area.w + maxReach, cellsX);
+	int maxY = getCellCoordinate(area.y + area.h + maxReach, cellsY);
+
+	for (int y = minY; y <= maxY; y++) {
+		for (int x = minX; x <= maxX; x++) {
+			std::vector<unsigned int>& cell = cells[(size_t)y * cellsX + x];
+			uids.insert(uids.end(), cell.begin(), cell.end());
+			count -= cell.size();
+			cell.clear();
+		}
+	}
+}
+
+/**
+* @brief Removes every entity.
+* @param uids - Buffer the unique identifiers of the removed entities are appended to.
+*/
+void SleepGrid::collectAll(std::vector<unsigned int>& uids) {
+	for (size_t i = 0; i < cells.size() && count > 0; i++) {
+		uids.insert(uids.end(), cells[i].begin(), cells[i].end());
+		count -= cells[i].size();
+		cells[i].clear();
+	}
+}
+
+/**
+* @brief Gets the cell column or row of a coordinate, clamped to the grid.
+* @param value - Coordinate in pixels.
+* @param cellCount - Number of cells along the axis.
+* @return Column or row of the cell.
+*/
+int SleepGrid::getCellCoordinate(int value, int cellCount) {
+	if (value < 0) return 0;
+	return std::min(value / CELL_SIZE, cellCount - 1);
+}
+
+/**
+* @brief Removes an entity from a cell.
+* @param cell - Index of the cell.
+* @param uid - Unique identifier of the entity.
+* @return Whether the entity was found in the cell.
+*/
+bool SleepGrid::removeFromCell(size_t cell, unsigned int uid) {
+	std::vector<unsigned int>& entities = cells[cell];
+	for (size_t i = 0; i < entities.size(); i++) {
+		if (entities[i] == uid) {
+			entities[i] = entities.back();
+			entities.pop_back();
+			count--;
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+* @brief Accounts a change of the storage of the cells in the memory tracker.
+* @param bytes - Current size of the storage in bytes.
+*/
+void SleepGrid::trackMemory(size_t bytes) {
+	if (bytes != trackedBytes) {
+		MemoryTracker::trackDeallocation(TAG_COMPONENTS, trackedBytes);
+		MemoryTracker::trackAllocation(TAG_COMPONENTS, bytes);
+		trackedBytes = bytes;
+	}
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <vector>
+#include "SDL.h"
+#include "memorytracker.h"
+
+/**
+ * @brief Uniform grid of the sleeping entities by their position. Used to find the sleeping entities close to the camera or to moving colliders without iterating every sleeping entity.
+*/
+class SleepGrid {
+public:
+	/**
+	 * @brief Width and height of a cell in pixels.
+	*/
+	static const int CELL_SIZE = 128;
+
+	/**
+	 * @brief Destructor of the grid. Removes the cells from the memory tracker.
+	*/
+	~SleepGrid();
+
+	/**
+	 * @brief Initializes the cells of the grid and removes every entity.
+	 * @param worldWidth - Width of the world in pixels.
+	 * @param worldHeight - Height of the world in pixels.
+	*/
+	void init(int worldWidth, int worldHeight);
+
+	/**
+	 * @brief Adds a sleeping entity.
+	 * @param uid - Unique identifier of the entity.
+	 * @param position - Position of the entity in pixels. Positions outside of the world are added to the border cells.
+	 * @param reach - Distance in pixels the entity reaches out of its position, e.g. with its collider. The collected areas are extended by the largest reach of the sleeping entities.
+	 * @return Whether the entity was added. False if the grid was not initialized.
+	*/
+	bool add(unsigned int uid, SDL_Point position, int reach = 0);
+
+	/**
+	 * @brief Removes a sleeping entity. Every cell is searched if the entity is not found in the cell of the position.
+	 * @param uid - Unique identifier of the entity.
+	 * @param position - Position of the entity when it was added.
+	 * @return Whether the entity was found.
+	*/
+	bool remove(unsigned int uid, SDL_Point position);
+
+	/**
+	 * @brief Removes the entities of every cell overlapping the area extended by the largest reach of the sleeping entities.
+	 * @param area - Area in pixels.
+	 * @param uids - Buffer the unique identifiers of the removed entities are appended to.
+	*/
+	void collect(SDL_Rect area, std::vector<unsigned int>& uids);
+
+	/**
+	 * @brief Removes every entity.
+	 * @param uids - Buffer the unique identifiers of the removed entities are appended to.
+	*/
+	void collectAll(std::vector<unsigned int>& uids);
+
+	/**
+	 * @brief Gets the number of sleeping entities in the grid.
+	 * @return Number of entities.
+	*/
+	size_t getCount() { return count; }
+private:
+	/**
+	 * @brief Sleeping entities per cell.
+	*/
+	std::vector<std::vector<unsigned int>> cells;
+
+	/**
+	 * @brief Number of cells per row.
+	*/
+	int cellsX = 0;
+
+	/**
+	 * @brief Number of cells per column.
+	*/
+	int cellsY = 0;
+
+	/**
+	 * @brief Number of sleeping entities in the grid.
+	*/
+	size_t count = 0;
+
+	/**
+	 * @brief Largest reach of the entities added since the grid was empty the last time.
+	*/
+	int maxReach = 0;
+
+	/**
+	 * @brief Bytes of the cells accounted to the memory tracker.
+	*/
+	size_t trackedBytes = 0;
+
+	/**
+	 * @brief Gets the cell column or row of a coordinate, clamped to the grid.
+	 * @param value - Coordinate in pixels.
+	 * @param cellCount - Number of cells along the axis.
+	 * @return Column or row of the cell.
+	*/
+	static int getCellCoordinate(int value, int cellCount);
+
+	/**
+	 * @brief Removes an entity from a cell.
+	 * @param cell - Index of the cell.
+	 * @param uid - Unique identifier of the entity.
+	 * @return Whether the entity was found in the cell.
+	*/
+	bool removeFromCell(size_t cell, unsigned int uid);
+
+	/**
+	 * @brief Accounts a change of the storage of the cells in the memory tracker.
+	 * @param bytes - Current size of the storage in bytes.
+	*/
+	void trackMemory(size_t bytes);
+};
@@ -1,9 +1,48 @@
 #pragma once
-#include <map>
+#include <cstdint>
 #include <vector>
 #include "SDL.h"
 #include "../util/texture.h"
+#include "memorytracker.h"
 #include <iostream>
+#include "log.h"
+/**
+ * @brief Read only view of the tiles of a tile layer, row by row. Empty for indices without a tile layer.
+*/
+struct TileLayer {
+	/**
+	 * @brief Tiles of the layer if the tilemap stores its tiles with 16 bits.
+	*/
+	const uint16_t* narrowTiles = nullptr;
+
+	/**
+	 * @brief Tiles of the layer if the tilemap stores its tiles with 32 bits.
+	*/
+	const unsigned int* wideTiles = nullptr;
+
+	/**
+	 * @brief Number of tiles of the layer.
+	*/
+	size_t tileCount = 0;
+
+	/**
+	 * @brief Gets a tile of the layer.
+	 * @param index - Index of the tile. Has to be smaller than the size of the layer.
+	 * @return Tile at the index. 0 for an empty tile.
+	*/
+	unsigned int operator[](size_t index) const {
+		return (narrowTiles != nullptr) ? narrowTiles[index] : wideTiles[index];
+	}
+
+	/**
+	 * @brief Gets the number of tiles of the layer.
+	 * @return Number of tiles.
+	*/
+	size_t size() const {
+		return tileCount;
+	}
+};
+
 /**
  * @brief Struct to store all data for the tilemap.
 */
@@ -25,13 +64,52 @@ public:
 	}
 
 	/**
-	 * @brief Adds a layer to the tilemap.
+	 * @brief Destructor of the tilemap. Removes the tilemap data from the memory tracker.
+	*/
+	~Tilemap() {
+		MemoryTracker::trackDeallocation(TAG_TILEMAP, trackedBytes);
+		for (size_t i = 0; i < tilemapColliderIndex + tilemapObjectIndex; i++) {
+			MemoryTracker::trackDeallocation(TAG_TILEMAP, sizeof(SDL_Rect));
+		}
+	}
+
+	/**
+	 * @brief Adds a layer to the tilemap. Missing tiles are empty, tiles beyond the size of the tilemap are ignored.
 	 * @param layer - Index of layer to add.
 	 * @param vector - Layer data stored in an vector.
 	*/
-	void addLayer(size_t layer, std::vector<unsigned int> vector) {
-		layers.insert(std::pair<size_t, std::vector<unsigned int>>(layer, vector));
-		layerCount++;
+	void addLayer(size_t layer, const std::vector<unsigned int>& vector) {
+		if (layer >= layerSlots.size()) {
+			layerSlots.resize(layer + 1, -1);
+		}
+		if (layerSlots[layer] == -1) {
+			layerSlots[layer] = (int)layerCount;
+			layerCount++;
+		}
+
+		size_t cells = (size_t)tilesPerRow * tilesPerCol;
+		size_t count = (vector.size() < cells) ? vector.size() : cells;
+		for (size_t i = 0; i < count && !wide; i++) {
+			if (vector[i] > UINT16_MAX) this->widenTiles();
+		}
+		if (wide) {
+			wideTiles.resize(cells * layerCount, 0);
+		}
+		else {
+			tiles.resize(cells * layerCount, 0);
+		}
+
+		size_t start = (size_t)layerSlots[layer] * cells;
+		for (size_t i = 0; i < cells; i++) {
+			unsigned int tile = (i < count) ? vector[i] : 0;
+			if (wide) {
+				wideTiles[start + i] = tile;
+			}
+			else {
+				tiles[start + i] = (uint16_t)tile;
+			}
+		}
+		this->trackMemory();
 	}
 
 	/**
@@ -39,6 +117,7 @@ public:
 	 * @param obj - Collider to add.
 	*/
 	void addTilemapCollider(SDL_Rect obj) {
+		MemoryTracker::trackAllocation(TAG_TILEMAP, sizeof(SDL_Rect));
 		tilemapCollider.insert(tilemapCollider.begin() + tilemapColliderIndex, obj);
 		tilemapColliderIndex++;
 	}
@@ -48,6 +127,7 @@ public:
 	 * @param obj - Object to add.
 	*/
 	void addTilemapObject(SDL_Rect obj) {
+		MemoryTracker::trackAllocation(TAG_TILEMAP, sizeof(SDL_Rect));
 		tilemapObjects.insert(tilemapObjects.begin() + tilemapObjectIndex, obj);
 		tilemapObjectIndex++;
 	}
@@ -57,7 +137,7 @@ public:
 	 * @param layer - Index of layer to print.
 	*/
 	void print(size_t layer) {
-		std::vector<unsigned int> vec = layers[layer];
+		TileLayer vec = getLayer(layer);
 		for (size_t i = 0; i < vec.size(); i++)
 		{
 			std::cout << vec[i] << std::endl;
@@ -67,13 +147,48 @@ public:
 	/**
 	 * @brief Gets the tilemap data of layer with certain index.
 	 * @param layer - Index of layer to get the data from
-	 * @return Data of tilemap layer. Returns nullptr if given layer index is not allowed.
+	 * @return View of the data of tilemap layer. Returns an empty layer if given layer index is not allowed.
 	*/
-	std::vector<unsigned int> getLayer(size_t layer) {
-		if (layer < layerCount) {
-			return layers[layer];
+	TileLayer getLayer(size_t layer) const {
+		TileLayer result;
+		if (layer >= layerCount || layer >= layerSlots.size() || layerSlots[layer] == -1) {
+			return result;
+		}
+		size_t cells = (size_t)tilesPerRow * tilesPerCol;
+		size_t start = (size_t)layerSlots[layer] * cells;
+		if (wide) {
+			result.wideTiles = wideTiles.data() + start;
+		}
+		else {
+			result.narrowTiles = tiles.data() + start;
 		}
-		return std::vector<unsigned int>();
+		result.tileCount = cells;
+		return result;
+	}
+
+	/**
+	 * @brief Changes a tile of a layer.
+	 * @param layer - Index of the layer.
+	 * @param index - Index of the tile in the layer.
+	 * @param tile - New tile. 0 for an empty tile.
+	 * @return Whether the layer contains the tile.
+	*/
+	bool setTile(size_t layer, size_t index, unsigned int tile) {
+		if (index >= getLayer(layer).size()) {
+			return false;
+		}
+		if (tile > UINT16_MAX && !wide) {
+			this->widenTiles();
+		}
+
+		size_t position = (size_t)layerSlots[layer] * tilesPerRow * tilesPerCol + index;
+		if (wide) {
+			wideTiles[position] = tile;
+		}
+		else {
+			tiles[position] = (uint16_t)tile;
+		}
+		return true;
 	}
 
 	/**
@@ -178,7 +293,7 @@ public:
 	*/
 	void setCollisionLayerIndex(int index) {
 		if (hasCollisionLayer()) {
-			SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Scene error", "Multiple collision layers detected.", NULL);
+			Log::error("Scene error", "Multiple collision layers detected.");
 		}
 		collisionLayerIndex = index;
 	}
@@ -189,7 +304,7 @@ public:
 	*/
 	void setTilemapObjectLayerIndex(int index) {
 		if (hasTilemapObjectLayer()) {
-			SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Scene error", "Multiple object layers detected.", NULL);
+			Log::error("Scene error", "Multiple object layers detected.");
 		}
 		tilemapObjectLayerIndex = index;
 	}
@@ -244,9 +359,29 @@ private:
 	size_t layerCount;
 
 	/**
-	 * @brief Data of each tile layer stored in a map with layer index as the key.
+	 * @brief Tiles of every tile layer stored with 16 bits, layer after layer and row by row. Empty if a tile does not fit into 16 bits.
+	*/
+	std::vector<uint16_t> tiles = {};
+
+	/**
+	 * @brief Tiles of every tile layer stored with 32 bits. Only used if a tile does not fit into 16 bits.
+	*/
+	std::vector<unsigned int> wideTiles = {};
+
+	/**
+	 * @brief Whether the tiles are stored with 32 bits.
+	*/
+	bool wide = false;
+
+	/**
+	 * @brief Position of each layer in the tile storage by layer index. -1 for layers without tiles.
 	*/
-	std::map<size_t, std::vector<unsigned int> > layers = {};
+	std::vector<int> layerSlots = {};
+
+	/**
+	 * @brief Bytes of the tile layers accounted to the memory tracker.
+	*/
+	size_t trackedBytes = 0;
 
 	/**
 	 * @brief Data of each tilemap collider.
@@ -278,6 +413,30 @@ private:
 	*/
 	int tilemapObjectLayerIndex = -1;
 
+	/**
+	 * @brief Moves the tiles into the 32 bit storage.
+	*/
+	void widenTiles() {
+		wideTiles.assign(tiles.begin(), tiles.end());
+		tiles.clear();
+		tiles.shrink_to_fit();
+		wide = true;
+		this->trackMemory();
+	}
+
+	/**
+	 * @brief Accounts the current storage of the tile layers in the memory tracker.
+	*/
+	void trackMemory() {
+		size_t bytes = tiles.capacity() * sizeof(uint16_t) + wideTiles.capacity() * sizeof(unsigned int) + layerSlots.capacity() * sizeof(int);
+		if (bytes > trackedBytes) {
+			MemoryTracker::trackAllocation(TAG_TILEMAP, bytes - trackedBytes);
+		}
+		else if (bytes < trackedBytes) {
+			MemoryTracker::trackDeallocation(TAG_TILEMAP, trackedBytes - bytes);
+		}
+		trackedBytes = bytes;
+	}
 };
 
 /**
@@ -292,17 +451,49 @@ public:
 	Tileset(Texture tilesetTexture) {
 		this->tilesetTexture = tilesetTexture;
 		this->tilesetDestinationRect = {};
-		this->tilesetSourceRect = {};
 	}
 
 	/**
-	 * @brief Initializes source rectangle of the tileset with tile width and tile height.
+	 * @brief Destructor of the tileset. Removes the source rectangles from the memory tracker.
+	*/
+	~Tileset() {
+		MemoryTracker::trackDeallocation(TAG_TILEMAP, tileRects.capacity() * sizeof(SDL_Rect));
+	}
+
+	/**
+	 * @brief Computes the source rectangle of every tile of the tileset. Tiles are numbered row by row, starting at 1.
 	 * @param width - Width of each tile in tileset.
 	 * @param height - Height of each tile in tileset.
 	*/
-	void initSourceRect(unsigned int width, unsigned int height) {
-		tilesetSourceRect.w = width;
-		tilesetSourceRect.h = height;
+	void initTileRects(unsigned int width, unsigned int height) {
+		MemoryTracker::trackDeallocation(TAG_TILEMAP, tileRects.capacity() * sizeof(SDL_Rect));
+		tileRects.clear();
+
+		// tile 0 is the empty tile
+		tileRects.push_back({ 0, 0, 0, 0 });
+		if (width > 0 && height > 0 && tilesetTexture.textureWidth > 0 && tilesetTexture.textureHeight > 0) {
+			int columns = tilesetTexture.textureWidth / (int)width;
+			int rows = tilesetTexture.textureHeight / (int)height;
+			tileRects.reserve((size_t)columns * rows + 1);
+			for (int y = 0; y < rows; y++) {
+				for (int x = 0; x < columns; x++) {
+					tileRects.push_back({ x * (int)width, y * (int)height, (int)width, (int)height });
+				}
+			}
+		}
+		MemoryTracker::trackAllocation(TAG_TILEMAP, tileRects.capacity() * sizeof(SDL_Rect));
+	}
+
+	/**
+	 * @brief Gets the source rectangle of a tile.
+	 * @param tile - Tile of the tilemap.
+	 * @return Source rectangle of the tile in the tileset texture. nullptr for empty tiles and tiles outside of the tileset.
+	*/
+	const SDL_Rect* getTileRect(unsigned int tile) const {
+		if (tile == 0 || tile >= tileRects.size()) {
+			return nullptr;
+		}
+		return &tileRects[tile];
 	}
 
 	/**
@@ -315,16 +506,6 @@ public:
 		tilesetDestinationRect.h = height;
 	}
 
-	/**
-	 * @brief Sets the x/y position of the source rectangle. Determines which tile will be displayed of the tileset.
-	 * @param x - X position of the source rectangle.
-	 * @param y - Y position of the source rectangle.
-	*/
-	void setSourceRect(unsigned int x, unsigned int y) {
-		tilesetSourceRect.x = x;
-		tilesetSourceRect.y = y;
-	}
-
 	/**
 	 * @brief Sets the x/y position of the destination rectangle. Determines where in the game window the tile will be displayed.
 	 * @param x - X position of the destination rectangle.
@@ -343,14 +524,6 @@ public:
 		return tilesetTexture;
 	}
 
-	/**
-	 * @brief Gets the source rectangle of the tileset texture.
-	 * @return Source rectangle of the tileset texture.
-	*/
-	SDL_Rect* getSourceRect() {
-		return &tilesetSourceRect;
-	}
-
 	/**
 	 * @brief Gets the destination rectangle of the tileset texture.
 	 * @return Destination rectangle of the tileset texture.
@@ -365,9 +538,9 @@ private:
 	Texture tilesetTexture;
 
 	/**
-	 * @brief The source rectangle of the tileset texture. Determins which part of the tileset will be displayed.
+	 * @brief Source rectangles of the tiles by tile, computed once when the tilemap is set.
 	*/
-	SDL_Rect tilesetSourceRect;
+	std::vector<SDL_Rect> tileRects;
 
 	/**
 	 * @brief The destination rectangle of the tileset texture. Determins where the part of the tileset will be displayed in the game window.
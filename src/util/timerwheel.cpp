@@ -0,0 +1,237 @@
+#include "timerwheel.h"
+#include <algorithm>
+
+const uint32_t TimerWheel::MAX_DELAY;
+const int32_t TimerWheel::NO_TIMER;
+
+/**
+* @brief Creates an empty wheel.
+*/
+TimerWheel::TimerWheel() {
+	std::fill(slots, slots + sizeof(slots) / sizeof(slots[0]), NO_TIMER);
+}
+
+/**
+* @brief Destructor of the wheel. Removes the timers from the memory tracker.
+*/
+TimerWheel::~TimerWheel() {
+	MemoryTracker::trackDeallocation(TAG_COMPONENTS, trackedBytes);
+}
+
+/**
+* @brief Removes every timer and fired event and sets the current time of the wheel.
+* @param now - Current time in milliseconds.
+*/
+void TimerWheel::reset(uint32_t now) {
+	std::fill(slots, slots + sizeof(slots) / sizeof(slots[0]), NO_TIMER);
+	freeTimer = NO_TIMER;
+	for (size_t i = timers.size(); i > 0; i--) {
+		// handles of the removed timers stay invalid
+		this->release((int32_t)(i - 1));
+	}
+	count = 0;
+	firedEvents.clear();
+	currentTick = now + 1;
+}
+
+/**
+* @brief Schedules a timer.
+* @param delayMS - Milliseconds from the last advance until the timer fires. Timers with a delay of 0 fire at the next advance.
+* @param type - Type of the fired event.
+* @param uid - Unique identifier of the entity the timer belongs to. 0 if the timer belongs to no entity.
+* @param callback - Function called by the owner of the wheel when the timer fires. May be nullptr.
+* @return Handle of the timer.
+*/
+TimerHandle TimerWheel::schedule(uint32_t delayMS, TIMER_EVENTS type, unsigned int uid, timerFunction callback) {
+	int32_t index = freeTimer;
+	if (index == NO_TIMER) {
+		size_t capacity = timers.capacity();
+		index = (int32_t)timers.size();
+		timers.push_back({ 0, 1, NO_TIMER, NO_TIMER, NO_TIMER, type, 0, nullptr });
+		if (timers.capacity() != capacity) this->trackMemory();
+	}
+	else {
+		freeTimer = timers[index].next;
+	}
+
+	// the last advance processed the millisecond before the current tick
+	if (delayMS > MAX_DELAY) delayMS = MAX_DELAY;
+	Timer& timer = timers[index];
+	timer.expires = currentTick + ((delayMS > 0) ? delayMS - 1 : 0);
+	timer.type = type;
+	timer.uid = uid;
+	timer.callback = callback;
+	this->insert(index);
+	count++;
+	return ((TimerHandle)timer.generation << 32) | (uint32_t)index;
+}
+
+/**
+* @brief Cancels a timer.
+* @param handle - Handle of the timer.
+* @return Whether the timer was scheduled.
+*/
+bool TimerWheel::cancel(TimerHandle handle) {
+	int32_t index = this->getTimer(handle);
+	if (index == NO_TIMER) return false;
+
+	this->unlink(index);
+	this->release(index);
+	count--;
+	return true;
+}
+
+/**
+* @brief Checks if a timer is scheduled.
+* @param handle - Handle of the timer.
+* @return Whether the timer has neither fired nor was canceled.
+*/
+bool TimerWheel::isScheduled(TimerHandle handle) {
+	return this->getTimer(handle) != NO_TIMER;
+}
+
+/**
+* @brief Advances the wheel and appends the events of the expired timers to the fired events.
+* @param now - Current time in milliseconds.
+* @return Number of fired timers.
+*/
+size_t TimerWheel::advance(uint32_t now) {
+	size_t firedCount = 0;
+	size_t capacity = firedEvents.capacity();
+
+	while ((int32_t)(now - currentTick) >= 0) {
+		// nothing can expire, so the wheel jumps to the current time
+		if (count == 0) {
+			currentTick = now + 1;
+			break;
+		}
+
+		uint32_t slot = currentTick & (FIRST_LEVEL_SLOTS - 1);
+		if (slot == 0) {
+			for (int level = 1; level < LEVELS; level++) {
+				uint32_t shift = FIRST_LEVEL_BITS + LEVEL_BITS * (level - 1);
+				if (this->cascade(level, (currentTick >> shift) & (LEVEL_SLOTS - 1)) != 0) break;
+			}
+		}
+
+		while (slots[slot] != NO_TIMER) {
+			int32_t index = slots[slot];
+			Timer& timer = timers[index];
+			firedEvents.push_back({ ((TimerHandle)timer.generation << 32) | (uint32_t)index, timer.type, timer.uid, timer.callback });
+			this->unlink(index);
+			this->release(index);
+			count--;
+			firedCount++;
+		}
+		currentTick++;
+	}
+
+	if (firedEvents.capacity() != capacity) this->trackMemory();
+	return firedCount;
+}
+
+/**
+* @brief Gets the index of the timer of a handle.
+* @param handle - Handle of the timer.
+* @return Index of the timer. NO_TIMER if the timer is not scheduled.
+*/
+int32_t TimerWheel::getTimer(TimerHandle handle) {
+	uint32_t index = (uint32_t)handle;
+	if (handle == INVALID_TIMER || index >= timers.size()) return NO_TIMER;
+
+	const Timer& timer = timers[index];
+	if (timer.generation != (uint32_t)(handle >> 32) || timer.slot == NO_TIMER) return NO_TIMER;
+	return (int32_t)index;
+}
+
+/**
+* @brief Links a timer into the slot of its expiration relative to the current tick.
+* @param index - Index of the timer.
+*/
+void TimerWheel::insert(int32_t index) {
+	Timer& timer = timers[index];
+	uint32_t delta = timer.expires - currentTick;
+	int32_t slot;
+
+	if (delta < FIRST_LEVEL_SLOTS) {
+		slot = (int32_t)(timer.expires & (FIRST_LEVEL_SLOTS - 1));
+	}
+	else {
+		// the level whose range covers the delay
+		int level = 1;
+		while (level < LEVELS - 1 && delta >= (1u << (FIRST_LEVEL_BITS + LEVEL_BITS * level))) {
+			level++;
+		}
+		uint32_t shift = FIRST_LEVEL_BITS + LEVEL_BITS * (level - 1);
+		slot = (int32_t)(FIRST_LEVEL_SLOTS + LEVEL_SLOTS * (level - 1) + ((timer.expires >> shift) & (LEVEL_SLOTS - 1)));
+	}
+
+	timer.slot = slot;
+	timer.previous = NO_TIMER;
+	timer.next = slots[slot];
+	if (timer.next != NO_TIMER) timers[timer.next].previous = index;
+	slots[slot] = index;
+}
+
+/**
+* @brief Unlinks a timer from its slot.
+* @param index - Index of the timer.
+*/
+void TimerWheel::unlink(int32_t index) {
+	Timer& timer = timers[index];
+	if (timer.previous != NO_TIMER) {
+		timers[timer.previous].next = timer.next;
+	}
+	else {
+		slots[timer.slot] = timer.next;
+	}
+	if (timer.next != NO_TIMER) timers[timer.next].previous = timer.previous;
+	timer.slot = NO_TIMER;
+}
+
+/**
+* @brief Adds a timer to the free list. Its handle becomes invalid.
+* @param index - Index of the timer.
+*/
+void TimerWheel::release(int32_t index) {
+	Timer& timer = timers[index];
+	timer.slot = NO_TIMER;
+	timer.callback = nullptr;
+	// generation 0 would allow the invalid handle
+	timer.generation = (timer.generation == UINT32_MAX) ? 1 : timer.generation + 1;
+	timer.next = freeTimer;
+	freeTimer = index;
+}
+
+/**
+* @brief Moves the timers of a slot of a higher level into the lower levels.
+* @param level - Level of the slot, at least 1.
+* @param slot - Slot of the level.
+* @return The slot of the level, used to check whether the next level has to cascade too.
+*/
+uint32_t TimerWheel::cascade(int level, uint32_t slot) {
+	int32_t* head = &slots[FIRST_LEVEL_SLOTS + LEVEL_SLOTS * (level - 1) + slot];
+	int32_t index = *head;
+	*head = NO_TIMER;
+
+	while (index != NO_TIMER) {
+		int32_t next = timers[index].next;
+		this->insert(index);
+		index = next;
+	}
+	return slot;
+}
+
+/**
+* @brief Accounts the current storage of the timers and events in the memory tracker.
+*/
+void TimerWheel::trackMemory() {
+	size_t bytes = timers.capacity() * sizeof(Timer) + firedEvents.capacity() * sizeof(Event);
+	if (bytes > trackedBytes) {
+		MemoryTracker::trackAllocation(TAG_COMPONENTS, bytes - trackedBytes);
+	}
+	else if (bytes < trackedBytes) {
+		MemoryTracker::trackDeallocation(TAG_COMPONENTS, trackedBytes - bytes);
+	}
+	trackedBytes = bytes;
+}
@@ -0,0 +1,230 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "memorytracker.h"
+
+/**
+ * @brief Handle of a scheduled timer. Stays unique after the timer fired or was canceled, so old handles can not cancel new timers.
+*/
+typedef uint64_t TimerHandle;
+
+/**
+ * @brief Handle of no timer.
+*/
+const TimerHandle INVALID_TIMER = 0;
+
+/**
+ * @brief Types of the events fired by timers.
+*/
+enum TIMER_EVENTS {
+	TIMER_EVENT_CALLBACK,
+	TIMER_EVENT_PATHFINDING,
+	TIMER_EVENT_LIFETIME
+};
+
+/**
+ * @brief Hierarchical timing wheel of millisecond timers. Timers are scheduled and canceled in constant time.
+ * The first level has a slot per millisecond, every further level covers the whole previous level per slot. Timers of the higher levels cascade down when the wheel reaches their slot.
+ * Advancing the wheel moves the expired timers into a list of fired events that is handled by the owner of the wheel.
+*/
+class TimerWheel {
+public:
+	// function pointer of callback timers.
+	typedef void (*timerFunction)(void);
+
+	/**
+	 * @brief Event of an expired timer.
+	*/
+	struct Event {
+		TimerHandle handle;
+		TIMER_EVENTS type;
+		unsigned int uid;
+		timerFunction callback;
+	};
+
+	/**
+	 * @brief Number of levels of the wheel.
+	*/
+	static const int LEVELS = 4;
+
+	/**
+	 * @brief Number of bits of the slots of the first level.
+	*/
+	static const int FIRST_LEVEL_BITS = 8;
+
+	/**
+	 * @brief Number of bits of the slots of the higher levels.
+	*/
+	static const int LEVEL_BITS = 6;
+
+	/**
+	 * @brief Longest delay in milliseconds (about 18 hours). Longer delays are shortened.
+	*/
+	static const uint32_t MAX_DELAY = (1u << (FIRST_LEVEL_BITS + LEVEL_BITS * (LEVELS - 1))) - 1;
+
+	/**
+	 * @brief Creates an empty wheel.
+	*/
+	TimerWheel();
+
+	/**
+	 * @brief Destructor of the wheel. Removes the timers from the memory tracker.
+	*/
+	~TimerWheel();
+
+	/**
+	 * @brief Removes every timer and fired event and sets the current time of the wheel.
+	 * @param now - Current time in milliseconds.
+	*/
+	void reset(uint32_t now);
+
+	/**
+	 * @brief Schedules a timer.
+	 * @param delayMS - Milliseconds from the last advance until the timer fires. Timers with a delay of 0 fire at the next advance.
+	 * @param type - Type of the fired event.
+	 * @param uid - Unique identifier of the entity the timer belongs to. 0 if the timer belongs to no entity.
+	 * @param callback - Function called by the owner of the wheel when the timer fires. May be nullptr.
+	 * @return Handle of the timer.
+	*/
+	TimerHandle schedule(uint32_t delayMS, TIMER_EVENTS type, unsigned int uid, timerFunction callback = nullptr);
+
+	/**
+	 * @brief Cancels a timer.
+	 * @param handle - Handle of the timer.
+	 * @return Whether the timer was scheduled.
+	*/
+	bool cancel(TimerHandle handle);
+
+	/**
+	 * @brief Checks if a timer is scheduled.
+	 * @param handle - Handle of the timer.
+	 * @return Whether the timer has neither fired nor was canceled.
+	*/
+	bool isScheduled(TimerHandle handle);
+
+	/**
+	 * @brief Advances the wheel and appends the events of the expired timers to the fired events.
+	 * @param now - Current time in milliseconds.
+	 * @return Number of fired timers.
+	*/
+	size_t advance(uint32_t now);
+
+	/**
+	 * @brief Gets the events of the fired timers since the events were cleared.
+	 * @return Reference to the fired events.
+	*/
+	const std::vector<Event>& getFiredEvents() { return firedEvents; }
+
+	/**
+	 * @brief Removes the fired events after they were handled.
+	*/
+	void clearFiredEvents() { firedEvents.clear(); }
+
+	/**
+	 * @brief Gets the number of scheduled timers.
+	 * @return Number of timers.
+	*/
+	size_t getCount() { return count; }
+private:
+	/**
+	 * @brief Index of no timer.
+	*/
+	static const int32_t NO_TIMER = -1;
+
+	/**
+	 * @brief Number of slots of the first level.
+	*/
+	static const uint32_t FIRST_LEVEL_SLOTS = 1u << FIRST_LEVEL_BITS;
+
+	/**
+	 * @brief Number of slots of each higher level.
+	*/
+	static const uint32_t LEVEL_SLOTS = 1u << LEVEL_BITS;
+
+	/**
+	 * @brief Timer of the wheel. Scheduled timers are linked per slot, unused timers are linked in the free list.
+	*/
+	struct Timer {
+		uint32_t expires;
+		uint32_t generation;
+		int32_t previous;
+		int32_t next;
+		int32_t slot;
+		TIMER_EVENTS type;
+		unsigned int uid;
+		timerFunction callback;
+	};
+
+	/**
+	 * @brief Storage of the timers.
+	*/
+	std::vector<Timer> timers;
+
+	/**
+	 * @brief First timer of each slot. The slots of the first level are followed by the slots of the higher levels.
+	*/
+	int32_t slots[FIRST_LEVEL_SLOTS + LEVEL_SLOTS * (LEVELS - 1)];
+
+	/**
+	 * @brief First unused timer.
+	*/
+	int32_t freeTimer = NO_TIMER;
+
+	/**
+	 * @brief Next millisecond that is processed.
+	*/
+	uint32_t currentTick = 0;
+
+	/**
+	 * @brief Number of scheduled timers.
+	*/
+	size_t count = 0;
+
+	/**
+	 * @brief Events of the fired timers.
+	*/
+	std::vector<Event> firedEvents;
+
+	/**
+	 * @brief Bytes of the timers and events accounted to the memory tracker.
+	*/
+	size_t trackedBytes = 0;
+
+	/**
+	 * @brief Gets the index of the timer of a handle.
+	 * @param handle - Handle of the timer.
+	 * @return Index of the timer. NO_TIMER if the timer is not scheduled.
+	*/
+	int32_t getTimer(TimerHandle handle);
+
+	/**
+	 * @brief Links a timer into the slot of its expiration relative to the current tick.
+	 * @param index - Index of the timer.
+	*/
+	void insert(int32_t index);
+
+	/**
+	 * @brief Unlinks a timer from its slot.
+	 * @param index - Index of the timer.
+	*/
+	void unlink(int32_t index);
+
+	/**
+	 * @brief Adds a timer to the free list. Its handle becomes invalid.
+	 * @param index - Index of the timer.
+	*/
+	void release(int32_t index);
+
+	/**
+	 * @brief Moves the timers of a slot of a higher level into the lower levels.
+	 * @param level - Level of the slot, at least 1.
+	 * @param slot - Slot of the level.
+	 * @return The slot of the level, used to check whether the next level has to cascade too.
+	*/
+	uint32_t cascade(int level, uint32_t slot);
+
+	/**
+	 * @brief Accounts the current storage of the timers and events in the memory tracker.
+	*/
+	void trackMemory();
+};
@@ -2,6 +2,7 @@
 #include "SDL_ttf.h"
 #include "string"
 #include "uielement.h"
+#include "../memorytracker.h"
 /**
  * @brief Struct that represents ui labels.
 */
@@ -30,6 +31,7 @@ public:
 		this->text = labelText;
 		this->textColor = color;
 		this->textFont = font;
+		this->labelTexture = nullptr;
 
 		createLabelTexture(renderer);
 		setPosition(x, y);
@@ -39,6 +41,9 @@ public:
 	* @brief Deconstructor of label.
 	*/
 	~Label(){
+		if (labelTexture != nullptr) {
+			MemoryTracker::trackDeallocation(TAG_UI, MemoryTracker::getTextureSize(labelTexture));
+		}
 		SDL_DestroyTexture(labelTexture);
 	}
 
@@ -115,13 +120,21 @@ private:
 	std::string text;
 
 	/**
-	 * @brief Creates a new texture based on the current text.
+	 * @brief Creates a new texture based on the current text. Destroys the previous texture.
 	 * @param renderer - Pointer to the window renderer.
 	*/
 	void createLabelTexture(SDL_Renderer* renderer) {
+		if (labelTexture != nullptr) {
+			MemoryTracker::trackDeallocation(TAG_UI, MemoryTracker::getTextureSize(labelTexture));
+			SDL_DestroyTexture(labelTexture);
+		}
+
 		SDL_Surface* tempSurface = TTF_RenderText_Blended(textFont, text.c_str(), textColor);
 		this->labelTexture = SDL_CreateTextureFromSurface(renderer, tempSurface);
 		SDL_FreeSurface(tempSurface);
+		if (labelTexture != nullptr) {
+			MemoryTracker::trackAllocation(TAG_UI, MemoryTracker::getTextureSize(labelTexture));
+		}
 
 		SDL_QueryTexture(labelTexture, NULL, NULL, &displayPosition.w, &displayPosition.h);
 	}
@@ -21,6 +21,9 @@ public:
 	* @brief Deconstructor of panel.
 	*/
 	~Panel() {
+		if (panelTexture != nullptr) {
+			MemoryTracker::trackDeallocation(TAG_UI, MemoryTracker::getTextureSize(panelTexture));
+		}
 		SDL_DestroyTexture(panelTexture);
 	}
 
@@ -35,7 +38,7 @@ public:
 	 * @param panelColor - Color of the panel texture.
 	*/
 	Panel(SDL_Renderer* renderer, const char* filePath, int x, int y, int w, int h, SDL_Color panelColor) {
-		this->panelTexture = FileLoader::loadSDLTexture(filePath, renderer);
+		this->panelTexture = FileLoader::loadSDLTexture(filePath, renderer, TAG_UI);
 		setPanelColor(panelColor);
 		setPosition(x, y);
 		setSize(w, h);
@@ -52,7 +55,7 @@ public:
 	*/
 	Panel(SDL_Renderer* renderer, int x, int y, int w, int h, SDL_Color panelColor) {
 		// use base panel texture
-		this->panelTexture = FileLoader::loadSDLTexture("assets/base_panel.png", renderer);
+		this->panelTexture = FileLoader::loadSDLTexture("assets/base_panel.png", renderer, TAG_UI);
 		setPanelColor(panelColor);
 		setPosition(x, y);
 		setSize(w, h);
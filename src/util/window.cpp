@@ -6,12 +6,31 @@
 bool Window::initWindow() {
 	this->window = SDL_CreateWindow(windowTitle.c_str(), SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, width, height, 0);
 	if (this->window == nullptr) {
-		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Initialization error", "Could not initialize window of game engine.", NULL);
+		Log::error("Initialization error", "Could not initialize window of game engine.");
 		return false;
 	}
 	this->renderer = SDL_CreateRenderer(this->window, -1, SDL_RENDERER_ACCELERATED| SDL_RENDERER_PRESENTVSYNC);
 	if (this->renderer == nullptr) {
-		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Initialization error", "Could not initialize renderer of game engine.", NULL);
+		Log::error("Initialization error", "Could not initialize renderer of game engine.");
+		return false;
+	}
+	SDL_SetRenderDrawColor(this->renderer, 0, 0, 0, 255);
+	return true;
+}
+
+/**
+* @brief Initializes the window without display. The renderer draws into a software surface.
+* @return Whether the headless window was successfully initialized.
+*/
+bool Window::initHeadless() {
+	this->surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA8888);
+	if (this->surface == nullptr) {
+		Log::error("Initialization error", "Could not create surface of headless game engine.");
+		return false;
+	}
+	this->renderer = SDL_CreateSoftwareRenderer(this->surface);
+	if (this->renderer == nullptr) {
+		Log::error("Initialization error", "Could not initialize software renderer of headless game engine.");
 		return false;
 	}
 	SDL_SetRenderDrawColor(this->renderer, 0, 0, 0, 255);
@@ -28,6 +47,6 @@ void Window::setWindowIcon(const char* filePath) {
 		SDL_SetWindowIcon(window, icon);
 	}
 	else {
-		SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Initialization error", "Could not load icon of game window.", NULL);
+		Log::error("Initialization error", "Could not load icon of game window.");
 	}
 }
\ No newline at end of file
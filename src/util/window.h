@@ -2,6 +2,7 @@
 #include "SDL.h"
 #include "SDL_image.h"
 #include <string>
+#include "log.h"
 /**
  * @brief Class representing the game window.
 */
@@ -25,6 +26,12 @@ public:
 	*/
 	bool initWindow();
 
+	/**
+	 * @brief Initializes the window without display. The renderer draws into a software surface.
+	 * @return Whether the headless window was successfully initialized.
+	*/
+	bool initHeadless();
+
 	/**
 	 * @brief Sets the icon of the window.
 	 * @param filePath - Filepath to icon.
@@ -35,11 +42,14 @@ public:
 	* @brief Window destructor. Destroys the SDL_Renderer and the SDL_Window. 
 	*/
 	~Window() {
+		if (renderer) {
+			SDL_DestroyRenderer(renderer);
+		}
 		if (window) {
 			SDL_DestroyWindow(window);
 		}
-		if (renderer) {
-			SDL_DestroyRenderer(renderer);
+		if (surface) {
+			SDL_FreeSurface(surface);
 		}
 	}
 
@@ -74,6 +84,14 @@ public:
 	SDL_Renderer* getRenderer() {
 		return renderer;
 	}
+
+	/**
+	 * @brief Checks if the window was initialized without display.
+	 * @return Whether the window is headless.
+	*/
+	bool isHeadless() {
+		return surface != nullptr;
+	}
 private:
 	/**
 	 * @brief Width of the game window.
@@ -97,4 +115,9 @@ private:
 	 * @brief Pointer to the SDL_Renderer.
 	*/
 	SDL_Renderer* renderer = nullptr;
+
+	/**
+	 * @brief Pointer to the surface the renderer draws into in headless mode.
+	*/
+	SDL_Surface* surface = nullptr;
 };
\ No newline at end of file
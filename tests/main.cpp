@@ -0,0 +1,51 @@
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include "SDL.h"
+#include "test.h"
+#include "memorytests.h"
+#include "navigationtests.h"
+#include "sleepgridtests.h"
+
+/**
+* @brief Prints the command line usage.
+*/
+static void printUsage() {
+	std::cout << "Usage: tests [options]\n"
+		<< "  --filter <text>      Only run tests containing text in their name.\n"
+		<< "  --seed <n>           Seed of the randomized checks (default 1337).\n";
+}
+
+int main(int argc, char* argv[]) {
+	std::string filter = "";
+	unsigned int seed = 1337;
+
+	for (int i = 1; i < argc; i++) {
+		bool hasValue = i + 1 < argc;
+		if (std::strcmp(argv[i], "--filter") == 0 && hasValue) {
+			filter = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) {
+			seed = (unsigned int)std::strtoul(argv[++i], nullptr, 10);
+		}
+		else {
+			printUsage();
+			return (std::strcmp(argv[i], "--help") == 0) ? 0 : 1;
+		}
+	}
+
+	// the tests run the engine headless at most, no window or audio device is needed
+	if (SDL_Init(SDL_INIT_TIMER) != 0) {
+		std::cerr << "Could not initialize SDL: " << SDL_GetError() << "\n";
+		return 1;
+	}
+
+	TestRunner runner;
+	registerMemoryTests(&runner);
+	registerNavigationTests(&runner);
+	registerSleepGridTests(&runner);
+	bool success = runner.run(filter, seed);
+
+	SDL_Quit();
+	return success ? 0 : 1;
+}
@@ -0,0 +1,44 @@
+#include "memorytests.h"
+#include <util/memorytracker.h>
+
+/**
+* @brief Checks that the strict frame mode only counts allocating frames after the warmup frames.
+* @param context - Context of the test.
+*/
+static void testStrictFrameMode(TestContext& context) {
+	MemoryTracker::setStrictFrameMode(true, 1);
+
+	// warmup frame
+	MemoryTracker::beginFrame();
+	MemoryTracker::trackAllocation(TAG_UI, 64);
+	MemoryTracker::endFrame();
+	TEST_CHECK(context, MemoryTracker::getFrameViolationCount() == 0);
+
+	// releasing memory does not violate the steady state
+	MemoryTracker::beginFrame();
+	MemoryTracker::trackDeallocation(TAG_UI, 64);
+	TEST_CHECK(context, MemoryTracker::endFrame() == 0);
+	TEST_CHECK(context, MemoryTracker::getFrameViolationCount() == 0);
+
+	MemoryTracker::beginFrame();
+	MemoryTracker::trackAllocation(TAG_UI, 64);
+	TEST_CHECK(context, MemoryTracker::endFrame() == 1);
+	TEST_CHECK(context, MemoryTracker::getFrameViolationCount() == 1);
+	MemoryTracker::trackDeallocation(TAG_UI, 64);
+
+	// disabling the mode resets the violations and stops counting them
+	MemoryTracker::setStrictFrameMode(false, 0);
+	MemoryTracker::beginFrame();
+	MemoryTracker::trackAllocation(TAG_UI, 64);
+	MemoryTracker::endFrame();
+	MemoryTracker::trackDeallocation(TAG_UI, 64);
+	TEST_CHECK(context, MemoryTracker::getFrameViolationCount() == 0);
+}
+
+/**
+* @brief Registers the tests of the memory tracker.
+* @param runner - Runner to register the tests to.
+*/
+void registerMemoryTests(TestRunner* runner) {
+	runner->addTest("memory_strict_frame_mode", testStrictFrameMode);
+}
@@ -0,0 +1,468 @@
+#include "navigationtests.h"
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <util/navigation/hierarchicalgrid.h>
+#include <util/navigation/incrementalplanner.h>
+#include <util/navigation/navgrid.h>
+
+/**
+* @brief Number of random grids every randomized check is executed on.
+*/
+static const int GRID_COUNT = 200;
+
+/**
+* @brief Number of random queries per grid.
+*/
+static const int QUERIES_PER_GRID = 20;
+
+/**
+* @brief Difference up to which two path costs are treated as equal.
+*/
+static const float COST_EPSILON = 0.001f;
+
+/**
+* @brief Fills a grid of random size with randomly blocked nodes.
+* @param grid - Grid to initialize.
+* @param random - Random number generator of the test.
+* @param weighted - Whether the walkable nodes get random costs, otherwise every walkable node has a cost of 1.
+*/
+static void createRandomGrid(NavGrid& grid, std::mt19937& random, bool weighted) {
+	int width = std::uniform_int_distribution<int>(1, 40)(random);
+	int height = std::uniform_int_distribution<int>(1, 40)(random);
+	float blockedChance = std::uniform_real_distribution<float>(0.0f, 0.45f)(random);
+	std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+	std::uniform_int_distribution<int> cost(1, 9);
+
+	grid.init(width, height);
+	for (NodeIndex node = 0; node < (NodeIndex)grid.getNodeCount(); node++) {
+		if (chance(random) < blockedChance) {
+			grid.setCost(node, 0);
+		}
+		else if (weighted) {
+			grid.setCost(node, (uint8_t)cost(random));
+		}
+	}
+}
+
+/**
+* @brief Picks a random node of the grid.
+* @param grid - Navigation grid.
+* @param random - Random number generator of the test.
+* @return Random node.
+*/
+static NodeIndex getRandomNode(NavGrid& grid, std::mt19937& random) {
+	return std::uniform_int_distribution<NodeIndex>(0, (NodeIndex)grid.getNodeCount() - 1)(random);
+}
+
+/**
+* @brief Calculates the cost of the cheapest path with dijkstra's algorithm. Uses the step costs of NavGrid::findPath: blocked nodes and obstacles are avoided, the destination node can always be entered.
+* @param grid - Navigation grid.
+* @param start - Start node.
+* @param dest - Destination node.
+* @param uniform - Whether every walkable node is treated with a cost of 1.
+* @return Cost of the cheapest path. INFINITY if there is no path.
+*/
+static float getShortestDistance(NavGrid& grid, NodeIndex start, NodeIndex dest, bool uniform) {
+	typedef std::pair<float, NodeIndex> Entry;
+	std::vector<float> distances(grid.getNodeCount(), INFINITY);
+	std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+
+	distances[start] = 0.0f;
+	open.push({ 0.0f, start });
+	while (!open.empty()) {
+		Entry current = open.top();
+		open.pop();
+		if (current.second == dest) {
+			return current.first;
+		}
+		if (current.first > distances[current.second]) {
+			continue;
+		}
+
+		for (int i = 0; i < NavGrid::NEIGHBOUR_COUNT; i++) {
+			NodeIndex neighbour = grid.getNeighbour(current.second, i);
+			if (neighbour == INVALID_NODE || (neighbour != dest && !grid.isWalkable(neighbour))) {
+				continue;
+			}
+
+			uint8_t cost = grid.getCost(neighbour);
+			float step = NavGrid::getNeighbourDistance(i) * ((uniform || cost == 0) ? 1.0f : (float)cost);
+			if (current.first + step < distances[neighbour]) {
+				distances[neighbour] = current.first + step;
+				open.push({ distances[neighbour], neighbour });
+			}
+		}
+	}
+	return INFINITY;
+}
+
+/**
+* @brief Checks that a path connects the start and the destination node with neighbouring walkable nodes and calculates its cost.
+* @param grid - Navigation grid.
+* @param path - Path from the destination node back to the start node.
+* @param start - Start node.
+* @param dest - Destination node.
+* @param uniform - Whether every walkable node is treated with a cost of 1.
+* @return Cost of the path. INFINITY if the path is not valid.
+*/
+static float getPathCost(NavGrid& grid, const std::vector<NodeIndex>& path, NodeIndex start, NodeIndex dest, bool uniform) {
+	if (path.empty() || path.front() != dest || path.back() != start) {
+		return INFINITY;
+	}
+
+	float total = 0.0f;
+	for (size_t i = path.size() - 1; i > 0; i--) {
+		NodeIndex from = path[i];
+		NodeIndex to = path[i - 1];
+		if (to != dest && !grid.isWalkable(to)) {
+			return INFINITY;
+		}
+
+		int direction = -1;
+		for (int j = 0; j < NavGrid::NEIGHBOUR_COUNT; j++) {
+			if (grid.getNeighbour(from, j) == to) {
+				direction = j;
+			}
+		}
+		if (direction < 0) {
+			return INFINITY;
+		}
+
+		uint8_t cost = grid.getCost(to);
+		total += NavGrid::getNeighbourDistance(direction) * ((uniform || cost == 0) ? 1.0f : (float)cost);
+	}
+	return total;
+}
+
+/**
+* @brief Checks that a* finds a path exactly when dijkstra's algorithm does and that the path has the same cost on weighted grids.
+* @param context - Context of the test.
+*/
+static void testAStarMatchesDijkstra(TestContext& context) {
+	std::mt19937 random(context.getSeed());
+	NavGrid grid;
+	std::vector<NodeIndex> path;
+
+	for (int g = 0; g < GRID_COUNT; g++) {
+		createRandomGrid(grid, random, true);
+		for (int q = 0; q < QUERIES_PER_GRID; q++) {
+			NodeIndex start = getRandomNode(grid, random);
+			NodeIndex dest = getRandomNode(grid, random);
+			float expected = getShortestDistance(grid, start, dest, false);
+
+			bool found = grid.findPath(start, dest, path);
+			TEST_CHECK(context, found == (expected != INFINITY));
+			if (found) {
+				TEST_CHECK(context, std::fabs(getPathCost(grid, path, start, dest, false) - expected) < COST_EPSILON);
+			}
+			else {
+				TEST_CHECK(context, path.empty());
+			}
+		}
+	}
+}
+
+/**
+* @brief Checks that jump point search and jump point search plus find a path exactly when dijkstra's algorithm does and that the paths have the same cost on grids with uniform costs.
+* @param context - Context of the test.
+*/
+static void testJumpPointSearchMatchesDijkstra(TestContext& context) {
+	std::mt19937 random(context.getSeed());
+	NavGrid grid;
+	std::vector<NodeIndex> path;
+
+	for (int g = 0; g < GRID_COUNT; g++) {
+		createRandomGrid(grid, random, false);
+		grid.buildJumpTable();
+		for (int q = 0; q < QUERIES_PER_GRID; q++) {
+			NodeIndex start = getRandomNode(grid, random);
+			NodeIndex dest = getRandomNode(grid, random);
+			float expected = getShortestDistance(grid, start, dest, true);
+
+			bool found = grid.findPathJps(start, dest, path);
+			TEST_CHECK(context, found == (expected != INFINITY));
+			if (found) {
+				TEST_CHECK(context, std::fabs(getPathCost(grid, path, start, dest, true) - expected) < COST_EPSILON);
+			}
+
+			found = grid.findPathJpsPlus(start, dest, path);
+			TEST_CHECK(context, found == (expected != INFINITY));
+			if (found) {
+				TEST_CHECK(context, std::fabs(getPathCost(grid, path, start, dest, true) - expected) < COST_EPSILON);
+			}
+		}
+	}
+}
+
+/**
+* @brief Follows the partial paths of the hierarchical search from the start node until a path ends at the destination node.
+* @param context - Context of the test.
+* @param grid - Navigation grid.
+* @param hierarchicalGrid - Clusters built for the grid.
+* @param start - Start node.
+* @param dest - Destination node.
+* @return Whether the first search found a path.
+*/
+static bool followHierarchicalPath(TestContext& context, NavGrid& grid, HierarchicalGrid& hierarchicalGrid, NodeIndex start, NodeIndex dest) {
+	std::vector<NodeIndex> path;
+	bool complete = false;
+	NodeIndex current = start;
+
+	// every partial path moves at least one node, so the destination is reached within one search per node
+	for (size_t i = 0; i < grid.getNodeCount(); i++) {
+		if (!hierarchicalGrid.findPath(grid, current, dest, path, complete)) {
+			TEST_CHECK(context, current == start);
+			return false;
+		}
+
+		TEST_CHECK(context, !path.empty() && path.back() == current);
+		TEST_CHECK(context, path.size() > 1 || current == dest);
+		for (size_t j = 0; j + 1 < path.size(); j++) {
+			TEST_CHECK(context, grid.getDistance(path[j], path[j + 1]) < 1.5f);
+			TEST_CHECK(context, path[j] == dest || grid.isWalkable(path[j]));
+		}
+		if (complete) {
+			TEST_CHECK(context, path.front() == dest);
+			return true;
+		}
+		if (path.size() < 2) {
+			break;
+		}
+		current = path.front();
+	}
+	TEST_CHECK(context, !"partial paths do not reach the destination");
+	return true;
+}
+
+/**
+* @brief Checks that the hierarchical search finds a path exactly when dijkstra's algorithm does, including diagonal steps over the borders and corners of the clusters and blocked start and destination nodes, and that following its partial paths reaches the destination.
+* @param context - Context of the test.
+*/
+static void testHierarchicalSearchReachesDestination(TestContext& context) {
+	NavGrid grid;
+	HierarchicalGrid hierarchicalGrid;
+
+	// the only way from the top to the bottom leads diagonally over the border of the clusters at (1,4) -> (2,5) and over their corner at (4,4) -> (5,5)
+	grid.init(6, 17);
+	for (int x = 0; x < 6; x++) {
+		if (x != 1 && x != 4) grid.setCost(grid.getIndex(x, 4), 0);
+		if (x != 2 && x != 5) grid.setCost(grid.getIndex(x, 5), 0);
+	}
+	hierarchicalGrid.init(6, 17, 5);
+	hierarchicalGrid.update(grid);
+	TEST_CHECK(context, followHierarchicalPath(context, grid, hierarchicalGrid, grid.getIndex(0, 0), grid.getIndex(5, 16)));
+	TEST_CHECK(context, followHierarchicalPath(context, grid, hierarchicalGrid, grid.getIndex(5, 16), grid.getIndex(0, 0)));
+
+	// blocked destination on the border of its cluster that can only be entered from the neighbouring cluster, like the node occupied by the player
+	grid.init(10, 10);
+	for (int y = 0; y < 10; y++) {
+		grid.setCost(grid.getIndex(3, y), 0);
+	}
+	grid.setCost(grid.getIndex(4, 1), 0);
+	grid.setCost(grid.getIndex(4, 2), 0);
+	grid.setCost(grid.getIndex(4, 3), 0);
+	hierarchicalGrid.init(10, 10, 5);
+	hierarchicalGrid.update(grid);
+	TEST_CHECK(context, followHierarchicalPath(context, grid, hierarchicalGrid, grid.getIndex(9, 9), grid.getIndex(4, 2)));
+	TEST_CHECK(context, followHierarchicalPath(context, grid, hierarchicalGrid, grid.getIndex(4, 2), grid.getIndex(9, 9)));
+
+	std::mt19937 random(context.getSeed());
+	for (int g = 0; g < GRID_COUNT; g++) {
+		createRandomGrid(grid, random, true);
+		int clusterSize = std::uniform_int_distribution<int>(2, 8)(random);
+		hierarchicalGrid.init(grid.getWidth(), grid.getHeight(), clusterSize);
+		hierarchicalGrid.update(grid);
+
+		for (int q = 0; q < QUERIES_PER_GRID; q++) {
+			NodeIndex start = getRandomNode(grid, random);
+			NodeIndex dest = getRandomNode(grid, random);
+			bool reachable = getShortestDistance(grid, start, dest, false) != INFINITY;
+			TEST_CHECK(context, followHierarchicalPath(context, grid, hierarchicalGrid, start, dest) == reachable);
+		}
+	}
+}
+
+/**
+* @brief Checks that the incremental search finds a path exactly when dijkstra's algorithm does while the agent moves along its path, the costs of the grid change and the destination moves.
+* The paths have the same cost as the ones of dijkstra's algorithm until the destination moves away from the root of the search.
+* @param context - Context of the test.
+*/
+static void testIncrementalSearchMatchesDijkstra(TestContext& context) {
+	std::mt19937 random(context.getSeed());
+	std::uniform_int_distribution<int> cost(0, 9);
+	std::uniform_int_distribution<int> direction(0, NavGrid::NEIGHBOUR_COUNT - 1);
+	NavGrid grid;
+	IncrementalPlanner planner;
+	std::vector<NodeIndex> path;
+
+	for (int g = 0; g < GRID_COUNT; g++) {
+		createRandomGrid(grid, random, true);
+		planner.reset();
+		NodeIndex start = getRandomNode(grid, random);
+		NodeIndex dest = getRandomNode(grid, random);
+		bool rooted = true;
+
+		for (int q = 0; q < QUERIES_PER_GRID; q++) {
+			float expected = getShortestDistance(grid, start, dest, false);
+			bool found = planner.findPath(grid, start, dest, path);
+			TEST_CHECK(context, found == (expected != INFINITY));
+			if (found) {
+				float actual = getPathCost(grid, path, start, dest, false);
+				TEST_CHECK(context, actual != INFINITY);
+				TEST_CHECK(context, !rooted || std::fabs(actual - expected) < COST_EPSILON);
+			}
+
+			// the agent walks one node, then a few nodes change their cost and the destination moves in the second half
+			if (found && path.size() > 1) {
+				start = path[path.size() - 2];
+			}
+			for (int i = 0; i < 2; i++) {
+				grid.setCost(getRandomNode(grid, random), (uint8_t)cost(random));
+			}
+			NodeIndex neighbour = grid.getNeighbour(dest, direction(random));
+			if (q >= QUERIES_PER_GRID / 2 && neighbour != INVALID_NODE) {
+				dest = neighbour;
+				rooted = false;
+			}
+		}
+	}
+}
+
+/**
+* @brief Checks that the connected components answer whether a path exists like dijkstra's algorithm while nodes are opened and closed by cost changes and static occupants.
+* @param context - Context of the test.
+*/
+static void testReachabilityMatchesDijkstra(TestContext& context) {
+	std::mt19937 random(context.getSeed());
+	std::uniform_int_distribution<int> change(0, 3);
+	NavGrid grid;
+	std::vector<NodeIndex> occupied;
+
+	for (int g = 0; g < GRID_COUNT; g++) {
+		createRandomGrid(grid, random, false);
+		occupied.clear();
+
+		for (int q = 0; q < QUERIES_PER_GRID; q++) {
+			NodeIndex start = getRandomNode(grid, random);
+			NodeIndex dest = getRandomNode(grid, random);
+			bool reachable = getShortestDistance(grid, start, dest, true) != INFINITY;
+			TEST_CHECK(context, grid.isReachable(start, dest) == reachable);
+
+			// changes between the queries split and merge the components
+			NodeIndex node = getRandomNode(grid, random);
+			switch (change(random)) {
+			case 0:
+				grid.setCost(node, 0);
+				break;
+			case 1:
+				grid.setCost(node, 1);
+				break;
+			case 2:
+				grid.addOccupant(node, OCCUPANCY_STATIC);
+				occupied.push_back(node);
+				break;
+			default:
+				if (!occupied.empty()) {
+					grid.removeOccupant(occupied.back(), OCCUPANCY_STATIC);
+					occupied.pop_back();
+				}
+				break;
+			}
+		}
+	}
+	TEST_CHECK(context, !grid.isReachable(INVALID_NODE, 0));
+}
+
+/**
+* @brief Checks the line of sight by visiting every node the line between the centers of the nodes touches (supercover). A line through the corner of two blocked nodes is blocked.
+* @param grid - Navigation grid.
+* @param from - First node.
+* @param to - Second node.
+* @return Whether no node between the ends blocks the sight.
+*/
+static bool isSightClear(NavGrid& grid, NodeIndex from, NodeIndex to) {
+	int x = grid.getX(from);
+	int y = grid.getY(from);
+	int dx = std::abs(grid.getX(to) - x);
+	int dy = std::abs(grid.getY(to) - y);
+	int stepX = (grid.getX(to) > x) ? 1 : -1;
+	int stepY = (grid.getY(to) > y) ? 1 : -1;
+
+	// error of the line at the next border in half nodes, positive if the vertical border is crossed first
+	int error = dx - dy;
+	while (x != grid.getX(to) || y != grid.getY(to)) {
+		if (error > 0) {
+			x += stepX;
+			error -= 2 * dy;
+		}
+		else if (error < 0) {
+			y += stepY;
+			error += 2 * dx;
+		}
+		else {
+			if (!grid.isWalkable(grid.getIndex(x + stepX, y)) && !grid.isWalkable(grid.getIndex(x, y + stepY))) {
+				return false;
+			}
+			x += stepX;
+			y += stepY;
+			error += 2 * dx - 2 * dy;
+		}
+
+		NodeIndex node = grid.getIndex(x, y);
+		if (node != to && !grid.isWalkable(node)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+* @brief Checks that the line of sight of single queries and batches matches a supercover traversal of the nodes on random grids with blocked nodes and static occupants.
+* @param context - Context of the test.
+*/
+static void testLineOfSightMatchesSupercover(TestContext& context) {
+	std::mt19937 random(context.getSeed());
+	NavGrid grid;
+	std::vector<NavGrid::SightQuery> queries;
+
+	for (int g = 0; g < GRID_COUNT; g++) {
+		createRandomGrid(grid, random, false);
+		for (int i = 0; i < 3; i++) {
+			grid.addOccupant(getRandomNode(grid, random), OCCUPANCY_STATIC);
+		}
+
+		queries.clear();
+		for (int q = 0; q < QUERIES_PER_GRID; q++) {
+			NodeIndex from = getRandomNode(grid, random);
+			NodeIndex to = getRandomNode(grid, random);
+			bool visible = isSightClear(grid, from, to);
+			TEST_CHECK(context, grid.hasLineOfSight(from, to) == visible);
+			TEST_CHECK(context, grid.hasLineOfSight(to, from) == visible);
+
+			// the batch shares the result of equal neighbouring queries
+			queries.push_back({ from, to, !visible });
+			queries.push_back({ from, to, !visible });
+		}
+
+		grid.checkLineOfSight(queries.data(), queries.size());
+		for (size_t i = 0; i < queries.size(); i++) {
+			TEST_CHECK(context, queries[i].visible == isSightClear(grid, queries[i].from, queries[i].to));
+		}
+	}
+}
+
+/**
+* @brief Registers the tests of the navigation grid and its searches.
+* @param runner - Runner to register the tests to.
+*/
+void registerNavigationTests(TestRunner* runner) {
+	runner->addTest("navigation_astar_matches_dijkstra", testAStarMatchesDijkstra);
+	runner->addTest("navigation_jps_matches_dijkstra", testJumpPointSearchMatchesDijkstra);
+	runner->addTest("navigation_hierarchical_reaches_destination", testHierarchicalSearchReachesDestination);
+	runner->addTest("navigation_incremental_matches_dijkstra", testIncrementalSearchMatchesDijkstra);
+	runner->addTest("navigation_reachability_matches_dijkstra", testReachabilityMatchesDijkstra);
+	runner->addTest("navigation_line_of_sight_matches_supercover", testLineOfSightMatchesSupercover);
+}
@@ -0,0 +1,8 @@
+#pragma once
+#include "test.h"
+
+/**
+ * @brief Registers the tests of the navigation grid and its searches.
+ * @param runner - Runner to register the tests to.
+*/
+void registerNavigationTests(TestRunner* runner);
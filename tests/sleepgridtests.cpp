@@ -0,0 +1,38 @@
+#include "sleepgridtests.h"
+#include <util/sleepgrid.h>
+
+/**
+* @brief Checks that a sleeping entity is collected by an area that only overlaps its collider in the neighbouring cell.
+* @param context - Context of the test.
+*/
+static void testCollectReachingEntity(TestContext& context) {
+	SleepGrid grid;
+	std::vector<unsigned int> uids;
+	grid.init(4 * SleepGrid::CELL_SIZE, 4 * SleepGrid::CELL_SIZE);
+
+	// position in the first cell, collider reaching 40 pixels into the second one
+	SDL_Point position = { SleepGrid::CELL_SIZE - 8, 64 };
+	TEST_CHECK(context, grid.add(1, position, 48));
+	TEST_CHECK(context, grid.add(2, { 3 * SleepGrid::CELL_SIZE + 64, 64 }));
+
+	SDL_Rect area = { SleepGrid::CELL_SIZE + 32, 48, 16, 16 };
+	grid.collect(area, uids);
+	TEST_CHECK(context, uids.size() == 1 && uids[0] == 1);
+	TEST_CHECK(context, grid.getCount() == 1);
+
+	// the reach is forgotten once the grid is empty
+	grid.collectAll(uids);
+	TEST_CHECK(context, grid.getCount() == 0);
+	uids.clear();
+	TEST_CHECK(context, grid.add(3, position));
+	grid.collect(area, uids);
+	TEST_CHECK(context, uids.empty());
+}
+
+/**
+* @brief Registers the tests of the sleep grid.
+* @param runner - Runner to register the tests to.
+*/
+void registerSleepGridTests(TestRunner* runner) {
+	runner->addTest("sleepgrid_collect_reaching_entity", testCollectReachingEntity);
+}
@@ -0,0 +1,8 @@
+#pragma once
+#include "test.h"
+
+/**
+ * @brief Registers the tests of the sleep grid.
+ * @param runner - Runner to register the tests to.
+*/
+void registerSleepGridTests(TestRunner* runner);
@@ -0,0 +1,62 @@
+#include "test.h"
+#include <cstdio>
+
+/**
+* @brief Records a check. Failed checks are printed with their location.
+* @param condition - Result of the check.
+* @param expression - Checked expression.
+* @param file - Source file of the check.
+* @param line - Source line of the check.
+* @return Result of the check.
+*/
+bool TestContext::check(bool condition, const char* expression, const char* file, int line) {
+	if (!condition) {
+		// later failures of randomized checks usually repeat the first ones
+		if (failures < 10) {
+			std::printf("  %s:%d: check failed: %s\n", file, line, expression);
+		}
+		failures++;
+	}
+	return condition;
+}
+
+/**
+* @brief Registers a test.
+* @param name - Unique name of the test.
+* @param function - Function executing the test.
+*/
+void TestRunner::addTest(const char* name, TestFunction function) {
+	tests.push_back({ name, function });
+}
+
+/**
+* @brief Runs every test matching the filter.
+* @param filter - Only tests containing the filter in their name are executed. Empty runs every test.
+* @param seed - Seed of the randomized checks.
+* @return Whether every check passed.
+*/
+bool TestRunner::run(const std::string& filter, unsigned int seed) {
+	size_t executed = 0;
+	size_t failed = 0;
+
+	for (size_t i = 0; i < tests.size(); i++) {
+		if (!filter.empty() && tests[i].name.find(filter) == std::string::npos) {
+			continue;
+		}
+
+		TestContext context(seed);
+		tests[i].function(context);
+		executed++;
+
+		if (context.getFailures() > 0) {
+			std::printf("FAIL %s (%zu failed checks)\n", tests[i].name.c_str(), context.getFailures());
+			failed++;
+		}
+		else {
+			std::printf("ok   %s\n", tests[i].name.c_str());
+		}
+	}
+
+	std::printf("\n%zu tests, %zu failed\n", executed, failed);
+	return failed == 0;
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <string>
+#include <vector>
+
+/**
+ * @brief State of the running test. Collects the failed checks.
+*/
+class TestContext {
+public:
+	/**
+	 * @brief Creates the context of a test.
+	 * @param seed - Seed of the randomized checks.
+	*/
+	TestContext(unsigned int seed) : seed{ seed } {}
+
+	/**
+	 * @brief Records a check. Failed checks are printed with their location.
+	 * @param condition - Result of the check.
+	 * @param expression - Checked expression.
+	 * @param file - Source file of the check.
+	 * @param line - Source line of the check.
+	 * @return Result of the check.
+	*/
+	bool check(bool condition, const char* expression, const char* file, int line);
+
+	/**
+	 * @brief Gets the seed of the randomized checks. Every test starts with the same seed, so failures can be reproduced.
+	 * @return Seed of the test.
+	*/
+	unsigned int getSeed() { return seed; }
+
+	/**
+	 * @brief Gets the number of failed checks.
+	 * @return Number of failed checks.
+	*/
+	size_t getFailures() { return failures; }
+private:
+	/**
+	 * @brief Seed of the randomized checks.
+	*/
+	unsigned int seed;
+
+	/**
+	 * @brief Number of failed checks.
+	*/
+	size_t failures = 0;
+};
+
+/**
+ * @brief Checks a condition in a test. The test continues after a failed check.
+*/
+#define TEST_CHECK(context, condition) (context).check((condition), #condition, __FILE__, __LINE__)
+
+/**
+ * @brief Function executing a test.
+*/
+typedef void (*TestFunction)(TestContext& context);
+
+/**
+ * @brief Executes the registered tests and reports the failures.
+*/
+class TestRunner {
+public:
+	/**
+	 * @brief Registers a test.
+	 * @param name - Unique name of the test.
+	 * @param function - Function executing the test.
+	*/
+	void addTest(const char* name, TestFunction function);
+
+	/**
+	 * @brief Runs every test matching the filter.
+	 * @param filter - Only tests containing the filter in their name are executed. Empty runs every test.
+	 * @param seed - Seed of the randomized checks.
+	 * @return Whether every check passed.
+	*/
+	bool run(const std::string& filter, unsigned int seed);
+private:
+	/**
+	 * @brief Registered test.
+	*/
+	struct Test {
+		std::string name;
+		TestFunction function;
+	};
+
+	/**
+	 * @brief Registered tests.
+	*/
+	std::vector<Test> tests;
+};